@@ -23,6 +23,8 @@
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer/optimizer.h"
 #include "lite/core/program.h"
+#include "lite/core/thread_pool.h"
+#include "lite/core/tuning_cache.h"
 #include "lite/core/types.h"
 #include "lite/model_parser/model_parser.h"
 
@@ -178,6 +180,14 @@ class LITE_API Predictor {
 #endif
   }
 
+  void ConfigMemoryArena(const lite_api::CxxConfig& config) {
+    program_->set_use_memory_arena(config.use_memory_arena());
+  }
+
+  void ConfigInterOp(const lite_api::CxxConfig& config) {
+    program_->set_inter_op_threads(config.inter_op_threads());
+  }
+
 #ifdef LITE_WITH_METAL
   void ConfigMetalContext(const lite_api::CxxConfig& config) {
     program_->ConfigMetalContext(config.metal_lib_path(),
@@ -195,6 +205,11 @@ class LITE_API Predictor {
   /// \return a boolean variable.
   bool TryShrinkMemory();
 
+  profile::TraceProfiler* trace_profiler() {
+    CHECK(program_) << "The runtime program is not created.";
+    return program_->trace_profiler();
+  }
+
   // Get offset-th col of feed inputs.
   lite::Tensor* GetInput(size_t offset);
   // get input by name.
@@ -299,6 +314,9 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   /// \return a boolean variable.
   bool TryShrinkMemory() override;
 
+  void EnableProfiler(bool enable) override;
+  std::string GetProfilerTrace(bool clear = true) override;
+
   std::shared_ptr<lite_api::PaddlePredictor> Clone() override;
 
   std::shared_ptr<lite_api::PaddlePredictor> Clone(
@@ -329,6 +347,10 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   lite_api::CxxConfig config_;
   std::mutex mutex_;
   bool status_is_cloned_;
+  // Owned by the predictor, so predictors don't share worker threads
+  std::shared_ptr<ThreadPool> thread_pool_;
+  // Only created if the cpu autotuning is on
+  std::shared_ptr<TuningCache> tuning_cache_;
 };
 
 /*
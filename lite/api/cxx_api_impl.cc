@@ -45,11 +45,11 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
   mode_ = config.power_mode();
   threads_ = config.threads();
 #ifdef LITE_USE_THREAD_POOL
-  int thread_num = ThreadPool::Init(threads_);
-  if (thread_num > 1) {
-    ThreadPool::AcquireThreadPool();
-  }
+  thread_pool_ = std::make_shared<ThreadPool>(threads_, config.cpu_affinity());
 #endif
+  if (config.cpu_autotune() && !tuning_cache_) {
+    tuning_cache_ = std::make_shared<TuningCache>(config.cpu_autotune_file());
+  }
   if (!status_is_cloned_) {
     auto places = config.valid_places();
     std::vector<std::string> passes = config.get_passes_internal();
@@ -120,6 +120,9 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
     CHECK(raw_predictor_) << "The Predictor can not be nullptr in Clone mode.";
   }
 
+  raw_predictor_->ConfigMemoryArena(config);
+  raw_predictor_->ConfigInterOp(config);
+
 #ifdef LITE_WITH_METAL
   raw_predictor_->ConfigMetalContext(config);
 #endif
@@ -189,31 +192,31 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
 #endif
 }
 
-CxxPaddleApiImpl::~CxxPaddleApiImpl() {
-#ifdef LITE_USE_THREAD_POOL
-  ThreadPool::ReleaseThreadPool();
-#endif
-}
+CxxPaddleApiImpl::~CxxPaddleApiImpl() { WaitForAsyncRuns(); }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInputByName(
     const std::string &name) {
+  WaitForAsyncRuns();
   auto *x = raw_predictor_->GetInputByName(name);
   return std::unique_ptr<lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
 std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetOutputByName(
     const std::string &name) const {
+  WaitForAsyncRuns();
   const auto *x = raw_predictor_->GetOutputByName(name);
   return std::unique_ptr<lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInput(int i) {
+  WaitForAsyncRuns();
   auto *x = raw_predictor_->GetInput(i);
   return std::unique_ptr<lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
 std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetOutput(
     int i) const {
+  WaitForAsyncRuns();
   const auto *x = raw_predictor_->GetOutput(i);
   return std::unique_ptr<lite_api::Tensor>(new lite_api::Tensor(x));
 }
@@ -231,25 +234,36 @@ std::vector<std::string> CxxPaddleApiImpl::GetOutputNames() {
 }
 
 void CxxPaddleApiImpl::Run() {
+  WaitForAsyncRuns();
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
 #endif
+#ifdef LITE_USE_THREAD_POOL
+  ThreadPool::ScopedBind bind_thread_pool(thread_pool_.get());
+#endif
+  TuningCache::ScopedBind bind_tuning_cache(tuning_cache_.get());
   raw_predictor_->Run();
 }
 
 std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::Clone() {
+  WaitForAsyncRuns();
   std::lock_guard<std::mutex> lock(mutex_);
   auto predictor =
       std::make_shared<lite::CxxPaddleApiImpl>(raw_predictor_->Clone());
+  // The clones share the tuned records
+  predictor->tuning_cache_ = tuning_cache_;
   predictor->Init(config_);
   return predictor;
 }
 
 std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::Clone(
     const std::vector<std::string> &var_names) {
+  WaitForAsyncRuns();
   std::lock_guard<std::mutex> lock(mutex_);
   auto predictor = std::make_shared<lite::CxxPaddleApiImpl>(
       raw_predictor_->Clone(var_names));
+  // The clones share the tuned records
+  predictor->tuning_cache_ = tuning_cache_;
   predictor->Init(config_);
   return predictor;
 }
@@ -258,12 +272,14 @@ std::string CxxPaddleApiImpl::GetVersion() const { return version(); }
 
 std::unique_ptr<const lite_api::Tensor> CxxPaddleApiImpl::GetTensor(
     const std::string &name) const {
+  WaitForAsyncRuns();
   auto *x = raw_predictor_->GetTensor(name);
   return std::unique_ptr<const lite_api::Tensor>(new lite_api::Tensor(x));
 }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetMutableTensor(
     const std::string &name) {
+  WaitForAsyncRuns();
   return std::unique_ptr<lite_api::Tensor>(
       new lite_api::Tensor(raw_predictor_->GetMutableTensor(name)));
 }
@@ -271,13 +287,26 @@ std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetMutableTensor(
 void CxxPaddleApiImpl::SaveOptimizedModel(const std::string &model_dir,
                                           lite_api::LiteModelType model_type,
                                           bool record_info) {
+  WaitForAsyncRuns();
   raw_predictor_->SaveModel(model_dir, model_type, record_info);
 }
 
 bool CxxPaddleApiImpl::TryShrinkMemory() {
+  WaitForAsyncRuns();
   return raw_predictor_->TryShrinkMemory();
 }
 
+void CxxPaddleApiImpl::EnableProfiler(bool enable) {
+  raw_predictor_->trace_profiler()->set_enabled(enable);
+}
+
+std::string CxxPaddleApiImpl::GetProfilerTrace(bool clear) {
+  auto* profiler = raw_predictor_->trace_profiler();
+  std::string trace = profiler->ToChromeTrace();
+  if (clear) profiler->Clear();
+  return trace;
+}
+
 }  // namespace lite
 
 namespace lite_api {
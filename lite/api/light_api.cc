@@ -23,12 +23,14 @@ namespace paddle {
 namespace lite {
 
 void LightPredictor::Build(const std::string& lite_model_file,
-                           bool model_from_memory) {
+                           bool model_from_memory,
+                           bool use_mmap) {
   if (model_from_memory) {
     LoadModelNaiveFromMemory(
         lite_model_file, scope_.get(), program_desc_.get());
   } else {
-    LoadModelNaiveFromFile(lite_model_file, scope_.get(), program_desc_.get());
+    LoadModelNaiveFromFile(
+        lite_model_file, scope_.get(), program_desc_.get(), use_mmap);
   }
 
   // For weight quantization of post training, load the int8/16 weights
@@ -320,6 +322,37 @@ void LightPredictor::DequantizeWeight() {
     }
     return result;
   };
+  // The x86 fc, mul and matmul_v2 kernels compute with the int8 and int4
+  // weights directly, so they are kept in int8.
+  auto is_weight_kept_quantized = [](const cpp::OpDesc* op_desc,
+                                     const std::string& weight_name,
+                                     int quantize_weight_bits) {
+    if ((quantize_weight_bits != 8 && quantize_weight_bits != 4) ||
+        !op_desc->HasAttr(kKernelTypeAttr)) {
+      return false;
+    }
+    std::string op_type;
+    std::string alias;
+    Place place;
+    KernelBase::ParseKernelType(
+        op_desc->GetAttr<std::string>(kKernelTypeAttr),
+        &op_type,
+        &alias,
+        &place);
+    if (place.target != TARGET(kX86) || place.precision != PRECISION(kFloat)) {
+      return false;
+    }
+    if (op_type == "fc") {
+      return op_desc->Input("W").front() == weight_name;
+    } else if (op_type == "mul") {
+      return op_desc->Input("Y").front() == weight_name;
+    } else if (op_type == "matmul_v2") {
+      return op_desc->Input("Y").front() == weight_name &&
+             !op_desc->GetAttr<bool>("trans_x") &&
+             !op_desc->GetAttr<bool>("trans_y");
+    }
+    return false;
+  };
   Tensor tmp_tensor;
   for (size_t i = 0; i < program_desc->BlocksSize(); i++) {
     auto* block = program_desc->GetBlock<cpp::BlockDesc>(i);
@@ -349,13 +382,25 @@ void LightPredictor::DequantizeWeight() {
             CHECK(scope_var != nullptr);
             auto input_tensor = scope_var->GetMutable<lite::Tensor>();
             CHECK(input_tensor != nullptr);
+            int quantize_weight_bits =
+                op_desc->GetAttr<int>("quantize_weight_bits");
+            // The 4 bits weights are saved in int8
+            CHECK(quantize_weight_bits == 4 || quantize_weight_bits == 8 ||
+                  quantize_weight_bits == 16);
+            if (input_tensor->precision() != PRECISION(kInt8) &&
+                input_tensor->precision() != PRECISION(kInt16)) {
+              // Dequantized for another op sharing it
+              continue;
+            }
+            if (input_tensor->dims().size() == 2 &&
+                is_weight_kept_quantized(
+                    op_desc, input_name, quantize_weight_bits)) {
+              continue;
+            }
             tmp_tensor.CopyDataFrom(*input_tensor);
             auto scale_list =
                 op_desc->GetAttr<std::vector<float>>(input_scale_name);
 
-            int quantize_weight_bits =
-                op_desc->GetAttr<int>("quantize_weight_bits");
-            CHECK(quantize_weight_bits == 8 || quantize_weight_bits == 16);
             float* fp_data = input_tensor->mutable_data<float>();
             CHECK(fp_data != nullptr);
 
@@ -364,7 +409,7 @@ void LightPredictor::DequantizeWeight() {
               int64_t ch = input_tensor->dims()[0];
               int64_t offset = input_tensor->numel() / ch;
               CHECK_EQ(scale_list.size(), ch);
-              if (quantize_weight_bits == 8) {
+              if (quantize_weight_bits != 16) {
                 const int8_t* int_data = tmp_tensor.data<int8_t>();
                 CHECK(int_data != nullptr);
                 PROCESS_CONV2D_DATA()
@@ -374,6 +419,7 @@ void LightPredictor::DequantizeWeight() {
                 PROCESS_CONV2D_DATA()
               }
             } else if (op_type == "fc" || op_type == "mul" ||
+                       op_type == "matmul" || op_type == "matmul_v2" ||
                        op_type == "lookup_table") {
               int64_t chin = input_tensor->dims()[0];
               int64_t chout = input_tensor->numel() / chin;
@@ -385,7 +431,7 @@ void LightPredictor::DequantizeWeight() {
                 chin = 1;
               }
               CHECK_EQ(scale_list.size(), chout);
-              if (quantize_weight_bits == 8) {
+              if (quantize_weight_bits != 16) {
                 const int8_t* int_data = tmp_tensor.data<int8_t>();
                 CHECK(int_data != nullptr);
                 PROCESS_FC_DATA()
@@ -28,6 +28,8 @@
 #include "lite/core/context.h"
 #include "lite/core/program.h"
 #include "lite/core/tensor.h"
+#include "lite/core/thread_pool.h"
+#include "lite/core/tuning_cache.h"
 #include "lite/core/types.h"
 #include "lite/model_parser/model_parser.h"
 
@@ -43,13 +45,16 @@ class LITE_API LightPredictor {
   // constructor function of LightPredictor, `lite_model_file` refers to data in
   // model file or buffer,`model_from_memory` refers to whther to load model
   // from memory.
+  // `use_mmap` refers to whether to map the model file into memory and let
+  // the weights reference the mapping.
   LightPredictor(const std::string& lite_model_file,
                  bool model_from_memory = false,
-                 bool use_low_precision = false) {
+                 bool use_low_precision = false,
+                 bool use_mmap = false) {
     use_low_precision_ = use_low_precision;
     scope_ = std::make_shared<Scope>();
     program_desc_ = std::make_shared<cpp::ProgramDesc>();
-    Build(lite_model_file, model_from_memory);
+    Build(lite_model_file, model_from_memory, use_mmap);
   }
 
   // NOTE: This is a deprecated API and will be removed in latter release.
@@ -80,6 +85,10 @@ class LITE_API LightPredictor {
   bool TryShrinkMemory();
   bool use_low_precision_ = false;
 
+  profile::TraceProfiler* trace_profiler() {
+    return program_->trace_profiler();
+  }
+
   // Get offset-th col of feed inputs.
   Tensor* GetInput(size_t offset);
   // get input by name.
@@ -103,6 +112,14 @@ class LITE_API LightPredictor {
   void PrepareFeedFetch();
   Scope* scope() { return scope_.get(); }
 
+  void ConfigMemoryArena(const lite_api::MobileConfig& config) {
+    program_->set_use_memory_arena(config.use_memory_arena());
+  }
+
+  void ConfigInterOp(const lite_api::MobileConfig& config) {
+    program_->set_inter_op_threads(config.inter_op_threads());
+  }
+
 #ifdef LITE_WITH_METAL
   void ConfigMetalContext(const lite_api::MobileConfig& config) {
     program_->ConfigMetalContext(config.metal_lib_path(),
@@ -119,7 +136,8 @@ class LITE_API LightPredictor {
   void CheckInputValid();
 
   void Build(const std::string& lite_model_file,
-             bool model_from_memory = false);
+             bool model_from_memory = false,
+             bool use_mmap = false);
 
   // NOTE: This is a deprecated API and will be removed in latter release.
   void Build(
@@ -183,10 +201,17 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
   /// \return a boolean variable.
   bool TryShrinkMemory() override;
 
+  void EnableProfiler(bool enable) override;
+  std::string GetProfilerTrace(bool clear = true) override;
+
   bool use_low_precision_ = false;
 
  private:
   std::unique_ptr<lite::LightPredictor> raw_predictor_;
+  // Owned by the predictor, so predictors don't share worker threads
+  std::shared_ptr<ThreadPool> thread_pool_;
+  // Only created if the cpu autotuning is on
+  std::shared_ptr<TuningCache> tuning_cache_;
 };
 
 }  // namespace lite
@@ -48,17 +48,21 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
         config.lite_model_file(),
         config.is_model_from_memory(),
         (config.precision_mode() == lite_api::LITE_PRECISION_LOW) ? true
-                                                                  : false));
+                                                                  : false,
+        config.use_model_mmap()));
   }
 
   mode_ = config.power_mode();
   threads_ = config.threads();
 #ifdef LITE_USE_THREAD_POOL
-  int thread_num = ThreadPool::Init(threads_);
-  if (thread_num > 1) {
-    ThreadPool::AcquireThreadPool();
-  }
+  thread_pool_ = std::make_shared<ThreadPool>(threads_, config.cpu_affinity());
 #endif
+  if (config.cpu_autotune() && !tuning_cache_) {
+    tuning_cache_ = std::make_shared<TuningCache>(config.cpu_autotune_file());
+  }
+
+  raw_predictor_->ConfigMemoryArena(config);
+  raw_predictor_->ConfigInterOp(config);
 
 #ifdef LITE_WITH_METAL
   raw_predictor_->ConfigMetalContext(config);
@@ -96,39 +100,44 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
 #endif
 }
 
-LightPredictorImpl::~LightPredictorImpl() {
-#ifdef LITE_USE_THREAD_POOL
-  ThreadPool::ReleaseThreadPool();
-#endif
-}
+LightPredictorImpl::~LightPredictorImpl() { WaitForAsyncRuns(); }
 
 std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetInputByName(
     const std::string& name) {
+  WaitForAsyncRuns();
   return std::unique_ptr<lite_api::Tensor>(
       new lite_api::Tensor(raw_predictor_->GetInputByName(name)));
 }
 
 std::unique_ptr<const lite_api::Tensor> LightPredictorImpl::GetOutputByName(
     const std::string& name) const {
+  WaitForAsyncRuns();
   return std::unique_ptr<lite_api::Tensor>(
       new lite_api::Tensor(raw_predictor_->GetOutputByName(name)));
 }
 
 std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetInput(int i) {
+  WaitForAsyncRuns();
   return std::unique_ptr<lite_api::Tensor>(
       new lite_api::Tensor(raw_predictor_->GetInput(i)));
 }
 
 std::unique_ptr<const lite_api::Tensor> LightPredictorImpl::GetOutput(
     int i) const {
+  WaitForAsyncRuns();
   return std::unique_ptr<lite_api::Tensor>(
       new lite_api::Tensor(raw_predictor_->GetOutput(i)));
 }
 
 void LightPredictorImpl::Run() {
+  WaitForAsyncRuns();
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
 #endif
+#ifdef LITE_USE_THREAD_POOL
+  ThreadPool::ScopedBind bind_thread_pool(thread_pool_.get());
+#endif
+  TuningCache::ScopedBind bind_tuning_cache(tuning_cache_.get());
   raw_predictor_->Run();
 }
 
@@ -147,6 +156,7 @@ std::string LightPredictorImpl::GetVersion() const { return lite::version(); }
 
 std::unique_ptr<const lite_api::Tensor> LightPredictorImpl::GetTensor(
     const std::string& name) const {
+  WaitForAsyncRuns();
   return std::unique_ptr<const lite_api::Tensor>(
       new lite_api::Tensor(raw_predictor_->GetTensor(name)));
 }
@@ -160,9 +170,21 @@ std::vector<std::string> LightPredictorImpl::GetOutputNames() {
 }
 
 bool LightPredictorImpl::TryShrinkMemory() {
+  WaitForAsyncRuns();
   return raw_predictor_->TryShrinkMemory();
 }
 
+void LightPredictorImpl::EnableProfiler(bool enable) {
+  raw_predictor_->trace_profiler()->set_enabled(enable);
+}
+
+std::string LightPredictorImpl::GetProfilerTrace(bool clear) {
+  auto* profiler = raw_predictor_->trace_profiler();
+  std::string trace = profiler->ToChromeTrace();
+  if (clear) profiler->Clear();
+  return trace;
+}
+
 }  // namespace lite
 
 namespace lite_api {
@@ -14,6 +14,10 @@
 
 #include "lite/api/paddle_api.h"
 
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "lite/core/context.h"
@@ -23,7 +27,6 @@
 
 #ifdef LITE_WITH_XPU
 #include <functional>
-#include <mutex>  // NOLINT
 #include "lite/backends/xpu/target_wrapper.h"
 #endif
 
@@ -35,6 +38,10 @@
 #include "lite/backends/metal/target_wrapper.h"
 #endif
 
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+#include "lite/backends/x86/cpu_info.h"
+#endif
+
 namespace paddle {
 namespace lite_api {
 
@@ -247,6 +254,15 @@ std::vector<std::string> PaddlePredictor::GetParamNames() {
   return null_result;
 }
 
+void PaddlePredictor::EnableProfiler(bool enable) {
+  LOG(FATAL) << "The EnableProfiler API is not supported by this predictor.";
+}
+
+std::string PaddlePredictor::GetProfilerTrace(bool clear) {
+  LOG(FATAL) << "The GetProfilerTrace API is not supported by this predictor.";
+  return "";
+}
+
 void PaddlePredictor::SaveOptimizedModel(const std::string &model_dir,
                                          LiteModelType model_type,
                                          bool record_info) {
@@ -254,6 +270,112 @@ void PaddlePredictor::SaveOptimizedModel(const std::string &model_dir,
       << "The SaveOptimizedModel API is only supported by CxxConfig predictor.";
 }
 
+// A worker thread running the tasks submitted one by one in order.
+class PaddlePredictor::AsyncRunner {
+ public:
+  AsyncRunner() : worker_(&AsyncRunner::Loop, this) {}
+
+  ~AsyncRunner() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+
+  void Submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_all();
+  }
+
+  void Wait() {
+    if (std::this_thread::get_id() == worker_.get_id()) return;
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+  }
+
+ private:
+  void Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) break;
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      task();
+      lock.lock();
+      busy_ = false;
+      cv_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool busy_{false};
+  bool stop_{false};
+  std::thread worker_;
+};
+
+PaddlePredictor::AsyncRunner *PaddlePredictor::async_runner() {
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto runner = std::atomic_load(&async_runner_);
+  if (!runner) {
+    runner = std::make_shared<AsyncRunner>();
+    std::atomic_store(&async_runner_, runner);
+  }
+  return runner.get();
+}
+
+void PaddlePredictor::WaitForAsyncRuns() const {
+  auto runner = std::atomic_load(&async_runner_);
+  if (runner) runner->Wait();
+}
+
+std::future<void> PaddlePredictor::RunAsync() {
+  auto promise = std::make_shared<std::promise<void>>();
+  auto future = promise->get_future();
+  async_runner()->Submit([this, promise] {
+#ifdef LITE_WITH_EXCEPTION
+    try {
+      Run();
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+      return;
+    }
+#else
+    Run();
+#endif
+    promise->set_value();
+  });
+  return future;
+}
+
+void PaddlePredictor::RunAsync(
+    std::function<void(std::exception_ptr)> callback) {
+  CHECK(callback) << "The callback of RunAsync is empty.";
+  async_runner()->Submit([this, callback] {
+    std::exception_ptr error;
+#ifdef LITE_WITH_EXCEPTION
+    try {
+      Run();
+    } catch (...) {
+      error = std::current_exception();
+    }
+#else
+    Run();
+#endif
+    callback(error);
+  });
+}
+
 template <typename ConfigT>
 std::shared_ptr<PaddlePredictor> CreatePaddlePredictor(const ConfigT &) {
   return std::shared_ptr<PaddlePredictor>();
@@ -330,6 +452,26 @@ void ConfigBase::set_threads(int threads) {
   lite::DeviceInfo::Global().SetRunMode(mode_, threads);
   mode_ = lite::DeviceInfo::Global().mode();
   threads_ = lite::DeviceInfo::Global().threads();
+#elif defined(LITE_USE_THREAD_POOL)
+  threads_ = threads > 1 ? threads : 1;
+#endif
+}
+
+void ConfigBase::set_numa_node(int node) {
+  numa_node_ = node;
+#if (defined LITE_WITH_X86) && !(defined LITE_ON_MODEL_OPTIMIZE_TOOL)
+  if (node < 0) {
+    return;
+  }
+  if (node >= lite::x86::NumaNodeNum()) {
+    LOG(WARNING) << "NUMA node " << node << " doesn't exist, only "
+                 << lite::x86::NumaNodeNum() << " node(s) are found.";
+    return;
+  }
+  auto cpu_ids = lite::x86::NumaNodeCpus(node);
+  if (!cpu_ids.empty()) {
+    cpu_affinity_ = cpu_ids;
+  }
 #endif
 }
 
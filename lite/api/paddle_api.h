@@ -19,7 +19,9 @@
 
 #ifndef PADDLE_LITE_API_H_  // NOLINT
 #define PADDLE_LITE_API_H_
+#include <exception>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
@@ -106,6 +108,20 @@ class LITE_API PaddlePredictor {
   virtual std::unique_ptr<const Tensor> GetOutput(int i) const = 0;
 
   virtual void Run() = 0;
+
+  /// Run asynchronously on a worker thread owned by the predictor, the runs
+  /// submitted are executed one at a time in submission order. The inputs
+  /// and outputs are locked until the run completes: GetInput, GetOutput,
+  /// Run and the other calls touching the tensors wait for the pending runs
+  /// first, and the tensors got before must not be accessed meanwhile.
+  /// The future gets the exception thrown by Run (with LITE_WITH_EXCEPTION).
+  virtual std::future<void> RunAsync();
+  /// The same as above, but call `callback` on the worker thread when the run
+  /// completes, with the exception thrown by Run or null on success. The
+  /// callback mustn't block on the futures of the same predictor, nor own the
+  /// predictor, which can't be destroyed on its worker thread.
+  virtual void RunAsync(std::function<void(std::exception_ptr)> callback);
+
   virtual std::shared_ptr<PaddlePredictor> Clone() = 0;
   virtual std::shared_ptr<PaddlePredictor> Clone(
       const std::vector<std::string>& var_names) = 0;
@@ -122,6 +138,14 @@ class LITE_API PaddlePredictor {
   /// Release all tmp tensor to compress the size of the memory pool.
   virtual bool TryShrinkMemory() = 0;
 
+  /// Switch the op-level profiler on or off, it takes effect from the next
+  /// run. While it is on, every run records the start and end time, the
+  /// thread, the shapes and the estimated FLOPs and bytes of each op.
+  virtual void EnableProfiler(bool enable);
+  /// Get the records as Chrome trace-event JSON, which can be opened by
+  /// chrome://tracing or Perfetto, and drop them if `clear` is true.
+  virtual std::string GetProfilerTrace(bool clear = true);
+
   // Get Input by name
   virtual std::unique_ptr<Tensor> GetInputByName(const std::string& name) = 0;
 
@@ -142,8 +166,20 @@ class LITE_API PaddlePredictor {
   virtual ~PaddlePredictor() = default;
 
  protected:
+  /// Wait for the runs submitted by RunAsync to complete, it returns at once
+  /// when called by the worker thread. The predictors must call it on
+  /// entering the calls touching the tensors and in their destructors.
+  void WaitForAsyncRuns() const;
+
   int threads_{1};
   lite_api::PowerMode mode_{lite_api::LITE_POWER_NO_BIND};
+
+ private:
+  class AsyncRunner;
+  AsyncRunner* async_runner();
+
+  // Created by the first RunAsync
+  std::shared_ptr<AsyncRunner> async_runner_;
 };
 
 /// Base class for all the configs.
@@ -177,6 +213,13 @@ class LITE_API ConfigBase {
   std::map<std::string, std::vector<char>> nnadapter_model_cache_buffers_{};
   int device_id_{0};
   int x86_math_num_threads_ = 1;
+  // The cpus that the predictor-owned thread pool is pinned to.
+  std::vector<int> cpu_affinity_{};
+  int numa_node_{-1};
+  bool use_memory_arena_{false};
+  int inter_op_threads_{1};
+  bool cpu_autotune_{false};
+  std::string cpu_autotune_file_;
 
   std::string metal_path_;
   bool metal_use_mps_{false};
@@ -244,6 +287,26 @@ class LITE_API ConfigBase {
   /// \return void
   void set_opencl_precision(CLPrecisionType p = CL_PRECISION_AUTO);
 
+  /// \brief Select the algorithms of the CPU kernels by timing them.
+  ///
+  /// When it is on, a kernel with several viable algorithms for its shapes
+  /// (only the x86 fp32 conv2d for now) times each of them on the first run
+  /// and keeps the fastest one. The first run is slower accordingly.
+  ///
+  /// \param autotune  Turn it on or off.
+  /// \param autotune_file  The file to persist the results in, which is
+  /// loaded when the predictor is created and updated when it's destroyed. A
+  /// file produced on a different CPU model is ignored. Leave it empty to
+  /// tune on every load.
+  /// \return void
+  void set_cpu_autotune(bool autotune = true,
+                        const std::string& autotune_file = "") {
+    cpu_autotune_ = autotune;
+    cpu_autotune_file_ = autotune_file;
+  }
+  bool cpu_autotune() const { return cpu_autotune_; }
+  const std::string& cpu_autotune_file() const { return cpu_autotune_file_; }
+
   // set subgraph_model_dir
   void set_subgraph_model_cache_dir(std::string subgraph_model_cache_dir) {
     subgraph_model_cache_dir_ = subgraph_model_cache_dir;
@@ -329,6 +392,59 @@ class LITE_API ConfigBase {
   // set x86_math_num_threads
   void set_x86_math_num_threads(int threads);
   int x86_math_num_threads() const;
+  /// \brief Pin the threads of the predictor-owned thread pool to cpus.
+  ///
+  /// Only takes effect on Linux when the library is built with the thread
+  /// pool(LITE_THREAD_POOL=ON). Every predictor owns its pool, so predictors
+  /// pinned to disjoint cpu sets run in isolated lanes.
+  ///
+  /// \param cpu_ids  The ids of the cpus, the workers are pinned to them in
+  /// round-robin order.
+  /// \return void
+  void set_cpu_affinity(const std::vector<int>& cpu_ids) {
+    cpu_affinity_ = cpu_ids;
+  }
+  const std::vector<int>& cpu_affinity() const { return cpu_affinity_; }
+  /// \brief Pin the predictor-owned thread pool to the cpus of a NUMA node.
+  ///
+  /// Overrides the cpus set by `set_cpu_affinity`. Memory is placed on the
+  /// node by the first-touch policy of the kernel.
+  ///
+  /// \param node  The index of the NUMA node, -1 to disable.
+  /// \return void
+  void set_numa_node(int node);
+  int numa_node() const { return numa_node_; }
+  /// \brief Place the activations at offsets of one contiguous memory arena.
+  ///
+  /// The arena is planned by the sizes and lifetimes of the tensors after the
+  /// first run, and re-planned when a tensor outgrows its slot. Only the
+  /// activations on host, x86 and ARM are placed in the arena.
+  ///
+  /// \param use_memory_arena  Whether to use the memory arena.
+  /// \return void
+  void set_use_memory_arena(bool use_memory_arena) {
+    use_memory_arena_ = use_memory_arena;
+  }
+  bool use_memory_arena() const { return use_memory_arena_; }
+  /// \brief Run the independent ops, e.g. the branches of Inception or FPN
+  /// heads, concurrently.
+  ///
+  /// The dependencies of the ops are built from their inputs and outputs
+  /// when the predictor runs for the first time, and an op runs as soon as
+  /// the ops it depends on have completed. The inter-op threads share the
+  /// intra-op thread pool of `set_threads`, so e.g. 2 inter-op threads and 4
+  /// threads run 2 ops at a time, each on a part of the 4 threads. It only
+  /// applies to the host and x86 kernels, the ops of the other targets and
+  /// those with sub-blocks run alone, and it is disabled with the memory
+  /// arena.
+  ///
+  /// \param threads  The number of the ops running at a time, 1 to run them
+  /// in order.
+  /// \return void
+  void set_inter_op_threads(int threads) {
+    inter_op_threads_ = threads > 1 ? threads : 1;
+  }
+  int inter_op_threads() const { return inter_op_threads_; }
 
   void set_metal_lib_path(const std::string& path);
   void set_metal_use_mps(bool flag);
@@ -528,6 +644,8 @@ class LITE_API MobileConfig : public ConfigBase {
   // whether to load data from memory. Model data will be loaded from memory
   // buffer if model_from_memory_ is true.
   bool model_from_memory_{false};
+  // whether to map the model file into memory instead of reading it.
+  bool use_model_mmap_{false};
   PrecisionMode precision_mode_{LITE_PRECISION_NORMAL};
 
   // model data readed from file or memory buffer in combined format.
@@ -558,6 +676,15 @@ class LITE_API MobileConfig : public ConfigBase {
   // abandoned in v3.0.
   bool model_from_memory() const { return model_from_memory_; }
 
+  // Map the model file set by `set_model_from_file` into memory and let the
+  // weights reference the mapping instead of copying them. The mapping is
+  // shared by all the predictors which load the same file in the process.
+  // Only the models saved by opt with meta_version 2 benefit from it.
+  void set_use_model_mmap(bool use_model_mmap) {
+    use_model_mmap_ = use_model_mmap;
+  }
+  bool use_model_mmap() const { return use_model_mmap_; }
+
   // NOTE: This is a deprecated API and will be removed in latter release.
   void set_model_buffer(const char* model_buffer,
                         size_t model_buffer_size,
@@ -0,0 +1,381 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/paddle_batcher.h"
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "lite/utils/log/cp_logging.h"
+#include "lite/utils/string.h"
+
+namespace paddle {
+namespace lite_api {
+
+using Clock = std::chrono::steady_clock;
+
+struct DynamicBatcher::Request {
+  std::vector<BatchTensor> inputs;
+  std::promise<std::vector<BatchTensor>> promise;
+  Clock::time_point enqueue_time;
+  // Rows and top-level sequences of the first input
+  int64_t rows{0};
+  int64_t seqs{0};
+};
+
+namespace {
+
+size_t ElementSize(PrecisionType precision) {
+  return precision == PrecisionType::kBool ? sizeof(bool)
+                                           : PrecisionTypeLength(precision);
+}
+
+void* MutableData(Tensor* tensor, PrecisionType precision) {
+  switch (precision) {
+    case PrecisionType::kFloat:
+      return tensor->mutable_data<float>();
+    case PrecisionType::kFP64:
+      return tensor->mutable_data<double>();
+    case PrecisionType::kInt64:
+      return tensor->mutable_data<int64_t>();
+    case PrecisionType::kInt32:
+      return tensor->mutable_data<int32_t>();
+    case PrecisionType::kInt16:
+      return tensor->mutable_data<int16_t>();
+    case PrecisionType::kInt8:
+      return tensor->mutable_data<int8_t>();
+    case PrecisionType::kUInt8:
+      return tensor->mutable_data<uint8_t>();
+    case PrecisionType::kBool:
+      return tensor->mutable_data<bool>();
+    default:
+      LOG(FATAL) << "Unsupported precision " << PrecisionToStr(precision)
+                 << " for DynamicBatcher.";
+  }
+  return nullptr;
+}
+
+// Whether the two requests can be concatenated along dim 0.
+bool Mergeable(const std::vector<BatchTensor>& a,
+               const std::vector<BatchTensor>& b) {
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].precision != b[i].precision ||
+        a[i].shape.size() != b[i].shape.size() ||
+        a[i].lod.size() != b[i].lod.size() ||
+        !std::equal(a[i].shape.begin() + 1, a[i].shape.end(),
+                    b[i].shape.begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Take the rows of the sequences [begin, end) of the top level, and rebase
+// their LoD to start from 0.
+void SliceLoD(const lod_t& lod,
+              uint64_t begin,
+              uint64_t end,
+              lod_t* sub,
+              uint64_t* row_begin,
+              uint64_t* row_end) {
+  sub->clear();
+  for (auto& level : lod) {
+    std::vector<uint64_t> offsets;
+    for (uint64_t k = begin; k <= end; k++) {
+      offsets.push_back(level[k] - level[begin]);
+    }
+    sub->push_back(offsets);
+    auto next_begin = level[begin];
+    end = level[end];
+    begin = next_begin;
+  }
+  *row_begin = begin;
+  *row_end = end;
+}
+
+}  // namespace
+
+int64_t BatchTensor::numel() const {
+  int64_t n = 1;
+  for (auto d : shape) n *= d;
+  return n;
+}
+
+DynamicBatcher::DynamicBatcher(
+    const std::vector<std::shared_ptr<PaddlePredictor>>& predictors,
+    const Options& options)
+    : predictors_(predictors), options_(options) {
+  CHECK(!predictors_.empty()) << "DynamicBatcher needs a predictor at least.";
+  CHECK_GT(options_.max_batch_size, 0);
+  CHECK_GE(options_.max_delay_us, 0);
+  stats_.batch_size_hist.resize(options_.max_batch_size + 1, 0);
+  for (auto& predictor : predictors_) {
+    CHECK(predictor);
+    workers_.emplace_back(&DynamicBatcher::Loop, this, predictor.get());
+  }
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::future<std::vector<BatchTensor>> DynamicBatcher::Submit(
+    std::vector<BatchTensor> inputs) {
+  CHECK_EQ(inputs.size(), predictors_[0]->GetInputNames().size())
+      << "The inputs of the request mismatch the model.";
+  for (auto& input : inputs) {
+    CHECK(input.precision != PrecisionType::kFP16 &&
+          ElementSize(input.precision) > 0)
+        << "Unsupported precision " << PrecisionToStr(input.precision)
+        << " for DynamicBatcher.";
+    CHECK(!input.shape.empty()) << "The inputs must have dim 0 to batch on.";
+    CHECK_EQ(input.data.size(), input.numel() * ElementSize(input.precision))
+        << "The data size mismatches the shape.";
+    if (!input.lod.empty()) {
+      CHECK_EQ(input.lod.back().back(), static_cast<uint64_t>(input.shape[0]))
+          << "The LoD mismatches the shape.";
+    }
+  }
+  auto request = std::make_shared<Request>();
+  request->rows = inputs[0].shape[0];
+  request->seqs = inputs[0].lod.empty()
+                      ? request->rows
+                      : static_cast<int64_t>(inputs[0].lod[0].size()) - 1;
+  request->inputs = std::move(inputs);
+  auto future = request->promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK(!stop_);
+    request->enqueue_time = Clock::now();
+    queue_.push_back(request);
+  }
+  cv_.notify_all();
+  return future;
+}
+
+void DynamicBatcher::Loop(PaddlePredictor* predictor) {
+  while (true) {
+    auto batch = NextBatch();
+    if (batch.empty()) break;
+    RunBatch(predictor, batch);
+  }
+}
+
+std::vector<std::shared_ptr<DynamicBatcher::Request>>
+DynamicBatcher::NextBatch() {
+  const int64_t max_rows = options_.max_batch_size;
+  // Pick the oldest request and the following ones which are mergeable with
+  // it and fit in the batch
+  auto pack = [&](std::vector<size_t>* picked) {
+    auto& lead = queue_.front();
+    int64_t rows = 0;
+    for (size_t i = 0; i < queue_.size() && rows < max_rows; i++) {
+      if (i == 0 || (rows + queue_[i]->rows <= max_rows &&
+                     Mergeable(lead->inputs, queue_[i]->inputs))) {
+        rows += queue_[i]->rows;
+        if (picked) picked->push_back(i);
+      }
+    }
+    return rows;
+  };
+  std::vector<std::shared_ptr<Request>> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Wait until a batch is filled, or the oldest request has waited for long
+  // enough
+  while (true) {
+    if (queue_.empty()) {
+      if (stop_) return batch;
+      cv_.wait(lock);
+      continue;
+    }
+    auto deadline = queue_.front()->enqueue_time +
+                    std::chrono::microseconds(options_.max_delay_us);
+    if (stop_ || pack(nullptr) >= max_rows || Clock::now() >= deadline) {
+      break;
+    }
+    cv_.wait_until(lock, deadline);
+  }
+  std::vector<size_t> picked;
+  pack(&picked);
+  for (auto i : picked) {
+    batch.push_back(queue_[i]);
+  }
+  for (auto it = picked.rbegin(); it != picked.rend(); ++it) {
+    queue_.erase(queue_.begin() + *it);
+  }
+  return batch;
+}
+
+void DynamicBatcher::RunBatch(
+    PaddlePredictor* predictor,
+    const std::vector<std::shared_ptr<Request>>& batch) {
+  auto start = Clock::now();
+  int64_t total_rows = 0;
+  int64_t total_seqs = 0;
+  for (auto& request : batch) {
+    total_rows += request->rows;
+    total_seqs += request->seqs;
+  }
+  std::vector<std::vector<BatchTensor>> results(batch.size());
+  bool success = true;
+  try {
+    // Concatenate the inputs along dim 0 and their LoD
+    auto& lead = batch[0]->inputs;
+    for (size_t i = 0; i < lead.size(); i++) {
+      auto tensor = predictor->GetInput(static_cast<int>(i));
+      shape_t shape = lead[i].shape;
+      shape[0] = 0;
+      lod_t lod(lead[i].lod.size(), std::vector<uint64_t>(1, 0));
+      for (auto& request : batch) {
+        auto& input = request->inputs[i];
+        shape[0] += input.shape[0];
+        for (size_t l = 0; l < lod.size(); l++) {
+          auto base = lod[l].back();
+          for (size_t k = 1; k < input.lod[l].size(); k++) {
+            lod[l].push_back(base + input.lod[l][k]);
+          }
+        }
+      }
+      tensor->Resize(shape);
+      auto dst = static_cast<uint8_t*>(
+          MutableData(tensor.get(), lead[i].precision));
+      for (auto& request : batch) {
+        auto& data = request->inputs[i].data;
+        memcpy(dst, data.data(), data.size());
+        dst += data.size();
+      }
+      if (!lod.empty()) tensor->SetLoD(lod);
+    }
+
+    predictor->Run();
+
+    // Scatter the outputs
+    int num_outputs = static_cast<int>(predictor->GetOutputNames().size());
+    for (int j = 0; j < num_outputs; j++) {
+      auto tensor = predictor->GetOutput(j);
+      auto shape = tensor->shape();
+      auto lod = tensor->lod();
+      auto precision = tensor->precision();
+      auto src = static_cast<const uint8_t*>(tensor->data<void>());
+      size_t bytes = ElementSize(precision);
+      for (auto d : shape) bytes *= d;
+      if (batch.size() == 1) {
+        BatchTensor output;
+        output.shape = shape;
+        output.lod = lod;
+        output.precision = precision;
+        output.data.assign(src, src + bytes);
+        results[0].push_back(std::move(output));
+        continue;
+      }
+      bool by_lod = !lod.empty() &&
+                    static_cast<int64_t>(lod[0].size()) - 1 == total_seqs;
+      bool by_rows = !by_lod && !shape.empty() && shape[0] == total_rows;
+      bool by_seqs = !by_lod && !by_rows && !shape.empty() &&
+                     shape[0] == total_seqs;
+      if (!by_lod && !by_rows && !by_seqs) {
+        throw std::runtime_error(lite::string_format(
+            "Can't split the output %d of the batch, its dims or LoD don't "
+            "match the rows or the sequences of the requests.",
+            j));
+      }
+      size_t row_bytes = shape[0] > 0 ? bytes / shape[0] : 0;
+      uint64_t row = 0;
+      uint64_t seq = 0;
+      for (size_t r = 0; r < batch.size(); r++) {
+        BatchTensor output;
+        output.shape = shape;
+        output.precision = precision;
+        uint64_t row_begin = row;
+        uint64_t row_end = row;
+        if (by_lod) {
+          SliceLoD(lod,
+                   seq,
+                   seq + batch[r]->seqs,
+                   &output.lod,
+                   &row_begin,
+                   &row_end);
+        } else {
+          row_end += by_rows ? batch[r]->rows : batch[r]->seqs;
+        }
+        seq += batch[r]->seqs;
+        row = row_end;
+        output.shape[0] = row_end - row_begin;
+        output.data.assign(src + row_begin * row_bytes,
+                           src + row_end * row_bytes);
+        results[r].push_back(std::move(output));
+      }
+    }
+  } catch (...) {
+    success = false;
+    auto error = std::current_exception();
+    for (auto& request : batch) {
+      request->promise.set_exception(error);
+    }
+  }
+  auto end = Clock::now();
+
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.requests += batch.size();
+    stats_.batches++;
+    if (!success) stats_.failed_batches++;
+    auto hist_index = std::min<int64_t>(total_rows, options_.max_batch_size);
+    stats_.batch_size_hist[hist_index]++;
+    stats_.avg_batch_size +=
+        (total_rows - stats_.avg_batch_size) / stats_.batches;
+    for (auto& request : batch) {
+      double delay =
+          std::chrono::duration<double, std::milli>(start -
+                                                    request->enqueue_time)
+              .count();
+      total_queue_delay_ms_ += delay;
+      stats_.max_queue_delay_ms = std::max(stats_.max_queue_delay_ms, delay);
+    }
+    total_run_ms_ +=
+        std::chrono::duration<double, std::milli>(end - start).count();
+    stats_.avg_queue_delay_ms = total_queue_delay_ms_ / stats_.requests;
+    stats_.avg_run_ms = total_run_ms_ / stats_.batches;
+  }
+  if (success) {
+    for (size_t r = 0; r < batch.size(); r++) {
+      batch[r]->promise.set_value(std::move(results[r]));
+    }
+  }
+}
+
+DynamicBatcher::Stats DynamicBatcher::GetStats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+void DynamicBatcher::ResetStats() {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  stats_ = Stats();
+  stats_.batch_size_hist.resize(options_.max_batch_size + 1, 0);
+  total_queue_delay_ms_ = 0;
+  total_run_ms_ = 0;
+}
+
+}  // namespace lite_api
+}  // namespace paddle
@@ -0,0 +1,138 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * This file defines DynamicBatcher, which merges the concurrent small
+ * requests into batches in front of the PaddlePredictors.
+ */
+
+#ifndef PADDLE_LITE_BATCHER_H_  // NOLINT
+#define PADDLE_LITE_BATCHER_H_
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+#include "paddle_api.h"  // NOLINT
+
+namespace paddle {
+namespace lite_api {
+
+/// A host tensor owned by a request, used for both the inputs and the
+/// outputs of DynamicBatcher.
+struct LITE_API BatchTensor {
+  shape_t shape;
+  lod_t lod;
+  PrecisionType precision{PrecisionType::kFloat};
+  std::vector<uint8_t> data;
+
+  BatchTensor() = default;
+  template <typename T>
+  BatchTensor(const T* src, const shape_t& shape, const lod_t& lod = {})
+      : shape(shape),
+        lod(lod),
+        precision(PrecisionTypeTrait<T>::Type()),
+        data(reinterpret_cast<const uint8_t*>(src),
+             reinterpret_cast<const uint8_t*>(src) + numel() * sizeof(T)) {}
+
+  int64_t numel() const;
+  template <typename T>
+  const T* data_as() const {
+    return reinterpret_cast<const T*>(data.data());
+  }
+};
+
+/// DynamicBatcher accumulates the concurrent requests until `max_batch_size`
+/// rows are queued or the oldest request has waited for `max_delay_us`,
+/// concatenates their inputs along dim 0, runs the batch once, and scatters
+/// the outputs back to the callers. It trades a bounded queueing delay for a
+/// much better utilization of the GEMMs than running batch 1 requests.
+///
+/// Each predictor, e.g. the clones of one predictor, is driven by a worker
+/// thread of the batcher and mustn't be used elsewhere meanwhile. The inputs
+/// and the outputs must be host tensors.
+///
+/// The requests are merged only if all their inputs agree on the precision
+/// and the dims except dim 0. For the inputs with LoD, the offsets of the
+/// requests are concatenated. An output is split by its top-level LoD if
+/// it has one, and otherwise by its dim 0, which must match either the rows
+/// or the top-level sequences of the first input.
+class LITE_API DynamicBatcher {
+ public:
+  struct Options {
+    // The max number of rows (dim 0 of the first input) of a batch. A
+    // request which is larger runs alone.
+    int max_batch_size{8};
+    // How long the oldest queued request can wait for the batch to fill.
+    int64_t max_delay_us{2000};
+  };
+
+  struct Stats {
+    uint64_t requests{0};
+    uint64_t batches{0};
+    uint64_t failed_batches{0};
+    // batch_size_hist[i] is the number of batches of i rows, the last one
+    // counts the larger requests which run alone too.
+    std::vector<uint64_t> batch_size_hist;
+    double avg_batch_size{0};
+    // From Submit to the start of the run of the batch.
+    double avg_queue_delay_ms{0};
+    double max_queue_delay_ms{0};
+    double avg_run_ms{0};
+  };
+
+  DynamicBatcher(
+      const std::vector<std::shared_ptr<PaddlePredictor>>& predictors,
+      const Options& options);
+  /// Run the requests queued and stop the workers.
+  ~DynamicBatcher();
+
+  /// Queue a request, `inputs` are in the order of GetInputNames(). The
+  /// future gets the outputs in the order of GetOutputNames(), or the
+  /// exception of a failed batch.
+  std::future<std::vector<BatchTensor>> Submit(
+      std::vector<BatchTensor> inputs);
+
+  Stats GetStats() const;
+  void ResetStats();
+
+ private:
+  struct Request;
+  void Loop(PaddlePredictor* predictor);
+  std::vector<std::shared_ptr<Request>> NextBatch();
+  void RunBatch(PaddlePredictor* predictor,
+                const std::vector<std::shared_ptr<Request>>& batch);
+
+  std::vector<std::shared_ptr<PaddlePredictor>> predictors_;
+  Options options_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::shared_ptr<Request>> queue_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+
+  mutable std::mutex stats_mutex_;
+  Stats stats_;
+  double total_queue_delay_ms_{0};
+  double total_run_ms_{0};
+};
+
+}  // namespace lite_api
+}  // namespace paddle
+
+#endif  // NOLINT
@@ -120,7 +120,9 @@ const std::string& DataLayoutToStr(DataLayoutType layout) {
                                                   "ImageFolder",
                                                   "ImageNW",
                                                   "MetalTexture2DArray",
-                                                  "MetalTexture2D"};
+                                                  "MetalTexture2D",
+                                                  "NCHW8c",
+                                                  "NCHW16c"};
   auto x = static_cast<int>(layout);
   CHECK_LT(x, static_cast<int>(DATALAYOUT(NUM)));
   return datalayout2string[x];
@@ -175,7 +177,9 @@ const std::string& DataLayoutRepr(DataLayoutType layout) {
                                                   "kImageFolder",
                                                   "kImageNW",
                                                   "kMetalTexture2DArray",
-                                                  "kMetalTexture2D"};
+                                                  "kMetalTexture2D",
+                                                  "kNCHW8c",
+                                                  "kNCHW16c"};
   auto x = static_cast<int>(layout);
   CHECK_LT(x, static_cast<int>(DATALAYOUT(NUM)));
   return datalayout2string[x];
@@ -237,7 +241,9 @@ std::set<DataLayoutType> ExpandValidLayouts(DataLayoutType layout) {
        DATALAYOUT(kImageFolder),
        DATALAYOUT(kImageNW),
        DATALAYOUT(kMetalTexture2DArray),
-       DATALAYOUT(kMetalTexture2D)});
+       DATALAYOUT(kMetalTexture2D),
+       DATALAYOUT(kNCHW8c),
+       DATALAYOUT(kNCHW16c)});
   if (layout == DATALAYOUT(kAny)) {
     return valid_set;
   }
@@ -94,7 +94,9 @@ enum class DataLayoutType : int {
   kAny = 2,           // any data layout
   kMetalTexture2DArray = 7,
   kMetalTexture2D = 8,
-  NUM = 9,  // number of fields.
+  kNCHW8c = 9,    // x86 blocked layout, [N, C/8, H, W, 8]
+  kNCHW16c = 10,  // x86 blocked layout, [N, C/16, H, W, 16]
+  NUM = 11,       // number of fields.
 };
 
 typedef enum {
@@ -173,6 +175,8 @@ static size_t PrecisionTypeLength(PrecisionType type) {
 enum class QuantType : int {
   QUANT_INT8,
   QUANT_INT16,
+  // 4 bits values saved in int8 tensors
+  QUANT_INT4,
 };
 
 template <typename T>
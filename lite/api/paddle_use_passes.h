@@ -41,6 +41,7 @@ USE_MIR_PASS(lite_reshape2_matmul_fuse_pass);
 USE_MIR_PASS(lite_matmul_fuse_pass);
 USE_MIR_PASS(lite_fc_fuse_pass);
 USE_MIR_PASS(lite_matmul_element_add_fuse_pass);
+USE_MIR_PASS(lite_multi_head_attention_fuse_pass);
 USE_MIR_PASS(lite_shuffle_channel_fuse_pass);
 USE_MIR_PASS(lite_transpose_softmax_transpose_fuse_pass);
 USE_MIR_PASS(lite_interpolate_fuse_pass);
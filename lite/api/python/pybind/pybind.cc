@@ -302,7 +302,9 @@ void BindLitePlace(py::module *m) {
       .value("ImageFolder", DataLayoutType::kImageFolder)
       .value("ImageNW", DataLayoutType::kImageNW)
       .value("MetalTexture2DArray", DataLayoutType::kMetalTexture2DArray)
-      .value("MetalTexture2D", DataLayoutType::kMetalTexture2D);
+      .value("MetalTexture2D", DataLayoutType::kMetalTexture2D)
+      .value("NCHW8c", DataLayoutType::kNCHW8c)
+      .value("NCHW16c", DataLayoutType::kNCHW16c);
 
   // Place
   py::class_<Place>(*m, "Place")
@@ -0,0 +1,159 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/api/paddle_batcher.h"
+#include <gtest/gtest.h>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite_api {
+
+// Out0 = 2 * X with the LoD of X, Out1 holds the number of rows of each
+// top-level sequence of X.
+class FakePredictor : public PaddlePredictor {
+ public:
+  std::unique_ptr<Tensor> GetInput(int i) override {
+    return std::unique_ptr<Tensor>(new Tensor(&x_));
+  }
+  std::unique_ptr<const Tensor> GetOutput(int i) const override {
+    return std::unique_ptr<const Tensor>(new Tensor(i == 0 ? &out0_ : &out1_));
+  }
+  void Run() override {
+    runs_++;
+    out0_.Resize(x_.dims());
+    out0_.set_lod(x_.lod());
+    auto x = x_.data<float>();
+    auto y = out0_.mutable_data<float>();
+    for (int64_t i = 0; i < x_.numel(); i++) y[i] = 2 * x[i];
+    std::vector<uint64_t> offsets;
+    if (x_.lod().empty()) {
+      for (int64_t i = 0; i <= x_.dims()[0]; i++) offsets.push_back(i);
+    } else {
+      offsets = x_.lod()[0];
+    }
+    int64_t seqs = offsets.size() - 1;
+    out1_.Resize({seqs, 1});
+    auto z = out1_.mutable_data<int64_t>();
+    for (int64_t i = 0; i < seqs; i++) z[i] = offsets[i + 1] - offsets[i];
+  }
+  std::shared_ptr<PaddlePredictor> Clone() override { return nullptr; }
+  std::shared_ptr<PaddlePredictor> Clone(
+      const std::vector<std::string>& var_names) override {
+    return nullptr;
+  }
+  std::string GetVersion() const override { return ""; }
+  std::vector<std::string> GetInputNames() override { return {"x"}; }
+  std::vector<std::string> GetOutputNames() override {
+    return {"out0", "out1"};
+  }
+  bool TryShrinkMemory() override { return true; }
+  std::unique_ptr<Tensor> GetInputByName(const std::string& name) override {
+    return GetInput(0);
+  }
+  std::unique_ptr<const Tensor> GetTensor(
+      const std::string& name) const override {
+    return nullptr;
+  }
+
+  int runs_{0};
+
+ private:
+  lite::Tensor x_;
+  lite::Tensor out0_;
+  lite::Tensor out1_;
+};
+
+std::vector<BatchTensor> MakeRequest(int rows, float value, lod_t lod = {}) {
+  std::vector<float> data(rows * 3, value);
+  return {BatchTensor(data.data(), {rows, 3}, lod)};
+}
+
+TEST(DynamicBatcher, batch) {
+  auto predictor = std::make_shared<FakePredictor>();
+  DynamicBatcher::Options options;
+  options.max_batch_size = 4;
+  options.max_delay_us = 200000;
+  DynamicBatcher batcher({predictor}, options);
+
+  // Fill a batch of 4 rows, skipping the request which is too large and
+  // runs alone
+  std::vector<std::future<std::vector<BatchTensor>>> futures;
+  futures.push_back(batcher.Submit(MakeRequest(1, 1.f)));
+  futures.push_back(batcher.Submit(MakeRequest(6, 2.f)));
+  futures.push_back(batcher.Submit(MakeRequest(2, 3.f)));
+  futures.push_back(batcher.Submit(MakeRequest(1, 4.f)));
+  std::vector<int> rows = {1, 6, 2, 1};
+  for (size_t r = 0; r < futures.size(); r++) {
+    auto outputs = futures[r].get();
+    ASSERT_EQ(outputs.size(), 2u);
+    ASSERT_EQ(outputs[0].shape, shape_t({rows[r], 3}));
+    for (int i = 0; i < rows[r] * 3; i++) {
+      EXPECT_EQ(outputs[0].data_as<float>()[i], 2.f * (r + 1));
+    }
+    ASSERT_EQ(outputs[1].shape, shape_t({rows[r], 1}));
+    EXPECT_EQ(outputs[1].precision, PrecisionType::kInt64);
+  }
+  EXPECT_EQ(predictor->runs_, 2);
+  auto stats = batcher.GetStats();
+  EXPECT_EQ(stats.requests, 4u);
+  EXPECT_EQ(stats.batches, 2u);
+  EXPECT_EQ(stats.batch_size_hist[4], 2u);
+  EXPECT_EQ(stats.avg_batch_size, 5.);
+}
+
+TEST(DynamicBatcher, lod) {
+  auto predictor = std::make_shared<FakePredictor>();
+  DynamicBatcher::Options options;
+  options.max_batch_size = 16;
+  options.max_delay_us = 50000;
+  DynamicBatcher batcher({predictor}, options);
+
+  auto a = batcher.Submit(MakeRequest(5, 1.f, {{0, 2, 5}}));
+  auto b = batcher.Submit(MakeRequest(4, 2.f, {{0, 1, 3, 4}}));
+  auto out_a = a.get();
+  auto out_b = b.get();
+  EXPECT_EQ(predictor->runs_, 1);
+  EXPECT_EQ(out_a[0].lod, lod_t({{0, 2, 5}}));
+  EXPECT_EQ(out_b[0].lod, lod_t({{0, 1, 3, 4}}));
+  EXPECT_EQ(out_b[0].shape, shape_t({4, 3}));
+  EXPECT_EQ(out_b[0].data_as<float>()[11], 4.f);
+  // Out1 has a row per sequence
+  ASSERT_EQ(out_a[1].shape, shape_t({2, 1}));
+  EXPECT_EQ(out_a[1].data_as<int64_t>()[1], 3);
+  ASSERT_EQ(out_b[1].shape, shape_t({3, 1}));
+  EXPECT_EQ(out_b[1].data_as<int64_t>()[0], 1);
+  EXPECT_EQ(out_b[1].data_as<int64_t>()[1], 2);
+}
+
+TEST(DynamicBatcher, timeout) {
+  auto predictor = std::make_shared<FakePredictor>();
+  DynamicBatcher::Options options;
+  options.max_batch_size = 64;
+  options.max_delay_us = 1000;
+  DynamicBatcher batcher({predictor}, options);
+  auto start = std::chrono::steady_clock::now();
+  auto outputs = batcher.Submit(MakeRequest(1, 1.f)).get();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::seconds(1));
+  EXPECT_EQ(outputs[0].shape, shape_t({1, 3}));
+  EXPECT_GE(batcher.GetStats().max_queue_delay_ms, 1.);
+}
+
+}  // namespace lite_api
+}  // namespace paddle
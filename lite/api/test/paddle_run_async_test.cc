@@ -0,0 +1,224 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <future>  // NOLINT
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite_api {
+
+// Out = X + 1, every run takes a few milliseconds so that the runs submitted
+// together are still queued when the test goes on. Like the real predictors,
+// it waits for the pending runs on entering the calls touching the tensors
+// and in its destructor.
+class FakePredictor : public PaddlePredictor {
+ public:
+  FakePredictor() {
+    x_.Resize({1});
+    x_.mutable_data<float>()[0] = 0.f;
+  }
+  ~FakePredictor() { WaitForAsyncRuns(); }
+
+  std::unique_ptr<Tensor> GetInput(int i) override {
+    WaitForAsyncRuns();
+    return std::unique_ptr<Tensor>(new Tensor(&x_));
+  }
+  std::unique_ptr<const Tensor> GetOutput(int i) const override {
+    WaitForAsyncRuns();
+    return std::unique_ptr<const Tensor>(new Tensor(&out_));
+  }
+  void Run() override {
+    WaitForAsyncRuns();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    run_threads_.push_back(std::this_thread::get_id());
+    runs_++;
+    if (fail_) throw std::runtime_error("run failed");
+    out_.Resize({1});
+    out_.mutable_data<float>()[0] = x_.data<float>()[0] + 1.f;
+  }
+  std::shared_ptr<PaddlePredictor> Clone() override { return nullptr; }
+  std::shared_ptr<PaddlePredictor> Clone(
+      const std::vector<std::string>& var_names) override {
+    return nullptr;
+  }
+  std::string GetVersion() const override { return ""; }
+  std::vector<std::string> GetInputNames() override { return {"x"}; }
+  std::vector<std::string> GetOutputNames() override { return {"out"}; }
+  bool TryShrinkMemory() override {
+    WaitForAsyncRuns();
+    return true;
+  }
+  std::unique_ptr<Tensor> GetInputByName(const std::string& name) override {
+    return GetInput(0);
+  }
+  std::unique_ptr<const Tensor> GetTensor(
+      const std::string& name) const override {
+    return GetOutput(0);
+  }
+
+  std::atomic<int> runs_{0};
+  std::vector<std::thread::id> run_threads_;
+  bool fail_{false};
+
+ private:
+  lite::Tensor x_;
+  lite::Tensor out_;
+};
+
+static float Input(FakePredictor* predictor) {
+  return predictor->GetInput(0)->data<float>()[0];
+}
+
+static void SetInput(FakePredictor* predictor, float value) {
+  predictor->GetInput(0)->mutable_data<float>()[0] = value;
+}
+
+static float Output(const FakePredictor* predictor) {
+  return predictor->GetOutput(0)->data<float>()[0];
+}
+
+TEST(RunAsync, order) {
+  FakePredictor predictor;
+  std::vector<int> completed;
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 5; i++) {
+    if (i % 2 == 0) {
+      futures.push_back(predictor.RunAsync());
+    } else {
+      predictor.RunAsync([&completed, i](std::exception_ptr error) {
+        EXPECT_FALSE(error);
+        completed.push_back(i);
+      });
+    }
+  }
+  // A run completes only after all the ones submitted before it
+  futures[1].get();
+  EXPECT_GE(predictor.runs_.load(), 3);
+  EXPECT_EQ(futures[0].wait_for(std::chrono::seconds(0)),
+            std::future_status::ready);
+  futures[2].get();
+  futures[0].get();
+  EXPECT_EQ(predictor.runs_.load(), 5);
+  EXPECT_EQ(completed, std::vector<int>({1, 3}));
+  // All on the same worker thread, which isn't the caller's one
+  ASSERT_EQ(predictor.run_threads_.size(), 5u);
+  for (auto& id : predictor.run_threads_) {
+    EXPECT_EQ(id, predictor.run_threads_[0]);
+  }
+  EXPECT_NE(predictor.run_threads_[0], std::this_thread::get_id());
+}
+
+TEST(RunAsync, wait_for_pending_runs) {
+  FakePredictor predictor;
+  SetInput(&predictor, 1.f);
+  for (int i = 0; i < 3; i++) predictor.RunAsync();
+  EXPECT_LT(predictor.runs_.load(), 3);
+  // GetOutput waits for the queued runs
+  EXPECT_EQ(Output(&predictor), 2.f);
+  EXPECT_EQ(predictor.runs_.load(), 3);
+
+  for (int i = 0; i < 3; i++) predictor.RunAsync();
+  EXPECT_LT(predictor.runs_.load(), 3 + 3);
+  // So does Run, which runs after them on the caller's thread
+  predictor.Run();
+  EXPECT_EQ(predictor.runs_.load(), 3 + 3 + 1);
+  EXPECT_EQ(predictor.run_threads_.back(), std::this_thread::get_id());
+
+  // The input set after the queued runs isn't seen by them
+  predictor.RunAsync();
+  SetInput(&predictor, 5.f);
+  EXPECT_EQ(predictor.runs_.load(), 3 + 3 + 1 + 1);
+  EXPECT_EQ(Output(&predictor), 2.f);
+  predictor.RunAsync().get();
+  EXPECT_EQ(Output(&predictor), 6.f);
+}
+
+TEST(RunAsync, callback_reads_outputs) {
+  FakePredictor predictor;
+  std::vector<float> outputs;
+  for (int i = 0; i < 3; i++) {
+    SetInput(&predictor, static_cast<float>(i));
+    std::promise<void> done;
+    // GetOutput returns at once on the worker thread instead of waiting for
+    // the run calling the callback
+    predictor.RunAsync([&](std::exception_ptr error) {
+      EXPECT_FALSE(error);
+      outputs.push_back(Output(&predictor));
+      done.set_value();
+    });
+    done.get_future().get();
+  }
+  EXPECT_EQ(outputs, std::vector<float>({1.f, 2.f, 3.f}));
+  EXPECT_EQ(Input(&predictor), 2.f);
+}
+
+#ifdef LITE_WITH_EXCEPTION
+TEST(RunAsync, exception) {
+  FakePredictor predictor;
+  predictor.fail_ = true;
+  auto future = predictor.RunAsync();
+  EXPECT_THROW(future.get(), std::runtime_error);
+
+  std::promise<std::exception_ptr> failed;
+  predictor.RunAsync(
+      [&](std::exception_ptr error) { failed.set_value(error); });
+  auto error = failed.get_future().get();
+  ASSERT_TRUE(error);
+  try {
+    std::rethrow_exception(error);
+  } catch (const std::runtime_error& e) {
+    EXPECT_EQ(std::string(e.what()), "run failed");
+  }
+
+  // The worker goes on after a failed run
+  predictor.fail_ = false;
+  SetInput(&predictor, 1.f);
+  predictor.RunAsync().get();
+  EXPECT_EQ(Output(&predictor), 2.f);
+}
+#endif
+
+TEST(RunAsync, destroy_with_pending_runs) {
+  std::atomic<int> completed{0};
+  std::unique_ptr<FakePredictor> predictor(new FakePredictor);
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 4; i++) {
+    futures.push_back(predictor->RunAsync());
+    predictor->RunAsync([&completed](std::exception_ptr error) {
+      EXPECT_FALSE(error);
+      completed++;
+    });
+  }
+  EXPECT_LT(completed.load(), 4);
+  // The destructor waits for the queued runs rather than dropping them
+  predictor.reset();
+  EXPECT_EQ(completed.load(), 4);
+  for (auto& future : futures) {
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(0)),
+              std::future_status::ready);
+    future.get();
+  }
+}
+
+}  // namespace lite_api
+}  // namespace paddle
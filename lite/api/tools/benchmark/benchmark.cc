@@ -14,13 +14,19 @@
 
 #include "lite/api/tools/benchmark/benchmark.h"
 #include <algorithm>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
 #include <cstdio>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <numeric>
+#include <random>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 #ifdef __ANDROID__
@@ -57,7 +63,11 @@ int Benchmark(int argc, char** argv) {
   auto input_shapes = lite::GetShapes(FLAGS_input_shape);
 
   // Run
-  Run(model_file, input_shapes);
+  if (FLAGS_streams > 0) {
+    RunThroughput(model_file, input_shapes);
+  } else {
+    Run(model_file, input_shapes);
+  }
 
   return 0;
 }
@@ -76,6 +86,28 @@ std::shared_ptr<PaddlePredictor> CreatePredictor(
   return predictor;
 }
 
+void SetInputs(std::shared_ptr<PaddlePredictor> predictor,
+               const std::vector<std::vector<int64_t>>& input_shapes) {
+  auto input_types = lite::Split(FLAGS_input_data_type, ":");
+  auto paths = lite::Split(FLAGS_input_data_path, ":");
+  for (size_t i = 0; i < input_shapes.size(); i++) {
+    auto input_tensor = predictor->GetInput(i);
+    std::string path;
+
+    if (FLAGS_input_data_path.empty()) {
+      path = "";
+    } else {
+      path = paths[i];
+    }
+
+    if ((i < input_types.size()) && (input_types[i] == "int64")) {
+      setInputValue<int64_t>(input_tensor, input_shapes[i], path);
+    } else {  // default input_type float32
+      setInputValue<float>(input_tensor, input_shapes[i], path);
+    }
+  }
+}
+
 void RunImpl(std::shared_ptr<PaddlePredictor> predictor, PerfData* perf_data) {
   lite::Timer timer;
   timer.Start();
@@ -133,28 +165,9 @@ void Run(const std::string& model_file,
 #endif
   perf_data.set_init_time(timer.Stop());
 
-  // Get input types
-  auto input_types = lite::Split(FLAGS_input_data_type, ":");
-
   // Set inputs
   if (FLAGS_validation_set.empty()) {
-    auto paths = lite::Split(FLAGS_input_data_path, ":");
-    for (size_t i = 0; i < input_shapes.size(); i++) {
-      auto input_tensor = predictor->GetInput(i);
-      std::string path;
-
-      if (FLAGS_input_data_path.empty()) {
-        path = "";
-      } else {
-        path = paths[i];
-      }
-
-      if ((i < input_types.size()) && (input_types[i] == "int64")) {
-        setInputValue<int64_t>(input_tensor, input_shapes[i], path);
-      } else {  // default input_type float32
-        setInputValue<float>(input_tensor, input_shapes[i], path);
-      }
-    }
+    SetInputs(predictor, input_shapes);
   } else {
 #ifdef __ANDROID__
     config = LoadConfigTxt(FLAGS_config_path);
@@ -344,5 +357,250 @@ void Run(const std::string& model_file,
   StoreBenchmarkResult(ss.str());
 }
 
+
+void RunThroughput(const std::string& model_file,
+                   const std::vector<std::vector<int64_t>>& input_shapes) {
+  using Clock = std::chrono::steady_clock;
+  auto to_ms = [](Clock::duration d) {
+    return std::chrono::duration<float, std::milli>(d).count();
+  };
+  const int streams = FLAGS_streams;
+  const bool timed = FLAGS_duration > 0.;
+  const bool open_loop = FLAGS_arrival_rate > 0.;
+  const int64_t total_requests =
+      FLAGS_requests > 0 ? FLAGS_requests
+                         : static_cast<int64_t>(FLAGS_repeats) * streams;
+
+  // The light predictor does not support Clone(), so every stream loads its
+  // own copy of the optimized model instead.
+  lite::Timer timer;
+  timer.Start();
+  std::vector<std::shared_ptr<PaddlePredictor>> predictors;
+  for (int i = 0; i < streams; ++i) {
+    predictors.push_back(CreatePredictor(model_file));
+    SetInputs(predictors.back(), input_shapes);
+  }
+  float init_time = timer.Stop();
+
+#ifdef __linux__
+  profile::ResourceUsageMonitor resource_monter(FLAGS_memory_check_interval_ms);
+#endif
+  std::vector<StreamPerfData> perf_data(streams);
+  std::mutex mutex;
+  std::condition_variable cv;
+  int ready_streams = 0;
+  bool started = false;
+  Clock::time_point start;
+  std::vector<std::thread> clients;
+  for (int s = 0; s < streams; ++s) {
+    int64_t quota = timed ? std::numeric_limits<int64_t>::max()
+                          : total_requests / streams +
+                                (s < total_requests % streams ? 1 : 0);
+    clients.emplace_back([&, s, quota]() {
+      auto& predictor = predictors[s];
+      auto& data = perf_data[s];
+      // Warmup in the client thread since some backends keep their
+      // workspace per thread.
+      for (int i = 0; i < FLAGS_warmup; ++i) {
+        predictor->Run();
+      }
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (++ready_streams == streams) cv.notify_all();
+        cv.wait(lock, [&]() { return started; });
+      }
+      auto deadline =
+          start + std::chrono::duration_cast<Clock::duration>(
+                      std::chrono::duration<double>(FLAGS_duration));
+      std::mt19937 rng(s + 1);
+      std::exponential_distribution<double> interval(
+          open_loop ? FLAGS_arrival_rate / streams : 1.);
+#ifdef __linux__
+      double cpu_time = profile::GetThreadCpuTimeMs();
+#endif
+      auto arrival = start;
+      for (int64_t i = 0; i < quota; ++i) {
+        if (open_loop) {
+          // Latency counts from the scheduled arrival, so requests delayed by
+          // a slow predecessor are not hidden (no coordinated omission).
+          arrival += std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(interval(rng)));
+          if (timed && arrival >= deadline) break;
+          std::this_thread::sleep_until(arrival);
+        } else {
+          arrival = Clock::now();
+          if (timed && arrival >= deadline) break;
+        }
+        predictor->Run();
+        data.latency.push_back(to_ms(Clock::now() - arrival));
+      }
+      data.wall_time = to_ms(Clock::now() - start);
+#ifdef __linux__
+      data.cpu_time = profile::GetThreadCpuTimeMs() - cpu_time;
+#endif
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return ready_streams == streams; });
+#ifdef __linux__
+    resource_monter.Start();
+#endif
+    start = Clock::now();
+    started = true;
+  }
+  cv.notify_all();
+  for (auto& client : clients) {
+    client.join();
+  }
+#ifdef __linux__
+  float peak_memory_usage = resource_monter.GetPeakMemUsageInKB();
+  resource_monter.Stop();
+  float process_cpu_usage = resource_monter.GetAvgCpuUsageRatio();
+#endif
+
+  // Summarize
+  std::vector<float> latency;
+  float elapsed = 0.f;
+  for (auto& data : perf_data) {
+    std::sort(data.latency.begin(), data.latency.end());
+    latency.insert(latency.end(), data.latency.begin(), data.latency.end());
+    elapsed = std::max(elapsed, data.wall_time);
+  }
+  std::sort(latency.begin(), latency.end());
+  auto qps = [](size_t num, float ms) {
+    return ms > 0.f ? num * 1e3f / ms : 0.f;
+  };
+  auto avg = [](const std::vector<float>& v) {
+    return v.empty() ? 0.f
+                     : std::accumulate(v.begin(), v.end(), 0.f) / v.size();
+  };
+  const double percentiles[] = {50., 90., 99., 99.9};
+  const char* percentile_names[] = {"p50", "p90", "p99", "p99.9"};
+
+  std::stringstream ss;
+  ss.precision(3);
+  ss << std::fixed << std::left;
+  ss << "\n======= Model Info =======\n";
+  ss << "optimized_model_file: " << model_file << std::endl;
+  ss << "input_data_path: "
+     << (FLAGS_input_data_path.empty() ? "All 1.f" : FLAGS_input_data_path)
+     << std::endl;
+  ss << "input_shape: " << FLAGS_input_shape << std::endl;
+  ss << "\n======= Runtime Info =======\n";
+  ss << "benchmark_bin version: " << lite::version() << std::endl;
+  ss << "threads: " << FLAGS_threads << std::endl;
+  ss << "power_mode: " << FLAGS_power_mode << std::endl;
+  ss << "warmup: " << FLAGS_warmup << std::endl;
+  ss << "streams: " << streams << std::endl;
+  if (timed) {
+    ss << "duration(sec): " << FLAGS_duration << std::endl;
+  } else {
+    ss << "requests: " << total_requests << std::endl;
+  }
+  ss << "arrival_rate(qps): "
+     << (open_loop ? std::to_string(FLAGS_arrival_rate) : "closed-loop")
+     << std::endl;
+  ss << "\n======= Backend Info =======\n";
+  ss << "backend: " << FLAGS_backend << std::endl;
+  ss << "cpu precision: " << FLAGS_cpu_precision << std::endl;
+  ss << "\n======= Throughput Info =======\n";
+  ss << "init(ms)   = " << std::setw(12) << init_time << std::endl;
+  ss << "finished   = " << std::setw(12) << latency.size() << std::endl;
+  ss << "elapsed(s) = " << std::setw(12) << elapsed / 1e3f << std::endl;
+  ss << "qps        = " << std::setw(12) << qps(latency.size(), elapsed)
+     << std::endl;
+  ss << "Latency(unit: ms):\n";
+  ss << "min   = " << std::setw(12) << (latency.empty() ? 0.f : latency.front())
+     << std::endl;
+  ss << "max   = " << std::setw(12) << (latency.empty() ? 0.f : latency.back())
+     << std::endl;
+  ss << "avg   = " << std::setw(12) << avg(latency) << std::endl;
+  for (int i = 0; i < 4; ++i) {
+    ss << std::setw(6) << percentile_names[i] << "= " << std::setw(12)
+       << Percentile(latency, percentiles[i]) << std::endl;
+  }
+  ss << "Streams:\n";
+  for (int s = 0; s < streams; ++s) {
+    const auto& sorted = perf_data[s].latency;
+    ss << "stream " << s << ": requests = " << sorted.size()
+       << ", qps = " << qps(sorted.size(), perf_data[s].wall_time)
+       << ", avg = " << avg(sorted) << ", p99 = " << Percentile(sorted, 99.);
+#ifdef __linux__
+    ss << ", cpu usage = "
+       << perf_data[s].cpu_time / std::max(perf_data[s].wall_time, 1e-3f) *
+              100
+       << "%";
+#endif
+    ss << std::endl;
+  }
+#ifdef __linux__
+  if (process_cpu_usage >= 0.f) {
+    ss << "process cpu usage = " << process_cpu_usage * 100 << "%"
+       << std::endl;
+  }
+  if (peak_memory_usage >= 0.f) {
+    ss << "peak memory(MB)   = " << peak_memory_usage / 1024 << std::endl;
+  }
+#endif
+  std::cout << ss.str() << std::endl;
+  StoreBenchmarkResult(ss.str());
+
+  if (!FLAGS_json_result_path.empty()) {
+    std::stringstream js;
+    js.precision(3);
+    js << std::fixed;
+    js << "{\n";
+    js << "  \"model\": \"" << model_file << "\",\n";
+    js << "  \"version\": \"" << lite::version() << "\",\n";
+    js << "  \"backend\": \"" << FLAGS_backend << "\",\n";
+    js << "  \"input_shape\": \"" << FLAGS_input_shape << "\",\n";
+    js << "  \"threads\": " << FLAGS_threads << ",\n";
+    js << "  \"streams\": " << streams << ",\n";
+    js << "  \"duration_s\": " << (timed ? FLAGS_duration : 0.) << ",\n";
+    js << "  \"arrival_rate\": " << (open_loop ? FLAGS_arrival_rate : 0.)
+       << ",\n";
+    js << "  \"init_ms\": " << init_time << ",\n";
+    js << "  \"requests\": " << latency.size() << ",\n";
+    js << "  \"elapsed_s\": " << elapsed / 1e3f << ",\n";
+    js << "  \"qps\": " << qps(latency.size(), elapsed) << ",\n";
+    js << "  \"latency_ms\": {";
+    js << "\"min\": " << (latency.empty() ? 0.f : latency.front());
+    js << ", \"max\": " << (latency.empty() ? 0.f : latency.back());
+    js << ", \"avg\": " << avg(latency);
+    for (int i = 0; i < 4; ++i) {
+      js << ", \"" << percentile_names[i]
+         << "\": " << Percentile(latency, percentiles[i]);
+    }
+    js << "},\n";
+#ifdef __linux__
+    js << "  \"process_cpu_usage\": " << process_cpu_usage << ",\n";
+    js << "  \"peak_memory_mb\": " << peak_memory_usage / 1024 << ",\n";
+#endif
+    js << "  \"per_stream\": [";
+    for (int s = 0; s < streams; ++s) {
+      const auto& sorted = perf_data[s].latency;
+      js << (s == 0 ? "\n" : ",\n");
+      js << "    {\"stream\": " << s << ", \"requests\": " << sorted.size()
+         << ", \"qps\": " << qps(sorted.size(), perf_data[s].wall_time)
+         << ", \"avg_ms\": " << avg(sorted)
+         << ", \"p99_ms\": " << Percentile(sorted, 99.)
+         << ", \"cpu_time_ms\": " << perf_data[s].cpu_time
+         << ", \"cpu_usage\": "
+         << perf_data[s].cpu_time / std::max(perf_data[s].wall_time, 1e-3f)
+         << "}";
+    }
+    js << "\n  ]\n}\n";
+    std::ofstream fs(FLAGS_json_result_path);
+    if (!fs.is_open()) {
+      std::cerr << "Fail to open json result file: " << FLAGS_json_result_path
+                << std::endl;
+    } else {
+      fs << js.str();
+    }
+  }
+}
+
 }  // namespace lite_api
 }  // namespace paddle
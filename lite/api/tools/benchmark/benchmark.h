@@ -93,9 +93,25 @@ class PerfData {
   std::vector<float> run_time_;
 };
 
+// Measurements of one stream in the throughput mode.
+struct StreamPerfData {
+  std::vector<float> latency;  // ms of each finished request
+  float wall_time{0.f};        // ms from the common start to the last request
+  float cpu_time{0.f};         // ms of cpu time spent by the client thread
+};
+
+// Nearest-rank percentile, `sorted` must be in ascending order.
+inline float Percentile(const std::vector<float>& sorted, const double p) {
+  if (sorted.empty()) return 0.f;
+  auto rank = static_cast<size_t>(std::ceil(p / 100. * sorted.size()));
+  return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
 int Benchmark(int argc, char** argv);
 void Run(const std::string& model_file,
          const std::vector<std::vector<int64_t>>& input_shape);
+void RunThroughput(const std::string& model_file,
+                   const std::vector<std::vector<int64_t>>& input_shape);
 
 #ifdef __ANDROID__
 std::string GetDeviceInfo() {
@@ -195,6 +211,18 @@ bool CheckFlagsValid() {
       ret = false;
     }
   }
+  if (FLAGS_streams > 0 && !FLAGS_validation_set.empty()) {
+    std::cerr << "--validation_set is not supported in throughput mode!"
+              << std::endl;
+    ret = false;
+  }
+  if (FLAGS_streams > 0 && FLAGS_duration <= 0. && FLAGS_requests <= 0 &&
+      FLAGS_repeats <= 0) {
+    std::cerr << "One of --duration, --requests and --repeats should be "
+                 "positive in throughput mode!"
+              << std::endl;
+    ret = false;
+  }
   if (!FLAGS_validation_set.empty()) {
     if (FLAGS_config_path.empty()) {
       std::cerr
@@ -242,6 +270,11 @@ const std::string PrintUsage() {
         "--model_file=/path/to/mobilenetv1/model "
         "--param_file=/path/to/mobilenetv1/params "
         "--input_shape=1,3,224,224 --backend=x86 \n\n"
+        "  For throughput of 4 concurrent streams in 60 seconds: "
+        "./benchmark_bin "
+        "--optimized_model_file=/path/to/mbilenetv1_opt.nb "
+        "--input_shape=1,3,224,224 --backend=x86 --streams=4 --duration=60 "
+        "--json_result_path=/path/to/result.json \n\n"
         "For detailed usage info: ./benchmark_bin --help \n\n";
 
   return ss.str();
@@ -19,6 +19,7 @@
 #include <sys/sysinfo.h>
 #endif
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #include <chrono>  //NOLINT
 #include <iostream>
@@ -140,6 +141,12 @@ float GetCpuUsageRatio(int pid) {
   static CpuUsage cpu_monter;
   return cpu_monter.GetCpuUsageRatio(pid);
 }
+
+double GetThreadCpuTimeMs() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0.0;
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
 }  // namespace profile
 }  // namespace lite_api
 }  // namespace paddle
@@ -40,6 +40,9 @@ class CpuUsage {
 };
 
 float GetCpuUsageRatio(int pid);
+
+// CPU time in milliseconds consumed by the calling thread so far.
+double GetThreadCpuTimeMs();
 }  // namespace paddle
 }  // namespace lite_api
 }  // namespace profile
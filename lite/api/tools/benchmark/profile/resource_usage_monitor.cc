@@ -44,6 +44,8 @@ void ResourceUsageMonitor::Start() {
   }
   std::cout << "start monitoring memory!" << std::endl;
   stop_signal_ = false;
+  cpu_usage_sum_ = 0.0f;
+  cpu_usage_samples_ = 0;
   check_memory_thd_.reset(new std::thread(([this]() {
     // Note we retrieve the memory usage at the very beginning of the thread.
     while (true) {
@@ -51,9 +53,11 @@ void ResourceUsageMonitor::Start() {
       if (mem_info.max_rss_kb > peak_max_rss_kb_) {
         peak_max_rss_kb_ = mem_info.max_rss_kb;
       }
+      const float cpu_usage = sampler_->GetCpuUsageRatio(getpid());
+      cpu_usage_sum_ += cpu_usage;
+      cpu_usage_samples_++;
       std::cout << std::fixed << "cpu usage ratio: " << std::setprecision(1)
-                << sampler_->GetCpuUsageRatio(getpid()) * 100 << "%"
-                << std::endl;
+                << cpu_usage * 100 << "%" << std::endl;
       if (stop_signal_) break;
       sampler_->SleepFor(sampling_interval_);
     }
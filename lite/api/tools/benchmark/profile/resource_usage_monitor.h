@@ -78,6 +78,14 @@ class ResourceUsageMonitor {
     return peak_max_rss_kb_;
   }
 
+  // The average cpu usage ratio of the process over the samples taken between
+  // Start() and Stop(), 1.0 means one fully busy core. Returns a negative
+  // value if nothing has been sampled.
+  float GetAvgCpuUsageRatio() const {
+    if (!is_supported_ || cpu_usage_samples_ == 0) return -1.0f;
+    return cpu_usage_sum_ / cpu_usage_samples_;
+  }
+
   ResourceUsageMonitor(ResourceUsageMonitor&) = delete;
   ResourceUsageMonitor& operator=(const ResourceUsageMonitor&) = delete;
   ResourceUsageMonitor(ResourceUsageMonitor&&) = delete;
@@ -92,6 +100,8 @@ class ResourceUsageMonitor {
   const int sampling_interval_;
   std::unique_ptr<std::thread> check_memory_thd_ = nullptr;
   int64_t peak_max_rss_kb_ = kInvalidMemUsageKB;
+  float cpu_usage_sum_ = 0.0f;
+  int cpu_usage_samples_ = 0;
 };
 
 }  // namespace paddle
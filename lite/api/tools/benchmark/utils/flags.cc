@@ -37,6 +37,13 @@ DEFINE_int32(power_mode, 0, power_mode_msg);
 DEFINE_int32(threads, 1, threads_msg);
 DEFINE_string(result_path, "", result_path_msg);
 
+// Throughput options
+DEFINE_int32(streams, 0, streams_msg);
+DEFINE_double(duration, 0.0, duration_msg);
+DEFINE_int32(requests, 0, requests_msg);
+DEFINE_double(arrival_rate, 0.0, arrival_rate_msg);
+DEFINE_string(json_result_path, "", json_result_path_msg);
+
 // Backend options
 DEFINE_string(backend, "", backend_msg);
 DEFINE_string(cpu_precision, "fp32", cpu_precision_msg);
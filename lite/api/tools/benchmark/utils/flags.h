@@ -78,6 +78,27 @@ static const char power_mode_msg[] =
 static const char threads_msg[] = "threads num";
 static const char result_path_msg[] = "Save benchmark info to the file.";
 
+// Throughput options
+static const char streams_msg[] =
+    "Number of predictors driven concurrently by their own client threads. "
+    "Set a positive value to run in throughput mode instead of measuring "
+    "the latency of a single predictor.";
+static const char duration_msg[] =
+    "How long in seconds the throughput mode runs. "
+    "Non-positive values mean to stop after --requests requests.";
+static const char requests_msg[] =
+    "Total number of requests issued by all streams in throughput mode, "
+    "only used when --duration is not set. "
+    "Default to --repeats requests per stream if it is not positive.";
+static const char arrival_rate_msg[] =
+    "Open-loop arrival rate in requests per second over all streams. "
+    "Requests arrive as a poisson process and the latency includes the time "
+    "queued behind the previous request of the same stream. "
+    "Non-positive values mean closed-loop, i.e. each stream issues its next "
+    "request as soon as the previous one finishes.";
+static const char json_result_path_msg[] =
+    "Save the throughput mode results to the file in JSON format.";
+
 // Backend options
 static const char backend_msg[] =
     "To use a particular backend for execution. "
@@ -145,6 +166,13 @@ DECLARE_int32(power_mode);
 DECLARE_int32(threads);
 DECLARE_string(result_path);
 
+// Throughput options
+DECLARE_int32(streams);
+DECLARE_double(duration);
+DECLARE_int32(requests);
+DECLARE_double(arrival_rate);
+DECLARE_string(json_result_path);
+
 // Backend options
 DECLARE_string(backend);
 DECLARE_string(cpu_precision);
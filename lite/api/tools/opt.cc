@@ -45,8 +45,8 @@ DEFINE_bool(quant_model,
             "Use post_quant_dynamic method to quantize the model weights.");
 DEFINE_string(quant_type,
               "QUANT_INT16",
-              "Set the quant_type for post_quant_dynamic, "
-              "and it should be QUANT_INT8 or QUANT_INT16 for now.");
+              "Set the quant_type for post_quant_dynamic, and it should be "
+              "QUANT_INT8, QUANT_INT16 or QUANT_INT4 for now.");
 DEFINE_bool(enable_fp16, false, "Set kernel_type run in FP16.");
 DEFINE_bool(record_tailoring_info,
             false,
@@ -57,7 +57,8 @@ DEFINE_string(optimize_out, "", "path of the output optimized model");
 DEFINE_string(valid_targets,
               "arm",
               "The targets this model optimized for, should be one of (arm, "
-              "opencl, x86, x86_opencl), splitted by space");
+              "opencl, x86, x86_nchw8c, x86_nchw16c, x86_opencl), splitted by "
+              "space");
 DEFINE_bool(print_supported_ops,
             false,
             "Print supported operators on the inputed target");
@@ -53,6 +53,8 @@ void OptBase::SetQuantType(const std::string& quant_type) {
     opt_config_.set_quant_type(lite_api::QuantType::QUANT_INT8);
   } else if (quant_type == "QUANT_INT16") {
     opt_config_.set_quant_type(lite_api::QuantType::QUANT_INT16);
+  } else if (quant_type == "QUANT_INT4") {
+    opt_config_.set_quant_type(lite_api::QuantType::QUANT_INT4);
   } else {
     OPT_LOG_FATAL << "Unsupported quant type: " << quant_type;
   }
@@ -153,6 +155,16 @@ void OptBase::SetValidPlaces(const std::string& valid_places) {
       valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kFloat)});
       valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kInt64)});
       valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kAny)});
+    } else if (target_repr == "x86_nchw8c" || target_repr == "x86_nchw16c") {
+      // blocked layout kernels first, NCHW kernels for the other ops
+      valid_places_.emplace_back(
+          Place{TARGET(kX86),
+                PRECISION(kFloat),
+                target_repr == "x86_nchw8c" ? DATALAYOUT(kNCHW8c)
+                                            : DATALAYOUT(kNCHW16c)});
+      valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kFloat)});
+      valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kInt64)});
+      valid_places_.emplace_back(Place{TARGET(kX86), PRECISION(kAny)});
     } else if (target_repr == "x86_opencl") {
       valid_places_.emplace_back(
           Place{TARGET(kOpenCL), PRECISION(kFP16), DATALAYOUT(kImageDefault)});
@@ -374,7 +386,8 @@ void OptBase::PrintHelpInfo() {
       "default\n"
       "        `set_lite_out(output_optimize_model_dir)`\n"
       "        "
-      "`set_valid_places(arm|opencl|x86|metal|xpu|bm|mlu|intel_fpga|"
+      "`set_valid_places(arm|opencl|x86|x86_nchw8c|x86_nchw16c|metal|xpu|"
+      "bm|mlu|intel_fpga|"
       "huawei_ascend_npu|imagination_nna|rockchip_npu|"
       "mediatek_apu|huawei_kirin_npu|amlogic_npu|verisilicon_timvx|"
       "eeasytech_npu|android_nnapi|qualcomm_qnn|kunlunxin_xtcl)`"
@@ -419,14 +432,15 @@ void OptBase::PrintExecutableBinHelpInfo() {
       "        `--optimize_out_type=(protobuf|naive_buffer)`\n"
       "        `--optimize_out=<output_optimize_model_dir>`\n"
       "        "
-      "`--valid_targets=(arm|opencl|x86|metal|xpu|bm|mlu|intel_fpga|"
+      "`--valid_targets=(arm|opencl|x86|x86_nchw8c|x86_nchw16c|metal|xpu|"
+      "bm|mlu|intel_fpga|"
       "huawei_ascend_npu|imagination_nna|rockchip_npu|mediatek_apu|"
       "huawei_kirin_npu|amlogic_npu|verisilicon_timvx|android_nnapi|"
       "qualcomm_qnn|kunlunxin_xtcl)`\n"
       "        `--record_tailoring_info=(true|false)`\n"
       "  Arguments of mode quantization in opt:\n"
       "        `--quant_model=(true|false)`\n"
-      "        `--quant_type=(QUANT_INT8|QUANT_INT16)`\n"
+      "        `--quant_type=(QUANT_INT8|QUANT_INT16|QUANT_INT4)`\n"
       "  Arguements of sparse convolution in opt: \n"
       "        `--sparse_model=(true|false)`\n"
       "        `--sparse_threshold=(float)`\n"
@@ -439,13 +453,15 @@ void OptBase::PrintExecutableBinHelpInfo() {
       "operators of "
       "Paddle-Lite in markdown format\n"
       "        `--print_supported_ops=true  "
-      "--valid_targets=(arm|opencl|x86|metal|xpu|bm|mlu|intel_fpga|"
+      "--valid_targets=(arm|opencl|x86|x86_nchw8c|x86_nchw16c|metal|xpu|"
+      "bm|mlu|intel_fpga|"
       "huawei_ascend_npu|imagination_nna|rockchip_npu|mediatek_apu|"
       "huawei_kirin_npu|amlogic_npu|verisilicon_timvx|android_nnapi|"
       "qualcomm_qnn|kunlunxin_xtcl)`"
       "  Display valid operators of input targets\n"
       "        `--print_model_ops=true  --model_dir=<model_param_dir> "
-      "--valid_targets=(arm|opencl|x86|metal|xpu|bm|mlu|intel_fpga|"
+      "--valid_targets=(arm|opencl|x86|x86_nchw8c|x86_nchw16c|metal|xpu|"
+      "bm|mlu|intel_fpga|"
       "huawei_ascend_npu|imagination_nna|rockchip_npu|mediatek_apu|"
       "huawei_kirin_npu|amlogic_npu|verisilicon_timvx|android_nnapi|"
       "qualcomm_qnn|kunlunxin_xtcl)`"
@@ -0,0 +1,436 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/nms.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "lite/backends/host/math/nms_util.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// IoU of the box (bx1, by1, bx2, by2) with area `ba` against the boxes
+// [begin, end) of the arrays, in the same operation order as
+// JaccardOverlap() so that both give the same bits.
+template <typename T>
+static void IoUKernel(const T* xmin,
+                      const T* ymin,
+                      const T* xmax,
+                      const T* ymax,
+                      const T* area,
+                      T bx1,
+                      T by1,
+                      T bx2,
+                      T by2,
+                      T ba,
+                      T norm,
+                      int begin,
+                      int end,
+                      T* iou) {
+  for (int j = begin; j < end; ++j) {
+    T v = static_cast<T>(0.);
+    if (!(xmin[j] > bx2 || xmax[j] < bx1 || ymin[j] > by2 ||
+          ymax[j] < by1)) {
+      const T inter_w = (std::min)(bx2, xmax[j]) - (std::max)(bx1, xmin[j]);
+      const T inter_h = (std::min)(by2, ymax[j]) - (std::max)(by1, ymin[j]);
+      const T inter_area = (inter_w + norm) * (inter_h + norm);
+      v = inter_area / (ba + area[j] - inter_area);
+    }
+    iou[j - begin] = v;
+  }
+}
+
+#ifdef __AVX__
+static void IoUKernel(const float* xmin,
+                      const float* ymin,
+                      const float* xmax,
+                      const float* ymax,
+                      const float* area,
+                      float bx1,
+                      float by1,
+                      float bx2,
+                      float by2,
+                      float ba,
+                      float norm,
+                      int begin,
+                      int end,
+                      float* iou) {
+  const __m256 vbx1 = _mm256_set1_ps(bx1);
+  const __m256 vby1 = _mm256_set1_ps(by1);
+  const __m256 vbx2 = _mm256_set1_ps(bx2);
+  const __m256 vby2 = _mm256_set1_ps(by2);
+  const __m256 vba = _mm256_set1_ps(ba);
+  const __m256 vnorm = _mm256_set1_ps(norm);
+  int j = begin;
+  for (; j + 8 <= end; j += 8) {
+    const __m256 x1 = _mm256_loadu_ps(xmin + j);
+    const __m256 y1 = _mm256_loadu_ps(ymin + j);
+    const __m256 x2 = _mm256_loadu_ps(xmax + j);
+    const __m256 y2 = _mm256_loadu_ps(ymax + j);
+    __m256 disjoint = _mm256_or_ps(_mm256_cmp_ps(x1, vbx2, _CMP_GT_OQ),
+                                   _mm256_cmp_ps(x2, vbx1, _CMP_LT_OQ));
+    disjoint = _mm256_or_ps(disjoint, _mm256_cmp_ps(y1, vby2, _CMP_GT_OQ));
+    disjoint = _mm256_or_ps(disjoint, _mm256_cmp_ps(y2, vby1, _CMP_LT_OQ));
+    const __m256 inter_w =
+        _mm256_sub_ps(_mm256_min_ps(x2, vbx2), _mm256_max_ps(x1, vbx1));
+    const __m256 inter_h =
+        _mm256_sub_ps(_mm256_min_ps(y2, vby2), _mm256_max_ps(y1, vby1));
+    const __m256 inter_area = _mm256_mul_ps(_mm256_add_ps(inter_w, vnorm),
+                                            _mm256_add_ps(inter_h, vnorm));
+    const __m256 union_area = _mm256_sub_ps(
+        _mm256_add_ps(vba, _mm256_loadu_ps(area + j)), inter_area);
+    const __m256 v = _mm256_div_ps(inter_area, union_area);
+    _mm256_storeu_ps(iou + j - begin, _mm256_andnot_ps(disjoint, v));
+  }
+  IoUKernel<float>(xmin,
+                   ymin,
+                   xmax,
+                   ymax,
+                   area,
+                   bx1,
+                   by1,
+                   bx2,
+                   by2,
+                   ba,
+                   norm,
+                   j,
+                   end,
+                   iou + j - begin);
+}
+#endif
+
+// Bit k is set when iou[k], k in [0, n), is above the threshold. NaN counts
+// as above, same as `keep = overlap <= threshold` in the reference NMS.
+template <typename T>
+static uint64_t OverlapBits(const T* iou, int n, T threshold) {
+  uint64_t bits = 0;
+  for (int k = 0; k < n; ++k) {
+    bits |= static_cast<uint64_t>(!(iou[k] <= threshold)) << k;
+  }
+  return bits;
+}
+
+#ifdef __AVX__
+static uint64_t OverlapBits(const float* iou, int n, float threshold) {
+  const __m256 vthreshold = _mm256_set1_ps(threshold);
+  uint64_t bits = 0;
+  int k = 0;
+  for (; k + 8 <= n; k += 8) {
+    const __m256 above =
+        _mm256_cmp_ps(_mm256_loadu_ps(iou + k), vthreshold, _CMP_NLE_UQ);
+    bits |= static_cast<uint64_t>(_mm256_movemask_ps(above)) << k;
+  }
+  if (k < n) {
+    bits |= OverlapBits<float>(iou + k, n - k, threshold) << k;
+  }
+  return bits;
+}
+#endif
+
+template <typename T>
+void NMSBoxes<T>::Gather(const T* boxes,
+                         int64_t stride,
+                         const int* indices,
+                         int num) {
+  xmin_.resize(num);
+  ymin_.resize(num);
+  xmax_.resize(num);
+  ymax_.resize(num);
+  area_.resize(num);
+  for (int i = 0; i < num; ++i) {
+    const T* box = boxes + indices[i] * stride;
+    xmin_[i] = box[0];
+    ymin_[i] = box[1];
+    xmax_[i] = box[2];
+    ymax_[i] = box[3];
+    area_[i] = BBoxArea<T>(box, normalized_);
+  }
+}
+
+template <typename T>
+void NMSBoxes<T>::Push(const NMSBoxes<T>& other, int i) {
+  xmin_.push_back(other.xmin_[i]);
+  ymin_.push_back(other.ymin_[i]);
+  xmax_.push_back(other.xmax_[i]);
+  ymax_.push_back(other.ymax_[i]);
+  area_.push_back(other.area_[i]);
+}
+
+template <typename T>
+void NMSBoxes<T>::IoU(
+    const NMSBoxes<T>& other, int i, int begin, int end, T* iou) const {
+  const T norm = normalized_ ? static_cast<T>(0.) : static_cast<T>(1.);
+  IoUKernel(xmin_.data(),
+            ymin_.data(),
+            xmax_.data(),
+            ymax_.data(),
+            area_.data(),
+            other.xmin_[i],
+            other.ymin_[i],
+            other.xmax_[i],
+            other.ymax_[i],
+            other.area_[i],
+            norm,
+            begin,
+            end,
+            iou);
+}
+
+template <typename T>
+void SortScoreIndex(const T* scores,
+                    int64_t stride,
+                    int64_t num,
+                    T threshold,
+                    int64_t top_k,
+                    std::vector<int>* indices) {
+  std::vector<std::pair<T, int>> pairs;
+  for (int64_t i = 0; i < num; ++i) {
+    const T score = scores[i * stride];
+    if (score > threshold) {
+      pairs.emplace_back(score, static_cast<int>(i));
+    }
+  }
+  // Ties are broken by index, which gives the order of a stable sort and
+  // lets the top_k be selected before sorting.
+  auto greater = [](const std::pair<T, int>& a, const std::pair<T, int>& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  };
+  if (top_k > -1 && top_k < static_cast<int64_t>(pairs.size())) {
+    std::nth_element(
+        pairs.begin(), pairs.begin() + top_k, pairs.end(), greater);
+    pairs.resize(top_k);
+  }
+  std::sort(pairs.begin(), pairs.end(), greater);
+  indices->resize(pairs.size());
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    (*indices)[i] = pairs[i].second;
+  }
+}
+
+// Polygons have no vectorized IoU, they are compared one by one against
+// the kept boxes.
+template <typename T>
+static void GreedyPolyNMS(const T* boxes,
+                          int64_t box_stride,
+                          int box_size,
+                          const std::vector<int>& order,
+                          T nms_threshold,
+                          T eta,
+                          bool normalized,
+                          std::vector<int>* selected_indices) {
+  const bool is_poly = box_size == 8 || box_size == 16 || box_size == 24 ||
+                       box_size == 32;
+  T adaptive_threshold = nms_threshold;
+  for (int idx : order) {
+    bool keep = true;
+    for (size_t k = 0; keep && k < selected_indices->size(); ++k) {
+      const int kept_idx = (*selected_indices)[k];
+      T overlap = static_cast<T>(0.);
+      if (is_poly) {
+        overlap = PolyIoU<T>(boxes + idx * box_stride,
+                             boxes + kept_idx * box_stride,
+                             box_size,
+                             normalized);
+      }
+      keep = overlap <= adaptive_threshold;
+    }
+    if (keep) {
+      selected_indices->push_back(idx);
+      if (eta < 1 && adaptive_threshold > 0.5) {
+        adaptive_threshold *= eta;
+      }
+    }
+  }
+}
+
+template <typename T>
+void GreedyNMS(const T* boxes,
+               int64_t box_stride,
+               int box_size,
+               const T* scores,
+               int64_t score_stride,
+               int64_t num,
+               T score_threshold,
+               T nms_threshold,
+               T eta,
+               int64_t top_k,
+               bool normalized,
+               std::vector<int>* selected_indices) {
+  std::vector<int> order;
+  SortScoreIndex<T>(
+      scores, score_stride, num, score_threshold, top_k, &order);
+  selected_indices->clear();
+  if (box_size != 4) {
+    GreedyPolyNMS<T>(boxes,
+                     box_stride,
+                     box_size,
+                     order,
+                     nms_threshold,
+                     eta,
+                     normalized,
+                     selected_indices);
+    return;
+  }
+
+  const int n = static_cast<int>(order.size());
+  NMSBoxes<T> cands(normalized);
+  cands.Gather(boxes, box_stride, order.data(), n);
+  T iou[64];
+  if (eta >= 1 || nms_threshold <= 0.5) {
+    // The threshold is fixed, so each kept box suppresses the candidates
+    // behind it right away, 64 bits at a time. The bits of the candidates
+    // before it are already decided and set or not makes no difference.
+    const int words = (n + 63) / 64;
+    std::vector<uint64_t> suppressed(words, 0);
+    for (int i = 0; i < n; ++i) {
+      if ((suppressed[i >> 6] >> (i & 63)) & 1) continue;
+      selected_indices->push_back(order[i]);
+      for (int w = i >> 6; w < words; ++w) {
+        if (suppressed[w] == ~static_cast<uint64_t>(0)) continue;
+        const int begin = w << 6;
+        const int end = (std::min)(begin + 64, n);
+        cands.IoU(cands, i, begin, end, iou);
+        suppressed[w] |= OverlapBits(iou, end - begin, nms_threshold);
+      }
+    }
+    return;
+  }
+
+  // The threshold shrinks with every kept box, so a candidate is checked
+  // against the kept boxes with the threshold of its own turn, a block at a
+  // time so that an early overlap stops the scan.
+  const int kBlock = 64;
+  NMSBoxes<T> kept(normalized);
+  T adaptive_threshold = nms_threshold;
+  for (int i = 0; i < n; ++i) {
+    bool keep = true;
+    for (int b = 0; keep && b < kept.size(); b += kBlock) {
+      const int e = (std::min)(b + kBlock, kept.size());
+      kept.IoU(cands, i, b, e, iou);
+      for (int j = 0; j < e - b; ++j) {
+        keep = keep && iou[j] <= adaptive_threshold;
+      }
+    }
+    if (keep) {
+      selected_indices->push_back(order[i]);
+      kept.Push(cands, i);
+      if (adaptive_threshold > 0.5) {
+        adaptive_threshold *= eta;
+      }
+    }
+  }
+}
+
+template <typename T>
+void MatrixNMS(const T* boxes,
+               int64_t box_stride,
+               const T* scores,
+               int64_t score_stride,
+               int64_t num,
+               T score_threshold,
+               T post_threshold,
+               float sigma,
+               bool gaussian,
+               int64_t top_k,
+               bool normalized,
+               std::vector<int>* selected_indices,
+               std::vector<T>* decayed_scores) {
+  std::vector<int> order;
+  SortScoreIndex<T>(
+      scores, score_stride, num, score_threshold, top_k, &order);
+  const int n = static_cast<int>(order.size());
+  if (n <= 0) return;
+
+  NMSBoxes<T> cands(normalized);
+  cands.Gather(boxes, box_stride, order.data(), n);
+  // Row i of the lower triangle holds the IoU of box i with boxes [0, i).
+  std::vector<T> iou_matrix((static_cast<int64_t>(n) * (n - 1)) >> 1);
+  std::vector<T> iou_max(n);
+  iou_max[0] = 0.;
+  for (int i = 1; i < n; ++i) {
+    T* row = iou_matrix.data() + static_cast<int64_t>(i) * (i - 1) / 2;
+    cands.IoU(cands, i, 0, i, row);
+    T max_iou = 0.;
+    for (int j = 0; j < i; ++j) {
+      max_iou = (std::max)(max_iou, row[j]);
+    }
+    iou_max[i] = max_iou;
+  }
+
+  const T first_score = scores[order[0] * score_stride];
+  if (first_score > post_threshold) {
+    selected_indices->push_back(order[0]);
+    decayed_scores->push_back(first_score);
+  }
+  for (int i = 1; i < n; ++i) {
+    const T* row = iou_matrix.data() + static_cast<int64_t>(i) * (i - 1) / 2;
+    T min_decay = 1.;
+    for (int j = 0; j < i; ++j) {
+      const T max_iou = iou_max[j];
+      const T iou = row[j];
+      const T decay = gaussian
+                          ? std::exp((max_iou * max_iou - iou * iou) * sigma)
+                          : (1. - iou) / (1. - max_iou);
+      min_decay = (std::min)(min_decay, decay);
+    }
+    const T ds = min_decay * scores[order[i] * score_stride];
+    if (ds <= post_threshold) continue;
+    selected_indices->push_back(order[i]);
+    decayed_scores->push_back(ds);
+  }
+}
+
+template class NMSBoxes<float>;
+template void SortScoreIndex<float>(const float* scores,
+                                    int64_t stride,
+                                    int64_t num,
+                                    float threshold,
+                                    int64_t top_k,
+                                    std::vector<int>* indices);
+template void GreedyNMS<float>(const float* boxes,
+                               int64_t box_stride,
+                               int box_size,
+                               const float* scores,
+                               int64_t score_stride,
+                               int64_t num,
+                               float score_threshold,
+                               float nms_threshold,
+                               float eta,
+                               int64_t top_k,
+                               bool normalized,
+                               std::vector<int>* selected_indices);
+template void MatrixNMS<float>(const float* boxes,
+                               int64_t box_stride,
+                               const float* scores,
+                               int64_t score_stride,
+                               int64_t num,
+                               float score_threshold,
+                               float post_threshold,
+                               float sigma,
+                               bool gaussian,
+                               int64_t top_k,
+                               bool normalized,
+                               std::vector<int>* selected_indices,
+                               std::vector<float>* decayed_scores);
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,113 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// The NMS engine shared by multiclass_nms(2/3), matrix_nms and
+// retinanet_detection_output.
+//
+// The candidates of one class are sorted by score and their boxes are
+// gathered into a structure of arrays, so the IoU of one box against a run
+// of boxes is computed lane by lane. Greedy NMS keeps a bitmask of the
+// suppressed candidates: every kept box computes its IoU against the
+// candidates behind it once and marks the overlapped ones, so a suppressed
+// candidate costs nothing afterwards and no container is shifted.
+
+// Boxes [xmin, ymin, xmax, ymax] stored as a structure of arrays.
+template <typename T>
+class NMSBoxes {
+ public:
+  explicit NMSBoxes(bool normalized) : normalized_(normalized) {}
+
+  // Gathers the boxes at boxes + indices[i] * stride, i in [0, num).
+  void Gather(const T* boxes, int64_t stride, const int* indices, int num);
+  // Appends box i of `other`.
+  void Push(const NMSBoxes<T>& other, int i);
+
+  int size() const { return static_cast<int>(xmin_.size()); }
+
+  // iou[j - begin] = IoU(box i of `other`, box j), j in [begin, end).
+  // The result equals JaccardOverlap() in nms_util.h bit for bit.
+  void IoU(const NMSBoxes<T>& other, int i, int begin, int end, T* iou) const;
+
+ private:
+  bool normalized_;
+  std::vector<T> xmin_;
+  std::vector<T> ymin_;
+  std::vector<T> xmax_;
+  std::vector<T> ymax_;
+  std::vector<T> area_;
+};
+
+// Collects the indices i in [0, num) with scores[i * stride] > threshold,
+// sorted by score in descending order (ties keep their original order), and
+// keeps the first top_k of them if top_k > -1.
+template <typename T>
+void SortScoreIndex(const T* scores,
+                    int64_t stride,
+                    int64_t num,
+                    T threshold,
+                    int64_t top_k,
+                    std::vector<int>* indices);
+
+// Greedy NMS of the num boxes of one class. Box i starts at
+// boxes + i * box_stride and has box_size coordinates (4, or 8/16/24/32 for
+// polygons), its score is scores[i * score_stride]. Writes the kept indices
+// in descending order of score, same as the reference NMSFast: a candidate
+// is dropped when its IoU with a kept box is above the threshold, which is
+// multiplied by eta after every kept box while eta < 1 and it is above 0.5.
+template <typename T>
+void GreedyNMS(const T* boxes,
+               int64_t box_stride,
+               int box_size,
+               const T* scores,
+               int64_t score_stride,
+               int64_t num,
+               T score_threshold,
+               T nms_threshold,
+               T eta,
+               int64_t top_k,
+               bool normalized,
+               std::vector<int>* selected_indices);
+
+// Matrix NMS (SOLOv2) of the num boxes of one class laid out as in
+// GreedyNMS(). Appends the indices whose decayed score is above
+// post_threshold to selected_indices and the decayed scores to
+// decayed_scores, in descending order of the original score.
+template <typename T>
+void MatrixNMS(const T* boxes,
+               int64_t box_stride,
+               const T* scores,
+               int64_t score_stride,
+               int64_t num,
+               T score_threshold,
+               T post_threshold,
+               float sigma,
+               bool gaussian,
+               int64_t top_k,
+               bool normalized,
+               std::vector<int>* selected_indices,
+               std::vector<T>* decayed_scores);
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
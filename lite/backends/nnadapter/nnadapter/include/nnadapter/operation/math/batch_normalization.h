@@ -42,15 +42,25 @@ static int batch_normalization(const T* input_data,
   auto batch_size = input_shape[0];
   auto channel_size = input_shape[1];
   auto inner_size = shape_production(shape_slice(input_shape, 2, input_rank));
-  for (int bs = 0; bs < batch_size; bs++) {
-    for (int c = 0; c < channel_size; c++) {
-      for (int i = 0; i < inner_size; i++) {
-        *output_data++ = scale_data[c] * (*input_data++ - mean_data[c]) /
-                             sqrt(variance_data[c] + epsilon) +
-                         bias_data[c];
+  // The planes of the channels are computed in parallel
+  auto compute_planes = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int c = i % channel_size;
+      auto std_value = sqrt(variance_data[c] + epsilon);
+      const T* input_plane = input_data + i * inner_size;
+      T* output_plane = output_data + i * inner_size;
+      for (int64_t j = 0; j < inner_size; j++) {
+        output_plane[j] =
+            scale_data[c] * (input_plane[j] - mean_data[c]) / std_value +
+            bias_data[c];
       }
     }
-  }
+  };
+  parallel_for(
+      batch_size * channel_size,
+      compute_planes,
+      std::max<int64_t>(kParallelGrainSize / std::max<int64_t>(inner_size, 1),
+                        1));
   return 0;
 }
 
@@ -69,60 +69,80 @@ static int conv2d(const T* input_data,
                       1;
   auto output_channel_group = output_channel_size / group;
   auto input_channel_group = input_channel_size / group;
-  for (int bs = 0; bs < batch_size; bs++) {
-    for (int g = 0; g < group; g++) {
-      for (int oc = 0; oc < output_channel_group; oc++) {
-        for (int oh = 0; oh < output_height; oh++) {
-          for (int ow = 0; ow < output_width; ow++) {
-            int output_index =
-                bs * group * output_channel_group * output_height *
-                    output_width +
-                g * output_channel_group * output_height * output_width +
-                oc * output_height * output_width + oh * output_width + ow;
-            T output_value =
-                bias_data ? bias_data[g * output_channel_group + oc] : 0;
-            for (int ic = 0; ic < input_channel_group; ic++) {
-              for (int kh = 0; kh < kernel_height; kh++) {
-                for (int kw = 0; kw < kernel_width; kw++) {
-                  int iw =
-                      ow * stride_width - pad_width_left + kw * dilation_width;
-                  int ih = oh * stride_height - pad_height_top +
-                           kh * dilation_height;
-                  if (iw < 0 || iw >= input_width) continue;
-                  if (ih < 0 || ih >= input_height) continue;
-                  int input_index =
-                      bs * input_channel_size * input_height * input_width +
-                      g * input_channel_group * input_height * input_width +
-                      ic * input_height * input_width + ih * input_width + iw;
-                  int filter_index =
-                      g * output_channel_group * input_channel_group *
-                          kernel_height * kernel_width +
-                      oc * input_channel_group * kernel_height * kernel_width +
-                      ic * kernel_height * kernel_width + kh * kernel_width +
-                      kw;
-                  output_value +=
-                      input_data[input_index] * filter_data[filter_index];
+  if (fuse_code != FUSE_NONE && fuse_code != FUSE_RELU &&
+      fuse_code != FUSE_RELU1 && fuse_code != FUSE_RELU6) {
+    return -1;
+  }
+  int64_t input_plane_size = input_height * input_width;
+  int64_t output_plane_size = output_height * output_width;
+  int64_t filter_size = input_channel_group * kernel_height * kernel_width;
+  // The output planes are computed in parallel, every one of them accumulates
+  // the input rows of all of the kernel taps, which are contiguous if the
+  // stride of the width is 1
+  auto compute_output_planes = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int bs = i / output_channel_size;
+      int oc = i % output_channel_size;
+      int g = oc / output_channel_group;
+      T* output_plane = output_data + i * output_plane_size;
+      T bias_value = bias_data ? bias_data[oc] : 0;
+      for (int64_t j = 0; j < output_plane_size; j++) {
+        output_plane[j] = bias_value;
+      }
+      const T* filter_ptr = filter_data + oc * filter_size;
+      for (int ic = 0; ic < input_channel_group; ic++) {
+        const T* input_plane =
+            input_data +
+            (bs * input_channel_size + g * input_channel_group + ic) *
+                input_plane_size;
+        for (int kh = 0; kh < kernel_height; kh++) {
+          for (int kw = 0; kw < kernel_width; kw++) {
+            T filter_value = *filter_ptr++;
+            // The range of ow which reads 0 <= iw < input_width
+            int iw_offset = kw * dilation_width - pad_width_left;
+            int ow_begin = iw_offset >= 0
+                               ? 0
+                               : (-iw_offset + stride_width - 1) / stride_width;
+            int ow_end =
+                input_width - iw_offset <= 0
+                    ? 0
+                    : std::min(output_width,
+                               (input_width - iw_offset + stride_width - 1) /
+                                   stride_width);
+            if (ow_begin >= ow_end) continue;
+            for (int oh = 0; oh < output_height; oh++) {
+              int ih =
+                  oh * stride_height - pad_height_top + kh * dilation_height;
+              if (ih < 0 || ih >= input_height) continue;
+              const T* input_row = input_plane + ih * input_width;
+              T* output_row = output_plane + oh * output_width;
+              if (stride_width == 1) {
+                for (int ow = ow_begin; ow < ow_end; ow++) {
+                  output_row[ow] += filter_value * input_row[ow + iw_offset];
+                }
+              } else {
+                for (int ow = ow_begin; ow < ow_end; ow++) {
+                  output_row[ow] +=
+                      filter_value * input_row[ow * stride_width + iw_offset];
                 }
               }
             }
-            if (fuse_code == FUSE_RELU) {
-              output_value = output_value > 0 ? output_value : 0;
-            } else if (fuse_code == FUSE_RELU1) {
-              output_value = std::min(std::max(static_cast<T>(0), output_value),
-                                      static_cast<T>(1));
-            } else if (fuse_code == FUSE_RELU6) {
-              output_value = std::min(std::max(static_cast<T>(0), output_value),
-                                      static_cast<T>(6));
-            } else if (fuse_code == FUSE_NONE) {
-            } else {
-              return -1;
-            }
-            output_data[output_index] = output_value;
           }
         }
       }
+      if (fuse_code == FUSE_NONE) continue;
+      T max_value = fuse_code == FUSE_RELU1
+                        ? static_cast<T>(1)
+                        : (fuse_code == FUSE_RELU6
+                               ? static_cast<T>(6)
+                               : std::numeric_limits<T>::max());
+      for (int64_t j = 0; j < output_plane_size; j++) {
+        output_plane[j] = std::min(
+            std::max(static_cast<T>(0), output_plane[j]), max_value);
+      }
     }
-  }
+  };
+  parallel_for(batch_size * output_channel_size, compute_output_planes);
   return 0;
 }
 
@@ -40,74 +40,94 @@ static int elementwise(ElementwiseTypeCode eltwise_type,
   }
   auto output_shape = shape_broadcast(input0_shape, input1_shape);
   auto output_count = shape_production(output_shape);
-  std::vector<T> broadcasted_input0_data(output_count);
-  broadcast<T>(
-      input0_data, input0_shape, output_shape, broadcasted_input0_data.data());
-  std::vector<T> broadcasted_input1_data(output_count);
-  broadcast<T>(
-      input1_data, input1_shape, output_shape, broadcasted_input1_data.data());
-  if (eltwise_type == ADD) {
-    for (int64_t i = 0; i < output_count; i++) {
-      output_data[i] = broadcasted_input0_data[i] + broadcasted_input1_data[i];
-    }
-  } else if (eltwise_type == SUB) {
-    for (int64_t i = 0; i < output_count; i++) {
-      output_data[i] = broadcasted_input0_data[i] - broadcasted_input1_data[i];
-    }
-  } else if (eltwise_type == MUL) {
-    for (int64_t i = 0; i < output_count; i++) {
-      output_data[i] = broadcasted_input0_data[i] * broadcasted_input1_data[i];
-    }
-  } else if (eltwise_type == FLOOR_DIV) {
-    for (int64_t i = 0; i < output_count; i++) {
-      output_data[i] = static_cast<T>(
-          ::trunc(broadcasted_input0_data[i] / broadcasted_input1_data[i]));
-    }
-  } else if (eltwise_type == DIV) {
-    for (int64_t i = 0; i < output_count; i++) {
-      output_data[i] = broadcasted_input0_data[i] / broadcasted_input1_data[i];
-    }
-  } else if (eltwise_type == MAX) {
-    for (int64_t i = 0; i < output_count; i++) {
-      output_data[i] = broadcasted_input0_data[i] > broadcasted_input1_data[i]
-                           ? broadcasted_input0_data[i]
-                           : broadcasted_input1_data[i];
-    }
-  } else if (eltwise_type == MIN) {
-    for (int64_t i = 0; i < output_count; i++) {
-      output_data[i] = broadcasted_input0_data[i] > broadcasted_input1_data[i]
-                           ? broadcasted_input1_data[i]
-                           : broadcasted_input0_data[i];
-    }
-  } else if (eltwise_type == POW) {
-    for (int64_t i = 0; i < output_count; i++) {
-      output_data[i] =
-          ::pow(broadcasted_input0_data[i], broadcasted_input1_data[i]);
-    }
-  } else {
+  // Only the inputs of the other shapes than the output are broadcasted
+  std::vector<T> broadcasted_input0_data;
+  if (input0_shape != output_shape) {
+    broadcasted_input0_data.resize(output_count);
+    broadcast<T>(input0_data,
+                 input0_shape,
+                 output_shape,
+                 broadcasted_input0_data.data());
+    input0_data = broadcasted_input0_data.data();
+  }
+  std::vector<T> broadcasted_input1_data;
+  if (input1_shape != output_shape) {
+    broadcasted_input1_data.resize(output_count);
+    broadcast<T>(input1_data,
+                 input1_shape,
+                 output_shape,
+                 broadcasted_input1_data.data());
+    input1_data = broadcasted_input1_data.data();
+  }
+  if (eltwise_type != ADD && eltwise_type != SUB && eltwise_type != MUL &&
+      eltwise_type != FLOOR_DIV && eltwise_type != DIV &&
+      eltwise_type != MAX && eltwise_type != MIN && eltwise_type != POW) {
     return -1;
   }
-  if (fuse_code == FUSE_RELU) {
-    for (int64_t i = 0; i < output_count; i++) {
-      auto output_value = output_data[i];
-      output_data[i] = output_value > 0 ? output_value : 0;
-    }
-  } else if (fuse_code == FUSE_RELU1) {
-    for (int64_t i = 0; i < output_count; i++) {
-      auto output_value = output_data[i];
-      output_data[i] = std::min(std::max(static_cast<T>(0), output_value),
-                                static_cast<T>(1));
-    }
-  } else if (fuse_code == FUSE_RELU6) {
-    for (int64_t i = 0; i < output_count; i++) {
-      auto output_value = output_data[i];
-      output_data[i] = std::min(std::max(static_cast<T>(0), output_value),
-                                static_cast<T>(6));
-    }
-  } else if (fuse_code == FUSE_NONE) {
-  } else {
+  if (fuse_code != FUSE_NONE && fuse_code != FUSE_RELU &&
+      fuse_code != FUSE_RELU1 && fuse_code != FUSE_RELU6) {
     return -1;
   }
+  T max_value = fuse_code == FUSE_RELU1
+                    ? static_cast<T>(1)
+                    : (fuse_code == FUSE_RELU6 ? static_cast<T>(6)
+                                               : std::numeric_limits<T>::max());
+  // The blocks of the elements are computed in parallel
+  auto compute_elements = [&](int64_t begin, int64_t end) {
+    switch (eltwise_type) {
+      case ADD:
+        for (int64_t i = begin; i < end; i++) {
+          output_data[i] = input0_data[i] + input1_data[i];
+        }
+        break;
+      case SUB:
+        for (int64_t i = begin; i < end; i++) {
+          output_data[i] = input0_data[i] - input1_data[i];
+        }
+        break;
+      case MUL:
+        for (int64_t i = begin; i < end; i++) {
+          output_data[i] = input0_data[i] * input1_data[i];
+        }
+        break;
+      case FLOOR_DIV:
+        for (int64_t i = begin; i < end; i++) {
+          output_data[i] =
+              static_cast<T>(::trunc(input0_data[i] / input1_data[i]));
+        }
+        break;
+      case DIV:
+        for (int64_t i = begin; i < end; i++) {
+          output_data[i] = input0_data[i] / input1_data[i];
+        }
+        break;
+      case MAX:
+        for (int64_t i = begin; i < end; i++) {
+          output_data[i] = input0_data[i] > input1_data[i] ? input0_data[i]
+                                                           : input1_data[i];
+        }
+        break;
+      case MIN:
+        for (int64_t i = begin; i < end; i++) {
+          output_data[i] = input0_data[i] > input1_data[i] ? input1_data[i]
+                                                           : input0_data[i];
+        }
+        break;
+      case POW:
+        for (int64_t i = begin; i < end; i++) {
+          output_data[i] = ::pow(input0_data[i], input1_data[i]);
+        }
+        break;
+      default:
+        break;
+    }
+    if (fuse_code == FUSE_NONE) return;
+    for (int64_t i = begin; i < end; i++) {
+      output_data[i] =
+          std::min(std::max(static_cast<T>(0), output_data[i]), max_value);
+    }
+  };
+  parallel_for(output_count, compute_elements, kParallelGrainSize);
   return 0;
 }
 
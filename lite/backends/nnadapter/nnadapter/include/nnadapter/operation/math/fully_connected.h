@@ -51,29 +51,44 @@ static int fully_connected(const T* input_data,
   }
   std::vector<int32_t> output_shape = {static_cast<int32_t>(batch_size),
                                        num_units};
-  for (int m = 0; m < batch_size; m++) {
-    for (int n = 0; n < num_units; n++) {
-      T output_value = bias_data ? bias_data[n] : 0;
-      for (int k = 0; k < input_size; k++) {
-        output_value +=
-            input_data[m * input_size + k] * weight_data[n * input_size + k];
-      }
-      if (fuse_code == FUSE_RELU) {
-        output_value = output_value > 0 ? output_value : 0;
-      } else if (fuse_code == FUSE_RELU1) {
-        output_value = std::min(std::max(static_cast<T>(0), output_value),
-                                static_cast<T>(1));
-      } else if (fuse_code == FUSE_RELU6) {
-        output_value = std::min(std::max(static_cast<T>(0), output_value),
-                                static_cast<T>(6));
-      } else if (fuse_code == FUSE_NONE) {
-      } else {
-        return -1;
+  if (fuse_code != FUSE_NONE && fuse_code != FUSE_RELU &&
+      fuse_code != FUSE_RELU1 && fuse_code != FUSE_RELU6) {
+    return -1;
+  }
+  T max_value = fuse_code == FUSE_RELU1
+                    ? static_cast<T>(1)
+                    : (fuse_code == FUSE_RELU6 ? static_cast<T>(6)
+                                               : std::numeric_limits<T>::max());
+  // The units are computed in parallel, every row of the weight is read once
+  // for all of the batches, and the products are summed in 8 lanes which can
+  // be vectorized
+  parallel_for(num_units, [&](int64_t begin, int64_t end) {
+    for (int64_t n = begin; n < end; n++) {
+      const T* weight_row = weight_data + n * input_size;
+      for (int m = 0; m < batch_size; m++) {
+        const T* input_row = input_data + m * input_size;
+        T sums[8] = {0};
+        int k = 0;
+        for (; k + 8 <= input_size; k += 8) {
+          for (int j = 0; j < 8; j++) {
+            sums[j] += input_row[k + j] * weight_row[k + j];
+          }
+        }
+        T output_value = bias_data ? bias_data[n] : 0;
+        for (int j = 0; j < 8; j++) {
+          output_value += sums[j];
+        }
+        for (; k < input_size; k++) {
+          output_value += input_row[k] * weight_row[k];
+        }
+        if (fuse_code != FUSE_NONE) {
+          output_value =
+              std::min(std::max(static_cast<T>(0), output_value), max_value);
+        }
+        output_data[m * num_units + n] = output_value;
       }
-      auto output_index = m * num_units + n;
-      output_data[output_index] = output_value;
     }
-  }
+  });
   return 0;
 }
 
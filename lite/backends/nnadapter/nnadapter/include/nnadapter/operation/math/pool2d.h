@@ -61,8 +61,15 @@ static int average_pool2d(const T* input_data,
                        kernel_width + (ceil_mode ? stride_width - 1 : 0)) /
                           stride_width +
                       1;
-  for (int bs = 0; bs < batch_size; bs++) {
-    for (int c = 0; c < input_channel_size; c++) {
+  if (fuse_code != FUSE_NONE && fuse_code != FUSE_RELU &&
+      fuse_code != FUSE_RELU1 && fuse_code != FUSE_RELU6) {
+    return -1;
+  }
+  // The output planes are computed in parallel
+  auto compute_output_planes = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int bs = i / input_channel_size;
+      int c = i % input_channel_size;
       for (int h = 0; h < output_height; h++) {
         auto sh = h * stride_height;
         auto eh = sh + kernel_height;
@@ -104,9 +111,6 @@ static int average_pool2d(const T* input_data,
           } else if (fuse_code == FUSE_RELU6) {
             output_value = std::min(std::max(static_cast<T>(0), output_value),
                                     static_cast<T>(6));
-          } else if (fuse_code == FUSE_NONE) {
-          } else {
-            return -1;
           }
           auto output_index =
               bs * output_channel_size * output_height * output_width +
@@ -115,7 +119,8 @@ static int average_pool2d(const T* input_data,
         }
       }
     }
-  }
+  };
+  parallel_for(batch_size * input_channel_size, compute_output_planes);
   return 0;
 }
 
@@ -172,8 +177,15 @@ int max_pool2d(const T* input_data,
                        kernel_width + (ceil_mode ? stride_width - 1 : 0)) /
                           stride_width +
                       1;
-  for (int bs = 0; bs < batch_size; bs++) {
-    for (int c = 0; c < input_channel_size; c++) {
+  if (fuse_code != FUSE_NONE && fuse_code != FUSE_RELU &&
+      fuse_code != FUSE_RELU1 && fuse_code != FUSE_RELU6) {
+    return -1;
+  }
+  // The output planes are computed in parallel
+  auto compute_output_planes = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int bs = i / input_channel_size;
+      int c = i % input_channel_size;
       for (int h = 0; h < output_height; h++) {
         auto sh = h * stride_height;
         auto eh = sh + kernel_height;
@@ -211,9 +223,6 @@ int max_pool2d(const T* input_data,
           } else if (fuse_code == FUSE_RELU6) {
             output_value = std::min(std::max(static_cast<T>(0), output_value),
                                     static_cast<T>(6));
-          } else if (fuse_code == FUSE_NONE) {
-          } else {
-            return -1;
           }
           auto output_index =
               bs * output_channel_size * output_height * output_width +
@@ -222,7 +231,8 @@ int max_pool2d(const T* input_data,
         }
       }
     }
-  }
+  };
+  parallel_for(batch_size * input_channel_size, compute_output_planes);
   return 0;
 }
 
@@ -43,30 +43,37 @@ static int softmax(const T* input_data,
   auto inner_count =
       shape_production(shape_slice(input_shape, axis + 1, input_rank));
   auto compute_count = outer_count * inner_count;
-  for (int64_t i = 0; i < compute_count; i++) {
-    auto inner_index = i % inner_count;
-    auto outer_index = (i / inner_count) * axis_count;
-    auto start = outer_index * inner_count + inner_index;
-    auto offset = start;
-    auto max_value = std::numeric_limits<T>::lowest();
-    for (int j = 0; j < axis_count; j++) {
-      max_value =
-          input_data[offset] > max_value ? input_data[offset] : max_value;
-      offset += inner_count;
+  // Every slice along the axis is computed by a thread alone
+  auto compute_slices = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      auto inner_index = i % inner_count;
+      auto outer_index = (i / inner_count) * axis_count;
+      auto start = outer_index * inner_count + inner_index;
+      auto offset = start;
+      auto max_value = std::numeric_limits<T>::lowest();
+      for (int j = 0; j < axis_count; j++) {
+        max_value =
+            input_data[offset] > max_value ? input_data[offset] : max_value;
+        offset += inner_count;
+      }
+      offset = start;
+      T sum_value = 0;
+      for (int j = 0; j < axis_count; j++) {
+        output_data[offset] = exp(input_data[offset] - max_value);
+        sum_value += output_data[offset];
+        offset += inner_count;
+      }
+      offset = start;
+      for (int j = 0; j < axis_count; j++) {
+        output_data[offset] /= sum_value;
+        offset += inner_count;
+      }
     }
-    offset = start;
-    T sum_value = 0;
-    for (int j = 0; j < axis_count; j++) {
-      output_data[offset] = exp(input_data[offset] - max_value);
-      sum_value += output_data[offset];
-      offset += inner_count;
-    }
-    offset = start;
-    for (int j = 0; j < axis_count; j++) {
-      output_data[offset] /= sum_value;
-      offset += inner_count;
-    }
-  }
+  };
+  parallel_for(
+      compute_count,
+      compute_slices,
+      std::max<int64_t>(kParallelGrainSize / std::max(axis_count, 1), 1));
   return 0;
 }
 
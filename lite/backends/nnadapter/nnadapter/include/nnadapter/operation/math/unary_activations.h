@@ -35,19 +35,23 @@ static int unary_activations(ActivationTypeCode act_type,
     return -1;
   }
   auto input_count = shape_production(input_shape);
+  T max_value;
   if (act_type == RELU) {
-    for (int64_t i = 0; i < input_count; i++) {
-      output_data[i] = std::max(static_cast<T>(0), input_data[i]);
-    }
-    return 0;
+    max_value = std::numeric_limits<T>::max();
   } else if (act_type == RELU6) {
-    for (int64_t i = 0; i < input_count; i++) {
-      output_data[i] = std::min(static_cast<T>(6),
-                                std::max(static_cast<T>(0), input_data[i]));
-    }
-    return 0;
+    max_value = static_cast<T>(6);
+  } else {
+    return -1;
   }
-  return -1;
+  // The blocks of the elements are computed in parallel
+  auto compute_elements = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      output_data[i] =
+          std::min(max_value, std::max(static_cast<T>(0), input_data[i]));
+    }
+  };
+  parallel_for(input_count, compute_elements, kParallelGrainSize);
+  return 0;
 }
 
 int unary_activations(ActivationTypeCode act_type,
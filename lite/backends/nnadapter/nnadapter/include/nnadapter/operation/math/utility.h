@@ -17,6 +17,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <sys/cdefs.h>
+#include <functional>
 #include <vector>
 
 namespace nnadapter {
@@ -73,6 +74,23 @@ std::vector<int32_t> shape_broadcast(const std::vector<int32_t>& input0_shape,
 // Get the strides of the shape
 std::vector<int64_t> shape_strides(const std::vector<int32_t>& input_shape);
 
+// Set the number of threads of the math functions for the calling thread, 0 or
+// 1 means running in the calling thread only
+void set_num_threads(int num_threads);
+int get_num_threads();
+
+// Split [0, count) into contiguous ranges of at least grain_size and call
+// func(begin, end) for each of them, they are run by a shared thread pool if
+// more than one thread is set, or in the calling thread alone while the pool
+// is busy with another caller
+void parallel_for(int64_t count,
+                  const std::function<void(int64_t, int64_t)>& func,
+                  int64_t grain_size = 1);
+
+// The minimum number of elements computed by a thread in the element-wise math
+// functions, below which waking the workers costs more than it saves
+const int64_t kParallelGrainSize = 16384;
+
 }  // namespace math
 }  // namespace operation
 }  // namespace nnadapter
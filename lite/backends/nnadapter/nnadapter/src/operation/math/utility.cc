@@ -13,6 +13,11 @@
 // limitations under the License.
 
 #include "operation/math/utility.h"
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 
 namespace nnadapter {
 namespace operation {
@@ -65,6 +70,100 @@ std::vector<int64_t> shape_strides(const std::vector<int32_t>& input_shape) {
   return input_strides;
 }
 
+static thread_local int num_threads_ = 0;
+// Whether the calling thread is a worker of the thread pool, the nested
+// parallel_for runs in it directly
+static thread_local bool is_worker_ = false;
+
+void set_num_threads(int num_threads) { num_threads_ = num_threads; }
+
+int get_num_threads() { return num_threads_; }
+
+// The workers are created on demand and wait for the tasks, a task is split
+// among the workers and the calling thread, which waits for all of them.
+class ThreadPool {
+ public:
+  static ThreadPool& Global() {
+    static ThreadPool* thread_pool = new ThreadPool();
+    return *thread_pool;
+  }
+
+  // Return false without running the task if the pool is running another one
+  bool TryRun(int num_threads, const std::function<void(int)>& task) {
+    // Only one task is running at a time
+    std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+    if (!run_lock.owns_lock()) return false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (static_cast<int>(workers_.size()) < num_threads - 1) {
+        int index = workers_.size();
+        workers_.emplace_back([this, index]() { Work(index); });
+      }
+      task_ = &task;
+      active_count_ = num_threads - 1;
+      pending_count_ = active_count_;
+      generation_++;
+    }
+    cv_.notify_all();
+    task(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return pending_count_ == 0; });
+    task_ = nullptr;
+    return true;
+  }
+
+ private:
+  void Work(int index) {
+    is_worker_ = true;
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [&]() { return generation_ != generation; });
+      generation = generation_;
+      if (index >= active_count_) continue;
+      auto task = task_;
+      lock.unlock();
+      (*task)(index + 1);
+      lock.lock();
+      if (--pending_count_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable done_cv_;
+  // The pool is never destroyed, so the workers live as long as the process
+  std::vector<std::thread> workers_;
+  const std::function<void(int)>* task_{nullptr};
+  int active_count_{0};
+  int pending_count_{0};
+  uint64_t generation_{0};
+};
+
+void parallel_for(int64_t count,
+                  const std::function<void(int64_t, int64_t)>& func,
+                  int64_t grain_size) {
+  if (count <= 0) return;
+  grain_size = std::max<int64_t>(grain_size, 1);
+  int num_threads = static_cast<int>(std::min<int64_t>(
+      std::max(num_threads_, 1), (count + grain_size - 1) / grain_size));
+  if (num_threads == 1 || is_worker_) {
+    func(0, count);
+    return;
+  }
+  bool done = ThreadPool::Global().TryRun(num_threads, [&](int index) {
+    int64_t begin = count * index / num_threads;
+    int64_t end = count * (index + 1) / num_threads;
+    if (begin < end) func(begin, end);
+  });
+  // The pool is busy with the task of another program running on another
+  // thread, run in the calling thread rather than waiting for it
+  if (!done) func(0, count);
+}
+
 }  // namespace math
 }  // namespace operation
 }  // namespace nnadapter
@@ -15,10 +15,14 @@
 #include "runtime/device.h"
 #include <dlfcn.h>
 #include <stdlib.h>
+#include <map>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
+#include "operation/math/utility.h"
+#include "optimizer/constant_fold_operations.h"
 #include "optimizer/fuse_conv2d_activation_into_conv2d.h"
 #include "optimizer/fuse_conv2d_add_into_conv2d.h"
 #include "optimizer/fuse_conv2d_batch_norm_into_conv2d.h"
@@ -35,6 +39,9 @@
 // Specify the number of threads to use in thread pool, no thread
 // pool/single-thread is used as default(default value is 0).
 #define BUILTIN_DEVICE_NUM_THREADS "BUILTIN_DEVICE_NUM_THREADS"
+// Whether the temporary operands share the buffers of the released ones,
+// otherwise every one of them keeps its own buffer(default value is true).
+#define BUILTIN_DEVICE_REUSE_BUFFERS "BUILTIN_DEVICE_REUSE_BUFFERS"
 
 #define REGISTER_OPERATION(__op_type__,                                    \
                            __validate_func_name__,                         \
@@ -65,12 +72,14 @@ class Device {
 class Context {
  public:
   explicit Context(void* device, const char* properties);
-  bool num_threads() { return num_threads_; }
+  int num_threads() { return num_threads_; }
+  bool reuse_buffers() { return reuse_buffers_; }
   ~Context() {}
 
  private:
   void* device_{nullptr};
   int num_threads_{0};
+  bool reuse_buffers_{true};
 };
 
 Context::Context(void* device, const char* properties) : device_(device) {
@@ -86,6 +95,14 @@ Context::Context(void* device, const char* properties) : device_(device) {
     num_threads_ = GetIntFromEnv(BUILTIN_DEVICE_NUM_THREADS, 0);
   }
   NNADAPTER_LOG(INFO) << "num_threads: " << num_threads_;
+  // BUILTIN_DEVICE_REUSE_BUFFERS
+  if (key_values.count(BUILTIN_DEVICE_REUSE_BUFFERS)) {
+    reuse_buffers_ =
+        string_parse<bool>(key_values[BUILTIN_DEVICE_REUSE_BUFFERS]);
+  } else {
+    reuse_buffers_ = GetBoolFromEnv(BUILTIN_DEVICE_REUSE_BUFFERS, true);
+  }
+  NNADAPTER_LOG(INFO) << "reuse_buffers: " << reuse_buffers_;
 }
 
 class Program {
@@ -104,6 +121,7 @@ class Program {
 
  private:
   void Clear() {
+    ReleaseBuffers();
     if (model_.second && model_.first) {
       ClearModel(model_.first);
       delete model_.first;
@@ -111,7 +129,14 @@ class Program {
       model_.second = false;
     }
     operations_.clear();
-  }
+    released_operands_.clear();
+  }
+  // Find the temporary operands which can be released after each operation,
+  // whose buffers are reused by the following operations
+  void PlanTemporaryOperands();
+  void* AcquireBuffer(core::Operand* operand, size_t length);
+  void ReleaseBuffer(core::Operand* operand);
+  void ReleaseBuffers();
   int CheckInputsAndOutputs(uint32_t input_count,
                             core::Argument* input_arguments,
                             uint32_t output_count,
@@ -121,8 +146,84 @@ class Program {
   Context* context_{nullptr};
   std::pair<core::Model*, bool> model_;
   std::vector<core::Operation*> operations_;
+  std::vector<std::vector<core::Operand*>> released_operands_;
+  // The buffers of the temporary operands by their sizes, which are kept
+  // until the program is destroyed
+  std::multimap<size_t, void*> free_buffers_;
+  std::unordered_map<core::Operand*, std::pair<size_t, void*>> used_buffers_;
 };
 
+void Program::PlanTemporaryOperands() {
+  auto is_temporary_operand = [](core::Operand* operand) {
+    return operand && (IsTemporaryVariableOperand(operand) ||
+                       IsTemporaryShapeOperand(operand));
+  };
+  std::unordered_map<core::Operand*, size_t> last_operation_indexes;
+  for (size_t i = 0; i < operations_.size(); i++) {
+    for (auto operand : operations_[i]->input_operands) {
+      if (is_temporary_operand(operand)) last_operation_indexes[operand] = i;
+    }
+    // The outputs without consumers are released at once
+    for (auto operand : operations_[i]->output_operands) {
+      if (is_temporary_operand(operand) &&
+          !last_operation_indexes.count(operand)) {
+        last_operation_indexes[operand] = i;
+      }
+    }
+  }
+  released_operands_.assign(operations_.size(), {});
+  // The temporary operands are kept until the program is destroyed
+  if (!context_->reuse_buffers()) return;
+  for (auto& last_operation_index : last_operation_indexes) {
+    released_operands_[last_operation_index.second].push_back(
+        last_operation_index.first);
+  }
+}
+
+void* Program::AcquireBuffer(core::Operand* operand, size_t length) {
+  // The smallest free buffer not less than the length, or a new one
+  std::pair<size_t, void*> buffer;
+  auto it = free_buffers_.lower_bound(length);
+  if (it != free_buffers_.end()) {
+    buffer = *it;
+    free_buffers_.erase(it);
+  } else {
+    buffer = std::make_pair(length, malloc(length));
+    NNADAPTER_CHECK(buffer.second) << "Failed to allocate " << length
+                                   << " bytes, out of memory!";
+  }
+  used_buffers_[operand] = buffer;
+  // The operand gets its own size rather than the capacity of the buffer,
+  // which is only known by the pool
+  operand->buffer = buffer.second;
+  operand->length = length;
+  return buffer.second;
+}
+
+void Program::ReleaseBuffer(core::Operand* operand) {
+  auto it = used_buffers_.find(operand);
+  if (it == used_buffers_.end()) return;
+  free_buffers_.insert(it->second);
+  used_buffers_.erase(it);
+  // The operands don't own the buffers of the pool, which mustn't be freed by
+  // ClearModel
+  operand->buffer = nullptr;
+  operand->length = 0;
+}
+
+void Program::ReleaseBuffers() {
+  for (auto& used_buffer : used_buffers_) {
+    used_buffer.first->buffer = nullptr;
+    used_buffer.first->length = 0;
+    free(used_buffer.second.second);
+  }
+  used_buffers_.clear();
+  for (auto& free_buffer : free_buffers_) {
+    free(free_buffer.second);
+  }
+  free_buffers_.clear();
+}
+
 int Program::Validate(const core::Model* model, bool* supported_operations) {
   std::unordered_map<const core::Operation*, size_t> operation_to_index;
   size_t operation_index = 0;
@@ -174,6 +275,7 @@ int Program::Build(core::Model* model, core::Cache* cache) {
     NNADAPTER_VLOG(5) << "Cached model:" << std::endl << Visualize(model);
   } else {
     // Build from model
+    ConstantFoldOperations(model);
     FuseConv2DBatchNormIntoConv2D(model);
     FuseConv2DAddIntoConv2D(model);
     FuseConv2DActivationIntoConv2D(model);
@@ -195,6 +297,7 @@ int Program::Build(core::Model* model, core::Cache* cache) {
     }
   }
   operations_ = SortOperationsInTopologicalOrder(model);
+  PlanTemporaryOperands();
   NNADAPTER_VLOG(3) << "Build success.";
   return NNADAPTER_NO_ERROR;
 }
@@ -241,9 +344,24 @@ int Program::Execute(uint32_t input_count,
     operand->buffer = buffer;
     operand->length = GetOperandTypeBufferLength(*type);
   }
-  for (auto& operation : operations_) {
+  auto start_time = GetCurrentUS();
+  operation::math::set_num_threads(context_->num_threads());
+  for (size_t i = 0; i < operations_.size(); i++) {
+    auto operation = operations_[i];
     NNADAPTER_VLOG(5) << "Running " << OperationTypeToString(operation->type)
                       << " ...";
+    // The temporary outputs take the free buffers of the pool once their
+    // dimensions are inferred
+    auto acquire_buffers = [&]() {
+      for (auto operand : operation->output_operands) {
+        if (!IsTemporaryVariableOperand(operand) &&
+            !IsTemporaryShapeOperand(operand)) {
+          continue;
+        }
+        ReleaseBuffer(operand);
+        AcquireBuffer(operand, GetOperandTypeBufferLength(operand->type));
+      }
+    };
     switch (operation->type) {
 #define REGISTER_OPERATION(__op_type__,                            \
                            __validate_func_name__,                 \
@@ -252,6 +370,7 @@ int Program::Execute(uint32_t input_count,
   case NNADAPTER_##__op_type__:                                    \
     NNADAPTER_CHECK(operation::__prepare_func_name__(operation) == \
                     NNADAPTER_NO_ERROR);                           \
+    acquire_buffers();                                             \
     NNADAPTER_CHECK(operation::__execute_func_name__(operation) == \
                     NNADAPTER_NO_ERROR);                           \
     break;
@@ -264,6 +383,9 @@ int Program::Execute(uint32_t input_count,
                              << ") is found.";
         break;
     }
+    for (auto operand : released_operands_[i]) {
+      ReleaseBuffer(operand);
+    }
   }
   for (uint32_t i = 0; i < output_count; i++) {
     auto& arg = output_arguments[i];
@@ -278,7 +400,6 @@ int Program::Execute(uint32_t input_count,
     NNADAPTER_CHECK(buffer);
     memcpy(buffer, operand->buffer, length);
   }
-  auto start_time = GetCurrentUS();
   NNADAPTER_VLOG(3) << "Process cost " << GetCurrentUS() - start_time << " us";
   return NNADAPTER_NO_ERROR;
 }
@@ -320,7 +441,7 @@ int CreateContext(void* device,
 }
 
 void DestroyContext(void* context) {
-  if (!context) {
+  if (context) {
     auto c = reinterpret_cast<Context*>(context);
     delete c;
   }
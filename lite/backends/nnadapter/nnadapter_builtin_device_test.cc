@@ -0,0 +1,282 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/backends/nnadapter/nnadapter_wrapper.h"
+
+namespace paddle {
+namespace lite {
+
+static const std::vector<int32_t> kInputShape = {2, 8, 48, 48};
+
+static std::vector<float> RandomData(size_t size, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  std::vector<float> data(size);
+  for (auto& value : data) value = distribution(rng);
+  return data;
+}
+
+static void* AccessInput(void* memory,
+                         NNAdapterOperandType* type,
+                         void* device_buffer) {
+  type->dimensions.count = kInputShape.size();
+  for (size_t i = 0; i < kInputShape.size(); i++) {
+    type->dimensions.data[i] = kInputShape[i];
+  }
+  return reinterpret_cast<std::vector<float>*>(memory)->data();
+}
+
+static void* AccessOutput(void* memory,
+                          NNAdapterOperandType* type,
+                          void* device_buffer) {
+  size_t size = 1;
+  for (uint32_t i = 0; i < type->dimensions.count; i++) {
+    size *= type->dimensions.data[i];
+  }
+  auto data = reinterpret_cast<std::vector<float>*>(memory);
+  data->resize(size);
+  return data->data();
+}
+
+// Runs the following model on the builtin device,
+//   t0 = conv2d(x)           read by t1 and y
+//   t1 = relu(t0)            read by dead, t2 and t3
+//   dead = sub(t1, x)        a temporary without any consumer
+//   t2 = mul(t1, x)
+//   y = add(t0, t2), relu6   output 0
+//   t3 = avg_pool2d(t1)
+//   z = softmax(t3)          output 1
+// If t0 were released after relu, its buffer would be taken by dead and t2
+// before add reads it. All of the temporaries have the same size, so that
+// the pool reuses any released buffer for the next one.
+class BuiltinDeviceProgram {
+ public:
+  explicit BuiltinDeviceProgram(const std::string& properties)
+      : filter_(RandomData(8 * 8 * 3 * 3, 1)), bias_(RandomData(8, 2)) {
+    EXPECT_EQ(NNAdapterDevice_acquire_invoke("builtin_device", &device_),
+              NNADAPTER_NO_ERROR);
+    EXPECT_EQ(NNAdapterContext_create_invoke(
+                  &device_, 1, properties.c_str(), nullptr, &context_),
+              NNADAPTER_NO_ERROR);
+    EXPECT_EQ(NNAdapterModel_create_invoke(&model_), NNADAPTER_NO_ERROR);
+    auto x = AddTensor(kInputShape);
+    auto t0 = AddTensor(kInputShape);
+    AddOperation(NNADAPTER_CONV_2D,
+                 {x,
+                  AddConstant({8, 8, 3, 3}, &filter_),
+                  AddConstant({8}, &bias_),
+                  AddInt32({NNADAPTER_AUTO_PAD_NONE}),
+                  AddInt32({1, 1, 1, 1}),
+                  AddInt32({1, 1}),
+                  AddInt32({1}),
+                  AddInt32({1, 1}),
+                  AddInt32({NNADAPTER_FUSED_NONE})},
+                 {t0});
+    auto t1 = AddTensor(kInputShape);
+    AddOperation(NNADAPTER_RELU, {t0}, {t1});
+    AddOperation(NNADAPTER_SUB,
+                 {t1, x, AddInt32({NNADAPTER_FUSED_NONE})},
+                 {AddTensor(kInputShape)});
+    auto t2 = AddTensor(kInputShape);
+    AddOperation(
+        NNADAPTER_MUL, {t1, x, AddInt32({NNADAPTER_FUSED_NONE})}, {t2});
+    auto y = AddTensor(kInputShape);
+    AddOperation(
+        NNADAPTER_ADD, {t0, t2, AddInt32({NNADAPTER_FUSED_RELU6})}, {y});
+    auto t3 = AddTensor({2, 8, 24, 24});
+    AddOperation(NNADAPTER_AVERAGE_POOL_2D,
+                 {t1,
+                  AddInt32({NNADAPTER_AUTO_PAD_NONE}),
+                  AddInt32({0, 0, 0, 0}),
+                  AddInt32({2, 2}),
+                  AddInt32({2, 2}),
+                  AddBool8(false),
+                  AddBool8(false),
+                  AddInt32({NNADAPTER_FUSED_NONE})},
+                 {t3});
+    auto z = AddTensor({2, 8, 24, 24});
+    AddOperation(NNADAPTER_SOFTMAX, {t3, AddInt32({1})}, {z});
+    std::vector<NNAdapterOperand*> inputs = {x};
+    std::vector<NNAdapterOperand*> outputs = {y, z};
+    EXPECT_EQ(NNAdapterModel_identifyInputsAndOutputs_invoke(
+                  model_, 1, inputs.data(), 2, outputs.data()),
+              NNADAPTER_NO_ERROR);
+    EXPECT_EQ(NNAdapterModel_finish_invoke(model_), NNADAPTER_NO_ERROR);
+    EXPECT_EQ(NNAdapterCompilation_create_invoke(
+                  model_, "", nullptr, 0, "", context_, &compilation_),
+              NNADAPTER_NO_ERROR);
+    EXPECT_EQ(NNAdapterCompilation_finish_invoke(compilation_),
+              NNADAPTER_NO_ERROR);
+  }
+
+  ~BuiltinDeviceProgram() {
+    NNAdapterCompilation_destroy_invoke(compilation_);
+    NNAdapterModel_destroy_invoke(model_);
+    NNAdapterContext_destroy_invoke(context_);
+    NNAdapterDevice_release_invoke(device_);
+  }
+
+  // Return y and z
+  std::vector<std::vector<float>> Run(std::vector<float> x) {
+    std::vector<std::vector<float>> outputs(2);
+    NNAdapterExecution* execution = nullptr;
+    EXPECT_EQ(NNAdapterExecution_create_invoke(compilation_, &execution),
+              NNADAPTER_NO_ERROR);
+    NNAdapterExecution_setInput_invoke(execution, 0, &x, AccessInput);
+    for (int i = 0; i < 2; i++) {
+      NNAdapterExecution_setOutput_invoke(
+          execution, i, &outputs[i], AccessOutput);
+    }
+    EXPECT_EQ(NNAdapterExecution_compute_invoke(execution), NNADAPTER_NO_ERROR);
+    NNAdapterExecution_destroy_invoke(execution);
+    return outputs;
+  }
+
+ private:
+  NNAdapterOperand* AddOperand(NNAdapterOperandPrecisionCode precision,
+                               const std::vector<int32_t>& shape) {
+    NNAdapterOperandType type;
+    memset(&type, 0, sizeof(NNAdapterOperandType));
+    type.precision = precision;
+    type.layout = NNADAPTER_NCHW;
+    type.dimensions.count = shape.size();
+    for (size_t i = 0; i < shape.size(); i++) {
+      type.dimensions.data[i] = shape[i];
+    }
+    NNAdapterOperand* operand = nullptr;
+    EXPECT_EQ(NNAdapterModel_addOperand_invoke(model_, &type, &operand),
+              NNADAPTER_NO_ERROR);
+    return operand;
+  }
+
+  NNAdapterOperand* AddTensor(const std::vector<int32_t>& shape) {
+    return AddOperand(NNADAPTER_FLOAT32, shape);
+  }
+
+  NNAdapterOperand* AddConstant(const std::vector<int32_t>& shape,
+                                std::vector<float>* data) {
+    auto operand = AddOperand(NNADAPTER_FLOAT32, shape);
+    NNAdapterModel_setOperandValue_invoke(
+        operand, data->data(), data->size() * sizeof(float), true);
+    return operand;
+  }
+
+  NNAdapterOperand* AddInt32(std::vector<int32_t> values) {
+    auto operand =
+        AddOperand(NNADAPTER_INT32, {static_cast<int32_t>(values.size())});
+    NNAdapterModel_setOperandValue_invoke(
+        operand, values.data(), values.size() * sizeof(int32_t), true);
+    return operand;
+  }
+
+  NNAdapterOperand* AddBool8(bool value) {
+    auto operand = AddOperand(NNADAPTER_BOOL8, {1});
+    int8_t data = value;
+    NNAdapterModel_setOperandValue_invoke(operand, &data, sizeof(int8_t), true);
+    return operand;
+  }
+
+  void AddOperation(NNAdapterOperationType type,
+                    std::vector<NNAdapterOperand*> inputs,
+                    std::vector<NNAdapterOperand*> outputs) {
+    NNAdapterOperation* operation = nullptr;
+    EXPECT_EQ(NNAdapterModel_addOperation_invoke(model_,
+                                                 type,
+                                                 inputs.size(),
+                                                 inputs.data(),
+                                                 outputs.size(),
+                                                 outputs.data(),
+                                                 &operation),
+              NNADAPTER_NO_ERROR);
+  }
+
+  std::vector<float> filter_;
+  std::vector<float> bias_;
+  NNAdapterDevice* device_{nullptr};
+  NNAdapterContext* context_{nullptr};
+  NNAdapterModel* model_{nullptr};
+  NNAdapterCompilation* compilation_{nullptr};
+};
+
+static std::string Properties(int num_threads, bool reuse_buffers) {
+  return "BUILTIN_DEVICE_NUM_THREADS=" + std::to_string(num_threads) +
+         ";BUILTIN_DEVICE_REUSE_BUFFERS=" + (reuse_buffers ? "true" : "false");
+}
+
+static size_t InputSize() {
+  size_t size = 1;
+  for (auto dimension : kInputShape) size *= dimension;
+  return size;
+}
+
+// The programs reusing the temporary buffers and running in the thread pool
+// compute the same results as the one keeping a buffer per temporary and
+// running in the calling thread alone, over several runs.
+TEST(NNAdapterBuiltinDevice, reuse_buffers_and_threads) {
+  ASSERT_TRUE(NNAdapterWrapper::Global().Supported());
+  BuiltinDeviceProgram reference(Properties(1, false));
+  for (int num_threads : {1, 4}) {
+    BuiltinDeviceProgram program(Properties(num_threads, true));
+    for (uint32_t seed = 10; seed < 13; seed++) {
+      auto x = RandomData(InputSize(), seed);
+      auto expected = reference.Run(x);
+      auto outputs = program.Run(x);
+      ASSERT_EQ(outputs.size(), expected.size());
+      for (size_t i = 0; i < outputs.size(); i++) {
+        ASSERT_EQ(outputs[i].size(), expected[i].size());
+        for (size_t j = 0; j < outputs[i].size(); j++) {
+          ASSERT_EQ(outputs[i][j], expected[i][j])
+              << "num_threads: " << num_threads << " output: " << i
+              << " index: " << j;
+        }
+      }
+    }
+  }
+}
+
+// The programs running on the different threads don't wait for each other
+// on the thread pool, and still get their own results.
+TEST(NNAdapterBuiltinDevice, concurrent_programs) {
+  ASSERT_TRUE(NNAdapterWrapper::Global().Supported());
+  BuiltinDeviceProgram reference(Properties(1, false));
+  std::vector<std::vector<float>> inputs;
+  std::vector<std::vector<std::vector<float>>> expected;
+  for (uint32_t seed = 20; seed < 22; seed++) {
+    inputs.push_back(RandomData(InputSize(), seed));
+    expected.push_back(reference.Run(inputs.back()));
+  }
+  std::vector<std::vector<std::vector<float>>> outputs(inputs.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    threads.emplace_back([&, i]() {
+      BuiltinDeviceProgram program(Properties(4, true));
+      for (int j = 0; j < 3; j++) {
+        outputs[i] = program.Run(inputs[i]);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (size_t i = 0; i < inputs.size(); i++) {
+    EXPECT_EQ(outputs[i], expected[i]);
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
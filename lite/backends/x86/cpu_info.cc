@@ -26,6 +26,9 @@
 #endif  // _WIN32
 
 #include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
 #include "lite/utils/log/cp_logging.h"
 
 #include "lite/utils/env.h"
@@ -142,6 +145,52 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
 }
 #endif
 
+std::vector<int> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> cpu_ids;
+  std::stringstream ss(cpu_list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty()) continue;
+    auto pos = item.find('-');
+    int first = std::atoi(item.substr(0, pos).c_str());
+    int last = first;
+    if (pos != std::string::npos) {
+      last = std::atoi(item.substr(pos + 1).c_str());
+    }
+    for (int id = first; id <= last; ++id) {
+      cpu_ids.push_back(id);
+    }
+  }
+  return cpu_ids;
+}
+
+#if defined(__linux__)
+static std::string NumaNodePath(int node) {
+  return "/sys/devices/system/node/node" + std::to_string(node);
+}
+
+int NumaNodeNum() {
+  int node_num = 0;
+  while (std::ifstream(NumaNodePath(node_num) + "/cpulist").good()) {
+    ++node_num;
+  }
+  return std::max(node_num, 1);
+}
+
+std::vector<int> NumaNodeCpus(int node) {
+  std::ifstream fin(NumaNodePath(node) + "/cpulist");
+  std::string cpu_list;
+  if (!fin.good() || !std::getline(fin, cpu_list)) {
+    return {};
+  }
+  return ParseCpuList(cpu_list);
+}
+#else
+int NumaNodeNum() { return 1; }
+
+std::vector<int> NumaNodeCpus(int node) { return {}; }
+#endif
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
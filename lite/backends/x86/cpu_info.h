@@ -15,6 +15,8 @@
 #pragma once
 
 #include <stddef.h>
+#include <string>
+#include <vector>
 
 #ifdef _WIN32
 #if defined(__AVX2__)
@@ -66,6 +68,15 @@ typedef enum {
 // May I use some instruction
 bool MayIUse(const cpu_isa_t cpu_isa);
 
+//! Parse a kernel cpu list such as "0-3,8,10-11" into cpu ids.
+std::vector<int> ParseCpuList(const std::string& cpu_list);
+
+//! Get the number of NUMA nodes, 1 if the topology is unknown.
+int NumaNodeNum();
+
+//! Get the ids of the cpus that belong to a NUMA node, empty if unknown.
+std::vector<int> NumaNodeCpus(int node);
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
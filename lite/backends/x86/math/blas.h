@@ -29,6 +29,21 @@
 #include <cblas.h>
 #endif
 
+#if !defined(PADDLE_WITH_MKLML) && !defined(PADDLE_USE_OPENBLAS)
+#include "lite/backends/x86/math/packed_sgemm.h"
+// The cblas enums used by Blas, which is backed by the in-tree packed sgemm
+// when no cblas library is linked.
+typedef enum CBLAS_ORDER {
+  CblasRowMajor = 101,
+  CblasColMajor = 102
+} CBLAS_ORDER;
+typedef enum CBLAS_TRANSPOSE {
+  CblasNoTrans = 111,
+  CblasTrans = 112,
+  CblasConjTrans = 113
+} CBLAS_TRANSPOSE;
+#endif
+
 namespace paddle {
 namespace lite {
 namespace x86 {
@@ -256,6 +271,46 @@ class Blas {
                    int64_t strideA,
                    int64_t strideB) const;
 
+  // C_i = alpha * op(A_i) * op(B_i) + beta * C_i for i in [0, batchCount),
+  // where X_i = X + i * strideX. A stride of 0 broadcasts the matrix to all
+  // the batches.
+  template <typename T>
+  void BatchedGEMM(bool transA,
+                   bool transB,
+                   int M,
+                   int N,
+                   int K,
+                   T alpha,
+                   const T* A,
+                   int lda,
+                   int64_t strideA,
+                   const T* B,
+                   int ldb,
+                   int64_t strideB,
+                   T beta,
+                   T* C,
+                   int ldc,
+                   int64_t strideC,
+                   int batchCount) const;
+
+  // The same as above, with the matrices of the batches given by arrays of
+  // pointers, e.g. for broadcast batch dims.
+  template <typename T>
+  void BatchedGEMM(bool transA,
+                   bool transB,
+                   int M,
+                   int N,
+                   int K,
+                   T alpha,
+                   const T* const* A,
+                   int lda,
+                   const T* const* B,
+                   int ldb,
+                   T beta,
+                   T* const* C,
+                   int ldc,
+                   int batchCount) const;
+
   template <typename T>
   void MatMul(const lite::TensorLite& mat_a,
               const MatDescriptor& dim_a,
@@ -16,6 +16,7 @@
 #include <limits>
 #include <vector>
 #include "lite/backends/x86/math/math_function.h"
+#include "lite/core/parallel_defines.h"
 
 namespace paddle {
 namespace lite {
@@ -241,7 +242,7 @@ struct CBlas<double> {
   }
 };
 
-#else
+#elif defined(PADDLE_USE_OPENBLAS)
 
 template <>
 struct CBlas<float> {
@@ -288,6 +289,136 @@ struct CBlas<double> {
     cblas_dgemv(args...);
   }
 };
+
+#else
+
+// Without a cblas library, float is computed by the packed sgemm and double
+// by naive loops. Only the row major layout is used by Blas.
+template <typename T>
+struct NaiveBlas {
+  static void GEMM(CBLAS_ORDER order,
+                   CBLAS_TRANSPOSE transA,
+                   CBLAS_TRANSPOSE transB,
+                   int M,
+                   int N,
+                   int K,
+                   T alpha,
+                   const T *A,
+                   int lda,
+                   const T *B,
+                   int ldb,
+                   T beta,
+                   T *C,
+                   int ldc) {
+    CHECK_EQ(order, CblasRowMajor);
+    for (int i = 0; i < M; ++i) {
+      for (int j = 0; j < N; ++j) {
+        T sum = 0;
+        for (int k = 0; k < K; ++k) {
+          T a = transA == CblasNoTrans ? A[i * lda + k] : A[k * lda + i];
+          T b = transB == CblasNoTrans ? B[k * ldb + j] : B[j * ldb + k];
+          sum += a * b;
+        }
+        T *c = C + i * ldc + j;
+        *c = beta == 0 ? alpha * sum : alpha * sum + beta * *c;
+      }
+    }
+  }
+
+  static void AXPY(int n, T alpha, const T *x, int incx, T *y, int incy) {
+    for (int i = 0; i < n; ++i) {
+      y[i * incy] += alpha * x[i * incx];
+    }
+  }
+
+  static void VCOPY(int n, const T *x, int incx, T *y, int incy) {
+    for (int i = 0; i < n; ++i) {
+      y[i * incy] = x[i * incx];
+    }
+  }
+
+  static void GEMV(CBLAS_ORDER order,
+                   CBLAS_TRANSPOSE transA,
+                   int M,
+                   int N,
+                   T alpha,
+                   const T *A,
+                   int lda,
+                   const T *x,
+                   int incx,
+                   T beta,
+                   T *y,
+                   int incy) {
+    CHECK_EQ(order, CblasRowMajor);
+    int y_size = transA == CblasNoTrans ? M : N;
+    int x_size = transA == CblasNoTrans ? N : M;
+    for (int i = 0; i < y_size; ++i) {
+      T sum = 0;
+      for (int k = 0; k < x_size; ++k) {
+        T a = transA == CblasNoTrans ? A[i * lda + k] : A[k * lda + i];
+        sum += a * x[k * incx];
+      }
+      T *out = y + i * incy;
+      *out = beta == 0 ? alpha * sum : alpha * sum + beta * *out;
+    }
+  }
+};
+
+template <>
+struct CBlas<float> : public NaiveBlas<float> {
+  static void GEMM(CBLAS_ORDER order,
+                   CBLAS_TRANSPOSE transA,
+                   CBLAS_TRANSPOSE transB,
+                   int M,
+                   int N,
+                   int K,
+                   float alpha,
+                   const float *A,
+                   int lda,
+                   const float *B,
+                   int ldb,
+                   float beta,
+                   float *C,
+                   int ldc) {
+    CHECK_EQ(order, CblasRowMajor);
+    sgemm(transA != CblasNoTrans,
+          transB != CblasNoTrans,
+          M,
+          N,
+          K,
+          alpha,
+          A,
+          lda,
+          B,
+          ldb,
+          beta,
+          C,
+          ldc);
+  }
+
+  static void GEMV(CBLAS_ORDER order,
+                   CBLAS_TRANSPOSE transA,
+                   int M,
+                   int N,
+                   float alpha,
+                   const float *A,
+                   int lda,
+                   const float *x,
+                   int incx,
+                   float beta,
+                   float *y,
+                   int incy) {
+    if (order != CblasRowMajor || incx != 1 || incy != 1) {
+      NaiveBlas<float>::GEMV(
+          order, transA, M, N, alpha, A, lda, x, incx, beta, y, incy);
+      return;
+    }
+    sgemv(transA != CblasNoTrans, M, N, alpha, A, lda, x, beta, y);
+  }
+};
+
+template <>
+struct CBlas<double> : public NaiveBlas<double> {};
 #endif
 
 template <>
@@ -645,41 +776,151 @@ void Blas<lite::TargetType::kX86>::BatchedGEMM(CBLAS_TRANSPOSE transA,
                                                int batchCount,
                                                int64_t strideA,
                                                int64_t strideB) const {
-#ifdef PADDLE_WITH_MKLML
-  int lda = (transA == CblasNoTrans) ? K : M;
-  int ldb = (transB == CblasNoTrans) ? N : K;
-  int ldc = N;
+  this->template BatchedGEMM<T>(transA != CblasNoTrans,
+                                transB != CblasNoTrans,
+                                M,
+                                N,
+                                K,
+                                alpha,
+                                A,
+                                (transA == CblasNoTrans) ? K : M,
+                                strideA,
+                                B,
+                                (transB == CblasNoTrans) ? N : K,
+                                strideB,
+                                beta,
+                                C,
+                                N,
+                                static_cast<int64_t>(M) * N,
+                                batchCount);
+}
+
+template <>
+template <typename T>
+void Blas<lite::TargetType::kX86>::BatchedGEMM(bool transA,
+                                               bool transB,
+                                               int M,
+                                               int N,
+                                               int K,
+                                               T alpha,
+                                               const T *A,
+                                               int lda,
+                                               int64_t strideA,
+                                               const T *B,
+                                               int ldb,
+                                               int64_t strideB,
+                                               T beta,
+                                               T *C,
+                                               int ldc,
+                                               int64_t strideC,
+                                               int batchCount) const {
   auto a_array = std::vector<const T *>(batchCount);
   auto b_array = std::vector<const T *>(batchCount);
   auto c_array = std::vector<T *>(batchCount);
   for (int k = 0; k < batchCount; ++k) {
-    a_array[k] = &A[k * strideA];
-    b_array[k] = &B[k * strideB];
-    c_array[k] = &C[k * M * N];
+    a_array[k] = A + k * strideA;
+    b_array[k] = B + k * strideB;
+    c_array[k] = C + k * strideC;
   }
+  this->template BatchedGEMM<T>(transA,
+                                transB,
+                                M,
+                                N,
+                                K,
+                                alpha,
+                                a_array.data(),
+                                lda,
+                                b_array.data(),
+                                ldb,
+                                beta,
+                                c_array.data(),
+                                ldc,
+                                batchCount);
+}
 
+template <>
+template <typename T>
+void Blas<lite::TargetType::kX86>::BatchedGEMM(bool transA,
+                                               bool transB,
+                                               int M,
+                                               int N,
+                                               int K,
+                                               T alpha,
+                                               const T *const *A,
+                                               int lda,
+                                               const T *const *B,
+                                               int ldb,
+                                               T beta,
+                                               T *const *C,
+                                               int ldc,
+                                               int batchCount) const {
+  if (batchCount <= 0) return;
+  CBLAS_TRANSPOSE cblas_transA = transA ? CblasTrans : CblasNoTrans;
+  CBLAS_TRANSPOSE cblas_transB = transB ? CblasTrans : CblasNoTrans;
+#ifdef PADDLE_WITH_MKLML
   CBlas<T>::GEMM_BATCH(CblasRowMajor,
-                       &transA,
-                       &transB,
+                       &cblas_transA,
+                       &cblas_transB,
                        &M,
                        &N,
                        &K,
                        &alpha,
-                       a_array.data(),
+                       const_cast<const T **>(A),
                        &lda,
-                       b_array.data(),
+                       const_cast<const T **>(B),
                        &ldb,
                        &beta,
-                       c_array.data(),
+                       const_cast<T **>(C),
                        &ldc,
                        1 /* group_count */,
                        &batchCount);
 #else
+  // Small GEMMs are dominated by the overhead of the threading inside one
+  // GEMM, run the batches in parallel instead. A GEMM called from a parallel
+  // task runs serially on its thread.
+  int threads = 1;
+#ifdef LITE_USE_THREAD_POOL
+  ThreadPool *pool = ThreadPool::Current();
+  threads = pool != nullptr ? pool->thread_num() : 1;
+#endif
+  constexpr int64_t kSmallGemmWork = 64 * 64 * 64;
+  if (threads > 1 &&
+      (batchCount >= threads ||
+       static_cast<int64_t>(M) * N * K <= kSmallGemmWork)) {
+    LITE_PARALLEL_BEGIN(k, tid, batchCount) {
+      CBlas<T>::GEMM(CblasRowMajor,
+                     cblas_transA,
+                     cblas_transB,
+                     M,
+                     N,
+                     K,
+                     alpha,
+                     A[k],
+                     lda,
+                     B[k],
+                     ldb,
+                     beta,
+                     C[k],
+                     ldc);
+    }
+    LITE_PARALLEL_END();
+    return;
+  }
   for (int k = 0; k < batchCount; ++k) {
-    auto *Ak = &A[k * strideA];
-    auto *Bk = &B[k * strideB];
-    auto *Ck = &C[k * M * N];
-    this->template GEMM<T>(transA, transB, M, N, K, alpha, Ak, Bk, beta, Ck);
+    CBlas<T>::GEMM(CblasRowMajor,
+                   cblas_transA,
+                   cblas_transB,
+                   M,
+                   N,
+                   K,
+                   alpha,
+                   A[k],
+                   lda,
+                   B[k],
+                   ldb,
+                   beta,
+                   C[k],
+                   ldc);
   }
 #endif
 }
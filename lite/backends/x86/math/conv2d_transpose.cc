@@ -100,8 +100,8 @@ void conv_transpose_depthwise_s1(const float* dst,
       (height + pad_h0 + pad_h1 - (dilation_h * (kernel_h - 1) + 1)) + 1;
   const int output_w =
       (width + pad_w0 + pad_w1 - (dilation_w * (kernel_w - 1) + 1)) + 1;
-  float* zero_ptr =
-      static_cast<float*>(TargetMalloc(TARGET(kX86), width * sizeof(float)));
+  ctx->ExtendWorkspace(width * sizeof(float));
+  float* zero_ptr = ctx->workspace_data<float>();
   memset(zero_ptr, 0, width * sizeof(float));
   const int ic_plane_size = height * width;
   const int oc_plane_size = output_h * output_w;
@@ -246,7 +246,6 @@ void conv_transpose_depthwise_s1(const float* dst,
       }
     }
   }
-  TargetFree(TARGET(kX86), zero_ptr);
 }
 
 void conv_transpose_depthwise_s2(const float* dst,
@@ -269,8 +268,8 @@ void conv_transpose_depthwise_s2(const float* dst,
       (height + pad_h0 + pad_h1 - (dilation_h * (kernel_h - 1) + 1)) / 2 + 1;
   const int output_w =
       (width + pad_w0 + pad_w1 - (dilation_w * (kernel_w - 1) + 1)) / 2 + 1;
-  float* zero_ptr =
-      static_cast<float*>(TargetMalloc(TARGET(kX86), width * sizeof(float)));
+  ctx->ExtendWorkspace(width * sizeof(float));
+  float* zero_ptr = ctx->workspace_data<float>();
   memset(zero_ptr, 0, width * sizeof(float));
   const int ic_plane_size = height * width;
   const int oc_plane_size = output_h * output_w;
@@ -536,7 +535,6 @@ void conv_transpose_depthwise_s2(const float* dst,
       }
     }
   }
-  TargetFree(TARGET(kX86), zero_ptr);
 }
 
 }  // namespace math
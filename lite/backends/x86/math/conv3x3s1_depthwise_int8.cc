@@ -836,10 +836,9 @@ void conv_3x3s1_dw_int8(Dtype* dout,
   int rem_cnt = remain >> 1;
   int rem_rem = remain & 1;
   bool flag_bias = bias ? true : false;
-  int8_t* pre_din = static_cast<int8_t*>(
-      TargetMalloc(TARGET(kX86),
-                   std::max(pre_in_size * omp_num * sizeof(int8_t),
-                            32 * omp_num * sizeof(int8_t))));
+  ctx->ExtendWorkspace(std::max(pre_in_size * omp_num * sizeof(int8_t),
+                                32 * omp_num * sizeof(int8_t)));
+  int8_t* pre_din = ctx->workspace_data<int8_t>();
   // LOG(INFO) << "prepack_input_im2col_s1_int8: ";
   // auto start = clock();
   for (int n = 0; n < omp_num; ++n) {
@@ -960,7 +959,6 @@ void conv_3x3s1_dw_int8(Dtype* dout,
   }
   // end = clock();
   // LOG(INFO) << "compute duration: " << (end-start) * 1000.0 /CLOCKS_PER_SEC;
-  TargetFree(TARGET(kX86), pre_din);
 }
 template void conv_3x3s1_dw_int8(float* dout,
                                  const int8_t* din,
@@ -31,6 +31,22 @@ namespace x86 {
 namespace math {
 #define Max(a, b) (a > b ? a : b)
 
+// Carve the zero input row and the dummy output row out of the workspace.
+// Both rows are followed by 64 bytes of slack, as the vector loads and stores
+// at the ends of the rows may go past them.
+static void prepare_row_buffers(X86Context *ctx,
+                                size_t zero_size,
+                                int w_out,
+                                float **zero_ptr,
+                                float **write_ptr) {
+  const size_t slack = 64;
+  size_t write_offset = (zero_size + 2 * slack - 1) / slack * slack;
+  ctx->ExtendWorkspace(write_offset + w_out * sizeof(float) + slack);
+  *zero_ptr = ctx->workspace_data<float>();
+  memset(*zero_ptr, 0, zero_size);
+  *write_ptr = *zero_ptr + write_offset / sizeof(float);
+}
+
 void conv_depthwise_3x3s2_p01_direct(
     const float *din,
     float *dout,
@@ -45,7 +61,8 @@ void conv_depthwise_3x3s2_p01_direct(
     const float *bias,
     int pad,
     bool flag_bias,
-    const operators::ActivationParam act_param) {
+    const operators::ActivationParam act_param,
+    X86Context *ctx) {
 #ifdef __AVX__
 
   bool right = false;  // for right result
@@ -53,11 +70,13 @@ void conv_depthwise_3x3s2_p01_direct(
   bool has_active = act_param.has_active;
   auto act_type = act_param.active_type;
 
-  float *zero_ptr = static_cast<float *>(
-      TargetMalloc(TARGET(kX86), Max(w_in * sizeof(float), 8 * sizeof(float))));
-  memset(zero_ptr, 0, Max(w_in * sizeof(float), 8 * sizeof(float)));
-  float *write_ptr =
-      static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
+  float *zero_ptr = nullptr;
+  float *write_ptr = nullptr;
+  prepare_row_buffers(ctx,
+                      Max(w_in * sizeof(float), 8 * sizeof(float)),
+                      w_out,
+                      &zero_ptr,
+                      &write_ptr);
 
   //! prepare for processing right result
   int rmask_o[4] = {0};
@@ -333,19 +352,19 @@ void conv_depthwise_3x3s2_p01_direct(
       }
     }
   }
-  TargetFree(TARGET(kX86), zero_ptr);
-  TargetFree(TARGET(kX86), write_ptr);
 #else
   bool right = false;  // for right result
 
   bool has_active = act_param.has_active;
   auto act_type = act_param.active_type;
 
-  float *zero_ptr = static_cast<float *>(TargetMalloc(
-      TARGET(kX86), Max(w_in * sizeof(float), 12 * sizeof(float))));
-  memset(zero_ptr, 0, Max(w_in * sizeof(float), 12 * sizeof(float)));
-  float *write_ptr =
-      static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
+  float *zero_ptr = nullptr;
+  float *write_ptr = nullptr;
+  prepare_row_buffers(ctx,
+                      Max(w_in * sizeof(float), 12 * sizeof(float)),
+                      w_out,
+                      &zero_ptr,
+                      &write_ptr);
 
   //! prepare for processing right result
   float rmasko[4] = {1.f, 1.f, 1.f, 1.f};
@@ -605,8 +624,6 @@ void conv_depthwise_3x3s2_p01_direct(
       }
     }
   }
-  TargetFree(TARGET(kX86), zero_ptr);
-  TargetFree(TARGET(kX86), write_ptr);
 #endif
 }
 void conv_depthwise_3x3s1_p01_direct(
@@ -623,18 +640,21 @@ void conv_depthwise_3x3s1_p01_direct(
     const float *bias,
     int pad,
     bool flag_bias,
-    const operators::ActivationParam act_param) {
+    const operators::ActivationParam act_param,
+    X86Context *ctx) {
 #ifdef __AVX__
   bool right = false;
 
   bool has_active = act_param.has_active;
   auto act_type = act_param.active_type;
 
-  float *zero_ptr = static_cast<float *>(
-      TargetMalloc(TARGET(kX86), Max(w_in * sizeof(float), 8)));
-  memset(zero_ptr, 0, Max(w_in * sizeof(float), 8));
-  float *write_ptr =
-      static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
+  float *zero_ptr = nullptr;
+  float *write_ptr = nullptr;
+  prepare_row_buffers(ctx,
+                      Max(w_in * sizeof(float), 8),
+                      w_out,
+                      &zero_ptr,
+                      &write_ptr);
 
   //! prepare for processing right result
   int rmask_o[8] = {0, 0, 0, 0, 0, 0, 0, 0};
@@ -1003,19 +1023,19 @@ void conv_depthwise_3x3s1_p01_direct(
     }
   }
 
-  TargetFree(TARGET(kX86), zero_ptr);
-  TargetFree(TARGET(kX86), write_ptr);
 #else
   bool right = false;  // for right result
 
   bool has_active = act_param.has_active;
   auto act_type = act_param.active_type;
 
-  float *zero_ptr = static_cast<float *>(
-      TargetMalloc(TARGET(kX86), Max(w_in * sizeof(float), 8)));
-  memset(zero_ptr, 0, Max(w_in * sizeof(float), 8));
-  float *write_ptr =
-      static_cast<float *>(TargetMalloc(TARGET(kX86), w_out * sizeof(float)));
+  float *zero_ptr = nullptr;
+  float *write_ptr = nullptr;
+  prepare_row_buffers(ctx,
+                      Max(w_in * sizeof(float), 8),
+                      w_out,
+                      &zero_ptr,
+                      &write_ptr);
 
   //! prepare for processing right result
   float rmasko[4] = {1.f, 1.f, 1.f, 1.f};
@@ -1319,8 +1339,6 @@ void conv_depthwise_3x3s1_p01_direct(
       }
     }
   }
-  TargetFree(TARGET(kX86), zero_ptr);
-  TargetFree(TARGET(kX86), write_ptr);
 #endif
 }
 
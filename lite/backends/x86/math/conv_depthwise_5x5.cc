@@ -40,7 +40,8 @@ void conv_depthwise_5x5s1(const float* din,
                           const float* bias,
                           int pad,
                           bool flag_bias,
-                          const operators::ActivationParam act_param) {
+                          const operators::ActivationParam act_param,
+                          X86Context* ctx) {
   bool has_active = act_param.has_active;
   auto act_type = act_param.active_type;
 
@@ -49,13 +50,16 @@ void conv_depthwise_5x5s1(const float* din,
   int in_len = block_channel * (2 * pad + w_in);
 
   int channel_num = ROUNDUP(ch_in, block_channel);
-  float* pack_weight = static_cast<float*>(
-      TargetMalloc(TARGET(kX86), channel_num * 5 * 5 * sizeof(float)));
-  float* pack_input = static_cast<float*>(TargetMalloc(
-      TARGET(kX86),
-      (h_in + 2 * pad) * (w_in + 2 * pad) * block_channel * sizeof(float)));
-  float* pack_out = static_cast<float*>(TargetMalloc(
-      TARGET(kX86), h_out * w_out * block_channel * sizeof(float)));
+  // The packed weights, inputs and outputs are placed one after another in
+  // the workspace, each of them is 64-byte aligned.
+  int weight_size = ROUNDUP(channel_num * 5 * 5, 16);
+  int input_size =
+      ROUNDUP((h_in + 2 * pad) * (w_in + 2 * pad) * block_channel, 16);
+  int out_size = h_out * w_out * block_channel;
+  ctx->ExtendWorkspace((weight_size + input_size + out_size) * sizeof(float));
+  float* pack_weight = ctx->workspace_data<float>();
+  float* pack_input = pack_weight + weight_size;
+  float* pack_out = pack_input + input_size;
 
 #ifdef __AVX__
   packC8_common(weights, pack_weight, {0, 0, 0, 0}, 5, 5, ch_in);
@@ -403,9 +407,6 @@ void conv_depthwise_5x5s1(const float* din,
     }
   }
 
-  TargetFree(TARGET(kX86), pack_weight);
-  TargetFree(TARGET(kX86), pack_input);
-  TargetFree(TARGET(kX86), pack_out);
 }
 void conv_depthwise_5x5s2(const float* din,
                           float* dout,
@@ -420,7 +421,8 @@ void conv_depthwise_5x5s2(const float* din,
                           const float* bias,
                           int pad,
                           bool flag_bias,
-                          const operators::ActivationParam act_param) {
+                          const operators::ActivationParam act_param,
+                          X86Context* ctx) {
   bool has_active = act_param.has_active;
   auto act_type = act_param.active_type;
 
@@ -429,13 +431,16 @@ void conv_depthwise_5x5s2(const float* din,
   int in_len = block_channel * (2 * pad + w_in);
 
   int channel_num = ROUNDUP(ch_in, block_channel);
-  float* pack_weight = static_cast<float*>(
-      TargetMalloc(TARGET(kX86), channel_num * 5 * 5 * sizeof(float)));
-  float* pack_input = static_cast<float*>(TargetMalloc(
-      TARGET(kX86),
-      (h_in + 2 * pad) * (w_in + 2 * pad) * block_channel * sizeof(float)));
-  float* pack_out = static_cast<float*>(TargetMalloc(
-      TARGET(kX86), h_out * w_out * block_channel * sizeof(float)));
+  // The packed weights, inputs and outputs are placed one after another in
+  // the workspace, each of them is 64-byte aligned.
+  int weight_size = ROUNDUP(channel_num * 5 * 5, 16);
+  int input_size =
+      ROUNDUP((h_in + 2 * pad) * (w_in + 2 * pad) * block_channel, 16);
+  int out_size = h_out * w_out * block_channel;
+  ctx->ExtendWorkspace((weight_size + input_size + out_size) * sizeof(float));
+  float* pack_weight = ctx->workspace_data<float>();
+  float* pack_input = pack_weight + weight_size;
+  float* pack_out = pack_input + input_size;
 
 #ifdef __AVX__
   packC8_common(weights, pack_weight, {0, 0, 0, 0}, 5, 5, ch_in);
@@ -798,9 +803,6 @@ void conv_depthwise_5x5s2(const float* din,
     }
   }
 
-  TargetFree(TARGET(kX86), pack_weight);
-  TargetFree(TARGET(kX86), pack_input);
-  TargetFree(TARGET(kX86), pack_out);
 }
 
 }  // namespace math
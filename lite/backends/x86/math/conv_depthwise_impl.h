@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "lite/core/context.h"
 #include "lite/core/tensor.h"
 #include "lite/operators/op_params.h"
 
@@ -35,7 +36,8 @@ void conv_depthwise_3x3s1_p01_direct(
     const float* bias,
     int pad,
     bool flag_bias,
-    const operators::ActivationParam act_param);
+    const operators::ActivationParam act_param,
+    X86Context* ctx);
 void conv_depthwise_3x3s2_p01_direct(
     const float* din,
     float* dout,
@@ -50,7 +52,8 @@ void conv_depthwise_3x3s2_p01_direct(
     const float* bias,
     int pad,
     bool flag_bias,
-    const operators::ActivationParam act_param);
+    const operators::ActivationParam act_param,
+    X86Context* ctx);
 void conv_depthwise_5x5s1(const float* din,
                           float* dout,
                           int num,
@@ -64,7 +67,8 @@ void conv_depthwise_5x5s1(const float* din,
                           const float* bias,
                           int pad,
                           bool flag_bias,
-                          const operators::ActivationParam act_param);
+                          const operators::ActivationParam act_param,
+                          X86Context* ctx);
 void conv_depthwise_5x5s2(const float* din,
                           float* dout,
                           int num,
@@ -78,7 +82,8 @@ void conv_depthwise_5x5s2(const float* din,
                           const float* bias,
                           int pad,
                           bool flag_bias,
-                          const operators::ActivationParam act_param);
+                          const operators::ActivationParam act_param,
+                          X86Context* ctx);
 void conv_depthwise_3x3_pack(const operators::ConvParam& param,
                              lite::Tensor* input_padding_,
                              lite::Tensor* input_pack_,
@@ -0,0 +1,513 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/conv_nchwc.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include "lite/backends/x86/math/nchwc.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The loops over a tile must be fully unrolled to keep the accumulators in
+// registers.
+#if defined(__clang__)
+#define LITE_NCHWC_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define LITE_NCHWC_UNROLL _Pragma("GCC unroll 16")
+#else
+#define LITE_NCHWC_UNROLL
+#endif
+
+namespace {
+
+// Output pixels of a row computed together by the convolution, as many as
+// the accumulators fit in the registers.
+template <int B>
+struct TileW {
+  static const int value = B == 8 ? 12 : 6;
+};
+
+// Activations fused into the tiles, the others run after the convolution.
+bool ActFused(const operators::ActivationParam& act_param) {
+  if (!act_param.has_active) return true;
+  switch (act_param.active_type) {
+    case lite_api::ActivationType::kIndentity:
+    case lite_api::ActivationType::kRelu:
+    case lite_api::ActivationType::kRelu6:
+    case lite_api::ActivationType::kLeakyRelu:
+    case lite_api::ActivationType::kHardSwish:
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <int B>
+inline void StoreAct(const float* acc,
+                     float* dout,
+                     const operators::ActivationParam& act_param) {
+  if (!act_param.has_active) {
+    LITE_NCHWC_UNROLL
+    for (int b = 0; b < B; ++b) dout[b] = acc[b];
+    return;
+  }
+  switch (act_param.active_type) {
+    case lite_api::ActivationType::kRelu:
+      LITE_NCHWC_UNROLL
+      for (int b = 0; b < B; ++b) dout[b] = std::max(acc[b], 0.f);
+      break;
+    case lite_api::ActivationType::kRelu6: {
+      float clip = act_param.Relu_clipped_coef;
+      LITE_NCHWC_UNROLL
+      for (int b = 0; b < B; ++b) {
+        dout[b] = std::min(std::max(acc[b], 0.f), clip);
+      }
+    } break;
+    case lite_api::ActivationType::kLeakyRelu: {
+      float alpha = act_param.Leaky_relu_alpha;
+      LITE_NCHWC_UNROLL
+      for (int b = 0; b < B; ++b) {
+        dout[b] = acc[b] > 0.f ? acc[b] : acc[b] * alpha;
+      }
+    } break;
+    case lite_api::ActivationType::kHardSwish: {
+      float scale = 1.f / act_param.hard_swish_scale;
+      float threshold = act_param.hard_swish_threshold;
+      float offset = act_param.hard_swish_offset;
+      LITE_NCHWC_UNROLL
+      for (int b = 0; b < B; ++b) {
+        dout[b] = std::min(std::max(0.f, acc[b] + offset), threshold) *
+                  acc[b] * scale;
+      }
+    } break;
+    default:
+      LITE_NCHWC_UNROLL
+      for (int b = 0; b < B; ++b) dout[b] = acc[b];
+  }
+}
+
+// Whether the groups can be kept apart, that is every block of output
+// channels only reads whole blocks of input channels of its own group.
+bool GroupsAligned(const ConvNCHWcParam& param, int block) {
+  return param.groups == 1 || ((param.chin / param.groups) % block == 0 &&
+                               (param.chout / param.groups) % block == 0);
+}
+
+// Number of input blocks read by a block of output channels.
+int WeightInBlocks(const ConvNCHWcParam& param, int block) {
+  if (param.groups > 1 && GroupsAligned(param, block)) {
+    return param.chin / param.groups / block;
+  }
+  return nchwc_blocks(param.chin, block);
+}
+
+// First input block read by the block `ocb` of output channels.
+int InBlockStart(const ConvNCHWcParam& param, int block, int ocb) {
+  if (param.groups > 1 && GroupsAligned(param, block)) {
+    int group = ocb * block / (param.chout / param.groups);
+    return group * (param.chin / param.groups / block);
+  }
+  return 0;
+}
+
+#ifdef __AVX__
+inline __m256 MulAdd(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+#endif
+
+// TW consecutive outputs of a row, all the inputs read are inside the rows.
+template <int B, int TW>
+inline void ConvTile(const float* din,
+                     const float* weights,
+                     const float* bias,
+                     float* dout,
+                     int in_blocks,
+                     int ih0,
+                     int iw0,
+                     const ConvNCHWcParam& param,
+                     const operators::ActivationParam& act_param) {
+  const int kh = param.kernel_h;
+  const int kw = param.kernel_w;
+  const int in_step = param.stride_w * B;
+  const int64_t in_plane = static_cast<int64_t>(param.hin) * param.win * B;
+#ifdef __AVX__
+  // a block of output channels is held by V registers
+  constexpr int V = B / 8;
+  __m256 acc[TW][V];
+  LITE_NCHWC_UNROLL
+  for (int v = 0; v < V; ++v) {
+    __m256 init = bias ? _mm256_loadu_ps(bias + v * 8) : _mm256_setzero_ps();
+    LITE_NCHWC_UNROLL
+    for (int t = 0; t < TW; ++t) acc[t][v] = init;
+  }
+#else
+  float acc[TW][B];
+  for (int t = 0; t < TW; ++t) {
+    for (int b = 0; b < B; ++b) acc[t][b] = bias ? bias[b] : 0.f;
+  }
+#endif
+  for (int icb = 0; icb < in_blocks; ++icb) {
+    const float* in_c = din + icb * in_plane;
+    const float* w_c = weights + static_cast<int64_t>(icb) * kh * kw * B * B;
+    for (int ky = 0; ky < kh; ++ky) {
+      int ih = ih0 + ky * param.dilation_h;
+      if (ih < 0 || ih >= param.hin) continue;
+      const float* row = in_c + static_cast<int64_t>(ih) * param.win * B;
+      for (int kx = 0; kx < kw; ++kx) {
+        const float* src = row + (iw0 + kx * param.dilation_w) * B;
+        const float* w_k = w_c + (ky * kw + kx) * B * B;
+        for (int i = 0; i < B; ++i) {
+          const float* w_i = w_k + i * B;
+#ifdef __AVX__
+          __m256 w[V];
+          LITE_NCHWC_UNROLL
+          for (int v = 0; v < V; ++v) w[v] = _mm256_loadu_ps(w_i + v * 8);
+          LITE_NCHWC_UNROLL
+          for (int t = 0; t < TW; ++t) {
+            __m256 x = _mm256_broadcast_ss(src + t * in_step + i);
+            LITE_NCHWC_UNROLL
+            for (int v = 0; v < V; ++v) acc[t][v] = MulAdd(x, w[v], acc[t][v]);
+          }
+#else
+          for (int t = 0; t < TW; ++t) {
+            float x = src[t * in_step + i];
+            for (int b = 0; b < B; ++b) acc[t][b] += x * w_i[b];
+          }
+#endif
+        }
+      }
+    }
+  }
+  for (int t = 0; t < TW; ++t) {
+#ifdef __AVX__
+    float res[B];
+    for (int v = 0; v < V; ++v) _mm256_storeu_ps(res + v * 8, acc[t][v]);
+    StoreAct<B>(res, dout + t * B, act_param);
+#else
+    StoreAct<B>(acc[t], dout + t * B, act_param);
+#endif
+  }
+}
+
+// One output with the bounds of the inputs checked, for the borders.
+template <int B>
+inline void ConvPixel(const float* din,
+                      const float* weights,
+                      const float* bias,
+                      float* dout,
+                      int in_blocks,
+                      int ih0,
+                      int iw0,
+                      const ConvNCHWcParam& param,
+                      const operators::ActivationParam& act_param) {
+  const int kh = param.kernel_h;
+  const int kw = param.kernel_w;
+  const int64_t in_plane = static_cast<int64_t>(param.hin) * param.win * B;
+  float acc[B];
+  for (int b = 0; b < B; ++b) acc[b] = bias ? bias[b] : 0.f;
+  for (int icb = 0; icb < in_blocks; ++icb) {
+    const float* in_c = din + icb * in_plane;
+    const float* w_c = weights + static_cast<int64_t>(icb) * kh * kw * B * B;
+    for (int ky = 0; ky < kh; ++ky) {
+      int ih = ih0 + ky * param.dilation_h;
+      if (ih < 0 || ih >= param.hin) continue;
+      for (int kx = 0; kx < kw; ++kx) {
+        int iw = iw0 + kx * param.dilation_w;
+        if (iw < 0 || iw >= param.win) continue;
+        const float* src =
+            in_c + (static_cast<int64_t>(ih) * param.win + iw) * B;
+        const float* w_k = w_c + (ky * kw + kx) * B * B;
+        for (int i = 0; i < B; ++i) {
+          float x = src[i];
+          LITE_NCHWC_UNROLL
+          for (int b = 0; b < B; ++b) acc[b] += x * w_k[i * B + b];
+        }
+      }
+    }
+  }
+  StoreAct<B>(acc, dout, act_param);
+}
+
+template <int B>
+void ConvNCHWc(const float* din,
+               float* dout,
+               int num,
+               const float* weights,
+               const float* bias,
+               const ConvNCHWcParam& param,
+               const operators::ActivationParam& act_param) {
+  const int in_blocks = nchwc_blocks(param.chin, B);
+  const int out_blocks = nchwc_blocks(param.chout, B);
+  const int w_in_blocks = WeightInBlocks(param, B);
+  const int64_t w_block_size =
+      static_cast<int64_t>(w_in_blocks) * param.kernel_h * param.kernel_w * B *
+      B;
+  const int64_t in_plane = static_cast<int64_t>(param.hin) * param.win * B;
+  const int hout = param.hout;
+  const int wout = param.wout;
+  // outputs [ow_begin, ow_end) read no padding along the width
+  const int span = (param.kernel_w - 1) * param.dilation_w;
+  int ow_begin = (param.pad_w + param.stride_w - 1) / param.stride_w;
+  int ow_end = param.win + param.pad_w - span > 0
+                   ? (param.win + param.pad_w - span - 1) / param.stride_w + 1
+                   : 0;
+  ow_begin = std::min(ow_begin, wout);
+  ow_end = std::max(std::min(ow_end, wout), ow_begin);
+  const operators::ActivationParam& tile_act =
+      ActFused(act_param) ? act_param : operators::ActivationParam();
+
+  LITE_PARALLEL_BEGIN(job, tid, num * out_blocks * hout) {
+    int oh = job % hout;
+    int ocb = job / hout % out_blocks;
+    int n = job / hout / out_blocks;
+    const float* in_n =
+        din + (static_cast<int64_t>(n) * in_blocks +
+               InBlockStart(param, B, ocb)) *
+                  in_plane;
+    const float* w = weights + ocb * w_block_size;
+    const float* b = bias ? bias + ocb * B : nullptr;
+    float* out_row =
+        dout +
+        ((static_cast<int64_t>(n) * out_blocks + ocb) * hout + oh) * wout * B;
+    int ih0 = oh * param.stride_h - param.pad_h;
+    int ow = 0;
+    for (; ow < ow_begin; ++ow) {
+      ConvPixel<B>(in_n,
+                   w,
+                   b,
+                   out_row + ow * B,
+                   w_in_blocks,
+                   ih0,
+                   ow * param.stride_w - param.pad_w,
+                   param,
+                   tile_act);
+    }
+    const int tw = TileW<B>::value;
+    for (; ow + tw <= ow_end; ow += tw) {
+      ConvTile<B, tw>(in_n,
+                      w,
+                      b,
+                      out_row + ow * B,
+                      w_in_blocks,
+                      ih0,
+                      ow * param.stride_w - param.pad_w,
+                      param,
+                      tile_act);
+    }
+    // the rest of the interior in smaller tiles
+    for (; ow + 4 <= ow_end; ow += 4) {
+      ConvTile<B, 4>(in_n,
+                     w,
+                     b,
+                     out_row + ow * B,
+                     w_in_blocks,
+                     ih0,
+                     ow * param.stride_w - param.pad_w,
+                     param,
+                     tile_act);
+    }
+    for (; ow < wout; ++ow) {
+      ConvPixel<B>(in_n,
+                   w,
+                   b,
+                   out_row + ow * B,
+                   w_in_blocks,
+                   ih0,
+                   ow * param.stride_w - param.pad_w,
+                   param,
+                   tile_act);
+    }
+  }
+  LITE_PARALLEL_END();
+
+  if (!ActFused(act_param)) {
+    nchwc_act(dout,
+              dout,
+              nchwc_size(num, param.chout, hout * wout, B),
+              act_param);
+  }
+}
+
+template <int B>
+void ConvDepthwiseNCHWc(const float* din,
+                        float* dout,
+                        int num,
+                        const float* weights,
+                        const float* bias,
+                        const ConvNCHWcParam& param,
+                        const operators::ActivationParam& act_param) {
+  const int blocks = nchwc_blocks(param.chout, B);
+  const int kh = param.kernel_h;
+  const int kw = param.kernel_w;
+  const int hout = param.hout;
+  const int wout = param.wout;
+  const operators::ActivationParam& tile_act =
+      ActFused(act_param) ? act_param : operators::ActivationParam();
+
+  LITE_PARALLEL_BEGIN(job, tid, num * blocks * hout) {
+    int oh = job % hout;
+    int nb = job / hout;
+    int cb = nb % blocks;
+    const float* in_c =
+        din + static_cast<int64_t>(nb) * param.hin * param.win * B;
+    const float* w = weights + static_cast<int64_t>(cb) * kh * kw * B;
+    float* out_row = dout + (static_cast<int64_t>(nb) * hout + oh) * wout * B;
+    int ih0 = oh * param.stride_h - param.pad_h;
+    for (int ow = 0; ow < wout; ++ow) {
+      int iw0 = ow * param.stride_w - param.pad_w;
+      float acc[B];
+      LITE_NCHWC_UNROLL
+      for (int b = 0; b < B; ++b) acc[b] = bias ? bias[cb * B + b] : 0.f;
+      for (int ky = 0; ky < kh; ++ky) {
+        int ih = ih0 + ky * param.dilation_h;
+        if (ih < 0 || ih >= param.hin) continue;
+        const float* row = in_c + static_cast<int64_t>(ih) * param.win * B;
+        for (int kx = 0; kx < kw; ++kx) {
+          int iw = iw0 + kx * param.dilation_w;
+          if (iw < 0 || iw >= param.win) continue;
+          const float* src = row + iw * B;
+          const float* w_k = w + (ky * kw + kx) * B;
+          LITE_NCHWC_UNROLL
+          for (int b = 0; b < B; ++b) acc[b] += src[b] * w_k[b];
+        }
+      }
+      StoreAct<B>(acc, out_row + ow * B, tile_act);
+    }
+  }
+  LITE_PARALLEL_END();
+
+  if (!ActFused(act_param)) {
+    nchwc_act(dout,
+              dout,
+              nchwc_size(num, param.chout, hout * wout, B),
+              act_param);
+  }
+}
+
+}  // namespace
+
+int64_t conv_nchwc_weights_size(const ConvNCHWcParam& param, int block) {
+  return static_cast<int64_t>(nchwc_blocks(param.chout, block)) *
+         WeightInBlocks(param, block) * param.kernel_h * param.kernel_w *
+         block * block;
+}
+
+void conv_nchwc_trans_weights(const float* filter,
+                              float* dout,
+                              const ConvNCHWcParam& param,
+                              int block) {
+  const int out_blocks = nchwc_blocks(param.chout, block);
+  const int w_in_blocks = WeightInBlocks(param, block);
+  const int ic_group = param.chin / param.groups;
+  const int oc_group = param.chout / param.groups;
+  const int ksize = param.kernel_h * param.kernel_w;
+  float* dst = dout;
+  for (int ocb = 0; ocb < out_blocks; ++ocb) {
+    int icb_start = InBlockStart(param, block, ocb);
+    for (int icb = 0; icb < w_in_blocks; ++icb) {
+      for (int k = 0; k < ksize; ++k) {
+        for (int i = 0; i < block; ++i) {
+          int ic = (icb_start + icb) * block + i;
+          for (int o = 0; o < block; ++o) {
+            int oc = ocb * block + o;
+            float value = 0.f;
+            if (oc < param.chout && ic < param.chin &&
+                oc / oc_group == ic / ic_group) {
+              int ic_in_group = ic % ic_group;
+              value = filter[(static_cast<int64_t>(oc) * ic_group +
+                              ic_in_group) *
+                                 ksize +
+                             k];
+            }
+            *dst++ = value;
+          }
+        }
+      }
+    }
+  }
+}
+
+void conv_nchwc(const float* din,
+                float* dout,
+                int num,
+                const float* weights,
+                const float* bias,
+                const ConvNCHWcParam& param,
+                const operators::ActivationParam& act_param,
+                int block) {
+  if (block == 8) {
+    ConvNCHWc<8>(din, dout, num, weights, bias, param, act_param);
+  } else if (block == 16) {
+    ConvNCHWc<16>(din, dout, num, weights, bias, param, act_param);
+  } else {
+    LOG(FATAL) << "unsupported nchwc block " << block;
+  }
+}
+
+int64_t conv_depthwise_nchwc_weights_size(const ConvNCHWcParam& param,
+                                          int block) {
+  return static_cast<int64_t>(nchwc_blocks(param.chout, block)) * block *
+         param.kernel_h * param.kernel_w;
+}
+
+void conv_depthwise_nchwc_trans_weights(const float* filter,
+                                        float* dout,
+                                        const ConvNCHWcParam& param,
+                                        int block) {
+  const int blocks = nchwc_blocks(param.chout, block);
+  const int ksize = param.kernel_h * param.kernel_w;
+  for (int cb = 0; cb < blocks; ++cb) {
+    for (int k = 0; k < ksize; ++k) {
+      for (int b = 0; b < block; ++b) {
+        int c = cb * block + b;
+        dout[(cb * ksize + k) * block + b] =
+            c < param.chout ? filter[c * ksize + k] : 0.f;
+      }
+    }
+  }
+}
+
+void conv_depthwise_nchwc(const float* din,
+                          float* dout,
+                          int num,
+                          const float* weights,
+                          const float* bias,
+                          const ConvNCHWcParam& param,
+                          const operators::ActivationParam& act_param,
+                          int block) {
+  if (block == 8) {
+    ConvDepthwiseNCHWc<8>(din, dout, num, weights, bias, param, act_param);
+  } else if (block == 16) {
+    ConvDepthwiseNCHWc<16>(din, dout, num, weights, bias, param, act_param);
+  } else {
+    LOG(FATAL) << "unsupported nchwc block " << block;
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
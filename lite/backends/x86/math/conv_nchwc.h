@@ -0,0 +1,91 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * Direct convolutions on blocked NCHWc tensors (see nchwc.h), the
+ * accumulators of a few output pixels are kept in registers and updated
+ * with a whole block of output channels at once.
+ */
+
+struct ConvNCHWcParam {
+  int chin;
+  int hin;
+  int win;
+  int chout;
+  int hout;
+  int wout;
+  int kernel_h;
+  int kernel_w;
+  int stride_h;
+  int stride_w;
+  int pad_h;  // top
+  int pad_w;  // left
+  int dilation_h;
+  int dilation_w;
+  int groups;
+};
+
+// Size in floats of the weights transformed by conv_nchwc_trans_weights.
+int64_t conv_nchwc_weights_size(const ConvNCHWcParam& param, int block);
+
+// [chout, chin / groups, kh, kw] -> [chout / block, in blocks, kh, kw,
+// block (in), block (out)]. The groups are kept apart when the channels of
+// a group are a multiple of block, otherwise the filter is expanded into a
+// dense one with zeros out of the groups.
+void conv_nchwc_trans_weights(const float* filter,
+                              float* dout,
+                              const ConvNCHWcParam& param,
+                              int block);
+
+// bias is packed by nchwc_pack_channel and may be null.
+void conv_nchwc(const float* din,
+                float* dout,
+                int num,
+                const float* weights,
+                const float* bias,
+                const ConvNCHWcParam& param,
+                const operators::ActivationParam& act_param,
+                int block);
+
+// Depthwise convolution, groups == chin == chout.
+// [channel, 1, kh, kw] -> [channel / block, kh, kw, block]
+int64_t conv_depthwise_nchwc_weights_size(const ConvNCHWcParam& param,
+                                          int block);
+void conv_depthwise_nchwc_trans_weights(const float* filter,
+                                        float* dout,
+                                        const ConvNCHWcParam& param,
+                                        int block);
+void conv_depthwise_nchwc(const float* din,
+                          float* dout,
+                          int num,
+                          const float* weights,
+                          const float* bias,
+                          const ConvNCHWcParam& param,
+                          const operators::ActivationParam& act_param,
+                          int block);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
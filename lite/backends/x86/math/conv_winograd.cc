@@ -0,0 +1,495 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/conv_winograd.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <vector>
+#include "lite/backends/x86/math/packed_sgemm.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The tiles are transformed kLanes at a time, one tile per lane.
+const int kLanes = 8;
+// Floats of the transformed inputs and outputs of one block of tiles, so
+// that they stay in L2 between the transforms and the gemms.
+const int kBlockFloats = 512 * 1024;
+
+// The transforms must be fully unrolled, so that the zero coefficients are
+// dropped at compile time and the lanes stay in registers.
+#if defined(__clang__)
+#define LITE_WINOGRAD_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define LITE_WINOGRAD_UNROLL _Pragma("GCC unroll 8")
+#else
+#define LITE_WINOGRAD_UNROLL
+#endif
+
+#ifdef __AVX__
+typedef __m256 Lane;
+inline Lane LaneZero() { return _mm256_setzero_ps(); }
+inline Lane LaneLoad(const float* ptr) { return _mm256_loadu_ps(ptr); }
+inline void LaneStore(float* ptr, Lane v) { _mm256_storeu_ps(ptr, v); }
+// acc + c * x
+inline Lane LaneMulAdd(Lane acc, float c, Lane x) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(_mm256_set1_ps(c), x, acc);
+#else
+  return _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(c), x));
+#endif
+}
+#else
+struct Lane {
+  float v[kLanes];
+};
+inline Lane LaneZero() {
+  Lane r;
+  std::fill(r.v, r.v + kLanes, 0.f);
+  return r;
+}
+inline Lane LaneLoad(const float* ptr) {
+  Lane r;
+  std::copy(ptr, ptr + kLanes, r.v);
+  return r;
+}
+inline void LaneStore(float* ptr, Lane v) {
+  std::copy(v.v, v.v + kLanes, ptr);
+}
+inline Lane LaneMulAdd(Lane acc, float c, Lane x) {
+  for (int l = 0; l < kLanes; ++l) acc.v[l] += c * x.v[l];
+  return acc;
+}
+#endif
+
+// Transform matrices of F(unit, 3): Y = AT * [(G g GT) .* (BT d B)] * A,
+// the interpolation points are 0, 1, -1, 2, -2 (, 1/2, -1/2) and infinity.
+template <int UNIT>
+struct WinogradMatrix;
+
+template <>
+struct WinogradMatrix<4> {
+  static const int T = 6;
+  static const float BT[6][6];
+  static const float G[6][3];
+  static const float AT[4][6];
+};
+
+const float WinogradMatrix<4>::BT[6][6] = {{4.f, 0.f, -5.f, 0.f, 1.f, 0.f},
+                                          {0.f, -4.f, -4.f, 1.f, 1.f, 0.f},
+                                          {0.f, 4.f, -4.f, -1.f, 1.f, 0.f},
+                                          {0.f, -2.f, -1.f, 2.f, 1.f, 0.f},
+                                          {0.f, 2.f, -1.f, -2.f, 1.f, 0.f},
+                                          {0.f, 4.f, 0.f, -5.f, 0.f, 1.f}};
+const float WinogradMatrix<4>::G[6][3] = {{1.f / 4, 0.f, 0.f},
+                                          {-1.f / 6, -1.f / 6, -1.f / 6},
+                                          {-1.f / 6, 1.f / 6, -1.f / 6},
+                                          {1.f / 24, 1.f / 12, 1.f / 6},
+                                          {1.f / 24, -1.f / 12, 1.f / 6},
+                                          {0.f, 0.f, 1.f}};
+const float WinogradMatrix<4>::AT[4][6] = {{1.f, 1.f, 1.f, 1.f, 1.f, 0.f},
+                                          {0.f, 1.f, -1.f, 2.f, -2.f, 0.f},
+                                          {0.f, 1.f, 1.f, 4.f, 4.f, 0.f},
+                                          {0.f, 1.f, -1.f, 8.f, -8.f, 1.f}};
+
+template <>
+struct WinogradMatrix<6> {
+  static const int T = 8;
+  static const float BT[8][8];
+  static const float G[8][3];
+  static const float AT[6][8];
+};
+
+const float WinogradMatrix<6>::BT[8][8] = {
+    {1.f, 0.f, -21.f / 4, 0.f, 21.f / 4, 0.f, -1.f, 0.f},
+    {0.f, 1.f, 1.f, -17.f / 4, -17.f / 4, 1.f, 1.f, 0.f},
+    {0.f, -1.f, 1.f, 17.f / 4, -17.f / 4, -1.f, 1.f, 0.f},
+    {0.f, 1.f / 2, 1.f / 4, -5.f / 2, -5.f / 4, 2.f, 1.f, 0.f},
+    {0.f, -1.f / 2, 1.f / 4, 5.f / 2, -5.f / 4, -2.f, 1.f, 0.f},
+    {0.f, 2.f, 4.f, -5.f / 2, -5.f, 1.f / 2, 1.f, 0.f},
+    {0.f, -2.f, 4.f, 5.f / 2, -5.f, -1.f / 2, 1.f, 0.f},
+    {0.f, -1.f, 0.f, 21.f / 4, 0.f, -21.f / 4, 0.f, 1.f}};
+const float WinogradMatrix<6>::G[8][3] = {{1.f, 0.f, 0.f},
+                                          {-2.f / 9, -2.f / 9, -2.f / 9},
+                                          {-2.f / 9, 2.f / 9, -2.f / 9},
+                                          {1.f / 90, 1.f / 45, 2.f / 45},
+                                          {1.f / 90, -1.f / 45, 2.f / 45},
+                                          {32.f / 45, 16.f / 45, 8.f / 45},
+                                          {32.f / 45, -16.f / 45, 8.f / 45},
+                                          {0.f, 0.f, 1.f}};
+const float WinogradMatrix<6>::AT[6][8] = {
+    {1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 0.f},
+    {0.f, 1.f, -1.f, 2.f, -2.f, 1.f / 2, -1.f / 2, 0.f},
+    {0.f, 1.f, 1.f, 4.f, 4.f, 1.f / 4, 1.f / 4, 0.f},
+    {0.f, 1.f, -1.f, 8.f, -8.f, 1.f / 8, -1.f / 8, 0.f},
+    {0.f, 1.f, 1.f, 16.f, 16.f, 1.f / 16, 1.f / 16, 0.f},
+    {0.f, 1.f, -1.f, 32.f, -32.f, 1.f / 32, -1.f / 32, 1.f}};
+
+// out = L * in * R^T, L is [P, K], in is [K, K], R is [Q, K]. Zero
+// coefficients are skipped, most of the transform matrices are sparse.
+template <int P, int Q, int K>
+inline void LaneTransform(const float (&L)[P][K],
+                          const float (&R)[Q][K],
+                          const Lane (&in)[K][K],
+                          Lane (&out)[P][Q]) {
+  Lane tmp[P][K];
+  LITE_WINOGRAD_UNROLL
+  for (int i = 0; i < P; ++i) {
+    LITE_WINOGRAD_UNROLL
+    for (int j = 0; j < K; ++j) {
+      Lane acc = LaneZero();
+      LITE_WINOGRAD_UNROLL
+      for (int k = 0; k < K; ++k) {
+        if (L[i][k] != 0.f) acc = LaneMulAdd(acc, L[i][k], in[k][j]);
+      }
+      tmp[i][j] = acc;
+    }
+  }
+  LITE_WINOGRAD_UNROLL
+  for (int i = 0; i < P; ++i) {
+    LITE_WINOGRAD_UNROLL
+    for (int j = 0; j < Q; ++j) {
+      Lane acc = LaneZero();
+      LITE_WINOGRAD_UNROLL
+      for (int k = 0; k < K; ++k) {
+        if (R[j][k] != 0.f) acc = LaneMulAdd(acc, R[j][k], tmp[i][k]);
+      }
+      out[i][j] = acc;
+    }
+  }
+}
+
+template <int UNIT>
+void WinogradTransWeights(const float* filter,
+                          float* dout,
+                          int chout,
+                          int chin) {
+  typedef WinogradMatrix<UNIT> Matrix;
+  const int T = Matrix::T;
+  // [T * T, chout, chin] before packing
+  std::vector<float> trans(static_cast<size_t>(T) * T * chout * chin);
+  const int64_t plane = static_cast<int64_t>(chout) * chin;
+  for (int64_t oc_ic = 0; oc_ic < plane; ++oc_ic) {
+    const float* g = filter + oc_ic * 9;
+    // tmp = G * g, [T, 3]
+    float tmp[T][3];
+    for (int i = 0; i < T; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        tmp[i][j] = Matrix::G[i][0] * g[j] + Matrix::G[i][1] * g[3 + j] +
+                    Matrix::G[i][2] * g[6 + j];
+      }
+    }
+    // u = tmp * GT, [T, T]
+    for (int i = 0; i < T; ++i) {
+      for (int j = 0; j < T; ++j) {
+        trans[(i * T + j) * plane + oc_ic] = tmp[i][0] * Matrix::G[j][0] +
+                                             tmp[i][1] * Matrix::G[j][1] +
+                                             tmp[i][2] * Matrix::G[j][2];
+      }
+    }
+  }
+  const int64_t packed_size = sgemm_packed_a_size(chout, chin);
+  for (int e = 0; e < T * T; ++e) {
+    sgemm_pack_a(false,
+                 chout,
+                 chin,
+                 trans.data() + e * plane,
+                 chin,
+                 dout + e * packed_size);
+  }
+}
+
+// Transform the input tiles [tile_begin, tile_end) of one channel into
+// `dout` [T * T, chin, tile_block], starting at column `col`.
+template <int UNIT>
+void WinogradTransInput(const float* din,
+                        float* dout,
+                        int hin,
+                        int win,
+                        int pad_h,
+                        int pad_w,
+                        int tiles_w,
+                        int tile_begin,
+                        int tile_end,
+                        int64_t plane_stride) {
+  typedef WinogradMatrix<UNIT> Matrix;
+  const int T = Matrix::T;
+  for (int t0 = tile_begin; t0 < tile_end; t0 += kLanes) {
+    int lanes = std::min(kLanes, tile_end - t0);
+    float patch[T][T][kLanes];
+    for (int l = 0; l < kLanes; ++l) {
+      int tile = t0 + l;
+      int h0 = tile / tiles_w * UNIT - pad_h;
+      int w0 = tile % tiles_w * UNIT - pad_w;
+      if (l < lanes && h0 >= 0 && w0 >= 0 && h0 + T <= hin &&
+          w0 + T <= win) {
+        const float* src = din + static_cast<int64_t>(h0) * win + w0;
+        for (int i = 0; i < T; ++i) {
+          for (int j = 0; j < T; ++j) {
+            patch[i][j][l] = src[i * win + j];
+          }
+        }
+        continue;
+      }
+      // tiles on the border, or the padding lanes of the last group
+      for (int i = 0; i < T; ++i) {
+        int h = h0 + i;
+        for (int j = 0; j < T; ++j) {
+          int w = w0 + j;
+          bool valid = l < lanes && h >= 0 && h < hin && w >= 0 && w < win;
+          patch[i][j][l] = valid ? din[static_cast<int64_t>(h) * win + w] : 0.f;
+        }
+      }
+    }
+    Lane d[T][T];
+    Lane v[T][T];
+    for (int i = 0; i < T; ++i) {
+      for (int j = 0; j < T; ++j) {
+        d[i][j] = LaneLoad(patch[i][j]);
+      }
+    }
+    LaneTransform<T, T, T>(Matrix::BT, Matrix::BT, d, v);
+    float* dst = dout + (t0 - tile_begin);
+    for (int i = 0; i < T; ++i) {
+      for (int j = 0; j < T; ++j) {
+        float* ptr = dst + (i * T + j) * plane_stride;
+        if (lanes == kLanes) {
+          LaneStore(ptr, v[i][j]);
+        } else {
+          float tmp[kLanes];
+          LaneStore(tmp, v[i][j]);
+          std::copy(tmp, tmp + lanes, ptr);
+        }
+      }
+    }
+  }
+}
+
+// Transform the gemm results of one channel [T * T, chout, tile_block] back
+// into the output tiles [tile_begin, tile_end).
+template <int UNIT>
+void WinogradTransOutput(const float* din,
+                         float* dout,
+                         int hout,
+                         int wout,
+                         int tiles_w,
+                         int tile_begin,
+                         int tile_end,
+                         int64_t plane_stride) {
+  typedef WinogradMatrix<UNIT> Matrix;
+  const int T = Matrix::T;
+  for (int t0 = tile_begin; t0 < tile_end; t0 += kLanes) {
+    int lanes = std::min(kLanes, tile_end - t0);
+    const float* src = din + (t0 - tile_begin);
+    Lane m[T][T];
+    Lane y[UNIT][UNIT];
+    for (int i = 0; i < T; ++i) {
+      for (int j = 0; j < T; ++j) {
+        const float* ptr = src + (i * T + j) * plane_stride;
+        if (lanes == kLanes) {
+          m[i][j] = LaneLoad(ptr);
+        } else {
+          float tmp[kLanes] = {0.f};
+          std::copy(ptr, ptr + lanes, tmp);
+          m[i][j] = LaneLoad(tmp);
+        }
+      }
+    }
+    LaneTransform<UNIT, UNIT, T>(Matrix::AT, Matrix::AT, m, y);
+    float out[UNIT][UNIT][kLanes];
+    for (int i = 0; i < UNIT; ++i) {
+      for (int j = 0; j < UNIT; ++j) {
+        LaneStore(out[i][j], y[i][j]);
+      }
+    }
+    for (int l = 0; l < lanes; ++l) {
+      int tile = t0 + l;
+      int h0 = tile / tiles_w * UNIT;
+      int w0 = tile % tiles_w * UNIT;
+      int rows = std::min(UNIT, hout - h0);
+      int cols = std::min(UNIT, wout - w0);
+      for (int i = 0; i < rows; ++i) {
+        float* row = dout + static_cast<int64_t>(h0 + i) * wout + w0;
+        for (int j = 0; j < cols; ++j) {
+          row[j] = out[i][j][l];
+        }
+      }
+    }
+  }
+}
+
+template <int UNIT>
+void ConvWinograd3x3(const float* din,
+                     float* dout,
+                     int num,
+                     int chout,
+                     int hout,
+                     int wout,
+                     int chin,
+                     int hin,
+                     int win,
+                     int pad_h,
+                     int pad_w,
+                     const float* weights,
+                     X86Context* ctx) {
+  const int T = WinogradMatrix<UNIT>::T;
+  const int tiles_h = (hout + UNIT - 1) / UNIT;
+  const int tiles_w = (wout + UNIT - 1) / UNIT;
+  const int tiles = tiles_h * tiles_w;
+  int tile_block = kBlockFloats / (T * T * (chin + chout));
+  tile_block = std::max(kLanes, tile_block / kLanes * kLanes);
+  tile_block = std::min(tile_block, (tiles + kLanes - 1) / kLanes * kLanes);
+
+  const int64_t packed_size = sgemm_packed_a_size(chout, chin);
+  const int64_t in_plane = static_cast<int64_t>(chin) * tile_block;
+  const int64_t out_plane = static_cast<int64_t>(chout) * tile_block;
+  // Keep trans_out 64-byte aligned, in_plane is a multiple of kLanes.
+  const int64_t in_size = (T * T * in_plane + 15) / 16 * 16;
+  ctx->ExtendWorkspace(sizeof(float) * (in_size + T * T * out_plane));
+  float* trans_in = ctx->workspace_data<float>();
+  float* trans_out = trans_in + in_size;
+
+  for (int n = 0; n < num; ++n) {
+    const float* din_batch = din + static_cast<int64_t>(n) * chin * hin * win;
+    float* dout_batch = dout + static_cast<int64_t>(n) * chout * hout * wout;
+    for (int tile_begin = 0; tile_begin < tiles; tile_begin += tile_block) {
+      int tile_end = std::min(tile_begin + tile_block, tiles);
+      int block = tile_end - tile_begin;
+      LITE_PARALLEL_BEGIN(c, tid, chin) {
+        WinogradTransInput<UNIT>(
+            din_batch + static_cast<int64_t>(c) * hin * win,
+            trans_in + c * tile_block,
+            hin,
+            win,
+            pad_h,
+            pad_w,
+            tiles_w,
+            tile_begin,
+            tile_end,
+            in_plane);
+      }
+      LITE_PARALLEL_END();
+      // One gemm per element of the tile: [chout, chin] x [chin, block]
+      LITE_PARALLEL_BEGIN(e, tid, T * T) {
+        sgemm(false,
+              false,
+              chout,
+              block,
+              chin,
+              1.f,
+              nullptr,
+              chin,
+              trans_in + e * in_plane,
+              tile_block,
+              0.f,
+              trans_out + e * out_plane,
+              tile_block,
+              weights + e * packed_size,
+              nullptr);
+      }
+      LITE_PARALLEL_END();
+      LITE_PARALLEL_BEGIN(c, tid, chout) {
+        WinogradTransOutput<UNIT>(
+            trans_out + c * tile_block,
+            dout_batch + static_cast<int64_t>(c) * hout * wout,
+            hout,
+            wout,
+            tiles_w,
+            tile_begin,
+            tile_end,
+            out_plane);
+      }
+      LITE_PARALLEL_END();
+    }
+  }
+}
+
+}  // namespace
+
+int64_t conv_winograd3x3_weights_size(int unit, int chout, int chin) {
+  CHECK(unit == 4 || unit == 6) << "unsupported winograd unit " << unit;
+  return static_cast<int64_t>(unit + 2) * (unit + 2) *
+         sgemm_packed_a_size(chout, chin);
+}
+
+void conv_winograd3x3_trans_weights(
+    int unit, const float* filter, float* dout, int chout, int chin) {
+  if (unit == 4) {
+    WinogradTransWeights<4>(filter, dout, chout, chin);
+  } else if (unit == 6) {
+    WinogradTransWeights<6>(filter, dout, chout, chin);
+  } else {
+    LOG(FATAL) << "unsupported winograd unit " << unit;
+  }
+}
+
+void conv_winograd3x3(int unit,
+                      const float* din,
+                      float* dout,
+                      int num,
+                      int chout,
+                      int hout,
+                      int wout,
+                      int chin,
+                      int hin,
+                      int win,
+                      int pad_h,
+                      int pad_w,
+                      const float* weights,
+                      X86Context* ctx) {
+  if (unit == 4) {
+    ConvWinograd3x3<4>(din,
+                       dout,
+                       num,
+                       chout,
+                       hout,
+                       wout,
+                       chin,
+                       hin,
+                       win,
+                       pad_h,
+                       pad_w,
+                       weights,
+                       ctx);
+  } else if (unit == 6) {
+    ConvWinograd3x3<6>(din,
+                       dout,
+                       num,
+                       chout,
+                       hout,
+                       wout,
+                       chin,
+                       hin,
+                       win,
+                       pad_h,
+                       pad_w,
+                       weights,
+                       ctx);
+  } else {
+    LOG(FATAL) << "unsupported winograd unit " << unit;
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,65 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include "lite/core/context.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * 3x3 stride 1 convolution by Winograd F(unit x unit, 3x3), `unit` is 4 or 6.
+ *
+ * The input is split into tiles of (unit + 2) x (unit + 2) which overlap by
+ * 2, each tile gives unit x unit outputs. Input tiles and filters are
+ * transformed into the Winograd domain, where the convolution becomes
+ * (unit + 2)^2 independent [chout, chin] x [chin, tiles] gemms, computed by
+ * the packed sgemm.
+ */
+
+// Size of the transformed filter in floats.
+int64_t conv_winograd3x3_weights_size(int unit, int chout, int chin);
+
+// Transform the [chout, chin, 3, 3] filter into (unit + 2)^2 matrices of
+// [chout, chin], each one packed by sgemm_pack_a.
+void conv_winograd3x3_trans_weights(
+    int unit, const float* filter, float* dout, int chout, int chin);
+
+// Compute the convolution without bias, `weights` is transformed by
+// conv_winograd3x3_trans_weights, pad_h/pad_w are the top and left paddings.
+// The bottom and right paddings are implied by hout and wout. The transformed
+// tiles are kept in the workspace of `ctx`.
+void conv_winograd3x3(int unit,
+                      const float* din,
+                      float* dout,
+                      int num,
+                      int chout,
+                      int hout,
+                      int wout,
+                      int chin,
+                      int hin,
+                      int win,
+                      int pad_h,
+                      int pad_w,
+                      const float* weights,
+                      X86Context* ctx);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
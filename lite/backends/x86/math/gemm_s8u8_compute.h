@@ -20,6 +20,7 @@ limitations under the License. */
 #include "lite/backends/x86/math/gemm_s8u8_kernel.h"
 #include "lite/backends/x86/math/gemm_s8u8_pack.h"
 #include "lite/core/memory.h"
+#include "lite/core/parallel_defines.h"
 
 namespace paddle {
 namespace lite {
@@ -71,38 +72,59 @@ class generate_gemm_s8u8_x86_kern {
 
     _B = B;
     _C = C;
-    int loop_m, loop_n;
     int block_m, block_n;
-    int min_m, min_n;
-    int8_t *cur_a = _pack_A;
-    const int8_t *cur_b = _B;
-    TYPE_C *cur_c = _C;
     calc_block(_M, _N, _K, &block_m, &block_n);
-    for (loop_n = 0; loop_n < _N; loop_n += block_n) {
-      min_n = ((_N - loop_n) >= block_n) ? block_n : (_N - loop_n);
-      cur_b = _is_trans_B ? (_B + loop_n * _K) : (_B + loop_n);
-      int step = _is_trans_B ? _K : _N;
-      packB_i82u8(min_n, _K, step, cur_b, _pack_B, _is_trans_B);
-
-      for (loop_m = 0; loop_m < _M; loop_m += block_m) {
-        min_m = ((_M - loop_m) >= block_m) ? block_m : (_M - loop_m);
-        cur_a = _pack_A + loop_m * _k_align4;
-        cur_c = _C + loop_m * _ldc + loop_n;
-
-        // kernel
-        gemm_kernel_loop_int8(min_m,
-                              min_n,
-                              _K,
-                              cur_a,
-                              _pack_B,
-                              cur_c,
-                              _ldc,
-                              _scale + loop_m,
-                              _re_bias + loop_m,
-                              _relu_type,
-                              _relu_alpha);
+    // Every thread needs a tile: narrow the column blocks first, then split
+    // the rows in multiples of 8 once the columns run out. Each task packs
+    // its own B tile into a per thread slot of _pack_B.
+    const int threads = thread_num();
+    if (threads > 1) {
+      int n_tiles = (_N + block_n - 1) / block_n;
+      if (n_tiles < threads) {
+        block_n = (_N + threads - 1) / threads;
+        block_n = std::max(_unroll_n,
+                           (block_n + _unroll_n - 1) / _unroll_n * _unroll_n);
+        n_tiles = (_N + block_n - 1) / block_n;
       }
+      int m_parts = std::min((threads + n_tiles - 1) / n_tiles,
+                             std::max(1, _M / _min_m_per_thread));
+      block_m = (_M + m_parts - 1) / m_parts;
+      block_m = (block_m + _unroll_m_thread - 1) / _unroll_m_thread *
+                _unroll_m_thread;
+      reserve_pack_B(threads);
     }
+    const int m_tiles = (_M + block_m - 1) / block_m;
+    const int n_tiles = (_N + block_n - 1) / block_n;
+    const int step = _is_trans_B ? _K : _N;
+
+    LITE_PARALLEL_BEGIN(tile, tid, m_tiles * n_tiles) {
+      int loop_n = tile / m_tiles * block_n;
+      int loop_m = tile % m_tiles * block_m;
+      int min_n = std::min(block_n, _N - loop_n);
+      int min_m = std::min(block_m, _M - loop_m);
+#ifdef LITE_USE_THREAD_POOL
+      uint8_t *pack_b = _pack_B + static_cast<size_t>(tid) * _pack_B_size;
+#else
+      uint8_t *pack_b = _pack_B;
+#endif
+      const int8_t *cur_b = _is_trans_B ? (_B + loop_n * _K) : (_B + loop_n);
+      packB_i82u8(min_n, _K, step, cur_b, pack_b, _is_trans_B);
+
+      // kernel
+      gemm_kernel_loop_int8(_isa,
+                            min_m,
+                            min_n,
+                            _K,
+                            _pack_A + loop_m * _k_align4,
+                            pack_b,
+                            _C + loop_m * _ldc + loop_n,
+                            _ldc,
+                            _scale + loop_m,
+                            _re_bias + loop_m,
+                            _relu_type,
+                            _relu_alpha);
+    }
+    LITE_PARALLEL_END();
   }
 
  private:
@@ -118,7 +140,10 @@ class generate_gemm_s8u8_x86_kern {
   // divide block param
   const int _unroll_n = 32;
   const int _unroll_m = 2;
+  const int _unroll_m_thread = 8;
+  const int _min_m_per_thread = 16;
   const int _l2_size = 262144;  // 256K
+  GemmS8U8Isa _isa{GemmS8U8Isa::kAVX2};
   // work buffer
   TYPE_C *_C{nullptr};
   float *_Sa{nullptr};
@@ -127,6 +152,8 @@ class generate_gemm_s8u8_x86_kern {
   float *_re_bias{nullptr};
   int8_t *_pack_A{nullptr};
   uint8_t *_pack_B{nullptr};
+  int _pack_B_size{0};  // bytes of one thread slot
+  int _pack_B_slots{1};
   const int8_t *_A{nullptr};
   const int8_t *_B{nullptr};
 
@@ -171,8 +198,10 @@ class generate_gemm_s8u8_x86_kern {
     // malloc work_buf
     _pack_A = reinterpret_cast<int8_t *>(
         TargetMalloc(TARGET(kX86), block_m * K_align4));
+    _pack_B_size = block_n * K_align4;
     _pack_B = reinterpret_cast<uint8_t *>(
-        TargetMalloc(TARGET(kX86), block_n * K_align4));
+        TargetMalloc(TARGET(kX86), _pack_B_size));
+    _isa = gemm_s8u8_isa();
     _re_bias = reinterpret_cast<float *>(
         TargetMalloc(TARGET(kX86), M * sizeof(float)));
     _scale = reinterpret_cast<float *>(
@@ -190,6 +219,23 @@ class generate_gemm_s8u8_x86_kern {
     prepackA_i8(M, K, _A, _pack_A, _is_trans_A);
   }
 
+  static int thread_num() {
+#ifdef LITE_USE_THREAD_POOL
+    ThreadPool *pool = ThreadPool::Current();
+    return pool != nullptr ? pool->thread_num() : 1;
+#else
+    return 1;
+#endif
+  }
+
+  void reserve_pack_B(int slots) {
+    if (slots <= _pack_B_slots) return;
+    TargetFree(TARGET(kX86), _pack_B);
+    _pack_B = reinterpret_cast<uint8_t *>(TargetMalloc(
+        TARGET(kX86), static_cast<size_t>(slots) * _pack_B_size));
+    _pack_B_slots = slots;
+  }
+
   void gemm_int8_deinit() {
     if (_pack_A != nullptr) {
       TargetFree(TARGET(kX86), _pack_A);
@@ -0,0 +1,156 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#ifdef __AVX2__
+
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/x86/math/gemm_s8u8_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+int gemm_s8u8_dynamic_range() {
+  return gemm_s8u8_isa() == GemmS8U8Isa::kAVX512VNNI ? 127 : 63;
+}
+
+void quantize_rows_s8(bool trans,
+                      int M,
+                      int K,
+                      const float* A,
+                      int lda,
+                      int range,
+                      int8_t* out,
+                      float* scale) {
+  const int64_t row_step = trans ? 1 : lda;
+  const int64_t col_step = trans ? lda : 1;
+  for (int i = 0; i < M; i++) {
+    const float* a_ptr = A + i * row_step;
+    float max_val = 0.f;
+    for (int j = 0; j < K; j++) {
+      max_val = std::max(max_val, std::fabs(a_ptr[j * col_step]));
+    }
+    float inv_scale = max_val > 0.f ? range / max_val : 0.f;
+    int8_t* o_ptr = out + static_cast<int64_t>(i) * K;
+    for (int j = 0; j < K; j++) {
+      float val = a_ptr[j * col_step] * inv_scale;
+      o_ptr[j] = static_cast<int8_t>(std::round(val));
+    }
+    scale[i] = max_val / range;
+  }
+}
+
+float quantize_tensor_s8(int64_t size, const float* x, int range, int8_t* out) {
+  float max_val = 0.f;
+  for (int64_t i = 0; i < size; i++) {
+    max_val = std::max(max_val, std::fabs(x[i]));
+  }
+  float inv_scale = max_val > 0.f ? range / max_val : 0.f;
+  for (int64_t i = 0; i < size; i++) {
+    out[i] = static_cast<int8_t>(std::round(x[i] * inv_scale));
+  }
+  return max_val / range;
+}
+
+void gemm_s8u8_dynamic(bool trans_a,
+                       bool trans_b,
+                       int M,
+                       int N,
+                       int K,
+                       float alpha,
+                       const float* A,
+                       int lda,
+                       const int8_t* B,
+                       const float* b_scale,
+                       int b_scale_size,
+                       float* C) {
+  std::vector<int8_t> a_s8(static_cast<int64_t>(M) * K);
+  std::vector<float> a_scale(M);
+  quantize_rows_s8(trans_a,
+                   M,
+                   K,
+                   A,
+                   lda,
+                   gemm_s8u8_dynamic_range(),
+                   a_s8.data(),
+                   a_scale.data());
+  for (int i = 0; i < M; i++) a_scale[i] *= alpha;
+  // Per column scales of B can't fold into the per row scales of the kernel,
+  // they are applied to the float output instead.
+  bool per_column = b_scale_size > 1;
+  float Sb = per_column ? 1.f : b_scale[0];
+  generate_gemm_s8u8_x86_kern<float> gemm(false,
+                                          trans_b,
+                                          M,
+                                          N,
+                                          K,
+                                          a_s8.data(),
+                                          N,
+                                          a_scale.data(),
+                                          Sb,
+                                          1.f,
+                                          nullptr,
+                                          0,
+                                          0.f);
+  gemm.compute(a_s8.data(), B, C);
+  if (per_column) {
+    for (int i = 0; i < M; i++) {
+      float* c_ptr = C + static_cast<int64_t>(i) * N;
+      for (int j = 0; j < N; j++) c_ptr[j] *= b_scale[j];
+    }
+  }
+}
+
+const int8_t* gemm_s8u8_dynamic_b(const lite::Tensor& b,
+                                  bool trans_b,
+                                  const std::vector<float>& weight_scale,
+                                  lite::Tensor* b_s8,
+                                  std::vector<float>* b_scale) {
+  if (b.precision() != PRECISION(kInt8)) {
+    b_s8->Resize(b.dims());
+    float scale = quantize_tensor_s8(b.numel(),
+                                     b.data<float>(),
+                                     127,
+                                     b_s8->mutable_data<int8_t>());
+    b_scale->assign(1, scale);
+    return b_s8->data<int8_t>();
+  }
+  CHECK(!weight_scale.empty()) << "The int8 weight has no scale";
+  bool per_tensor = std::all_of(weight_scale.begin(),
+                                weight_scale.end(),
+                                [&](float s) { return s == weight_scale[0]; });
+  if (per_tensor) {
+    b_scale->assign(1, weight_scale[0]);
+  } else {
+    // The channel wise scales are along the last dim of the weight, they are
+    // the output columns only if the weight isn't transposed.
+    CHECK(!trans_b && static_cast<int64_t>(weight_scale.size()) ==
+                          b.dims()[b.dims().size() - 1])
+        << "The weight scales of size " << weight_scale.size()
+        << " don't match the output columns of weight " << b.dims();
+    *b_scale = weight_scale;
+  }
+  return b.data<int8_t>();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
+
+#endif  // __AVX2__
@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The largest int8 value of a dynamically quantized A. The AVX2 and AVX-512BW
+// kernels add two u8 x s8 products in int16, so A keeps 7 bits there.
+int gemm_s8u8_dynamic_range();
+
+// Symmetric quantization of the rows of op(A), A is [M, K] or [K, M] if
+// trans: out[M, K] = round(op(A) / scale) with scale[i] = max|row i| / range.
+void quantize_rows_s8(bool trans,
+                      int M,
+                      int K,
+                      const float* A,
+                      int lda,
+                      int range,
+                      int8_t* out,
+                      float* scale);
+
+// Symmetric quantization of a whole tensor, returns its scale.
+float quantize_tensor_s8(int64_t size, const float* x, int range, int8_t* out);
+
+// C[M, N] = alpha * op(A) * op(B), A is a float matrix quantized per row on
+// the fly, B is an int8 matrix with one scale (b_scale_size == 1) or one per
+// column of C. op(B) is [K, N], B itself is [N, K] if trans_b.
+void gemm_s8u8_dynamic(bool trans_a,
+                       bool trans_b,
+                       int M,
+                       int N,
+                       int K,
+                       float alpha,
+                       const float* A,
+                       int lda,
+                       const int8_t* B,
+                       const float* b_scale,
+                       int b_scale_size,
+                       float* C);
+
+// The int8 data and scales of B for gemm_s8u8_dynamic. An int8 B keeps the
+// weight scales of the op, a float B is quantized per tensor into b_s8.
+const int8_t* gemm_s8u8_dynamic_b(const lite::Tensor& b,
+                                  bool trans_b,
+                                  const std::vector<float>& weight_scale,
+                                  lite::Tensor* b_s8,
+                                  std::vector<float>* b_scale);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -21,6 +21,13 @@ namespace lite {
 namespace x86 {
 namespace math {
 
+// Micro kernels of the int8 gemm. The AVX2 one is always built, the AVX-512
+// ones are compiled for their own target and only run when the cpu has it.
+enum class GemmS8U8Isa { kAVX2 = 0, kAVX512BW, kAVX512VNNI };
+
+// The fastest kernel supported by the running cpu, probed once.
+GemmS8U8Isa gemm_s8u8_isa();
+
 void gemm_kernel_loop_int8(int M,
                            int N,
                            int K,
@@ -45,6 +52,34 @@ void gemm_kernel_loop_int8(int M,
                            int relu_type,
                            float relu_alpha);
 
+// Same as above with the micro kernel picked by `isa`, it falls back to AVX2
+// when the AVX-512 kernels are not compiled in.
+void gemm_kernel_loop_int8(GemmS8U8Isa isa,
+                           int M,
+                           int N,
+                           int K,
+                           int8_t* A,
+                           uint8_t* B,
+                           int8_t* C,
+                           int ldc,
+                           const float* scale,
+                           const float* bias,
+                           int relu_type,
+                           float relu_alpha);
+
+void gemm_kernel_loop_int8(GemmS8U8Isa isa,
+                           int M,
+                           int N,
+                           int K,
+                           int8_t* A,
+                           uint8_t* B,
+                           float* C,
+                           int ldc,
+                           const float* scale,
+                           const float* bias,
+                           int relu_type,
+                           float relu_alpha);
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
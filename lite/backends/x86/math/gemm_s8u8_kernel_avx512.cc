@@ -0,0 +1,383 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <algorithm>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+
+// The AVX-512 kernels are built with a per function target on top of the
+// AVX2 build, so one binary serves every cpu and only the dispatch changes.
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8)
+#define LITE_S8U8_WITH_AVX512
+#define LITE_S8U8_TARGET_AVX512BW \
+  __attribute__((target("avx512f,avx512bw,avx512vl,avx512dq")))
+#define LITE_S8U8_TARGET_AVX512VNNI \
+  __attribute__((target("avx512f,avx512bw,avx512vl,avx512dq,avx512vnni")))
+#elif defined(_MSC_VER)
+#define LITE_S8U8_WITH_AVX512
+#define LITE_S8U8_TARGET_AVX512BW
+#define LITE_S8U8_TARGET_AVX512VNNI
+#endif
+
+// The row loops must be fully unrolled to keep the accumulators in zmm.
+#if defined(__GNUC__)
+#define LITE_S8U8_UNROLL _Pragma("GCC unroll 8")
+#else
+#define LITE_S8U8_UNROLL
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#ifdef LITE_S8U8_WITH_AVX512
+
+namespace {
+
+// One tile is 8 rows of C (4 row pairs of the packed A) by one packed B
+// chunk of at most 32 columns, i.e. up to 16 zmm accumulators.
+const int kTileRows = 8;
+
+struct TileArgs {
+  int k4;
+  int k_align4;
+  const int8_t* a;
+  const uint8_t* b;
+  int b_step;        // bytes of B per 4 k, i.e. chunk width * 4
+  __mmask16 mask0;   // columns 0 ~ 15 of the chunk
+  __mmask16 mask1;   // columns 16 ~ 31, zero for chunks of 16 or less
+};
+
+// Rows of the packed A come in pairs laid out as [K/4][2][4], an odd last
+// row as [K/4][4]: ROWS rows with A_STEP 8, or the odd row with A_STEP 4.
+// maddubs saturates to int16 like the AVX2 kernel does.
+template <int ROWS, int A_STEP, bool WIDE>
+LITE_S8U8_TARGET_AVX512BW void dot_avx512bw(const TileArgs& t, __m512i* acc) {
+  const __m512i vec_one = _mm512_set1_epi16(1);
+  __m512i c0[ROWS];
+  __m512i c1[ROWS];
+  LITE_S8U8_UNROLL
+  for (int i = 0; i < ROWS; i++) {
+    c0[i] = _mm512_setzero_si512();
+    c1[i] = _mm512_setzero_si512();
+  }
+  const int8_t* a_ptr = t.a;
+  const uint8_t* b_ptr = t.b;
+  for (int k = 0; k < t.k4; k++) {
+    const __m512i b0 = _mm512_maskz_loadu_epi32(t.mask0, b_ptr);
+    const __m512i b1 =
+        WIDE ? _mm512_maskz_loadu_epi32(t.mask1, b_ptr + 64) : b0;
+    LITE_S8U8_UNROLL
+    for (int i = 0; i < ROWS; i++) {
+      const int8_t* row = a_ptr + (i >> 1) * 2 * t.k_align4 + (i & 1) * 4;
+      const __m512i a =
+          _mm512_set1_epi32(*reinterpret_cast<const int32_t*>(row));
+      c0[i] = _mm512_add_epi32(
+          c0[i], _mm512_madd_epi16(_mm512_maddubs_epi16(b0, a), vec_one));
+      if (WIDE) {
+        c1[i] = _mm512_add_epi32(
+            c1[i], _mm512_madd_epi16(_mm512_maddubs_epi16(b1, a), vec_one));
+      }
+    }
+    a_ptr += A_STEP;
+    b_ptr += t.b_step;
+  }
+  LITE_S8U8_UNROLL
+  for (int i = 0; i < ROWS; i++) {
+    acc[2 * i] = c0[i];
+    acc[2 * i + 1] = c1[i];
+  }
+}
+
+// vpdpbusd accumulates u8 x s8 straight into int32, no int16 saturation.
+template <int ROWS, int A_STEP, bool WIDE>
+LITE_S8U8_TARGET_AVX512VNNI void dot_avx512vnni(const TileArgs& t,
+                                                __m512i* acc) {
+  __m512i c0[ROWS];
+  __m512i c1[ROWS];
+  LITE_S8U8_UNROLL
+  for (int i = 0; i < ROWS; i++) {
+    c0[i] = _mm512_setzero_si512();
+    c1[i] = _mm512_setzero_si512();
+  }
+  const int8_t* a_ptr = t.a;
+  const uint8_t* b_ptr = t.b;
+  for (int k = 0; k < t.k4; k++) {
+    const __m512i b0 = _mm512_maskz_loadu_epi32(t.mask0, b_ptr);
+    const __m512i b1 =
+        WIDE ? _mm512_maskz_loadu_epi32(t.mask1, b_ptr + 64) : b0;
+    LITE_S8U8_UNROLL
+    for (int i = 0; i < ROWS; i++) {
+      const int8_t* row = a_ptr + (i >> 1) * 2 * t.k_align4 + (i & 1) * 4;
+      const __m512i a =
+          _mm512_set1_epi32(*reinterpret_cast<const int32_t*>(row));
+      c0[i] = _mm512_dpbusd_epi32(c0[i], b0, a);
+      if (WIDE) {
+        c1[i] = _mm512_dpbusd_epi32(c1[i], b1, a);
+      }
+    }
+    a_ptr += A_STEP;
+    b_ptr += t.b_step;
+  }
+  LITE_S8U8_UNROLL
+  for (int i = 0; i < ROWS; i++) {
+    acc[2 * i] = c0[i];
+    acc[2 * i + 1] = c1[i];
+  }
+}
+
+template <int ROWS, int A_STEP>
+LITE_S8U8_TARGET_AVX512BW void dot_avx512(bool vnni,
+                                          const TileArgs& t,
+                                          __m512i* acc) {
+  if (vnni) {
+    t.mask1 ? dot_avx512vnni<ROWS, A_STEP, true>(t, acc)
+            : dot_avx512vnni<ROWS, A_STEP, false>(t, acc);
+  } else {
+    t.mask1 ? dot_avx512bw<ROWS, A_STEP, true>(t, acc)
+            : dot_avx512bw<ROWS, A_STEP, false>(t, acc);
+  }
+}
+
+LITE_S8U8_TARGET_AVX512BW inline void store_avx512(__m512 data,
+                                                   __mmask16 mask,
+                                                   float* c) {
+  _mm512_mask_storeu_ps(c, mask, data);
+}
+
+// Requantize: round to nearest, saturate to int8 and clip to [-127, 127].
+LITE_S8U8_TARGET_AVX512BW inline void store_avx512(__m512 data,
+                                                   __mmask16 mask,
+                                                   int8_t* c) {
+  __m128i vec_s8 = _mm512_cvtsepi32_epi8(_mm512_cvtps_epi32(data));
+  vec_s8 = _mm_max_epi8(vec_s8, _mm_set1_epi8(-127));
+  _mm_mask_storeu_epi8(c, mask, vec_s8);
+}
+
+// Fused epilogue of one row: dequant scale, bias, activation and the store.
+template <typename TYPE_C>
+LITE_S8U8_TARGET_AVX512BW void store_row_avx512(const __m512i* acc,
+                                                const TileArgs& t,
+                                                float scale,
+                                                float bias,
+                                                int relu_type,
+                                                float relu_alpha,
+                                                TYPE_C* c) {
+  const __m512 vec_scale = _mm512_set1_ps(scale);
+  const __m512 vec_bias = _mm512_set1_ps(bias);
+  const __m512 vec_zero = _mm512_setzero_ps();
+  const __m512 vec_alpha = _mm512_set1_ps(relu_alpha);
+  for (int j = 0; j < 2; j++) {
+    const __mmask16 mask = j == 0 ? t.mask0 : t.mask1;
+    if (mask == 0) break;
+    __m512 data = _mm512_add_ps(
+        _mm512_mul_ps(_mm512_cvtepi32_ps(acc[j]), vec_scale), vec_bias);
+    switch (relu_type) {
+      case 1:
+        data = _mm512_max_ps(data, vec_zero);
+        break;
+      case 2:
+        data = _mm512_min_ps(_mm512_max_ps(data, vec_zero), vec_alpha);
+        break;
+      case 3: {
+        __mmask16 le_zero = _mm512_cmp_ps_mask(data, vec_zero, _CMP_LE_OS);
+        data = _mm512_mask_mul_ps(data, le_zero, data, vec_alpha);
+        break;
+      }
+      default:
+        break;
+    }
+    store_avx512(data, mask, c + j * 16);
+  }
+}
+
+inline __mmask16 lane_mask(int lanes) {
+  return lanes >= 16 ? static_cast<__mmask16>(0xffff)
+                     : static_cast<__mmask16>((1u << lanes) - 1);
+}
+
+// Same blocking as gemm_kernel_loop_int8: B was packed in chunks of 32
+// columns followed by tails of 24, 16, 8, 4, 2 and 1.
+template <typename TYPE_C>
+LITE_S8U8_TARGET_AVX512BW void gemm_kernel_loop_int8_avx512(bool vnni,
+                                                            int M,
+                                                            int N,
+                                                            int K,
+                                                            const int8_t* A,
+                                                            const uint8_t* B,
+                                                            TYPE_C* C,
+                                                            int ldc,
+                                                            const float* scale,
+                                                            const float* bias,
+                                                            int relu_type,
+                                                            float relu_alpha) {
+  static const int chunk_width[] = {32, 24, 16, 8, 4, 2, 1};
+  __m512i acc[2 * kTileRows];
+  TileArgs t;
+  t.k4 = (K + 3) >> 2;
+  t.k_align4 = t.k4 << 2;
+  for (int m = 0; m < M; m += kTileRows) {
+    const int rows = std::min(kTileRows, M - m);
+    const int pair_rows = rows & ~1;
+    int n = 0;
+    int w = 0;
+    while (n < N) {
+      while (chunk_width[w] > N - n) w++;
+      const int cols = chunk_width[w];
+      t.b = B + n * t.k_align4;
+      t.b_step = cols * 4;
+      t.mask0 = lane_mask(cols);
+      t.mask1 = cols > 16 ? lane_mask(cols - 16) : 0;
+      t.a = A + m * t.k_align4;
+      switch (pair_rows) {
+        case 8:
+          dot_avx512<8, 8>(vnni, t, acc);
+          break;
+        case 6:
+          dot_avx512<6, 8>(vnni, t, acc);
+          break;
+        case 4:
+          dot_avx512<4, 8>(vnni, t, acc);
+          break;
+        case 2:
+          dot_avx512<2, 8>(vnni, t, acc);
+          break;
+        default:
+          break;
+      }
+      for (int i = 0; i < pair_rows; i++) {
+        store_row_avx512(acc + 2 * i,
+                         t,
+                         scale[m + i],
+                         bias[m + i],
+                         relu_type,
+                         relu_alpha,
+                         C + (m + i) * ldc + n);
+      }
+      if (rows & 1) {
+        const int last = m + pair_rows;
+        t.a = A + last * t.k_align4;
+        dot_avx512<1, 4>(vnni, t, acc);
+        store_row_avx512(acc,
+                         t,
+                         scale[last],
+                         bias[last],
+                         relu_type,
+                         relu_alpha,
+                         C + last * ldc + n);
+      }
+      n += cols;
+    }
+  }
+}
+
+}  // namespace
+
+#endif  // LITE_S8U8_WITH_AVX512
+
+GemmS8U8Isa gemm_s8u8_isa() {
+#ifdef LITE_S8U8_WITH_AVX512
+  static const GemmS8U8Isa isa =
+      MayIUse(avx512_core_vnni)
+          ? GemmS8U8Isa::kAVX512VNNI
+          : (MayIUse(avx512_core) ? GemmS8U8Isa::kAVX512BW
+                                  : GemmS8U8Isa::kAVX2);
+  return isa;
+#else
+  return GemmS8U8Isa::kAVX2;
+#endif
+}
+
+void gemm_kernel_loop_int8(GemmS8U8Isa isa,
+                           int M,
+                           int N,
+                           int K,
+                           int8_t* A,
+                           uint8_t* B,
+                           int8_t* C,
+                           int ldc,
+                           const float* scale,
+                           const float* bias,
+                           int relu_type,
+                           float relu_alpha) {
+#ifdef LITE_S8U8_WITH_AVX512
+  if (isa != GemmS8U8Isa::kAVX2) {
+    gemm_kernel_loop_int8_avx512(isa == GemmS8U8Isa::kAVX512VNNI,
+                                 M,
+                                 N,
+                                 K,
+                                 A,
+                                 B,
+                                 C,
+                                 ldc,
+                                 scale,
+                                 bias,
+                                 relu_type,
+                                 relu_alpha);
+    return;
+  }
+#endif
+  gemm_kernel_loop_int8(
+      M, N, K, A, B, C, ldc, scale, bias, relu_type, relu_alpha);
+}
+
+void gemm_kernel_loop_int8(GemmS8U8Isa isa,
+                           int M,
+                           int N,
+                           int K,
+                           int8_t* A,
+                           uint8_t* B,
+                           float* C,
+                           int ldc,
+                           const float* scale,
+                           const float* bias,
+                           int relu_type,
+                           float relu_alpha) {
+#ifdef LITE_S8U8_WITH_AVX512
+  if (isa != GemmS8U8Isa::kAVX2) {
+    gemm_kernel_loop_int8_avx512(isa == GemmS8U8Isa::kAVX512VNNI,
+                                 M,
+                                 N,
+                                 K,
+                                 A,
+                                 B,
+                                 C,
+                                 ldc,
+                                 scale,
+                                 bias,
+                                 relu_type,
+                                 relu_alpha);
+    return;
+  }
+#endif
+  gemm_kernel_loop_int8(
+      M, N, K, A, B, C, ldc, scale, bias, relu_type, relu_alpha);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
+
+#undef LITE_S8U8_TARGET_AVX512BW
+#undef LITE_S8U8_TARGET_AVX512VNNI
+#undef LITE_S8U8_WITH_AVX512
+#undef LITE_S8U8_UNROLL
+
+#endif  // __AVX2__
@@ -0,0 +1,236 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#ifdef __AVX2__
+
+#include "lite/backends/x86/math/gemm_weight_only.h"
+#include <immintrin.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/log/cp_logging.h"
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define LITE_WEIGHT_ONLY_UNROLL _Pragma("GCC unroll 4")
+#else
+#define LITE_WEIGHT_ONLY_UNROLL
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The columns of a panel, two ymm of float
+static constexpr int kBlockN = 16;
+// The rows sharing a read of the weights
+static constexpr int kBlockM = 4;
+
+int64_t weight_only_packed_size(int bits, int K, int N) {
+  int64_t panels = (N + kBlockN - 1) / kBlockN;
+  return panels * K * kBlockN * bits / 8;
+}
+
+void pack_weight_only(
+    int bits, int K, int N, const int8_t* W, int ldw, uint8_t* packed) {
+  CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+  for (int j = 0; j < N; j += kBlockN) {
+    int cols = std::min(kBlockN, N - j);
+    for (int k = 0; k < K; k++) {
+      const int8_t* w_ptr = W + static_cast<int64_t>(k) * ldw + j;
+      if (bits == 8) {
+        memset(packed, 0, kBlockN);
+        memcpy(packed, w_ptr, cols);
+        packed += kBlockN;
+        continue;
+      }
+      for (int c = 0; c < kBlockN / 2; c++) {
+        int lo = c < cols ? w_ptr[c] + 8 : 8;
+        int hi = c + kBlockN / 2 < cols ? w_ptr[c + kBlockN / 2] + 8 : 8;
+        *packed++ = static_cast<uint8_t>(lo | (hi << 4));
+      }
+    }
+  }
+}
+
+// The 16 weights of a row of a panel in float, the int4 ones are still
+// offset by 8
+template <int BITS>
+inline void load_weights(const uint8_t* w, __m256* w0, __m256* w1);
+
+template <>
+inline void load_weights<8>(const uint8_t* w, __m256* w0, __m256* w1) {
+  __m128i lo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w));
+  __m128i hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w + 8));
+  *w0 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(lo));
+  *w1 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(hi));
+}
+
+template <>
+inline void load_weights<4>(const uint8_t* w, __m256* w0, __m256* w1) {
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w));
+  __m128i lo = _mm_and_si128(b, mask);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), mask);
+  *w0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(lo));
+  *w1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(hi));
+}
+
+// acc[2 * r + i] is the sum of row r and the 8 columns i of a panel. Less
+// than 3 rows split K into KS parts of their own accumulators, which hide the
+// latency of the fma chains.
+template <int ROWS, int BITS>
+static void weight_only_block(
+    int K, const float* A, int lda, const uint8_t* w, __m256* acc) {
+  constexpr int KS = ROWS == 1 ? 4 : (ROWS == 2 ? 2 : 1);
+  constexpr int w_step = kBlockN * BITS / 8;
+  __m256 sum[KS][2 * ROWS];
+  LITE_WEIGHT_ONLY_UNROLL
+  for (int s = 0; s < KS; s++) {
+    LITE_WEIGHT_ONLY_UNROLL
+    for (int r = 0; r < 2 * ROWS; r++) sum[s][r] = _mm256_setzero_ps();
+  }
+  int k = 0;
+  for (; k + KS <= K; k += KS) {
+    LITE_WEIGHT_ONLY_UNROLL
+    for (int s = 0; s < KS; s++) {
+      __m256 w0, w1;
+      load_weights<BITS>(w + (k + s) * w_step, &w0, &w1);
+      LITE_WEIGHT_ONLY_UNROLL
+      for (int r = 0; r < ROWS; r++) {
+        __m256 a = _mm256_broadcast_ss(A + r * lda + k + s);
+        sum[s][2 * r] = _mm256_fmadd_ps(a, w0, sum[s][2 * r]);
+        sum[s][2 * r + 1] = _mm256_fmadd_ps(a, w1, sum[s][2 * r + 1]);
+      }
+    }
+  }
+  for (; k < K; k++) {
+    __m256 w0, w1;
+    load_weights<BITS>(w + k * w_step, &w0, &w1);
+    LITE_WEIGHT_ONLY_UNROLL
+    for (int r = 0; r < ROWS; r++) {
+      __m256 a = _mm256_broadcast_ss(A + r * lda + k);
+      sum[0][2 * r] = _mm256_fmadd_ps(a, w0, sum[0][2 * r]);
+      sum[0][2 * r + 1] = _mm256_fmadd_ps(a, w1, sum[0][2 * r + 1]);
+    }
+  }
+  LITE_WEIGHT_ONLY_UNROLL
+  for (int r = 0; r < 2 * ROWS; r++) {
+    acc[r] = sum[0][r];
+    LITE_WEIGHT_ONLY_UNROLL
+    for (int s = 1; s < KS; s++) acc[r] = _mm256_add_ps(acc[r], sum[s][r]);
+  }
+}
+
+template <int BITS>
+static void weight_only_rows(
+    int rows, int K, const float* A, int lda, const uint8_t* w, __m256* acc) {
+  switch (rows) {
+    case 4:
+      weight_only_block<4, BITS>(K, A, lda, w, acc);
+      break;
+    case 3:
+      weight_only_block<3, BITS>(K, A, lda, w, acc);
+      break;
+    case 2:
+      weight_only_block<2, BITS>(K, A, lda, w, acc);
+      break;
+    default:
+      weight_only_block<1, BITS>(K, A, lda, w, acc);
+      break;
+  }
+}
+
+void gemm_weight_only(int bits,
+                      int M,
+                      int N,
+                      int K,
+                      const float* A,
+                      int lda,
+                      const uint8_t* W,
+                      const float* scale,
+                      const float* bias,
+                      bool relu,
+                      float* C,
+                      int ldc) {
+  CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+  int n_blocks = (N + kBlockN - 1) / kBlockN;
+  int64_t panel_size = static_cast<int64_t>(K) * kBlockN * bits / 8;
+  // The int4 weights are offset by 8, which adds 8 * sum(A[i, :]) to row i
+  std::vector<float> a_offset(M, 0.f);
+  if (bits == 4) {
+    for (int i = 0; i < M; i++) {
+      const float* a = A + static_cast<int64_t>(i) * lda;
+      float sum = 0.f;
+      for (int k = 0; k < K; k++) sum += a[k];
+      a_offset[i] = 8.f * sum;
+    }
+  }
+  LITE_PARALLEL_BEGIN(jb, tid, n_blocks) {
+    int j = jb * kBlockN;
+    int cols = std::min(kBlockN, N - j);
+    const uint8_t* w = W + jb * panel_size;
+    float s[kBlockN] = {0.f};
+    float b[kBlockN] = {0.f};
+    memcpy(s, scale + j, cols * sizeof(float));
+    if (bias) memcpy(b, bias + j, cols * sizeof(float));
+    __m256 s0 = _mm256_loadu_ps(s);
+    __m256 s1 = _mm256_loadu_ps(s + 8);
+    __m256 b0 = _mm256_loadu_ps(b);
+    __m256 b1 = _mm256_loadu_ps(b + 8);
+    __m256 zero = _mm256_setzero_ps();
+    for (int i = 0; i < M; i += kBlockM) {
+      int rows = std::min(kBlockM, M - i);
+      const float* a = A + static_cast<int64_t>(i) * lda;
+      __m256 acc[2 * kBlockM];
+      if (bits == 4) {
+        weight_only_rows<4>(rows, K, a, lda, w, acc);
+      } else {
+        weight_only_rows<8>(rows, K, a, lda, w, acc);
+      }
+      for (int r = 0; r < rows; r++) {
+        __m256 offset = _mm256_set1_ps(a_offset[i + r]);
+        __m256 c0 = _mm256_sub_ps(acc[2 * r], offset);
+        __m256 c1 = _mm256_sub_ps(acc[2 * r + 1], offset);
+        c0 = _mm256_fmadd_ps(c0, s0, b0);
+        c1 = _mm256_fmadd_ps(c1, s1, b1);
+        if (relu) {
+          c0 = _mm256_max_ps(c0, zero);
+          c1 = _mm256_max_ps(c1, zero);
+        }
+        float* c = C + static_cast<int64_t>(i + r) * ldc + j;
+        if (cols == kBlockN) {
+          _mm256_storeu_ps(c, c0);
+          _mm256_storeu_ps(c + 8, c1);
+        } else {
+          float tmp[kBlockN];
+          _mm256_storeu_ps(tmp, c0);
+          _mm256_storeu_ps(tmp + 8, c1);
+          memcpy(c, tmp, cols * sizeof(float));
+        }
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
+
+#undef LITE_WEIGHT_ONLY_UNROLL
+
+#endif  // __AVX2__
@@ -0,0 +1,55 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The bytes of K x N weights of `bits` (8 or 4) packed by pack_weight_only.
+int64_t weight_only_packed_size(int bits, int K, int N);
+
+// Packs the int8 weights W[K, N] into panels of 16 columns, every panel is a
+// contiguous [K, 16] block and the last one is zero padded. For 4 bits the
+// values are in [-8, 7] and stored + 8, byte c of a panel row holds column c
+// in the low and column c + 8 in the high nibble.
+void pack_weight_only(
+    int bits, int K, int N, const int8_t* W, int ldw, uint8_t* packed);
+
+// C[M, N] = A[M, K] * (W[K, N] * scale[N]) + bias[N], followed by relu if
+// relu is set. W is packed by pack_weight_only and stays int8 or int4, it's
+// dequantized inside the micro kernel, so it's read from memory at 1 or 1/2
+// byte per weight. It's meant for the memory bound fc of small M, which reads
+// W once every 4 rows.
+void gemm_weight_only(int bits,
+                      int M,
+                      int N,
+                      int K,
+                      const float* A,
+                      int lda,
+                      const uint8_t* W,
+                      const float* scale,
+                      const float* bias,
+                      bool relu,
+                      float* C,
+                      int ldc);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,459 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/nchwc.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#define NCHWC_DISPATCH(block, func, ...)               \
+  if (block == 8) {                                    \
+    func<8>(__VA_ARGS__);                              \
+  } else if (block == 16) {                            \
+    func<16>(__VA_ARGS__);                             \
+  } else {                                             \
+    LOG(FATAL) << "unsupported nchwc block " << block; \
+  }
+
+namespace {
+
+// Same windows as AdaptStartIndex / AdaptEndIndex of pooling.h
+inline int AdaptStart(int index, int input_size, int output_size) {
+  return static_cast<int>(
+      std::floor(static_cast<double>(index * input_size) / output_size));
+}
+
+inline int AdaptEnd(int index, int input_size, int output_size) {
+  return static_cast<int>(
+      std::ceil(static_cast<double>((index + 1) * input_size) / output_size));
+}
+
+template <int B>
+void NCHWToNCHWc(
+    const float* din, float* dout, int num, int channel, int size) {
+  const int blocks = nchwc_blocks(channel, B);
+  LITE_PARALLEL_BEGIN(nb, tid, num * blocks) {
+    int n = nb / blocks;
+    int c0 = nb % blocks * B;
+    int valid = std::min(B, channel - c0);
+    const float* src = din + (static_cast<int64_t>(n) * channel + c0) * size;
+    float* dst = dout + static_cast<int64_t>(nb) * size * B;
+    for (int i = 0; i < size; ++i) {
+      for (int b = 0; b < valid; ++b) {
+        dst[i * B + b] = src[b * size + i];
+      }
+      for (int b = valid; b < B; ++b) {
+        dst[i * B + b] = 0.f;
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+template <int B>
+void NCHWcToNCHW(
+    const float* din, float* dout, int num, int channel, int size) {
+  const int blocks = nchwc_blocks(channel, B);
+  LITE_PARALLEL_BEGIN(nb, tid, num * blocks) {
+    int n = nb / blocks;
+    int c0 = nb % blocks * B;
+    int valid = std::min(B, channel - c0);
+    const float* src = din + static_cast<int64_t>(nb) * size * B;
+    float* dst = dout + (static_cast<int64_t>(n) * channel + c0) * size;
+    for (int b = 0; b < valid; ++b) {
+      for (int i = 0; i < size; ++i) {
+        dst[b * size + i] = src[i * B + b];
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+template <int B>
+void NCHWcCopyChannels(const float* din,
+                       float* dout,
+                       int num,
+                       int channel,
+                       int channel_out,
+                       int offset,
+                       int size) {
+  const int blocks = nchwc_blocks(channel, B);
+  const int blocks_out = nchwc_blocks(channel_out, B);
+  if (offset % B == 0) {
+    // whole blocks, the padding of the last one is only copied when it is
+    // also the padding of dout
+    LITE_PARALLEL_BEGIN(nb, tid, num * blocks) {
+      int n = nb / blocks;
+      int cb = nb % blocks;
+      int valid = std::min(B, channel - cb * B);
+      bool tail = offset + channel == channel_out;
+      const float* src = din + static_cast<int64_t>(nb) * size * B;
+      float* dst =
+          dout + (static_cast<int64_t>(n) * blocks_out + offset / B + cb) *
+                     size * B;
+      if (valid == B || tail) {
+        memcpy(dst, src, sizeof(float) * size * B);
+      } else {
+        for (int i = 0; i < size; ++i) {
+          memcpy(dst + i * B, src + i * B, sizeof(float) * valid);
+        }
+      }
+    }
+    LITE_PARALLEL_END();
+    return;
+  }
+  LITE_PARALLEL_BEGIN(n, tid, num) {
+    const float* src = din + static_cast<int64_t>(n) * blocks * size * B;
+    float* dst = dout + static_cast<int64_t>(n) * blocks_out * size * B;
+    for (int c = 0; c < channel; ++c) {
+      int co = offset + c;
+      const float* src_c = src + static_cast<int64_t>(c / B) * size * B + c % B;
+      float* dst_c = dst + static_cast<int64_t>(co / B) * size * B + co % B;
+      for (int i = 0; i < size; ++i) {
+        dst_c[i * B] = src_c[i * B];
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+template <int B>
+void NCHWcChannelAffine(const float* din,
+                        float* dout,
+                        const float* scale,
+                        const float* bias,
+                        int num,
+                        int channel,
+                        int size) {
+  const int blocks = nchwc_blocks(channel, B);
+  LITE_PARALLEL_BEGIN(nb, tid, num * blocks) {
+    int cb = nb % blocks;
+    const float* s = scale ? scale + cb * B : nullptr;
+    const float* bs = bias + cb * B;
+    const float* src = din + static_cast<int64_t>(nb) * size * B;
+    float* dst = dout + static_cast<int64_t>(nb) * size * B;
+    for (int i = 0; i < size; ++i) {
+      if (s) {
+        for (int b = 0; b < B; ++b) {
+          dst[i * B + b] = src[i * B + b] * s[b] + bs[b];
+        }
+      } else {
+        for (int b = 0; b < B; ++b) {
+          dst[i * B + b] = src[i * B + b] + bs[b];
+        }
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+template <int B>
+void NCHWcBinaryChannel(const float* x,
+                        const float* y,
+                        float* out,
+                        int num,
+                        int channel,
+                        int size,
+                        bool y_per_batch,
+                        bool is_mul) {
+  const int blocks = nchwc_blocks(channel, B);
+  LITE_PARALLEL_BEGIN(nb, tid, num * blocks) {
+    const float* yb = y + (y_per_batch ? nb : nb % blocks) * B;
+    const float* src = x + static_cast<int64_t>(nb) * size * B;
+    float* dst = out + static_cast<int64_t>(nb) * size * B;
+    for (int i = 0; i < size; ++i) {
+      if (is_mul) {
+        for (int b = 0; b < B; ++b) {
+          dst[i * B + b] = src[i * B + b] * yb[b];
+        }
+      } else {
+        for (int b = 0; b < B; ++b) {
+          dst[i * B + b] = src[i * B + b] + yb[b];
+        }
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+template <int B>
+void PoolingNCHWc(const float* din,
+                  float* dout,
+                  int num,
+                  int channel,
+                  int hin,
+                  int win,
+                  int hout,
+                  int wout,
+                  const std::vector<int>& ksize,
+                  const std::vector<int>& strides,
+                  const std::vector<int>& paddings,
+                  bool is_max,
+                  bool exclusive,
+                  bool adaptive) {
+  const int blocks = nchwc_blocks(channel, B);
+  const int pad_h = paddings[0];
+  const int pad_w = paddings[2];
+  LITE_PARALLEL_BEGIN(job, tid, num * blocks * hout) {
+    int nb = job / hout;
+    int oh = job % hout;
+    const float* src = din + static_cast<int64_t>(nb) * hin * win * B;
+    float* dst = dout + (static_cast<int64_t>(nb) * hout + oh) * wout * B;
+    int hstart, hend;
+    if (adaptive) {
+      hstart = AdaptStart(oh, hin, hout);
+      hend = AdaptEnd(oh, hin, hout);
+    } else {
+      hstart = oh * strides[0] - pad_h;
+      hend = std::min(hstart + ksize[0], hin + pad_h);
+    }
+    for (int ow = 0; ow < wout; ++ow) {
+      int wstart, wend;
+      int h0 = hstart;
+      int h1 = hend;
+      int pool_size = 1;
+      if (adaptive) {
+        wstart = AdaptStart(ow, win, wout);
+        wend = AdaptEnd(ow, win, wout);
+      } else {
+        wstart = ow * strides[1] - pad_w;
+        wend = std::min(wstart + ksize[1], win + pad_w);
+        pool_size = (h1 - h0) * (wend - wstart);
+        h0 = std::max(h0, 0);
+        h1 = std::min(h1, hin);
+        wstart = std::max(wstart, 0);
+        wend = std::min(wend, win);
+      }
+      if (exclusive || adaptive) {
+        pool_size = (h1 - h0) * (wend - wstart);
+      }
+      float acc[B];
+      std::fill(acc, acc + B, is_max ? -FLT_MAX : 0.f);
+      for (int h = h0; h < h1; ++h) {
+        const float* row = src + static_cast<int64_t>(h) * win * B;
+        for (int w = wstart; w < wend; ++w) {
+          const float* ptr = row + w * B;
+          if (is_max) {
+            for (int b = 0; b < B; ++b) acc[b] = std::max(acc[b], ptr[b]);
+          } else {
+            for (int b = 0; b < B; ++b) acc[b] += ptr[b];
+          }
+        }
+      }
+      if (is_max) {
+        // empty windows only happen with large paddings
+        if (h0 >= h1 || wstart >= wend) std::fill(acc, acc + B, 0.f);
+        memcpy(dst + ow * B, acc, sizeof(float) * B);
+      } else {
+        float inv = pool_size > 0 ? 1.f / pool_size : 0.f;
+        for (int b = 0; b < B; ++b) dst[ow * B + b] = acc[b] * inv;
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace
+
+void nchw_to_nchwc(
+    const float* din, float* dout, int num, int channel, int size, int block) {
+  NCHWC_DISPATCH(block, NCHWToNCHWc, din, dout, num, channel, size);
+}
+
+void nchwc_to_nchw(
+    const float* din, float* dout, int num, int channel, int size, int block) {
+  NCHWC_DISPATCH(block, NCHWcToNCHW, din, dout, num, channel, size);
+}
+
+void nchwc_pack_channel(const float* din, float* dout, int channel, int block) {
+  int padded = nchwc_blocks(channel, block) * block;
+  memcpy(dout, din, sizeof(float) * channel);
+  std::fill(dout + channel, dout + padded, 0.f);
+}
+
+void nchwc_copy_channels(const float* din,
+                         float* dout,
+                         int num,
+                         int channel,
+                         int channel_out,
+                         int offset,
+                         int size,
+                         int block) {
+  NCHWC_DISPATCH(block,
+                 NCHWcCopyChannels,
+                 din,
+                 dout,
+                 num,
+                 channel,
+                 channel_out,
+                 offset,
+                 size);
+}
+
+void nchwc_act(const float* din,
+               float* dout,
+               int64_t len,
+               const operators::ActivationParam& act_param) {
+  switch (act_param.active_type) {
+    case lite_api::ActivationType::kRelu:
+      for (int64_t i = 0; i < len; ++i) dout[i] = std::max(din[i], 0.f);
+      break;
+    case lite_api::ActivationType::kRelu6: {
+      float clip = act_param.Relu_clipped_coef;
+      for (int64_t i = 0; i < len; ++i) {
+        dout[i] = std::min(std::max(din[i], 0.f), clip);
+      }
+    } break;
+    case lite_api::ActivationType::kLeakyRelu: {
+      float alpha = act_param.Leaky_relu_alpha;
+      for (int64_t i = 0; i < len; ++i) {
+        dout[i] = din[i] > 0.f ? din[i] : din[i] * alpha;
+      }
+    } break;
+    case lite_api::ActivationType::kHardSwish: {
+      float scale = 1.f / act_param.hard_swish_scale;
+      float threshold = act_param.hard_swish_threshold;
+      float offset = act_param.hard_swish_offset;
+      for (int64_t i = 0; i < len; ++i) {
+        dout[i] = std::min(std::max(0.f, din[i] + offset), threshold) *
+                  din[i] * scale;
+      }
+    } break;
+    case lite_api::ActivationType::kSigmoid:
+      for (int64_t i = 0; i < len; ++i) {
+        dout[i] = 1.f / (1.f + std::exp(-din[i]));
+      }
+      break;
+    case lite_api::ActivationType::kTanh:
+      for (int64_t i = 0; i < len; ++i) dout[i] = std::tanh(din[i]);
+      break;
+    case lite_api::ActivationType::kSwish: {
+      float beta = act_param.Swish_beta;
+      for (int64_t i = 0; i < len; ++i) {
+        dout[i] = din[i] / (1.f + std::exp(-beta * din[i]));
+      }
+    } break;
+    case lite_api::ActivationType::kAbs:
+      for (int64_t i = 0; i < len; ++i) dout[i] = std::fabs(din[i]);
+      break;
+    case lite_api::ActivationType::kHardSigmoid: {
+      float slope = act_param.hard_sigmoid_slope;
+      float offset = act_param.hard_sigmoid_offset;
+      for (int64_t i = 0; i < len; ++i) {
+        dout[i] = std::min(std::max(din[i] * slope + offset, 0.f), 1.f);
+      }
+    } break;
+    case lite_api::ActivationType::kIndentity:
+      if (din != dout) memcpy(dout, din, sizeof(float) * len);
+      break;
+    default:
+      LOG(FATAL) << "unsupported nchwc activation "
+                 << lite_api::ActivationTypeToStr(act_param.active_type);
+  }
+}
+
+void nchwc_channel_affine(const float* din,
+                          float* dout,
+                          const float* scale,
+                          const float* bias,
+                          int num,
+                          int channel,
+                          int size,
+                          int block) {
+  NCHWC_DISPATCH(block,
+                 NCHWcChannelAffine,
+                 din,
+                 dout,
+                 scale,
+                 bias,
+                 num,
+                 channel,
+                 size);
+}
+
+void nchwc_binary(
+    const float* x, const float* y, float* out, int64_t len, bool is_mul) {
+  if (is_mul) {
+    for (int64_t i = 0; i < len; ++i) out[i] = x[i] * y[i];
+  } else {
+    for (int64_t i = 0; i < len; ++i) out[i] = x[i] + y[i];
+  }
+}
+
+void nchwc_binary_channel(const float* x,
+                          const float* y,
+                          float* out,
+                          int num,
+                          int channel,
+                          int size,
+                          bool y_per_batch,
+                          bool is_mul,
+                          int block) {
+  NCHWC_DISPATCH(block,
+                 NCHWcBinaryChannel,
+                 x,
+                 y,
+                 out,
+                 num,
+                 channel,
+                 size,
+                 y_per_batch,
+                 is_mul);
+}
+
+void pooling_nchwc(const float* din,
+                   float* dout,
+                   int num,
+                   int channel,
+                   int hin,
+                   int win,
+                   int hout,
+                   int wout,
+                   const std::vector<int>& ksize,
+                   const std::vector<int>& strides,
+                   const std::vector<int>& paddings,
+                   bool is_max,
+                   bool exclusive,
+                   bool adaptive,
+                   int block) {
+  NCHWC_DISPATCH(block,
+                 PoolingNCHWc,
+                 din,
+                 dout,
+                 num,
+                 channel,
+                 hin,
+                 win,
+                 hout,
+                 wout,
+                 ksize,
+                 strides,
+                 paddings,
+                 is_max,
+                 exclusive,
+                 adaptive);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
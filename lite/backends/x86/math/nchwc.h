@@ -0,0 +1,126 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * Blocked NCHWc layout (DATALAYOUT(kNCHW8c) / DATALAYOUT(kNCHW16c)).
+ *
+ * A 4-D tensor of logical dims [N, C, H, W] is stored as
+ * [N, C / block, H, W, block], the channels are padded up to a multiple of
+ * `block`. The tensor keeps its logical dims, only its memory is larger, see
+ * `nchwc_size`. Tensors of other ranks are never blocked.
+ *
+ * Every kernel writing a blocked tensor keeps the padded channels finite
+ * (they are computed from zero weights and parameters), so that they never
+ * turn into nan in the next kernel.
+ */
+
+inline int nchwc_blocks(int channel, int block) {
+  return (channel + block - 1) / block;
+}
+
+// Number of floats of a blocked [num, channel, size] tensor.
+inline int64_t nchwc_size(int num, int channel, int size, int block) {
+  return static_cast<int64_t>(num) * nchwc_blocks(channel, block) * block *
+         size;
+}
+
+// [num, channel, size] <-> [num, channel / block, size, block], size is
+// height * width.
+void nchw_to_nchwc(
+    const float* din, float* dout, int num, int channel, int size, int block);
+void nchwc_to_nchw(
+    const float* din, float* dout, int num, int channel, int size, int block);
+
+// Pad a per channel parameter of `channel` floats with zeros.
+void nchwc_pack_channel(const float* din, float* dout, int channel, int block);
+
+// Copy the channels of din into the channels [offset, offset + channel) of
+// dout, which has `channel_out` channels.
+void nchwc_copy_channels(const float* din,
+                         float* dout,
+                         int num,
+                         int channel,
+                         int channel_out,
+                         int offset,
+                         int size,
+                         int block);
+
+// Apply the activation on `len` floats, din and dout may be the same.
+// Supports relu, relu6, leaky_relu, hard_swish, hard_sigmoid, sigmoid, tanh,
+// swish and abs.
+void nchwc_act(const float* din,
+               float* dout,
+               int64_t len,
+               const operators::ActivationParam& act_param);
+
+// dout = din * scale + bias per channel, scale and bias are packed by
+// nchwc_pack_channel. scale can be null.
+void nchwc_channel_affine(const float* din,
+                          float* dout,
+                          const float* scale,
+                          const float* bias,
+                          int num,
+                          int channel,
+                          int size,
+                          int block);
+
+// out = x + y or x * y on `len` floats.
+void nchwc_binary(
+    const float* x, const float* y, float* out, int64_t len, bool is_mul);
+
+// out = x + y or x * y, y is one value per channel, [num, channel] if
+// `y_per_batch`, or [channel] otherwise, packed by nchwc_pack_channel.
+void nchwc_binary_channel(const float* x,
+                          const float* y,
+                          float* out,
+                          int num,
+                          int channel,
+                          int size,
+                          bool y_per_batch,
+                          bool is_mul,
+                          int block);
+
+// max or avg pooling, paddings are [top, bottom, left, right] and the
+// windows follow Pool2dFunctor.
+void pooling_nchwc(const float* din,
+                   float* dout,
+                   int num,
+                   int channel,
+                   int hin,
+                   int win,
+                   int hout,
+                   int wout,
+                   const std::vector<int>& ksize,
+                   const std::vector<int>& strides,
+                   const std::vector<int>& paddings,
+                   bool is_max,
+                   bool exclusive,
+                   bool adaptive,
+                   int block);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
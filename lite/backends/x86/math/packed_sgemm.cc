@@ -0,0 +1,588 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/packed_sgemm.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <vector>
+#include "lite/core/device_info.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The AVX2 micro kernel is compiled only if the x86 math sources are built
+// with AVX2 and FMA (WITH_AVX), the AVX-512 one is compiled for its own target
+// on top of that, and both are picked at runtime.
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define LITE_SGEMM_WITH_AVX2
+#if defined(__GNUC__)
+#define LITE_SGEMM_WITH_AVX512
+#define LITE_SGEMM_TARGET_AVX512 __attribute__((target("avx512f")))
+#elif defined(_MSC_VER)
+#define LITE_SGEMM_WITH_AVX512
+#define LITE_SGEMM_TARGET_AVX512
+#endif
+#endif
+
+// The loops over the rows of a micro tile must be fully unrolled to keep the
+// accumulators in registers.
+#if defined(__clang__)
+#define LITE_SGEMM_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define LITE_SGEMM_UNROLL _Pragma("GCC unroll 16")
+#else
+#define LITE_SGEMM_UNROLL
+#endif
+
+namespace {
+
+// Depth of a packed block, the panels of A and B of one block stay in L2/L1.
+const int kKC = 256;
+const int kMaxMR = 12;
+
+// Compute a [m, NR] tile of C from an A panel (kc x MR) and a B panel
+// (kc x NR), only the first `n` columns are stored.
+typedef void (*MicroKernel)(int n,
+                            int kc,
+                            const float* pa,
+                            const float* pb,
+                            float* c,
+                            int ldc,
+                            float alpha,
+                            float beta);
+
+struct Blocking {
+  int mr;
+  int nr;
+  // Rows and columns of C computed by one task at most.
+  int mc;
+  int nc;
+  // kernels[m] computes m rows, 1 <= m <= mr.
+  MicroKernel kernels[kMaxMR + 1];
+};
+
+// Store the accumulated tile `acc` [R, ld] into C, C = alpha * acc + beta * C.
+// C isn't read if beta is 0.
+template <int R>
+inline void StoreTile(const float* acc,
+                      int ld,
+                      int n,
+                      float* c,
+                      int ldc,
+                      float alpha,
+                      float beta) {
+  for (int r = 0; r < R; ++r) {
+    const float* src = acc + r * ld;
+    float* dst = c + r * ldc;
+    if (beta == 0.f) {
+      for (int j = 0; j < n; ++j) dst[j] = alpha * src[j];
+    } else {
+      for (int j = 0; j < n; ++j) dst[j] = alpha * src[j] + beta * dst[j];
+    }
+  }
+}
+
+template <int R>
+void KernelGeneric4x8(int n,
+                      int kc,
+                      const float* pa,
+                      const float* pb,
+                      float* c,
+                      int ldc,
+                      float alpha,
+                      float beta) {
+  const int MR = 4;
+  const int NR = 8;
+  float acc[R * NR] = {0.f};
+  for (int k = 0; k < kc; ++k) {
+    LITE_SGEMM_UNROLL
+    for (int r = 0; r < R; ++r) {
+      float a = pa[r];
+      for (int j = 0; j < NR; ++j) {
+        acc[r * NR + j] += a * pb[j];
+      }
+    }
+    pa += MR;
+    pb += NR;
+  }
+  StoreTile<R>(acc, NR, n, c, ldc, alpha, beta);
+}
+
+#ifdef LITE_SGEMM_WITH_AVX2
+template <int R>
+void KernelAvx6x16(int n,
+                   int kc,
+                   const float* pa,
+                   const float* pb,
+                   float* c,
+                   int ldc,
+                   float alpha,
+                   float beta) {
+  const int MR = 6;
+  const int NR = 16;
+  __m256 acc0[R];
+  __m256 acc1[R];
+  LITE_SGEMM_UNROLL
+  for (int r = 0; r < R; ++r) {
+    acc0[r] = _mm256_setzero_ps();
+    acc1[r] = _mm256_setzero_ps();
+  }
+  for (int k = 0; k < kc; ++k) {
+    __m256 b0 = _mm256_loadu_ps(pb);
+    __m256 b1 = _mm256_loadu_ps(pb + 8);
+    LITE_SGEMM_UNROLL
+    for (int r = 0; r < R; ++r) {
+      __m256 a = _mm256_broadcast_ss(pa + r);
+      acc0[r] = _mm256_fmadd_ps(a, b0, acc0[r]);
+      acc1[r] = _mm256_fmadd_ps(a, b1, acc1[r]);
+    }
+    pa += MR;
+    pb += NR;
+  }
+  if (n == NR) {
+    __m256 valpha = _mm256_set1_ps(alpha);
+    __m256 vbeta = _mm256_set1_ps(beta);
+    LITE_SGEMM_UNROLL
+    for (int r = 0; r < R; ++r) {
+      float* dst = c + r * ldc;
+      __m256 c0 = _mm256_mul_ps(valpha, acc0[r]);
+      __m256 c1 = _mm256_mul_ps(valpha, acc1[r]);
+      if (beta != 0.f) {
+        c0 = _mm256_fmadd_ps(vbeta, _mm256_loadu_ps(dst), c0);
+        c1 = _mm256_fmadd_ps(vbeta, _mm256_loadu_ps(dst + 8), c1);
+      }
+      _mm256_storeu_ps(dst, c0);
+      _mm256_storeu_ps(dst + 8, c1);
+    }
+  } else {
+    float tile[R * NR];
+    LITE_SGEMM_UNROLL
+    for (int r = 0; r < R; ++r) {
+      _mm256_storeu_ps(tile + r * NR, acc0[r]);
+      _mm256_storeu_ps(tile + r * NR + 8, acc1[r]);
+    }
+    StoreTile<R>(tile, NR, n, c, ldc, alpha, beta);
+  }
+}
+#endif  // LITE_SGEMM_WITH_AVX2
+
+#ifdef LITE_SGEMM_WITH_AVX512
+template <int R>
+LITE_SGEMM_TARGET_AVX512 void KernelAvx512x12x32(int n,
+                                                 int kc,
+                                                 const float* pa,
+                                                 const float* pb,
+                                                 float* c,
+                                                 int ldc,
+                                                 float alpha,
+                                                 float beta) {
+  const int MR = 12;
+  const int NR = 32;
+  __m512 acc0[R];
+  __m512 acc1[R];
+  LITE_SGEMM_UNROLL
+  for (int r = 0; r < R; ++r) {
+    acc0[r] = _mm512_setzero_ps();
+    acc1[r] = _mm512_setzero_ps();
+  }
+  for (int k = 0; k < kc; ++k) {
+    __m512 b0 = _mm512_loadu_ps(pb);
+    __m512 b1 = _mm512_loadu_ps(pb + 16);
+    LITE_SGEMM_UNROLL
+    for (int r = 0; r < R; ++r) {
+      __m512 a = _mm512_set1_ps(pa[r]);
+      acc0[r] = _mm512_fmadd_ps(a, b0, acc0[r]);
+      acc1[r] = _mm512_fmadd_ps(a, b1, acc1[r]);
+    }
+    pa += MR;
+    pb += NR;
+  }
+  if (n == NR) {
+    __m512 valpha = _mm512_set1_ps(alpha);
+    __m512 vbeta = _mm512_set1_ps(beta);
+    LITE_SGEMM_UNROLL
+    for (int r = 0; r < R; ++r) {
+      float* dst = c + r * ldc;
+      __m512 c0 = _mm512_mul_ps(valpha, acc0[r]);
+      __m512 c1 = _mm512_mul_ps(valpha, acc1[r]);
+      if (beta != 0.f) {
+        c0 = _mm512_fmadd_ps(vbeta, _mm512_loadu_ps(dst), c0);
+        c1 = _mm512_fmadd_ps(vbeta, _mm512_loadu_ps(dst + 16), c1);
+      }
+      _mm512_storeu_ps(dst, c0);
+      _mm512_storeu_ps(dst + 16, c1);
+    }
+  } else {
+    float tile[R * NR];
+    LITE_SGEMM_UNROLL
+    for (int r = 0; r < R; ++r) {
+      _mm512_storeu_ps(tile + r * NR, acc0[r]);
+      _mm512_storeu_ps(tile + r * NR + 16, acc1[r]);
+    }
+    StoreTile<R>(tile, NR, n, c, ldc, alpha, beta);
+  }
+}
+#endif  // LITE_SGEMM_WITH_AVX512
+
+Blocking SelectBlocking() {
+  Blocking blocking;
+  std::fill(blocking.kernels, blocking.kernels + kMaxMR + 1, nullptr);
+#ifdef LITE_SGEMM_WITH_AVX512
+  // AVX-512 is only reported together with VNNI
+  if (device_avx_level() == AVXType::ISA_VNNI) {
+    blocking.mr = 12;
+    blocking.nr = 32;
+    blocking.mc = 144;
+    blocking.nc = 1024;
+    MicroKernel kernels[] = {nullptr,
+                             KernelAvx512x12x32<1>,
+                             KernelAvx512x12x32<2>,
+                             KernelAvx512x12x32<3>,
+                             KernelAvx512x12x32<4>,
+                             KernelAvx512x12x32<5>,
+                             KernelAvx512x12x32<6>,
+                             KernelAvx512x12x32<7>,
+                             KernelAvx512x12x32<8>,
+                             KernelAvx512x12x32<9>,
+                             KernelAvx512x12x32<10>,
+                             KernelAvx512x12x32<11>,
+                             KernelAvx512x12x32<12>};
+    std::copy(kernels, kernels + 13, blocking.kernels);
+    return blocking;
+  }
+#endif
+#ifdef LITE_SGEMM_WITH_AVX2
+  if (device_avx_level() >= AVXType::ISA_AVX2 &&
+      device_fma_level() == FMAType::ISA_FMA) {
+    blocking.mr = 6;
+    blocking.nr = 16;
+    blocking.mc = 144;
+    blocking.nc = 1024;
+    MicroKernel kernels[] = {nullptr,
+                             KernelAvx6x16<1>,
+                             KernelAvx6x16<2>,
+                             KernelAvx6x16<3>,
+                             KernelAvx6x16<4>,
+                             KernelAvx6x16<5>,
+                             KernelAvx6x16<6>};
+    std::copy(kernels, kernels + 7, blocking.kernels);
+    return blocking;
+  }
+#endif
+  blocking.mr = 4;
+  blocking.nr = 8;
+  blocking.mc = 96;
+  blocking.nc = 512;
+  MicroKernel kernels[] = {nullptr,
+                           KernelGeneric4x8<1>,
+                           KernelGeneric4x8<2>,
+                           KernelGeneric4x8<3>,
+                           KernelGeneric4x8<4>};
+  std::copy(kernels, kernels + 5, blocking.kernels);
+  return blocking;
+}
+
+const Blocking& GetBlocking() {
+  static const Blocking blocking = SelectBlocking();
+  return blocking;
+}
+
+inline int RoundUp(int x, int align) { return (x + align - 1) / align * align; }
+
+inline int ThreadNum() {
+#ifdef LITE_USE_THREAD_POOL
+  ThreadPool* pool = ThreadPool::Current();
+  return pool != nullptr ? pool->thread_num() : 1;
+#else
+  return 1;
+#endif
+}
+
+// Scale `n` elements of `y` by `beta`, without reading `y` if beta is 0.
+inline void ScaleVector(int n, float beta, float* y) {
+  if (beta == 0.f) {
+    std::fill(y, y + n, 0.f);
+  } else if (beta != 1.f) {
+    for (int i = 0; i < n; ++i) y[i] *= beta;
+  }
+}
+
+inline float Dot(int n, const float* x, const float* y) {
+  int i = 0;
+  float sum = 0.f;
+#ifdef LITE_SGEMM_WITH_AVX2
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    acc0 =
+        _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+    acc1 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), acc1);
+  }
+  acc0 = _mm256_add_ps(acc0, acc1);
+  __m128 acc = _mm_add_ps(_mm256_castps256_ps128(acc0),
+                          _mm256_extractf128_ps(acc0, 1));
+  acc = _mm_hadd_ps(acc, acc);
+  acc = _mm_hadd_ps(acc, acc);
+  sum = _mm_cvtss_f32(acc);
+#endif
+  for (; i < n; ++i) sum += x[i] * y[i];
+  return sum;
+}
+
+// y += a * x
+inline void Axpy(int n, float a, const float* x, float* y) {
+  int i = 0;
+#ifdef LITE_SGEMM_WITH_AVX2
+  __m256 va = _mm256_set1_ps(a);
+  for (; i + 8 <= n; i += 8) {
+    __m256 vy = _mm256_loadu_ps(y + i);
+    _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), vy));
+  }
+#endif
+  for (; i < n; ++i) y[i] += a * x[i];
+}
+
+// The packing buffers of the calling thread, they only grow so that the
+// steady-state calls don't allocate. `index` 0 is for A and 1 is for B.
+float* ThreadPackBuffer(int index, int64_t size) {
+  static LITE_THREAD_LOCAL std::vector<float> buffers[2];
+  auto& buffer = buffers[index];
+  if (static_cast<int64_t>(buffer.size()) < size) {
+    buffer.resize(size);
+  }
+  return buffer.data();
+}
+
+}  // namespace
+
+int64_t sgemm_packed_a_size(int M, int K) {
+  const auto& blocking = GetBlocking();
+  return static_cast<int64_t>(RoundUp(M, blocking.mr)) * K;
+}
+
+int64_t sgemm_packed_b_size(int K, int N) {
+  const auto& blocking = GetBlocking();
+  return static_cast<int64_t>(RoundUp(N, blocking.nr)) * K;
+}
+
+// op(A) is stored block by block along K, a block of depth kc holds
+// ceil(M / MR) panels of [kc, MR], rows beyond M are zero.
+void sgemm_pack_a(
+    bool trans_a, int M, int K, const float* A, int lda, float* packed_a) {
+  const auto& blocking = GetBlocking();
+  const int MR = blocking.mr;
+  const int m_pad = RoundUp(M, MR);
+  const int m_panels = m_pad / MR;
+  const int k_blocks = (K + kKC - 1) / kKC;
+  LITE_PARALLEL_BEGIN(task, tid, k_blocks * m_panels) {
+    int pc = task / m_panels * kKC;
+    int ir = task % m_panels * MR;
+    int kc = std::min(kKC, K - pc);
+    int rows = std::min(MR, M - ir);
+    float* dst = packed_a + static_cast<int64_t>(pc) * m_pad + ir * kc;
+    for (int k = 0; k < kc; ++k) {
+      for (int r = 0; r < rows; ++r) {
+        int64_t i = ir + r;
+        dst[r] = trans_a ? A[(pc + k) * static_cast<int64_t>(lda) + i]
+                         : A[i * lda + pc + k];
+      }
+      for (int r = rows; r < MR; ++r) dst[r] = 0.f;
+      dst += MR;
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+// op(B) is stored block by block along K, a block of depth kc holds
+// ceil(N / NR) panels of [kc, NR], columns beyond N are zero.
+void sgemm_pack_b(
+    bool trans_b, int K, int N, const float* B, int ldb, float* packed_b) {
+  const auto& blocking = GetBlocking();
+  const int NR = blocking.nr;
+  const int n_pad = RoundUp(N, NR);
+  const int n_panels = n_pad / NR;
+  const int k_blocks = (K + kKC - 1) / kKC;
+  LITE_PARALLEL_BEGIN(task, tid, k_blocks * n_panels) {
+    int pc = task / n_panels * kKC;
+    int jr = task % n_panels * NR;
+    int kc = std::min(kKC, K - pc);
+    int cols = std::min(NR, N - jr);
+    float* dst = packed_b + static_cast<int64_t>(pc) * n_pad + jr * kc;
+    for (int k = 0; k < kc; ++k) {
+      if (trans_b) {
+        for (int j = 0; j < cols; ++j) {
+          dst[j] = B[(jr + j) * static_cast<int64_t>(ldb) + pc + k];
+        }
+      } else {
+        const float* src = B + (pc + k) * static_cast<int64_t>(ldb) + jr;
+        std::copy(src, src + cols, dst);
+      }
+      for (int j = cols; j < NR; ++j) dst[j] = 0.f;
+      dst += NR;
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void sgemm(bool trans_a,
+           bool trans_b,
+           int M,
+           int N,
+           int K,
+           float alpha,
+           const float* A,
+           int lda,
+           const float* B,
+           int ldb,
+           float beta,
+           float* C,
+           int ldc,
+           const float* packed_a,
+           const float* packed_b) {
+  if (M <= 0 || N <= 0) return;
+  if (K <= 0 || alpha == 0.f) {
+    for (int i = 0; i < M; ++i) {
+      ScaleVector(N, beta, C + static_cast<int64_t>(i) * ldc);
+    }
+    return;
+  }
+  // A single row of output is a matrix-vector product, it's not worth packing
+  if (M == 1 && packed_a == nullptr && packed_b == nullptr &&
+      (!trans_a || lda == 1)) {
+    if (trans_b) {
+      sgemv(false, N, K, alpha, B, ldb, A, beta, C);
+    } else {
+      sgemv(true, K, N, alpha, B, ldb, A, beta, C);
+    }
+    return;
+  }
+
+  const auto& blocking = GetBlocking();
+  const int MR = blocking.mr;
+  const int NR = blocking.nr;
+  const int m_pad = RoundUp(M, MR);
+  const int n_pad = RoundUp(N, NR);
+  if (packed_a == nullptr) {
+    float* a_buffer = ThreadPackBuffer(0, sgemm_packed_a_size(M, K));
+    sgemm_pack_a(trans_a, M, K, A, lda, a_buffer);
+    packed_a = a_buffer;
+  }
+  if (packed_b == nullptr) {
+    float* b_buffer = ThreadPackBuffer(1, sgemm_packed_b_size(K, N));
+    sgemm_pack_b(trans_b, K, N, B, ldb, b_buffer);
+    packed_b = b_buffer;
+  }
+
+  // Split C into [mc, nc] tiles, make them smaller until every thread gets
+  // at least one
+  int mc = std::min(blocking.mc, m_pad);
+  int nc = std::min(blocking.nc, n_pad);
+  const int thread_num = ThreadNum();
+  while ((m_pad + mc - 1) / mc * ((n_pad + nc - 1) / nc) < thread_num) {
+    if (nc > NR && (nc >= mc || mc <= MR)) {
+      nc = RoundUp(nc / 2, NR);
+    } else if (mc > MR) {
+      mc = RoundUp(mc / 2, MR);
+    } else {
+      break;
+    }
+  }
+  const int m_tiles = (m_pad + mc - 1) / mc;
+  const int n_tiles = (n_pad + nc - 1) / nc;
+
+  LITE_PARALLEL_BEGIN(tile, tid, m_tiles * n_tiles) {
+    int ic = tile % m_tiles * mc;
+    int jc = tile / m_tiles * nc;
+    int m_end = std::min(ic + mc, M);
+    int n_end = std::min(jc + nc, N);
+    for (int pc = 0; pc < K; pc += kKC) {
+      int kc = std::min(kKC, K - pc);
+      float block_beta = pc == 0 ? beta : 1.f;
+      const float* a_block = packed_a + static_cast<int64_t>(pc) * m_pad;
+      const float* b_block = packed_b + static_cast<int64_t>(pc) * n_pad;
+      for (int jr = jc; jr < n_end; jr += NR) {
+        int cols = std::min(NR, n_end - jr);
+        const float* pb = b_block + static_cast<int64_t>(jr) * kc;
+        for (int ir = ic; ir < m_end; ir += MR) {
+          int rows = std::min(MR, m_end - ir);
+          blocking.kernels[rows](cols,
+                                 kc,
+                                 a_block + static_cast<int64_t>(ir) * kc,
+                                 pb,
+                                 C + static_cast<int64_t>(ir) * ldc + jr,
+                                 ldc,
+                                 alpha,
+                                 block_beta);
+        }
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void sgemv(bool trans_a,
+           int M,
+           int N,
+           float alpha,
+           const float* A,
+           int lda,
+           const float* x,
+           float beta,
+           float* y) {
+  if (M <= 0 || N <= 0) return;
+  if (!trans_a) {
+    // y[i] = alpha * A[i, :] . x + beta * y[i]
+    const int kRowBlock = 16;
+    const int blocks = (M + kRowBlock - 1) / kRowBlock;
+    LITE_PARALLEL_BEGIN(block, tid, blocks) {
+      int begin = block * kRowBlock;
+      int end = std::min(begin + kRowBlock, M);
+      for (int i = begin; i < end; ++i) {
+        float sum = alpha * Dot(N, A + static_cast<int64_t>(i) * lda, x);
+        y[i] = beta == 0.f ? sum : sum + beta * y[i];
+      }
+    }
+    LITE_PARALLEL_END();
+  } else {
+    // y = alpha * sum_i x[i] * A[i, :] + beta * y, over blocks of columns
+    const int kColBlock = 512;
+    const int blocks = (N + kColBlock - 1) / kColBlock;
+    LITE_PARALLEL_BEGIN(block, tid, blocks) {
+      int begin = block * kColBlock;
+      int cols = std::min(kColBlock, N - begin);
+      float acc[kColBlock];
+      std::fill(acc, acc + cols, 0.f);
+      for (int i = 0; i < M; ++i) {
+        Axpy(cols, x[i], A + static_cast<int64_t>(i) * lda + begin, acc);
+      }
+      float* dst = y + begin;
+      for (int j = 0; j < cols; ++j) {
+        dst[j] = beta == 0.f ? alpha * acc[j] : alpha * acc[j] + beta * dst[j];
+      }
+    }
+    LITE_PARALLEL_END();
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
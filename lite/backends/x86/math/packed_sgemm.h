@@ -0,0 +1,93 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * In-tree, cache-blocked SGEMM for x86, used when no cblas library (MKLML or
+ * OpenBLAS) is linked.
+ *
+ * op(A) is packed into panels of MR rows and op(B) into panels of NR columns,
+ * both split into blocks of KC along K, and an MR x NR micro kernel runs on
+ * the panels. The micro kernel is picked once at runtime from the ISA level
+ * of the cpu (see `device_avx_level()`): 12x32 with AVX-512 (reported as
+ * ISA_VNNI), 6x16 with AVX2 and FMA, and a portable 4x8 kernel otherwise.
+ *
+ * Constant operands (e.g. weights) can be packed once by `sgemm_pack_a` /
+ * `sgemm_pack_b` and passed to `sgemm` on every call. The packed layout
+ * depends on the cpu, so never save it into a model.
+ */
+
+// Number of floats needed to hold op(A) [M, K] packed by sgemm_pack_a.
+int64_t sgemm_packed_a_size(int M, int K);
+// Number of floats needed to hold op(B) [K, N] packed by sgemm_pack_b.
+int64_t sgemm_packed_b_size(int K, int N);
+
+void sgemm_pack_a(
+    bool trans_a, int M, int K, const float* A, int lda, float* packed_a);
+
+void sgemm_pack_b(
+    bool trans_b, int K, int N, const float* B, int ldb, float* packed_b);
+
+// C = alpha * op(A) * op(B) + beta * C, all the matrices are row major.
+// If `packed_a` (`packed_b`) is not null, it's the result of sgemm_pack_a
+// (sgemm_pack_b) and used instead of A (B).
+void sgemm(bool trans_a,
+           bool trans_b,
+           int M,
+           int N,
+           int K,
+           float alpha,
+           const float* A,
+           int lda,
+           const float* B,
+           int ldb,
+           float beta,
+           float* C,
+           int ldc,
+           const float* packed_a = nullptr,
+           const float* packed_b = nullptr);
+
+// y = alpha * op(A) * x + beta * y, A is [M, N] and row major.
+void sgemv(bool trans_a,
+           int M,
+           int N,
+           float alpha,
+           const float* A,
+           int lda,
+           const float* x,
+           float beta,
+           float* y);
+
+// Whether the kernels should prepack their constant weights and call `sgemm`
+// instead of Blas, which is the case unless a cblas library is linked.
+inline bool use_packed_sgemm() {
+#if defined(PADDLE_WITH_MKLML) || defined(PADDLE_USE_OPENBLAS)
+  return false;
+#else
+  return true;
+#endif
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
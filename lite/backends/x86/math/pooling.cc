@@ -13,18 +13,262 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "lite/backends/x86/math/pooling.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
 #include <algorithm>
+#include <cfloat>
+#include <cstring>
 #include <vector>
+#include "lite/core/parallel_defines.h"
 
 namespace paddle {
 namespace lite {
 namespace x86 {
 namespace math {
 
+namespace {
+
+struct PoolShape {
+  int hin;
+  int win;
+  int hout;
+  int wout;
+  int kernel_h;
+  int kernel_w;
+  int stride_h;
+  int stride_w;
+  int pad_h;
+  int pad_w;
+};
+
+#ifdef __AVX__
+inline __m256 PoolOp(__m256 a, __m256 b, bool is_max) {
+  return is_max ? _mm256_max_ps(a, b) : _mm256_add_ps(a, b);
+}
+#endif
+
+inline float PoolOp(float a, float b, bool is_max) {
+  return is_max ? std::max(a, b) : a + b;
+}
+
+// max or sum of `len` contiguous floats, for the global pooling.
+float PoolReduce(const float* din, int len, bool is_max) {
+  int i = 0;
+  float res = is_max ? -FLT_MAX : 0.f;
+#ifdef __AVX__
+  if (len >= 32) {
+    __m256 acc[4];
+    for (int k = 0; k < 4; ++k) acc[k] = _mm256_loadu_ps(din + k * 8);
+    for (i = 32; i + 32 <= len; i += 32) {
+      for (int k = 0; k < 4; ++k) {
+        acc[k] = PoolOp(acc[k], _mm256_loadu_ps(din + i + k * 8), is_max);
+      }
+    }
+    acc[0] = PoolOp(PoolOp(acc[0], acc[1], is_max),
+                    PoolOp(acc[2], acc[3], is_max),
+                    is_max);
+    float lanes[8];
+    _mm256_storeu_ps(lanes, acc[0]);
+    for (int k = 0; k < 8; ++k) res = PoolOp(res, lanes[k], is_max);
+  }
+#endif
+  for (; i < len; ++i) res = PoolOp(res, din[i], is_max);
+  return res;
+}
+
+// dout[i] = op(dout[i], din[i]) on `len` floats.
+void PoolRow(const float* din, float* dout, int len, bool is_max) {
+  int i = 0;
+#ifdef __AVX__
+  for (; i + 8 <= len; i += 8) {
+    _mm256_storeu_ps(dout + i,
+                     PoolOp(_mm256_loadu_ps(dout + i),
+                            _mm256_loadu_ps(din + i),
+                            is_max));
+  }
+#endif
+  for (; i < len; ++i) dout[i] = PoolOp(dout[i], din[i], is_max);
+}
+
+// The windows of the outputs [begin, end) of a row are all inside `row`,
+// which is the vertical max or sum of the rows of the windows.
+void PoolRowWindows(const float* row,
+                    float* dout,
+                    int begin,
+                    int end,
+                    const PoolShape& shape,
+                    bool is_max,
+                    float scale) {
+  const int kw = shape.kernel_w;
+  const int sw = shape.stride_w;
+  int ow = begin;
+#ifdef __AVX__
+  __m256 vscale = _mm256_set1_ps(scale);
+  if (sw == 1) {
+    for (; ow + 8 <= end; ow += 8) {
+      const float* src = row + ow - shape.pad_w;
+      __m256 acc = _mm256_loadu_ps(src);
+      for (int k = 1; k < kw; ++k) {
+        acc = PoolOp(acc, _mm256_loadu_ps(src + k), is_max);
+      }
+      if (!is_max) acc = _mm256_mul_ps(acc, vscale);
+      _mm256_storeu_ps(dout + ow, acc);
+    }
+  }
+#ifdef __AVX2__
+  if (sw == 2) {
+    // the even floats of 16, `row` is padded so that the last load is valid
+    for (; ow + 8 <= end; ow += 8) {
+      const float* src = row + 2 * ow - shape.pad_w;
+      __m256 acc;
+      for (int k = 0; k < kw; ++k) {
+        __m256 even = _mm256_shuffle_ps(_mm256_loadu_ps(src + k),
+                                        _mm256_loadu_ps(src + k + 8),
+                                        _MM_SHUFFLE(2, 0, 2, 0));
+        even = _mm256_castpd_ps(
+            _mm256_permute4x64_pd(_mm256_castps_pd(even), 0xD8));
+        acc = k == 0 ? even : PoolOp(acc, even, is_max);
+      }
+      if (!is_max) acc = _mm256_mul_ps(acc, vscale);
+      _mm256_storeu_ps(dout + ow, acc);
+    }
+  }
+#endif  // __AVX2__
+#endif  // __AVX__
+  for (; ow < end; ++ow) {
+    const float* src = row + ow * sw - shape.pad_w;
+    float acc = src[0];
+    for (int k = 1; k < kw; ++k) acc = PoolOp(acc, src[k], is_max);
+    dout[ow] = is_max ? acc : acc * scale;
+  }
+}
+
+// One plane of max or avg pooling with the windows of Pool2dFunctor. The
+// rows of a window are reduced into `row` first, so both passes read
+// contiguous memory. `row` holds win + 16 floats.
+void PoolPlane(const float* din,
+               float* dout,
+               float* row,
+               const PoolShape& shape,
+               bool is_max,
+               bool exclusive) {
+  const int win = shape.win;
+  // outputs whose windows are inside the columns
+  int ow_begin = std::min((shape.pad_w + shape.stride_w - 1) / shape.stride_w,
+                          shape.wout);
+  int ow_end = win + shape.pad_w - shape.kernel_w < 0
+                   ? 0
+                   : (win + shape.pad_w - shape.kernel_w) / shape.stride_w + 1;
+  ow_end = std::max(std::min(ow_end, shape.wout), ow_begin);
+
+  for (int oh = 0; oh < shape.hout; ++oh) {
+    float* out_row = dout + oh * shape.wout;
+    int hstart = oh * shape.stride_h - shape.pad_h;
+    int hend = std::min(hstart + shape.kernel_h, shape.hin + shape.pad_h);
+    int hsize = hend - hstart;
+    hstart = std::max(hstart, 0);
+    hend = std::min(hend, shape.hin);
+    int hvalid = hend - hstart;
+    if (hvalid > 0) {
+      memcpy(row, din + hstart * win, sizeof(float) * win);
+      for (int h = hstart + 1; h < hend; ++h) {
+        PoolRow(din + h * win, row, win, is_max);
+      }
+    }
+    auto border = [&](int ow) {
+      int wstart = ow * shape.stride_w - shape.pad_w;
+      int wend = std::min(wstart + shape.kernel_w, win + shape.pad_w);
+      int pool_size = hsize * (wend - wstart);
+      wstart = std::max(wstart, 0);
+      wend = std::min(wend, win);
+      float ele = is_max ? -FLT_MAX : 0.f;
+      if (hvalid > 0) {
+        for (int w = wstart; w < wend; ++w) ele = PoolOp(ele, row[w], is_max);
+      }
+      if (exclusive) pool_size = hvalid * (wend - wstart);
+      out_row[ow] = is_max ? ele : ele / pool_size;
+    };
+    if (hvalid <= 0) {
+      for (int ow = 0; ow < shape.wout; ++ow) border(ow);
+      continue;
+    }
+    for (int ow = 0; ow < ow_begin; ++ow) border(ow);
+    float scale = 1.f / ((exclusive ? hvalid : hsize) * shape.kernel_w);
+    PoolRowWindows(row, out_row, ow_begin, ow_end, shape, is_max, scale);
+    for (int ow = ow_end; ow < shape.wout; ++ow) border(ow);
+  }
+}
+
+void PoolPlanesFloat(const float* din,
+                     float* dout,
+                     int planes,
+                     const PoolShape& shape,
+                     bool is_max,
+                     bool exclusive) {
+  const int in_size = shape.hin * shape.win;
+  const int out_size = shape.hout * shape.wout;
+  if (shape.hout == 1 && shape.wout == 1 && shape.kernel_h == shape.hin &&
+      shape.kernel_w == shape.win && shape.pad_h == 0 && shape.pad_w == 0) {
+    // global pooling, one reduction per plane
+    LITE_PARALLEL_BEGIN(i, tid, planes) {
+      float res = PoolReduce(din + i * in_size, in_size, is_max);
+      dout[i] = is_max ? res : res / in_size;
+    }
+    LITE_PARALLEL_END();
+    return;
+  }
+  LITE_PARALLEL_BEGIN(i, tid, planes) {
+    std::vector<float> row(shape.win + 16, 0.f);
+    PoolPlane(din + static_cast<int64_t>(i) * in_size,
+              dout + static_cast<int64_t>(i) * out_size,
+              row.data(),
+              shape,
+              is_max,
+              exclusive);
+  }
+  LITE_PARALLEL_END();
+}
+
+// Only the float max and avg pooling have a fast path.
+template <typename PoolProcess, typename T>
+bool PoolPlanesFast(PoolProcess pool_process,
+                    const T* din,
+                    T* dout,
+                    int planes,
+                    const PoolShape& shape,
+                    bool exclusive) {
+  return false;
+}
+
+bool PoolPlanesFast(MaxPool<float> pool_process,
+                    const float* din,
+                    float* dout,
+                    int planes,
+                    const PoolShape& shape,
+                    bool exclusive) {
+  PoolPlanesFloat(din, dout, planes, shape, true, exclusive);
+  return true;
+}
+
+bool PoolPlanesFast(AvgPool<float> pool_process,
+                    const float* din,
+                    float* dout,
+                    int planes,
+                    const PoolShape& shape,
+                    bool exclusive) {
+  PoolPlanesFloat(din, dout, planes, shape, false, exclusive);
+  return true;
+}
+
+}  // namespace
+
 /*
  * All tensors are in NCHW format.
  * Ksize, strides, paddings are two elements. These two elements represent
  * height and width, respectively.
+ * The planes of [batch, channel] run in parallel, the float max and avg
+ * pooling without adaptive windows are vectorized.
  */
 template <typename PoolProcess, typename T>
 class Pool2dFunctor<lite::TargetType::kX86, PoolProcess, T> {
@@ -57,54 +301,69 @@ class Pool2dFunctor<lite::TargetType::kX86, PoolProcess, T> {
     const T* input_data = input->template data<T>();
     T* output_data = output->template mutable_data<T>(lite::TargetType::kX86);
 
-    int hstart, hend;
-    int wstart, wend;
+    const int planes = batch_size * output_channels;
+    PoolShape shape{input_height,
+                    input_width,
+                    output_height,
+                    output_width,
+                    ksize_height,
+                    ksize_width,
+                    stride_height,
+                    stride_width,
+                    padding_height,
+                    padding_width};
+    if (!adaptive &&
+        PoolPlanesFast(
+            pool_process, input_data, output_data, planes, shape, exclusive)) {
+      return;
+    }
 
-    for (int i = 0; i < batch_size; i++) {
-      for (int c = 0; c < output_channels; ++c) {
-        for (int ph = 0; ph < output_height; ++ph) {
+    LITE_PARALLEL_BEGIN(i, tid, planes) {
+      const T* in_plane = input_data + static_cast<int64_t>(i) * input_stride;
+      T* out_plane = output_data + static_cast<int64_t>(i) * output_stride;
+      PoolProcess process = pool_process;
+      int hstart, hend;
+      int wstart, wend;
+      for (int ph = 0; ph < output_height; ++ph) {
+        if (adaptive) {
+          hstart = AdaptStartIndex(ph, input_height, output_height);
+          hend = AdaptEndIndex(ph, input_height, output_height);
+        }
+        for (int pw = 0; pw < output_width; ++pw) {
+          int pool_size = 1;
           if (adaptive) {
-            hstart = AdaptStartIndex(ph, input_height, output_height);
-            hend = AdaptEndIndex(ph, input_height, output_height);
+            wstart = AdaptStartIndex(pw, input_width, output_width);
+            wend = AdaptEndIndex(pw, input_width, output_width);
+          } else {
+            hstart = ph * stride_height - padding_height;
+            wstart = pw * stride_width - padding_width;
+            hend =
+                std::min(hstart + ksize_height, input_height + padding_height);
+            wend = std::min(wstart + ksize_width, input_width + padding_width);
+            pool_size = (hend - hstart) * (wend - wstart);
+
+            wstart = std::max(wstart, 0);
+            hstart = std::max(hstart, 0);
+            hend = std::min(hend, input_height);
+            wend = std::min(wend, input_width);
           }
-          for (int pw = 0; pw < output_width; ++pw) {
-            int pool_size = 1;
-            if (adaptive) {
-              wstart = AdaptStartIndex(pw, input_width, output_width);
-              wend = AdaptEndIndex(pw, input_width, output_width);
-            } else {
-              hstart = ph * stride_height - padding_height;
-              wstart = pw * stride_width - padding_width;
-              hend = std::min(hstart + ksize_height,
-                              input_height + padding_height);
-              wend =
-                  std::min(wstart + ksize_width, input_width + padding_width);
-              pool_size = (hend - hstart) * (wend - wstart);
-
-              wstart = std::max(wstart, 0);
-              hstart = std::max(hstart, 0);
-              hend = std::min(hend, input_height);
-              wend = std::min(wend, input_width);
-            }
 
-            T ele = pool_process.initial();
-            for (int h = hstart; h < hend; ++h) {
-              for (int w = wstart; w < wend; ++w) {
-                pool_process.compute(input_data[h * input_width + w], &ele);
-              }
-            }
-            if (exclusive || adaptive) {
-              pool_size = (hend - hstart) * (wend - wstart);
+          T ele = process.initial();
+          for (int h = hstart; h < hend; ++h) {
+            for (int w = wstart; w < wend; ++w) {
+              process.compute(in_plane[h * input_width + w], &ele);
             }
-
-            pool_process.finalize(static_cast<T>(pool_size), &ele);
-            output_data[ph * output_width + pw] = ele;
           }
+          if (exclusive || adaptive) {
+            pool_size = (hend - hstart) * (wend - wstart);
+          }
+
+          process.finalize(static_cast<T>(pool_size), &ele);
+          out_plane[ph * output_width + pw] = ele;
         }
-        input_data += input_stride;
-        output_data += output_stride;
       }
     }
+    LITE_PARALLEL_END();
   }
 };
 
@@ -41,6 +41,7 @@
 #include "lite/core/scope.h"
 #include "lite/core/target_wrapper.h"
 #include "lite/core/tensor.h"
+#include "lite/core/workspace.h"
 #include "lite/utils/all.h"
 #include "lite/utils/env.h"
 #include "lite/utils/macros.h"
@@ -348,10 +349,31 @@ class Context<TargetType::kX86> {
   AVXType avx_level() { return device_avx_level(); }
   FMAType fma_level() { return device_fma_level(); }
 
+  // The workspace is shared by the kernels of a runtime program, the data is
+  // only valid until the kernel returns. Call `ExtendWorkspace` before
+  // `workspace_data`, the pointers returned earlier stay valid.
+  template <typename T>
+  T* workspace_data() {
+    return workspace()->data<T>();
+  }
+
+  bool ExtendWorkspace(size_t size) { return workspace()->Extend(size); }
+
+  void SetWorkspace(const std::shared_ptr<ScratchArena>& workspace) {
+    workspace_ = workspace;
+  }
+
  private:
-  // overall information
-  //
-  // kernel information
+  // A context which isn't attached to a runtime program, e.g. in the unit
+  // tests, owns its workspace.
+  ScratchArena* workspace() {
+    if (!workspace_) {
+      workspace_ = std::make_shared<ScratchArena>();
+    }
+    return workspace_.get();
+  }
+
+  std::shared_ptr<ScratchArena> workspace_;
 };
 #endif
 
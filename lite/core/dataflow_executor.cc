@@ -0,0 +1,121 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/dataflow_executor.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+DataflowExecutor::DataflowExecutor(const std::vector<std::vector<int>>& deps,
+                                   int lanes)
+    : lanes_(lanes > 1 ? lanes : 1),
+      successors_(deps.size()),
+      num_deps_(deps.size(), 0) {
+  for (int i = 0; i < static_cast<int>(deps.size()); i++) {
+    for (int dep : deps[i]) {
+      CHECK(dep >= 0 && dep < i) << "Node " << i << " depends on " << dep
+                                 << ", which isn't a node before it.";
+      successors_[dep].push_back(i);
+      num_deps_[i]++;
+    }
+  }
+  for (int lane = 1; lane < lanes_; lane++) {
+    workers_.emplace_back(&DataflowExecutor::WorkerLoop, this, lane);
+  }
+}
+
+DataflowExecutor::~DataflowExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void DataflowExecutor::Run(const std::function<void(int, int)>& task) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  task_ = &task;
+  error_ = nullptr;
+  pending_ = num_deps_;
+  remaining_ = num_deps_.size();
+  for (int i = 0; i < static_cast<int>(num_deps_.size()); i++) {
+    if (num_deps_[i] == 0) ready_.push(i);
+  }
+  cv_.notify_all();
+  Execute(0, &lock);
+  task_ = nullptr;
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void DataflowExecutor::WorkerLoop(int lane) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    if (ready_.empty()) {
+      cv_.wait(lock);
+      continue;
+    }
+    Execute(lane, &lock);
+  }
+}
+
+void DataflowExecutor::Execute(int lane, std::unique_lock<std::mutex>* lock) {
+  while (remaining_ > 0) {
+    if (ready_.empty()) {
+      // The workers return to wait for the next run, the caller waits for
+      // this one to complete
+      if (lane != 0) return;
+      cv_.wait(*lock);
+      continue;
+    }
+    int node = ready_.top();
+    ready_.pop();
+    bool skip = static_cast<bool>(error_);
+    lock->unlock();
+    if (!skip) {
+#ifdef LITE_WITH_EXCEPTION
+      try {
+        (*task_)(node, lane);
+      } catch (...) {
+        lock->lock();
+        if (!error_) error_ = std::current_exception();
+        lock->unlock();
+      }
+#else
+      (*task_)(node, lane);
+#endif
+    }
+    lock->lock();
+    int num_ready = 0;
+    for (int next : successors_[node]) {
+      if (--pending_[next] == 0) {
+        ready_.push(next);
+        num_ready++;
+      }
+    }
+    if (--remaining_ == 0 || num_ready > 1) {
+      cv_.notify_all();
+    } else if (num_ready == 1 && ready_.size() > 1) {
+      cv_.notify_one();
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,74 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <queue>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * DataflowExecutor runs the nodes of a DAG on a fixed number of lanes, each
+ * node as soon as all of the nodes it depends on have completed. Lane 0 is
+ * the thread calling `Run`, the others are worker threads owned by the
+ * executor, which sleep between the runs.
+ *
+ * The ready nodes are taken in the ascending order of their indices, so a
+ * DAG built from a sequence of instructions runs in the original order when
+ * there is a single lane or no independent nodes.
+ */
+class DataflowExecutor {
+ public:
+  // `deps[i]` lists the nodes which node `i` depends on, they must be smaller
+  // than `i`.
+  DataflowExecutor(const std::vector<std::vector<int>>& deps, int lanes);
+  ~DataflowExecutor();
+
+  // Call `task(node, lane)` once for every node and wait for all of them.
+  // If a task throws, the nodes not started yet are skipped and the first
+  // exception is rethrown.
+  void Run(const std::function<void(int, int)>& task);
+
+  int lanes() const { return lanes_; }
+  size_t size() const { return num_deps_.size(); }
+
+ private:
+  void WorkerLoop(int lane);
+  // Execute the ready nodes until the run completes, called with the lock
+  // held.
+  void Execute(int lane, std::unique_lock<std::mutex>* lock);
+
+  int lanes_{1};
+  std::vector<std::vector<int>> successors_;
+  std::vector<int> num_deps_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::priority_queue<int, std::vector<int>, std::greater<int>> ready_;
+  std::vector<int> pending_;
+  size_t remaining_{0};
+  const std::function<void(int, int)>* task_{nullptr};
+  std::exception_ptr error_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,79 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/dataflow_executor.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(DataflowExecutor, order) {
+  // A random DAG, every node checks that its dependencies have completed
+  std::mt19937 rng(7);
+  const int n = 200;
+  std::vector<std::vector<int>> deps(n);
+  for (int i = 1; i < n; i++) {
+    for (int k = 0; k < 3; k++) {
+      if (rng() % 2) deps[i].push_back(rng() % i);
+    }
+  }
+  for (int lanes : {1, 2, 4}) {
+    DataflowExecutor executor(deps, lanes);
+    for (int run = 0; run < 5; run++) {
+      std::vector<std::atomic<int>> done(n);
+      for (auto& d : done) d = 0;
+      std::atomic<int> violations{0};
+      executor.Run([&](int node, int lane) {
+        EXPECT_LT(lane, lanes);
+        for (int dep : deps[node]) {
+          if (!done[dep]) violations++;
+        }
+        done[node] = 1;
+      });
+      EXPECT_EQ(violations.load(), 0);
+      for (auto& d : done) EXPECT_EQ(d.load(), 1);
+    }
+  }
+}
+
+TEST(DataflowExecutor, sequential) {
+  std::vector<std::vector<int>> deps = {{}, {}, {}, {1}};
+  DataflowExecutor executor(deps, 1);
+  std::vector<int> order;
+  executor.Run([&](int node, int lane) { order.push_back(node); });
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST(DataflowExecutor, concurrent) {
+  // Two branches of 2 sleeping nodes joined by the last node
+  std::vector<std::vector<int>> deps = {{}, {0}, {}, {2}, {1, 3}};
+  DataflowExecutor executor(deps, 2);
+  std::vector<int> lanes(deps.size(), -1);
+  auto start = std::chrono::steady_clock::now();
+  executor.Run([&](int node, int lane) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lanes[node] = lane;
+  });
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::milliseconds(90));
+  EXPECT_NE(lanes[0], lanes[2]);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,203 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_arena.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace paddle {
+namespace lite {
+
+namespace {
+inline size_t AlignUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+inline bool LifetimeOverlap(const ArenaBlock& a, const ArenaBlock& b) {
+  return b.last >= a.first && a.last >= b.first;
+}
+}  // namespace
+
+size_t PlanArenaOffsets(std::vector<ArenaBlock>* blocks, size_t alignment) {
+  CHECK(blocks);
+  CHECK_GT(alignment, 0u);
+  std::vector<size_t> order(blocks->size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return (*blocks)[a].size > (*blocks)[b].size;
+  });
+
+  size_t arena_size = 0;
+  std::vector<size_t> placed;
+  std::vector<std::pair<size_t, size_t>> used;
+  for (auto idx : order) {
+    auto& block = (*blocks)[idx];
+    size_t size = AlignUp(block.size, alignment);
+    // The memory ranges taken by the placed blocks which are alive at the
+    // same time as the current one
+    used.clear();
+    for (auto placed_idx : placed) {
+      auto& other = (*blocks)[placed_idx];
+      if (LifetimeOverlap(block, other)) {
+        used.emplace_back(other.offset,
+                          other.offset + AlignUp(other.size, alignment));
+      }
+    }
+    std::sort(used.begin(), used.end());
+    // Find the smallest gap that fits, otherwise append to the end
+    size_t best_offset = std::numeric_limits<size_t>::max();
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t cursor = 0;
+    for (auto& range : used) {
+      if (range.first > cursor) {
+        size_t gap = range.first - cursor;
+        if (gap >= size && gap < best_gap) {
+          best_offset = cursor;
+          best_gap = gap;
+        }
+      }
+      cursor = (std::max)(cursor, range.second);
+    }
+    if (best_offset == std::numeric_limits<size_t>::max()) {
+      best_offset = cursor;
+    }
+    block.offset = best_offset;
+    arena_size = (std::max)(arena_size, best_offset + size);
+    placed.push_back(idx);
+  }
+  return arena_size;
+}
+
+size_t ArenaPeakLiveSize(const std::vector<ArenaBlock>& blocks) {
+  size_t peak = 0;
+  // The live size only grows when a block starts
+  for (auto& block : blocks) {
+    size_t live = 0;
+    for (auto& other : blocks) {
+      if (other.first <= block.first && block.first <= other.last) {
+        live += other.size;
+      }
+    }
+    peak = (std::max)(peak, live);
+  }
+  return peak;
+}
+
+struct MemoryArena::Storage {
+  Storage(TargetType target, size_t size) : target(target), size(size) {
+    data = TargetMalloc(target, size);
+  }
+  ~Storage() { TargetFree(target, data); }
+
+  TargetType target;
+  size_t size;
+  void* data{nullptr};
+  // Set once a tensor has outgrown its slot, the arena should be re-planned.
+  bool overflow{false};
+};
+
+// A non-owning view of a slot of the arena. It turns into an ordinary owned
+// buffer once the tensor needs more than the slot.
+class MemoryArena::ArenaBuffer : public Buffer {
+ public:
+  ArenaBuffer(const std::shared_ptr<Storage>& storage,
+              size_t offset,
+              size_t size,
+              TargetType target)
+      : Buffer(static_cast<char*>(storage->data) + offset, target, size),
+        storage_(storage) {}
+
+  void ResetLazy(TargetType target, size_t size) override {
+    if (storage_ && (target != target_ || space_ < size)) {
+      storage_->overflow = true;
+      storage_.reset();
+      data_ = nullptr;
+      space_ = 0;
+      own_data_ = true;
+    }
+    Buffer::ResetLazy(target, size);
+  }
+
+ private:
+  std::shared_ptr<Storage> storage_;
+};
+
+void MemoryArena::AddTensor(const std::string& name,
+                            Tensor* tensor,
+                            int first,
+                            int last) {
+  CHECK(tensor);
+  CHECK_LE(first, last);
+  Entry entry;
+  entry.name = name;
+  entry.tensor = tensor;
+  entry.block.first = first;
+  entry.block.last = last;
+  entries_.push_back(entry);
+}
+
+size_t MemoryArena::arena_size() const {
+  return storage_ ? storage_->size : 0;
+}
+
+void MemoryArena::Update() {
+  for (auto& entry : entries_) {
+    entry.block.size =
+        (std::max)(entry.block.size, entry.tensor->memory_size());
+  }
+  if (!storage_ || storage_->overflow) {
+    Plan();
+  }
+}
+
+void MemoryArena::Plan() {
+  std::vector<ArenaBlock> blocks;
+  std::vector<size_t> entry_ids;
+  size_t total_size = 0;
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    auto block = entries_[i].block;
+    if (block.size == 0) continue;
+    total_size += block.size;
+    // Keep the same tail padding as TargetMalloc for the kernels that read or
+    // write slightly beyond the end of the tensor
+    block.size += kAlignment;
+    blocks.push_back(block);
+    entry_ids.push_back(i);
+  }
+  storage_.reset();
+  if (blocks.empty()) return;
+
+  size_t arena_size = PlanArenaOffsets(&blocks, kAlignment);
+  size_t peak_size = ArenaPeakLiveSize(blocks);
+  storage_ = std::make_shared<Storage>(target_, arena_size);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    auto& entry = entries_[entry_ids[i]];
+    auto* tensor = entry.tensor;
+    std::shared_ptr<Buffer> buffer = std::make_shared<ArenaBuffer>(
+        storage_, blocks[i].offset, blocks[i].size, tensor->target());
+    tensor->ResetBuffer(buffer, tensor->memory_size());
+    VLOG(4) << "Memory arena: " << entry.name << " [" << blocks[i].first
+            << ", " << blocks[i].last << "] -> offset " << blocks[i].offset
+            << ", " << blocks[i].size << " bytes";
+  }
+  LOG(INFO) << "Memory arena: " << blocks.size() << " tensors, "
+            << total_size << " bytes without arena, " << arena_size
+            << " bytes in arena, lower bound " << peak_size << " bytes.";
+}
+
+}  // namespace lite
+}  // namespace paddle
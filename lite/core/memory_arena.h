@@ -0,0 +1,86 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/memory.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+// A tensor which is alive from the `first`-th to the `last`-th instruction.
+struct ArenaBlock {
+  int first{0};
+  int last{0};
+  size_t size{0};
+  size_t offset{0};
+};
+
+// Assign every block an offset so that blocks whose lifetimes overlap don't
+// overlap in memory. Blocks are placed from the largest to the smallest into
+// the smallest gap that fits (greedy-by-size, best-fit). Offsets and sizes
+// are rounded up to `alignment`. Return the size of the arena.
+size_t PlanArenaOffsets(std::vector<ArenaBlock>* blocks, size_t alignment);
+
+// The largest sum of sizes of the blocks which are alive at the same time,
+// which is the lower bound of any plan.
+size_t ArenaPeakLiveSize(const std::vector<ArenaBlock>& blocks);
+
+/*
+ * MemoryArena places a set of activation tensors at offsets of one
+ * contiguous allocation. The tensors are bound to non-owning buffers into the
+ * arena, so `mutable_data` doesn't allocate as long as the tensor fits into
+ * its slot. If a tensor outgrows its slot (e.g. the input shapes changed), it
+ * falls back to a private allocation for the current run, and the arena is
+ * re-planned with the largest sizes seen so far on the next `Update`.
+ */
+class MemoryArena {
+ public:
+  static const size_t kAlignment = 64;
+
+  explicit MemoryArena(TargetType target = TARGET(kHost)) : target_(target) {}
+
+  // Register a tensor which is alive from the `first`-th to the `last`-th
+  // instruction.
+  void AddTensor(const std::string& name, Tensor* tensor, int first, int last);
+
+  // Record the current sizes of the tensors, and (re-)plan the arena if it
+  // hasn't been planned yet or a tensor outgrew its slot. Should be called
+  // after a complete run.
+  void Update();
+
+  size_t arena_size() const;
+  size_t tensor_num() const { return entries_.size(); }
+
+ private:
+  struct Storage;
+  class ArenaBuffer;
+  struct Entry {
+    std::string name;
+    Tensor* tensor;
+    ArenaBlock block;
+  };
+
+  void Plan();
+
+  TargetType target_;
+  std::vector<Entry> entries_;
+  std::shared_ptr<Storage> storage_;
+};
+
+}  // namespace lite
+}  // namespace paddle
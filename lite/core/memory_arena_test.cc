@@ -0,0 +1,108 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_arena.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+ArenaBlock MakeBlock(int first, int last, size_t size) {
+  ArenaBlock block;
+  block.first = first;
+  block.last = last;
+  block.size = size;
+  return block;
+}
+
+void CheckNoConflict(const std::vector<ArenaBlock>& blocks, size_t arena) {
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    EXPECT_LE(blocks[i].offset + blocks[i].size, arena);
+    EXPECT_EQ(blocks[i].offset % 64, 0u);
+    for (size_t j = i + 1; j < blocks.size(); ++j) {
+      bool live = blocks[i].last >= blocks[j].first &&
+                  blocks[j].last >= blocks[i].first;
+      bool mem = blocks[i].offset < blocks[j].offset + blocks[j].size &&
+                 blocks[j].offset < blocks[i].offset + blocks[i].size;
+      EXPECT_FALSE(live && mem) << "block " << i << " and " << j;
+    }
+  }
+}
+
+TEST(memory_arena, plan_chain) {
+  // A chain of ops, every activation is only alive across two ops
+  std::vector<ArenaBlock> blocks = {MakeBlock(0, 1, 1024),
+                                    MakeBlock(1, 2, 4096),
+                                    MakeBlock(2, 3, 1024),
+                                    MakeBlock(3, 4, 4096),
+                                    MakeBlock(4, 5, 256)};
+  size_t arena = PlanArenaOffsets(&blocks, 64);
+  CheckNoConflict(blocks, arena);
+  EXPECT_EQ(arena, ArenaPeakLiveSize(blocks));
+}
+
+TEST(memory_arena, plan_random) {
+  std::vector<ArenaBlock> blocks;
+  unsigned seed = 7;
+  size_t total = 0;
+  for (int i = 0; i < 200; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int first = (seed >> 8) % 100;
+    seed = seed * 1103515245 + 12345;
+    int last = first + (seed >> 8) % 10;
+    seed = seed * 1103515245 + 12345;
+    size_t size = 64 * (1 + (seed >> 8) % 100);
+    blocks.push_back(MakeBlock(first, last, size));
+    total += size;
+  }
+  size_t arena = PlanArenaOffsets(&blocks, 64);
+  CheckNoConflict(blocks, arena);
+  EXPECT_GE(arena, ArenaPeakLiveSize(blocks));
+  EXPECT_LT(arena, total);
+}
+
+TEST(memory_arena, bind_and_replan) {
+  Tensor x, y, z;
+  x.Resize({256});
+  y.Resize({512});
+  z.Resize({256});
+  x.mutable_data<float>();
+  y.mutable_data<float>();
+  z.mutable_data<float>();
+  MemoryArena arena;
+  arena.AddTensor("x", &x, 0, 1);
+  arena.AddTensor("y", &y, 1, 2);
+  arena.AddTensor("z", &z, 2, 3);
+  arena.Update();
+  size_t arena_size = arena.arena_size();
+  EXPECT_GT(arena_size, 0u);
+  // x and z may share the same slot
+  EXPECT_EQ(x.raw_data(), z.raw_data());
+  auto* x_data = x.mutable_data<float>();
+  EXPECT_EQ(x_data, x.raw_data());
+  arena.Update();
+  EXPECT_EQ(arena.arena_size(), arena_size);
+
+  // Outgrowing the slot falls back to a private buffer and re-plans
+  y.Resize({4096});
+  auto* y_data = y.mutable_data<float>();
+  y_data[4095] = 1.f;
+  arena.Update();
+  EXPECT_GT(arena.arena_size(), arena_size);
+  EXPECT_NE(y.raw_data(), x.raw_data());
+}
+
+}  // namespace lite
+}  // namespace paddle
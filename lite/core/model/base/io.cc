@@ -13,6 +13,14 @@
 // limitations under the License.
 
 #include "lite/core/model/base/io.h"
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <map>
+#include <mutex>  // NOLINT
 
 namespace paddle {
 namespace lite {
@@ -33,6 +41,60 @@ void Buffer::ResetLazy(size_t size) {
   size_ = size;
 }
 
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string& path) {
+#if defined(_WIN32)
+  return nullptr;
+#else
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<MappedFile>> mapped_files;
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(WARNING) << "Unable to open file: " << path;
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return nullptr;
+  }
+  // A file which is replaced or modified in place gets a new mapping.
+  const std::string key = path + ":" + std::to_string(st.st_dev) + ":" +
+                          std::to_string(st.st_ino) + ":" +
+                          std::to_string(st.st_size) + ":" +
+                          std::to_string(st.st_mtime);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto file = mapped_files[key].lock();
+  if (!file) {
+    size_t length = static_cast<size_t>(st.st_size);
+    // Read-only, so that a stray write to a weight faults instead of silently
+    // corrupting the weights shared by all the predictors. The params copy
+    // themselves out of the mapping before they are written, see
+    // `MappedParamBuffer`.
+    void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      file = std::make_shared<MappedFile>(data, length);
+      mapped_files[key] = file;
+    } else {
+      LOG(WARNING) << "Unable to map file: " << path;
+    }
+  }
+  close(fd);
+  // Drop the expired entries
+  for (auto it = mapped_files.begin(); it != mapped_files.end();) {
+    it = it->second.expired() ? mapped_files.erase(it) : std::next(it);
+  }
+  return file;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+  if (data_) {
+    munmap(data_, length_);
+  }
+#endif
+}
+
 std::string ByteReader::ReadToString(size_t size) const {
   std::string tmp;
   tmp.resize(size);
@@ -63,6 +125,20 @@ void BinaryFileWriter::Write(const void* src, size_t size) const {
   cur_ += size;
 }
 
+void MappedFileReader::Read(void* dst, size_t size) const {
+  CHECK(dst);
+  CHECK_LE(cur_ + size, file_->length()) << "Failed to read " << size
+                                         << " bytes.";
+  lite::TargetCopy(TargetType::kHost, dst, file_->data() + cur_, size);
+  cur_ += size;
+}
+
+void MappedFileReader::Skip(size_t size) const {
+  CHECK_LE(cur_ + size, file_->length()) << "Failed to skip " << size
+                                         << " bytes.";
+  cur_ += size;
+}
+
 void StringBufferReader::Read(void* dst, size_t size) const {
   CHECK(dst);
   lite::TargetCopy(TargetType::kHost, dst, buf_ + cur_, size);
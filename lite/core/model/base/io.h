@@ -75,14 +75,41 @@ class Buffer {
   size_t size_{0};
 };
 
+// A read-only mapping of a whole file. The mappings of the same
+// file are shared by all the users in the process, see `Open`.
+class MappedFile {
+ public:
+  // Return the mapping of `path`, which is created on the first call and
+  // reused as long as someone still holds it. Return nullptr if the file can
+  // not be mapped.
+  static std::shared_ptr<MappedFile> Open(const std::string& path);
+
+  MappedFile(void* data, size_t length) : data_(data), length_(length) {}
+  ~MappedFile();
+
+  const char* data() const { return static_cast<const char*>(data_); }
+  size_t length() const { return length_; }
+
+ private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  void* data_{nullptr};
+  size_t length_{0};
+};
+
 class ByteReader {
  public:
   ByteReader() = default;
   virtual void Read(void* dst, size_t size) const = 0;
   virtual std::string ReadToString(size_t size) const;
+  virtual void Skip(size_t size) const { ReadToString(size); }
   virtual size_t length() const = 0;
   virtual size_t current() const = 0;
   virtual bool ReachEnd() const = 0;
+  // The mapping of the whole source if it is mapped into memory, so that the
+  // data at `current()` can be referenced instead of copied.
+  virtual std::shared_ptr<MappedFile> mapped_file() const { return nullptr; }
 
   template <typename T,
             typename = typename std::enable_if<
@@ -118,6 +145,8 @@ class ByteWriter {
   }
 
   virtual size_t Align(size_t bytes_size) const = 0;
+  // The number of bytes written so far.
+  virtual size_t current() const = 0;
 
   virtual ~ByteWriter() = default;
 
@@ -157,6 +186,7 @@ class BinaryFileWriter : public ByteWriter {
     }
   }
   void Write(const void* src, size_t size) const override;
+  size_t current() const override { return cur_; }
 
   // Fill a number of zero characters to align the number
   // of written bytes to a certain position.
@@ -179,6 +209,26 @@ class BinaryFileWriter : public ByteWriter {
   }
 };
 
+// Read from a mapped file, the offsets are counted from the beginning of the
+// file.
+class MappedFileReader : public ByteReader {
+ public:
+  explicit MappedFileReader(const std::shared_ptr<MappedFile>& file)
+      : file_(file) {
+    CHECK(file_);
+  }
+  void Read(void* dst, size_t size) const override;
+  void Skip(size_t size) const override;
+  bool ReachEnd() const override { return cur_ >= file_->length(); }
+  size_t length() const override { return file_->length(); }
+  size_t current() const override { return cur_; }
+  std::shared_ptr<MappedFile> mapped_file() const override { return file_; }
+
+ private:
+  std::shared_ptr<MappedFile> file_;
+  mutable size_t cur_{0};
+};
+
 class StringBufferReader : public ByteReader {
  public:
   explicit StringBufferReader(const std::string& buffer)
@@ -23,6 +23,7 @@
 #include <vector>
 #include "lite/core/context.h"
 #include "lite/core/kernel.h"
+#include "lite/core/profile/op_character.h"
 #include "lite/core/scope.h"
 #include "lite/model_parser/cpp_desc.h"
 #include "lite/operators/op_params.h"
@@ -80,9 +81,9 @@ class OpLite : public Registry {
   // Indicate whether the Op runs only once or not
   virtual bool run_once() const { return false; }
   std::string Type() const { return op_type_; }
-#ifdef LITE_WITH_PROFILE
+  // Fill the shapes and the estimated MACs of the last run, which are used by
+  // the profilers.
   virtual void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {}
-#endif
 
   // Link the external execution environ to internal context.
   bool Attach(const cpp::OpDesc &opdesc, lite::Scope *scope);
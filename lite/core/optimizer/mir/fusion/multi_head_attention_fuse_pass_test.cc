@@ -0,0 +1,235 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/optimizer/mir/pass_manager.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// The attention of a hidden size of 8 to be built, q, k and v are split into
+// the heads by their own shapes.
+struct AttentionDesc {
+  bool with_q_scale{false};
+  bool with_mask{false};
+  std::vector<int> q_shape{0, 0, 2, 4};
+  std::vector<int> k_shape{0, 0, 2, 4};
+  std::vector<int> v_shape{0, 0, 2, 4};
+  int64_t v_width{8};
+};
+
+class AttentionProgramBuilder {
+ public:
+  AttentionProgramBuilder()
+      : program_desc_(std::make_shared<cpp::ProgramDesc>()),
+        scope_(std::make_shared<Scope>()) {
+    block_desc_ = program_desc_->AddBlock<cpp::BlockDesc>();
+    block_desc_->ClearOps();
+    block_desc_->ClearVars();
+  }
+
+  std::unique_ptr<SSAGraph> Build(const AttentionDesc& desc) {
+    auto input = AddVar("input", false);
+    auto q = SplitHeads("q", Linear("q", input, {8, 8}), desc.q_shape);
+    auto k = SplitHeads("k", Linear("k", input, {8, 8}), desc.k_shape);
+    auto v =
+        SplitHeads("v", Linear("v", input, {8, desc.v_width}), desc.v_shape);
+    if (desc.with_q_scale) {
+      auto* op_desc = AddOp("scale", {{"X", q}}, {{"Out", "q_scale_out"}});
+      op_desc->SetAttr<float>("scale", 0.5f);
+      op_desc->SetAttr<float>("bias", 0.f);
+      op_desc->SetAttr<bool>("bias_after_scale", true);
+      q = "q_scale_out";
+    }
+    auto qk = Matmul("qk", q, k, true);
+    if (desc.with_mask) {
+      auto* op_desc = AddOp("elementwise_add",
+                            {{"X", qk}, {"Y", AddVar("mask", false)}},
+                            {{"Out", "mask_add_out"}});
+      op_desc->SetAttr<int>("axis", -1);
+      qk = "mask_add_out";
+    }
+    AddOp("softmax", {{"X", qk}}, {{"Out", "softmax_out"}})
+        ->SetAttr<int>("axis", -1);
+    auto qkv = Matmul("qkv", "softmax_out", v, false);
+    AddOp("transpose2",
+          {{"X", qkv}},
+          {{"Out", "qkv_transpose2_out"}, {"XShape", "qkv_transpose2_xshape"}})
+        ->SetAttr<std::vector<int>>("axis", {0, 2, 1, 3});
+    AddOp("reshape2",
+          {{"X", "qkv_transpose2_out"}},
+          {{"Out", "qkv_reshape2_out"}, {"XShape", "qkv_reshape2_xshape"}})
+        ->SetAttr<std::vector<int>>("shape", {0, 0, 8});
+    Linear("out", "qkv_reshape2_out", {8, 8});
+
+    std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)}};
+    program_.reset(new Program(program_desc_, scope_, valid_places));
+    std::unique_ptr<SSAGraph> graph(new SSAGraph);
+    graph->Build(*program_, valid_places);
+    return graph;
+  }
+
+ private:
+  std::string AddVar(const std::string& name,
+                     bool persistable,
+                     const std::vector<int64_t>& shape = {}) {
+    auto* var_desc = block_desc_->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+    var_desc->SetPersistable(persistable);
+    if (persistable) {
+      auto* tensor = scope_->Var(name)->GetMutable<Tensor>();
+      tensor->Resize(shape);
+      tensor->mutable_data<float>();
+    }
+    return name;
+  }
+
+  cpp::OpDesc* AddOp(
+      const std::string& type,
+      const std::vector<std::pair<std::string, std::string>>& inputs,
+      const std::vector<std::pair<std::string, std::string>>& outputs) {
+    auto* op_desc = block_desc_->AddOp<cpp::OpDesc>();
+    op_desc->SetType(type);
+    for (auto& input : inputs) {
+      op_desc->SetInput(input.first, {input.second});
+    }
+    for (auto& output : outputs) {
+      AddVar(output.second, false);
+      op_desc->SetOutput(output.first, {output.second});
+    }
+    return op_desc;
+  }
+
+  std::string Linear(const std::string& name,
+                     const std::string& input,
+                     const std::vector<int64_t>& weight_shape) {
+    auto* mul = AddOp("mul",
+                      {{"X", input},
+                       {"Y", AddVar(name + "_weight", true, weight_shape)}},
+                      {{"Out", name + "_mul_out"}});
+    mul->SetAttr<int>("x_num_col_dims", 2);
+    mul->SetAttr<int>("y_num_col_dims", 1);
+    auto* add =
+        AddOp("elementwise_add",
+              {{"X", name + "_mul_out"},
+               {"Y", AddVar(name + "_bias", true, {weight_shape[1]})}},
+              {{"Out", name + "_add_out"}});
+    add->SetAttr<int>("axis", -1);
+    return name + "_add_out";
+  }
+
+  std::string SplitHeads(const std::string& name,
+                         const std::string& input,
+                         const std::vector<int>& shape) {
+    AddOp("reshape2",
+          {{"X", input}},
+          {{"Out", name + "_reshape2_out"},
+           {"XShape", name + "_reshape2_xshape"}})
+        ->SetAttr<std::vector<int>>("shape", shape);
+    AddOp("transpose2",
+          {{"X", name + "_reshape2_out"}},
+          {{"Out", name + "_transpose2_out"},
+           {"XShape", name + "_transpose2_xshape"}})
+        ->SetAttr<std::vector<int>>("axis", {0, 2, 1, 3});
+    return name + "_transpose2_out";
+  }
+
+  std::string Matmul(const std::string& name,
+                     const std::string& x,
+                     const std::string& y,
+                     bool transpose_y) {
+    auto* op_desc =
+        AddOp("matmul", {{"X", x}, {"Y", y}}, {{"Out", name + "_matmul_out"}});
+    op_desc->SetAttr<bool>("transpose_X", false);
+    op_desc->SetAttr<bool>("transpose_Y", transpose_y);
+    op_desc->SetAttr<float>("alpha", transpose_y ? 0.5f : 1.f);
+    return name + "_matmul_out";
+  }
+
+  std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  std::shared_ptr<Scope> scope_;
+  cpp::BlockDesc* block_desc_{nullptr};
+  std::unique_ptr<Program> program_;
+};
+
+static int CountOps(SSAGraph* graph, const std::string& op_type) {
+  int count = 0;
+  for (auto& node : graph->StmtTopologicalOrder()) {
+    if (node->stmt()->op_type() == op_type) count++;
+  }
+  return count;
+}
+
+static void ApplyFusePass(const std::unique_ptr<SSAGraph>& graph) {
+  auto* pass =
+      PassManager::Global().LookUp("lite_multi_head_attention_fuse_pass");
+  ASSERT_TRUE(pass != nullptr);
+  pass->Apply(graph);
+}
+
+TEST(multi_head_attention_fuse_pass, fuse) {
+  for (auto with_q_scale : {false, true}) {
+    for (auto with_mask : {false, true}) {
+      AttentionDesc desc;
+      desc.with_q_scale = with_q_scale;
+      desc.with_mask = with_mask;
+      AttentionProgramBuilder builder;
+      auto graph = builder.Build(desc);
+      ApplyFusePass(graph);
+      EXPECT_EQ(CountOps(graph.get(), "fused_multi_head_attention"), 1);
+      EXPECT_EQ(CountOps(graph.get(), "softmax"), 0);
+      for (auto& node : graph->StmtTopologicalOrder()) {
+        auto* op_info = node->stmt()->op_info();
+        if (op_info->Type() != "fused_multi_head_attention") continue;
+        EXPECT_EQ(op_info->GetAttr<int>("head_num"), 2);
+        EXPECT_NEAR(op_info->GetAttr<float>("alpha"),
+                    with_q_scale ? 0.25f : 0.5f,
+                    1e-6f);
+        EXPECT_EQ(op_info->HasInput("Mask") && !op_info->Input("Mask").empty(),
+                  with_mask);
+      }
+    }
+  }
+}
+
+TEST(multi_head_attention_fuse_pass, skip_mismatched_heads) {
+  std::vector<AttentionDesc> descs(2);
+  // k has 4 heads of 2 while q has 2 heads of 4
+  descs[0].k_shape = {0, 0, 4, 2};
+  // The heads of v don't span its weight of width 16
+  descs[1].v_width = 16;
+  for (auto& desc : descs) {
+    desc.with_mask = true;
+    AttentionProgramBuilder builder;
+    auto graph = builder.Build(desc);
+    size_t num_nodes = graph->nodes().size();
+    ApplyFusePass(graph);
+    EXPECT_EQ(CountOps(graph.get(), "fused_multi_head_attention"), 0);
+    EXPECT_EQ(CountOps(graph.get(), "softmax"), 1);
+    EXPECT_EQ(graph->nodes().size(), num_nodes);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
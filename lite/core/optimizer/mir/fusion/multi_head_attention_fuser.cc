@@ -0,0 +1,401 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/multi_head_attention_fuser.h"
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// Whether `node` is a mul, matmul or matmul_v2 of the given transposes
+// without scaling.
+static bool IsPlainMatmul(const Node* node, bool trans_x, bool trans_y) {
+  auto* op_info = const_cast<Node*>(node)->stmt()->op_info();
+  const auto& op_type = op_info->Type();
+  if (op_type == "mul") {
+    return !trans_x && !trans_y &&
+           op_info->GetAttr<int>("x_num_col_dims") == 2 &&
+           op_info->GetAttr<int>("y_num_col_dims") == 1;
+  }
+  std::string trans_x_name = op_type == "matmul" ? "transpose_X" : "trans_x";
+  std::string trans_y_name = op_type == "matmul" ? "transpose_Y" : "trans_y";
+  return op_info->GetAttr<bool>(trans_x_name) == trans_x &&
+         op_info->GetAttr<bool>(trans_y_name) == trans_y;
+}
+
+static float MatmulAlpha(const OpInfo* op_info) {
+  return op_info->HasAttr("alpha") ? op_info->GetAttr<float>("alpha") : 1.f;
+}
+
+// The op of `op_type` which produces the input `arg` of `op`, or nullptr.
+static const Node* ProducerOp(const Node* op,
+                              const std::string& arg,
+                              const std::string& op_type) {
+  if (!op) return nullptr;
+  auto* op_info = op->stmt()->op_info();
+  if (!op_info->HasInput(arg) || op_info->Input(arg).size() != 1) {
+    return nullptr;
+  }
+  auto name = op_info->Input(arg).front();
+  for (auto* var : op->inlinks) {
+    if (!var->IsArg() || var->arg()->name != name) continue;
+    if (var->inlinks.size() != 1) return nullptr;
+    auto* producer = var->inlinks.front();
+    return producer->IsStmt() && producer->stmt()->op_type() == op_type
+               ? producer
+               : nullptr;
+  }
+  return nullptr;
+}
+
+// The only op of `op_type` which consumes the output `arg` of `op`, or
+// nullptr.
+static const Node* ConsumerOp(const Node* op,
+                              const std::string& arg,
+                              const std::string& op_type) {
+  if (!op) return nullptr;
+  auto* op_info = op->stmt()->op_info();
+  if (!op_info->HasOutput(arg) || op_info->Output(arg).size() != 1) {
+    return nullptr;
+  }
+  auto name = op_info->Output(arg).front();
+  for (auto* var : op->outlinks) {
+    if (!var->IsArg() || var->arg()->name != name) continue;
+    if (var->outlinks.size() != 1) return nullptr;
+    auto* consumer = var->outlinks.front();
+    return consumer->IsStmt() && consumer->stmt()->op_type() == op_type
+               ? consumer
+               : nullptr;
+  }
+  return nullptr;
+}
+
+// The dims of the persistable input `arg` of `op`.
+static bool InputDims(const Node* op, const std::string& arg, DDim* dims) {
+  auto* op_info = op->stmt()->op_info();
+  auto* scope = op->stmt()->op()->scope();
+  auto* var = scope->FindVar(op_info->Input(arg).front());
+  if (!var || !var->IsType<lite::Tensor>()) return false;
+  *dims = var->Get<lite::Tensor>().dims();
+  return true;
+}
+
+// Whether the linear `input * weight + bias` whose elementwise_add is `add`
+// has a 2-D weight of `rows` x `cols` and a bias of `cols`.
+static bool IsLinearOf(const Node* add,
+                       const std::string& mul_type,
+                       int64_t rows,
+                       int64_t cols) {
+  auto* mul = ProducerOp(add, "X", mul_type);
+  DDim weight_dims, bias_dims;
+  if (!mul || !InputDims(mul, "Y", &weight_dims) ||
+      !InputDims(add, "Y", &bias_dims)) {
+    return false;
+  }
+  return weight_dims.size() == 2 && weight_dims[0] == rows &&
+         weight_dims[1] == cols && bias_dims.production() == cols;
+}
+
+bool MultiHeadAttentionFuser::IsValidAttention(const Node* qkv_matmul) const {
+  // The split heads reshape2 of q, k and v
+  auto* softmax = ProducerOp(qkv_matmul, "X", "softmax");
+  auto* qk_matmul =
+      with_mask_ ? ProducerOp(ProducerOp(softmax, "X", "elementwise_add"),
+                              "X",
+                              qk_matmul_type_)
+                 : ProducerOp(softmax, "X", qk_matmul_type_);
+  auto* q_transpose =
+      with_q_scale_
+          ? ProducerOp(ProducerOp(qk_matmul, "X", "scale"), "X", "transpose2")
+          : ProducerOp(qk_matmul, "X", "transpose2");
+  const Node* reshapes[3] = {
+      ProducerOp(q_transpose, "X", "reshape2"),
+      ProducerOp(ProducerOp(qk_matmul, "Y", "transpose2"), "X", "reshape2"),
+      ProducerOp(ProducerOp(qkv_matmul, "Y", "transpose2"), "X", "reshape2")};
+  std::vector<int> shapes[3];
+  for (int i = 0; i < 3; i++) {
+    if (!reshapes[i]) return false;
+    shapes[i] =
+        reshapes[i]->stmt()->op_info()->GetAttr<std::vector<int>>("shape");
+    if (shapes[i].size() != 4) return false;
+  }
+  // q, k and v must have the same heads, which span the whole width of their
+  // weights
+  int64_t width = static_cast<int64_t>(shapes[0][2]) * shapes[0][3];
+  DDim input_weight_dims;
+  auto* q_add = ProducerOp(reshapes[0], "X", "elementwise_add");
+  auto* q_mul = ProducerOp(q_add, "X", mul_type_);
+  if (!q_mul || !InputDims(q_mul, "Y", &input_weight_dims) ||
+      input_weight_dims.size() != 2) {
+    return false;
+  }
+  for (int i = 0; i < 3; i++) {
+    if (shapes[i][2] != shapes[0][2] || shapes[i][3] != shapes[0][3] ||
+        !IsLinearOf(ProducerOp(reshapes[i], "X", "elementwise_add"),
+                    mul_type_,
+                    input_weight_dims[0],
+                    width)) {
+      return false;
+    }
+  }
+  // The merged heads go through the output linear
+  auto* merge_reshape = ConsumerOp(
+      ConsumerOp(qkv_matmul, "Out", "transpose2"), "Out", "reshape2");
+  if (!merge_reshape) return false;
+  auto merge_shape =
+      merge_reshape->stmt()->op_info()->GetAttr<std::vector<int>>("shape");
+  if (merge_shape.size() != 3 || merge_shape[2] != width) return false;
+  auto* out_add = ConsumerOp(
+      ConsumerOp(merge_reshape, "Out", mul_type_), "Out", "elementwise_add");
+  if (!out_add) return false;
+  auto* out_mul = ProducerOp(out_add, "X", mul_type_);
+  DDim out_weight_dims;
+  return out_mul && InputDims(out_mul, "Y", &out_weight_dims) &&
+         out_weight_dims.size() == 2 &&
+         IsLinearOf(out_add, mul_type_, width, out_weight_dims[1]);
+}
+
+PMNode* MultiHeadAttentionFuser::CreateLinear(const std::string& name,
+                                              PMNode* input) {
+  auto* weight = VarNode(name + "_weight")
+                     ->assert_is_op_input(mul_type_, "Y")
+                     ->assert_is_persistable_var()
+                     ->AsInput();
+  auto* mul = OpNode(name + "_mul", mul_type_)
+                  ->assert_node_satisfied([](const Node* node) {
+                    return IsPlainMatmul(node, false, false) &&
+                           std::fabs(MatmulAlpha(node->stmt()->op_info()) -
+                                     1.f) < 1e-5f;
+                  })
+                  ->AsIntermediate();
+  auto* mul_out = VarNode(name + "_mul_out")
+                      ->assert_is_op_output(mul_type_, "Out")
+                      ->assert_is_op_input("elementwise_add", "X")
+                      ->AsIntermediate();
+  auto* bias = VarNode(name + "_bias")
+                   ->assert_is_op_input("elementwise_add", "Y")
+                   ->assert_is_persistable_var()
+                   ->AsInput();
+  auto* add = OpNode(name + "_add", "elementwise_add")
+                  ->assert_op_attr_satisfied<int>(
+                      "axis", [](int axis) { return axis == -1 || axis == 2; })
+                  ->AsIntermediate();
+  auto* add_out =
+      VarNode(name + "_add_out")->assert_is_op_output("elementwise_add", "Out");
+  std::vector<PMNode*> mul_inputs{input, weight};
+  std::vector<PMNode*> add_inputs{mul_out, bias};
+  mul_inputs >> *mul >> *mul_out;
+  add_inputs >> *add >> *add_out;
+  return add_out;
+}
+
+PMNode* MultiHeadAttentionFuser::CreateSplitHeads(const std::string& name,
+                                                  PMNode* input) {
+  input->assert_is_op_input("reshape2", "X")->AsIntermediate();
+  auto* reshape = OpNode(name + "_reshape2", "reshape2")
+                      ->assert_op_attr_satisfied<std::vector<int>>(
+                          "shape",
+                          [](const std::vector<int>& shape) {
+                            return shape.size() == 4 && shape[0] == 0 &&
+                                   shape[1] <= 0 && shape[2] > 0 &&
+                                   shape[3] > 0;
+                          })
+                      ->AsIntermediate();
+  auto* reshape_out = VarNode(name + "_reshape2_out")
+                          ->assert_is_op_output("reshape2", "Out")
+                          ->assert_is_op_input("transpose2", "X")
+                          ->AsIntermediate();
+  auto* reshape_xshape = VarNode(name + "_reshape2_xshape")
+                             ->assert_is_op_output("reshape2", "XShape")
+                             ->AsIntermediate();
+  auto* transpose = OpNode(name + "_transpose2", "transpose2")
+                        ->assert_op_attr<std::vector<int>>("axis", {0, 2, 1, 3})
+                        ->AsIntermediate();
+  auto* transpose_out = VarNode(name + "_transpose2_out")
+                            ->assert_is_op_output("transpose2", "Out")
+                            ->AsIntermediate();
+  auto* transpose_xshape = VarNode(name + "_transpose2_xshape")
+                               ->assert_is_op_output("transpose2", "XShape")
+                               ->AsIntermediate();
+  *input >> *reshape >> *reshape_out >> *transpose >> *transpose_out;
+  *reshape >> *reshape_xshape;
+  *transpose >> *transpose_xshape;
+  return transpose_out;
+}
+
+void MultiHeadAttentionFuser::BuildPattern() {
+  auto* input = VarNode("input")->assert_is_op_input(mul_type_, "X")->AsInput();
+  auto* q = CreateSplitHeads("q", CreateLinear("q", input));
+  auto* k = CreateSplitHeads("k", CreateLinear("k", input));
+  auto* v = CreateSplitHeads("v", CreateLinear("v", input));
+
+  if (with_q_scale_) {
+    auto* scale = OpNode("q_scale", "scale")
+                      ->assert_op_attr<float>("bias", 0.f)
+                      ->AsIntermediate();
+    auto* scale_out = VarNode("q_scale_out")
+                          ->assert_is_op_output("scale", "Out")
+                          ->AsIntermediate();
+    q->assert_is_op_input("scale", "X");
+    *q >> *scale >> *scale_out;
+    q = scale_out;
+  }
+  q->assert_is_op_input(qk_matmul_type_, "X");
+  k->assert_is_op_input(qk_matmul_type_, "Y");
+  auto* qk_matmul = OpNode("qk_matmul", qk_matmul_type_)
+                        ->assert_node_satisfied([](const Node* node) {
+                          return IsPlainMatmul(node, false, true);
+                        })
+                        ->AsIntermediate();
+  auto* qk_out = VarNode("qk_matmul_out")
+                     ->assert_is_op_output(qk_matmul_type_, "Out")
+                     ->AsIntermediate();
+  std::vector<PMNode*> qk_inputs{q, k};
+  qk_inputs >> *qk_matmul >> *qk_out;
+  if (with_mask_) {
+    auto* mask =
+        VarNode("mask")->assert_is_op_input("elementwise_add", "Y")->AsInput();
+    auto* mask_add = OpNode("mask_add", "elementwise_add")
+                         ->assert_op_attr<int>("axis", -1)
+                         ->AsIntermediate();
+    auto* mask_out = VarNode("mask_add_out")
+                         ->assert_is_op_output("elementwise_add", "Out")
+                         ->AsIntermediate();
+    qk_out->assert_is_op_input("elementwise_add", "X");
+    std::vector<PMNode*> mask_inputs{qk_out, mask};
+    mask_inputs >> *mask_add >> *mask_out;
+    qk_out = mask_out;
+  }
+  qk_out->assert_is_op_input("softmax", "X");
+  auto* softmax =
+      OpNode("softmax", "softmax")
+          ->assert_op_attr_satisfied<int>(
+              "axis", [](int axis) { return axis == -1 || axis == 3; })
+          ->AsIntermediate();
+  auto* softmax_out = VarNode("softmax_out")
+                          ->assert_is_op_output("softmax", "Out")
+                          ->assert_is_op_input(qkv_matmul_type_, "X")
+                          ->AsIntermediate();
+  *qk_out >> *softmax >> *softmax_out;
+
+  v->assert_is_op_input(qkv_matmul_type_, "Y");
+  auto* qkv_matmul =
+      OpNode("qkv_matmul", qkv_matmul_type_)
+          ->assert_node_satisfied([this](const Node* node) {
+            return IsPlainMatmul(node, false, false) &&
+                   std::fabs(MatmulAlpha(node->stmt()->op_info()) - 1.f) <
+                       1e-5f &&
+                   IsValidAttention(node);
+          })
+          ->AsIntermediate();
+  auto* qkv_out = VarNode("qkv_matmul_out")
+                      ->assert_is_op_output(qkv_matmul_type_, "Out")
+                      ->assert_is_op_input("transpose2", "X")
+                      ->AsIntermediate();
+  std::vector<PMNode*> qkv_inputs{softmax_out, v};
+  qkv_inputs >> *qkv_matmul >> *qkv_out;
+
+  // merge the heads
+  auto* transpose = OpNode("qkv_transpose2", "transpose2")
+                        ->assert_op_attr<std::vector<int>>("axis", {0, 2, 1, 3})
+                        ->AsIntermediate();
+  auto* transpose_out = VarNode("qkv_transpose2_out")
+                            ->assert_is_op_output("transpose2", "Out")
+                            ->assert_is_op_input("reshape2", "X")
+                            ->AsIntermediate();
+  auto* transpose_xshape = VarNode("qkv_transpose2_xshape")
+                               ->assert_is_op_output("transpose2", "XShape")
+                               ->AsIntermediate();
+  auto* reshape = OpNode("qkv_reshape2", "reshape2")
+                      ->assert_op_attr_satisfied<std::vector<int>>(
+                          "shape",
+                          [](const std::vector<int>& shape) {
+                            return shape.size() == 3 && shape[0] == 0 &&
+                                   shape[1] <= 0 && shape[2] > 0;
+                          })
+                      ->AsIntermediate();
+  auto* reshape_out = VarNode("qkv_reshape2_out")
+                          ->assert_is_op_output("reshape2", "Out")
+                          ->AsIntermediate();
+  auto* reshape_xshape = VarNode("qkv_reshape2_xshape")
+                             ->assert_is_op_output("reshape2", "XShape")
+                             ->AsIntermediate();
+  *qkv_out >> *transpose >> *transpose_out >> *reshape >> *reshape_out;
+  *transpose >> *transpose_xshape;
+  *reshape >> *reshape_xshape;
+  reshape_out->assert_is_op_input(mul_type_, "X");
+  CreateLinear("out", reshape_out)->AsOutput();
+}
+
+void MultiHeadAttentionFuser::InsertNewNode(SSAGraph* graph,
+                                            const key2nodes_t& matched) {
+  auto q_mul = matched.at("q_mul")->stmt()->op();
+  auto* scope = q_mul->scope();
+  auto q_shape = matched.at("q_reshape2")
+                     ->stmt()
+                     ->op_info()
+                     ->GetAttr<std::vector<int>>("shape");
+  float alpha = MatmulAlpha(matched.at("qk_matmul")->stmt()->op_info());
+  if (with_q_scale_) {
+    alpha *= matched.at("q_scale")->stmt()->op_info()->GetAttr<float>("scale");
+  }
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_multi_head_attention");
+  op_desc.SetInput("Input", {matched.at("input")->arg()->name});
+  const std::vector<std::pair<std::string, std::string>> linears{
+      {"q", "Q"}, {"k", "K"}, {"v", "V"}, {"out", "Out"}};
+  for (auto& linear : linears) {
+    op_desc.SetInput(linear.second + "Weight",
+                     {matched.at(linear.first + "_weight")->arg()->name});
+    op_desc.SetInput(linear.second + "Bias",
+                     {matched.at(linear.first + "_bias")->arg()->name});
+  }
+  if (with_mask_) {
+    op_desc.SetInput("Mask", {matched.at("mask")->arg()->name});
+  }
+  op_desc.SetOutput("Output", {matched.at("out_add_out")->arg()->name});
+  op_desc.SetAttr<int>("head_num", q_shape[2]);
+  op_desc.SetAttr<float>("alpha", alpha);
+
+  auto attention_op = LiteOpRegistry::Global().Create(op_desc.Type());
+  attention_op->Attach(op_desc, scope);
+  auto* new_op_node =
+      graph->GraphCreateInstructNode(attention_op, q_mul->valid_places());
+  std::vector<std::string> inputs{"input",
+                                  "q_weight",
+                                  "q_bias",
+                                  "k_weight",
+                                  "k_bias",
+                                  "v_weight",
+                                  "v_bias",
+                                  "out_weight",
+                                  "out_bias"};
+  if (with_mask_) inputs.push_back("mask");
+  for (auto& input : inputs) {
+    IR_NODE_LINK_TO(matched.at(input), new_op_node);
+  }
+  IR_NODE_LINK_TO(new_op_node, matched.at("out_add_out"));
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
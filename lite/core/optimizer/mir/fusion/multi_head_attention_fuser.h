@@ -0,0 +1,88 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pattern_matcher_high_api.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+/*
+ * Fuse the multi-head attention of a BERT/ERNIE like encoder into
+ * fused_multi_head_attention:
+ *
+ *           +-------------------- input --------------------+
+ *           |                       |                       |
+ *   linear(q)->reshape2      linear(k)->reshape2     linear(v)->reshape2
+ *        ->transpose2            ->transpose2            ->transpose2
+ *        [->scale]                   |                       |
+ *           +------ matmul(trans_y) -+                       |
+ *                [->elementwise_add(mask)]                   |
+ *                      ->softmax                             |
+ *                          +------------ matmul -------------+
+ *                                           |
+ *                           transpose2->reshape2->linear(out)
+ *                                           |
+ *                                         output
+ *
+ * where linear is `mul_type` (mul, matmul or matmul_v2) on a constant 2-D
+ * weight followed by elementwise_add of a constant bias. The reshape2 ops
+ * must keep the batch and the sequence length, so the fused op works on any
+ * sequence length.
+ */
+class MultiHeadAttentionFuser : public FuseBase {
+ public:
+  MultiHeadAttentionFuser(const std::string& mul_type,
+                          const std::string& qk_matmul_type,
+                          const std::string& qkv_matmul_type,
+                          bool with_q_scale,
+                          bool with_mask)
+      : mul_type_(mul_type),
+        qk_matmul_type_(qk_matmul_type),
+        qkv_matmul_type_(qkv_matmul_type),
+        with_q_scale_(with_q_scale),
+        with_mask_(with_mask) {}
+
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+
+ private:
+  // Create the nodes of `input * weight + bias` with the keys prefixed by
+  // `name`, and return the output.
+  PMNode* CreateLinear(const std::string& name, PMNode* input);
+  // Create reshape2 (to [batch, seq_len, head_num, head_dim]) and transpose2
+  // on `input`, and return the output.
+  PMNode* CreateSplitHeads(const std::string& name, PMNode* input);
+  // Whether the attention around `qkv_matmul` splits q, k and v into the same
+  // heads spanning the whole width of their weights, and the weights and the
+  // biases have the shapes of fused_multi_head_attention. It's checked on the
+  // graph since the pattern can't compare the attributes of different nodes.
+  bool IsValidAttention(const Node* qkv_matmul) const;
+
+  std::string mul_type_;
+  std::string qk_matmul_type_;
+  std::string qkv_matmul_type_;
+  bool with_q_scale_;
+  bool with_mask_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
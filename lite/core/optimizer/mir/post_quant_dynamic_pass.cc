@@ -129,7 +129,7 @@ void PostQuantDynamicPerChannel(OpInfo* op_info,
   CHECK(weight_dims.size() == 1 || weight_dims.size() == 2 ||
         weight_dims.size() == 4);
   CHECK(quant_axis == 0 || quant_axis == 1);
-  CHECK(quant_bits == 8 || quant_bits == 16);
+  CHECK(quant_bits == 4 || quant_bits == 8 || quant_bits == 16);
   if (weight_dims.size() == 1) {
     CHECK(quant_axis == 0) << "when weight is bias, quant_axis must be 0";
   }
@@ -148,7 +148,8 @@ void PostQuantDynamicPerChannel(OpInfo* op_info,
   tmp_tensor.CopyDataFrom(*weight);
   weight->clear();
 
-  if (quant_bits == 8) {
+  // The 4 bits weights are saved in int8
+  if (quant_bits == 4 || quant_bits == 8) {
     weight->set_precision(PRECISION(kInt8));
     int8_t* weight_data = weight->mutable_data<int8_t>();
     QuantizeWeightPerChannel(tmp_tensor, scales, quant_axis, weight_data);
@@ -169,6 +170,8 @@ void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
     quant_bits = 8;
   } else if (quant_type_ == lite_api::QuantType::QUANT_INT16) {
     quant_bits = 16;
+  } else if (quant_type_ == lite_api::QuantType::QUANT_INT4) {
+    quant_bits = 4;
   } else {
     LOG(FATAL) << "Not support quant type:" << static_cast<int>(quant_type_);
   }
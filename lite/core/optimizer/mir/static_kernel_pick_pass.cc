@@ -157,25 +157,31 @@ void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
       // If the out_type_int8 is false, we should pick the kernel with the
       // int8 input and fp32 output.
       auto output_arguments = instruct.op_info()->OutputArgumentNames();
-      for (auto& candidate : scored) {
-        bool all_output_type_match = true;
-        auto expect_output_type =
-            out_type_int8 ? PRECISION(kInt8) : PRECISION(kFloat);
-
-        for (auto& arg_name : output_arguments) {
-          const Type* out_arg_ty =
-              candidate.second->GetOutputDeclType(arg_name);
-          if (out_arg_ty->precision() != expect_output_type) {
-            all_output_type_match = false;
+      auto pick_by_output_type = [&](PrecisionType expect_output_type) {
+        for (auto& candidate : scored) {
+          bool all_output_type_match = true;
+          for (auto& arg_name : output_arguments) {
+            const Type* out_arg_ty =
+                candidate.second->GetOutputDeclType(arg_name);
+            if (out_arg_ty->precision() != expect_output_type) {
+              all_output_type_match = false;
+            }
           }
-        }
 
-        if (all_output_type_match) {
-          instruct.kernels().emplace_back(std::move(candidate.second));
-          VLOG(2) << "instruct.kernels.emplace_back "
-                  << instruct.kernels().front()->name();
-          break;
+          if (all_output_type_match) {
+            instruct.kernels().emplace_back(std::move(candidate.second));
+            VLOG(2) << "instruct.kernels.emplace_back "
+                    << instruct.kernels().front()->name();
+            break;
+          }
         }
+      };
+      pick_by_output_type(out_type_int8 ? PRECISION(kInt8)
+                                        : PRECISION(kFloat));
+      // Some int8 kernels only have the fp32 output, the int8 inputs of the
+      // next ops are quantized by the calib ops in this case.
+      if (instruct.kernels().empty() && out_type_int8) {
+        pick_by_output_type(PRECISION(kFloat));
       }
       CHECK(!instruct.kernels().empty()) << "No kernels found for "
                                          << instruct.op_type();
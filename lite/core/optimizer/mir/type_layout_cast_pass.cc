@@ -116,6 +116,14 @@ void TypeLayoutTransformPass::ComplementInputs(
       return;
     }
 
+    // Blocked tensors are restored to NCHW for kernels of any layout.
+    if (b == DATALAYOUT(kAny) &&
+        (a == DATALAYOUT(kNCHW8c) || a == DATALAYOUT(kNCHW16c))) {
+      decl_arg_type = LiteType::GetTensorTy(decl_arg_type->target(),
+                                            decl_arg_type->precision(),
+                                            DATALAYOUT(kNCHW));
+    }
+
     AddLayoutInst(*in->AsArg().type,
                   *decl_arg_type,
                   in,
@@ -0,0 +1,160 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/pass_manager.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/optimizer/mir/static_kernel_pick_pass.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static void AddVar(cpp::BlockDesc* block_desc, const std::string& name) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarDescAPI::Type::LOD_TENSOR);
+}
+
+static cpp::OpDesc* AddOp(cpp::BlockDesc* block_desc,
+                          const std::string& type,
+                          const std::string& input,
+                          const std::vector<std::string>& outputs) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  op_desc->SetInput("X", {input});
+  op_desc->SetOutput("Out", {outputs[0]});
+  if (outputs.size() > 1) {
+    op_desc->SetOutput("XShape", {outputs[1]});
+  }
+  for (auto& output : outputs) {
+    AddVar(block_desc, output);
+  }
+  return op_desc;
+}
+
+// The stmt which produces the input `arg` of `stmt`.
+static Node* Producer(Node* stmt, const std::string& arg) {
+  std::string name = stmt->AsStmt().op_info()->Input(arg).front();
+  for (auto* in : stmt->inlinks) {
+    if (in->AsArg().name == name) {
+      return in->inlinks.empty() ? nullptr : in->inlinks.front();
+    }
+  }
+  return nullptr;
+}
+
+// x -> relu -> a -> softmax
+//                 -> reshape2
+// relu has a kernel of NCHW8c, while softmax has one of NCHW only and reshape2
+// one of kAny, so that `a` is restored to NCHW in front of both of them. The
+// conversion is created by the first consumer and shared by the other one.
+static void TestRestoreNCHW(bool any_layout_first) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto scope = std::make_shared<Scope>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  AddVar(block_desc, "x");
+  AddOp(block_desc, "relu", "x", {"a"});
+  auto add_softmax = [&] {
+    AddOp(block_desc, "softmax", "a", {"b"})->SetAttr<int>("axis", -1);
+  };
+  auto add_reshape2 = [&] {
+    AddOp(block_desc, "reshape2", "a", {"c", "c_xshape"})
+        ->SetAttr<std::vector<int>>("shape", {0, -1});
+  };
+  if (any_layout_first) {
+    add_reshape2();
+    add_softmax();
+  } else {
+    add_softmax();
+    add_reshape2();
+  }
+
+  std::vector<Place> valid_places{
+      Place{TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW8c)},
+      Place{TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW)},
+      Place{TARGET(kHost), PRECISION(kAny), DATALAYOUT(kAny)}};
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+
+  auto* kernel_pick_pass =
+      PassManager::Global().LookUp<StaticKernelPickPass>(
+          "static_kernel_pick_pass");
+  ASSERT_TRUE(kernel_pick_pass != nullptr);
+  core::KernelPickFactor kernel_pick_factor;
+  kernel_pick_factor.ConsiderTarget();
+  kernel_pick_factor.ConsiderPrecision();
+  kernel_pick_factor.ConsiderDataLayout();
+  *kernel_pick_pass->mutable_kernel_pick_factors() = kernel_pick_factor;
+  for (auto& pass_name : {"static_kernel_pick_pass",
+                          "variable_place_inference_pass",
+                          "type_layout_cast_pass",
+                          "variable_place_inference_pass"}) {
+    auto* pass = PassManager::Global().LookUp(pass_name);
+    ASSERT_TRUE(pass != nullptr) << pass_name;
+    pass->Apply(graph);
+  }
+
+  int num_layouts = 0;
+  Node* restored = nullptr;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto& stmt = node->AsStmt();
+    const auto& op_type = stmt.op_type();
+    if (op_type == "relu") {
+      EXPECT_EQ(stmt.picked_kernel().layout(), DATALAYOUT(kNCHW8c));
+    } else if (op_type == "layout") {
+      num_layouts++;
+    } else if (op_type == "softmax" || op_type == "reshape2") {
+      auto* layout = Producer(node, "X");
+      ASSERT_TRUE(layout != nullptr) << op_type;
+      ASSERT_EQ(layout->AsStmt().op_type(), "layout") << op_type;
+      auto& kernel = layout->AsStmt().picked_kernel();
+      EXPECT_EQ(kernel.GetInputDeclType("Input")->layout(),
+                DATALAYOUT(kNCHW8c));
+      EXPECT_EQ(kernel.GetOutputDeclType("Out")->layout(), DATALAYOUT(kNCHW));
+      EXPECT_EQ(layout->outlinks.front()->AsArg().type->layout(),
+                DATALAYOUT(kNCHW));
+      // Both consumers share the same conversion
+      if (restored != nullptr) EXPECT_EQ(restored, layout);
+      restored = layout;
+    }
+  }
+  EXPECT_TRUE(restored != nullptr);
+  EXPECT_EQ(num_layouts, 1);
+}
+
+TEST(type_layout_cast_pass, restore_nchw_from_blocked) {
+  TestRestoreNCHW(true);
+  TestRestoreNCHW(false);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(relu, kX86, kFloat, kNCHW8c, def);
+USE_LITE_KERNEL(softmax, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(reshape2, kHost, kAny, kAny, def);
+USE_LITE_KERNEL(layout, kX86, kFloat, kNCHW, nchw8c2nchw);
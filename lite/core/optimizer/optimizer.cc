@@ -165,6 +165,7 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "lite_conv_conv_fuse_pass",         //
        // TODO(Superjomn) Refine the fusion related design to select fusion
        // kernels for devices automatically.
+       "lite_multi_head_attention_fuse_pass",         //
        "lite_sigmoid_elementmul_fuse_pass",           //
        "lite_conv_activation_fuse_pass",              //
        "lite_squeeze2_matmul_fuse_pass",              //
@@ -277,6 +278,15 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
     }
   }
 
+  // The memory arena places the activations by their sizes and lifetimes at
+  // runtime, merging them by name beforehand only makes the slots larger
+  if (config.use_memory_arena()) {
+    passes_local.erase(
+        std::remove(
+            passes_local.begin(), passes_local.end(), "memory_optimize_pass"),
+        passes_local.end());
+  }
+
   // It's just a workaround to avoid repeated op fusion if the filter weights
   // are shared among sub-blocks
   if (program.block_size() > 1) {
@@ -0,0 +1,99 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/packed_weight_cache.h"
+#include <utility>
+#include "lite/utils/string.h"
+
+namespace paddle {
+namespace lite {
+
+struct PackedWeightCache::Entry {
+  // Shares the buffer of the source weight to pin its address
+  Tensor source;
+  Tensor packed;
+};
+
+PackedWeightCache& PackedWeightCache::Global() {
+  static PackedWeightCache* x = new PackedWeightCache;
+  return *x;
+}
+
+std::shared_ptr<const Tensor> PackedWeightCache::Get(const Tensor& weight,
+                                                     const std::string& kind,
+                                                     const PackFunc& pack) {
+  if (!weight.persistable()) {
+    std::shared_ptr<Tensor> packed(new Tensor);
+    pack(weight, packed.get());
+    return packed;
+  }
+  auto key = string_format("%p %s %s",
+                           weight.raw_data(),
+                           weight.dims().repr().c_str(),
+                           kind.c_str());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      auto entry = it->second.lock();
+      if (entry) {
+        return std::shared_ptr<const Tensor>(entry, &entry->packed);
+      }
+    }
+  }
+  // Pack without holding the lock, the clones created in parallel may pack
+  // the same weight at the same time, and the first one inserted wins.
+  auto entry = std::make_shared<Entry>();
+  entry->source.ShareDataWith(weight);
+  pack(weight, &entry->packed);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& slot = entries_[key];
+  auto existing = slot.lock();
+  if (existing) {
+    entry = existing;
+  } else {
+    slot = entry;
+    RemoveExpired();
+  }
+  return std::shared_ptr<const Tensor>(entry, &entry->packed);
+}
+
+void PackedWeightCache::RemoveExpired() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+size_t PackedWeightCache::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RemoveExpired();
+  return entries_.size();
+}
+
+size_t PackedWeightCache::memory_size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t bytes = 0;
+  for (auto& it : entries_) {
+    auto entry = it.second.lock();
+    if (entry) bytes += entry->packed.memory_size();
+  }
+  return bytes;
+}
+
+}  // namespace lite
+}  // namespace paddle
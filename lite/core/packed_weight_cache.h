@@ -0,0 +1,67 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * PackedWeightCache shares the transformed copies of the constant weights
+ * (packed gemm panels, winograd transformed filters, ...) among the kernels
+ * of the whole process, so that the predictors cloned from one another,
+ * which share the persistable tensors through the scope, keep one copy of
+ * every transformed weight instead of one per clone.
+ *
+ * An entry is keyed by the identity of the weight buffer, the kind of the
+ * transform and its parameters. The entries are reference counted: a
+ * transformed copy is released as soon as the last kernel using it is
+ * destroyed, and it keeps the source buffer alive meanwhile, so the address
+ * in the key can't be reused by another weight.
+ */
+class PackedWeightCache {
+ public:
+  using PackFunc = std::function<void(const Tensor& weight, Tensor* packed)>;
+
+  static PackedWeightCache& Global();
+
+  // Get the copy of `weight` transformed by `pack`. `kind` names the
+  // transform together with all of its parameters which the result depends
+  // on besides the weight itself, e.g. "x86.sgemm_pack_b k=64 n=128". A
+  // weight which isn't persistable is packed for the caller only.
+  std::shared_ptr<const Tensor> Get(const Tensor& weight,
+                                    const std::string& kind,
+                                    const PackFunc& pack);
+
+  // The number and the total bytes of the transformed copies alive.
+  size_t size();
+  size_t memory_size();
+
+ private:
+  struct Entry;
+  PackedWeightCache() = default;
+  void RemoveExpired();
+
+  std::mutex mutex_;
+  std::map<std::string, std::weak_ptr<Entry>> entries_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,101 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/packed_weight_cache.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace paddle {
+namespace lite {
+
+PackedWeightCache::PackFunc Doubler(int* calls) {
+  return [calls](const Tensor& weight, Tensor* packed) {
+    (*calls)++;
+    packed->Resize(weight.dims());
+    auto src = weight.data<float>();
+    auto dst = packed->mutable_data<float>();
+    for (int64_t i = 0; i < weight.numel(); i++) {
+      dst[i] = src[i] * 2.f;
+    }
+  };
+}
+
+TEST(PackedWeightCache, share) {
+  auto& cache = PackedWeightCache::Global();
+  Tensor weight;
+  weight.Resize({4, 8});
+  auto data = weight.mutable_data<float>();
+  for (int i = 0; i < 32; i++) data[i] = i;
+  weight.set_persistable(true);
+
+  int calls = 0;
+  auto a = cache.Get(weight, "double", Doubler(&calls));
+  auto b = cache.Get(weight, "double", Doubler(&calls));
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(a.get(), b.get());
+  EXPECT_EQ(a->data<float>()[31], 62.f);
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_EQ(cache.memory_size(), 32 * sizeof(float));
+
+  // Another transform of the same weight
+  auto c = cache.Get(weight, "double v2", Doubler(&calls));
+  EXPECT_EQ(calls, 2);
+  EXPECT_NE(a.get(), c.get());
+  EXPECT_EQ(cache.size(), 2u);
+
+  // Released with the last user
+  a.reset();
+  c.reset();
+  EXPECT_EQ(cache.size(), 1u);
+  b.reset();
+  EXPECT_EQ(cache.size(), 0u);
+  auto d = cache.Get(weight, "double", Doubler(&calls));
+  EXPECT_EQ(calls, 3);
+}
+
+TEST(PackedWeightCache, pin_source) {
+  auto& cache = PackedWeightCache::Global();
+  int calls = 0;
+  std::unique_ptr<Tensor> weight(new Tensor);
+  weight->Resize({16});
+  weight->mutable_data<float>();
+  weight->set_persistable(true);
+  const void* address = weight->raw_data();
+  auto packed = cache.Get(*weight, "double", Doubler(&calls));
+  // The buffer is kept by the packed copy, so the address can't be taken by
+  // another weight while the copy is alive
+  weight.reset();
+  Tensor other;
+  other.Resize({16});
+  other.mutable_data<float>();
+  other.set_persistable(true);
+  EXPECT_NE(other.raw_data(), address);
+}
+
+TEST(PackedWeightCache, not_persistable) {
+  auto& cache = PackedWeightCache::Global();
+  Tensor weight;
+  weight.Resize({8});
+  weight.mutable_data<float>();
+  int calls = 0;
+  auto a = cache.Get(weight, "double", Doubler(&calls));
+  auto b = cache.Get(weight, "double", Doubler(&calls));
+  EXPECT_EQ(calls, 2);
+  EXPECT_NE(a.get(), b.get());
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -17,14 +17,11 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "lite/core/profile/op_character.h"
 #include "lite/core/profile/timer.h"
 #include "lite/core/tensor.h"
 #include "lite/utils/replace_stl/stream.h"
 
-#ifdef LITE_WITH_OPENCL
-#include "lite/backends/opencl/cl_include.h"
-#endif
-
 namespace paddle {
 namespace lite {
 namespace profile {
@@ -48,65 +45,6 @@ struct TimeInfo {
 #endif
 };
 
-struct OpCharacter {
-  TargetType target;
-  void* op_lite{nullptr};
-  std::string op_type{std::string("N/A")};
-  std::string kernel_name{std::string("N/A")};
-  std::string kernel_attr{std::string("N/A")};
-  std::string kernel_func_name{std::string("N/A")};
-  std::string remark{std::string("N/A")};
-
-  std::string input_shape{"N/A"};
-  std::string output_shape{"N/A"};
-  std::string filter_shape{"N/A"};
-
-  float macs{0};
-  float macs_ps{0};
-
-  float io_duration{0};
-
-#ifdef LITE_WITH_OPENCL
-  cl::Event cl_event{};
-  std::string global_work_size{"N/A"};
-  std::string local_work_size{"N/A"};
-
-  std::string NDRangeToStr(const cl::NDRange& range) {
-    std::string range_str{""};
-    const size_t range_dims = range.dimensions();
-    if (range_dims == 0) return "NullRange";
-    for (size_t i = 0; i < range_dims; ++i) {
-      range_str += std::to_string(range[i]);
-      if (i != range_dims - 1) {
-        range_str += ",";
-      }
-    }
-    return range_str;
-  }
-#else
-  void* cl_event{nullptr};
-#endif
-
-  std::string DimToStr(const paddle::lite::DDimLite& dim) {
-    if (!dim.size()) return "NotImpl";
-    std::string dim_str{""};
-    for (size_t i = 0; i < dim.size(); ++i) {
-      dim_str += std::to_string(dim[i]);
-      if (i != dim.size() - 1) {
-        dim_str += "x";
-      }
-    }
-    return dim_str;
-  }
-
-  std::string str() {
-    std::string str{""};
-    str += kernel_name + "/" + kernel_func_name + "/" + remark + "/" +
-           input_shape + "/" + filter_shape + "/" + output_shape;
-    return str;
-  }
-};
-
 class StatisUnit final {
  public:
   explicit StatisUnit(const OpCharacter& ch);
@@ -0,0 +1,162 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/trace_profiler.h"
+#include <cstdio>
+#include <utility>
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+namespace {
+
+void AppendEscaped(const std::string& text, std::string* out) {
+  out->push_back('"');
+  for (char c : text) {
+    switch (c) {
+      case '"':
+        out->append("\\\"");
+        break;
+      case '\\':
+        out->append("\\\\");
+        break;
+      case '\n':
+        out->append("\\n");
+        break;
+      case '\t':
+        out->append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          out->append(buf);
+        } else {
+          out->push_back(c);
+        }
+    }
+  }
+  out->push_back('"');
+}
+
+void AppendNumber(double value, std::string* out) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.3f", value);
+  out->append(buf);
+}
+
+void AppendStringArg(const char* key,
+                     const std::string& value,
+                     std::string* out) {
+  if (value.empty() || value == "N/A") return;
+  out->append(",\"");
+  out->append(key);
+  out->append("\":");
+  AppendEscaped(value, out);
+}
+
+}  // namespace
+
+int TraceProfiler::ThreadIndex(std::thread::id id) {
+  auto it = threads_.find(id);
+  if (it != threads_.end()) return it->second;
+  int index = static_cast<int>(threads_.size());
+  threads_.emplace(id, index);
+  return index;
+}
+
+void TraceProfiler::AddRun(double start_us,
+                           double end_us,
+                           std::vector<TraceEvent>* ops) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const int thread = ThreadIndex(std::this_thread::get_id());
+  const int run = runs_++;
+  if (events_.size() + ops->size() + 1 > kMaxEvents) {
+    dropped_ += ops->size() + 1;
+    return;
+  }
+  TraceEvent event;
+  event.name = "run";
+  event.category = "run";
+  event.run = run;
+  event.start_us = start_us;
+  event.end_us = end_us;
+  event.thread = thread;
+  events_.push_back(std::move(event));
+  for (auto& op : *ops) {
+    op.run = run;
+    op.thread = op.thread_id == std::thread::id() ? thread
+                                                  : ThreadIndex(op.thread_id);
+    events_.push_back(std::move(op));
+  }
+  ops->clear();
+}
+
+std::vector<TraceEvent> TraceProfiler::events() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return events_;
+}
+
+size_t TraceProfiler::dropped_events() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+void TraceProfiler::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  dropped_ = 0;
+}
+
+std::string TraceProfiler::ToChromeTrace() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string json = "{\"traceEvents\":[";
+  for (size_t i = 0; i < events_.size(); ++i) {
+    const auto& e = events_[i];
+    if (i > 0) json.push_back(',');
+    json.append("\n{\"name\":");
+    AppendEscaped(e.name, &json);
+    json.append(",\"cat\":");
+    AppendEscaped(e.category, &json);
+    json.append(",\"ph\":\"X\",\"ts\":");
+    AppendNumber(e.start_us, &json);
+    json.append(",\"dur\":");
+    AppendNumber(e.end_us - e.start_us, &json);
+    json.append(",\"pid\":0,\"tid\":");
+    json.append(std::to_string(e.thread));
+    json.append(",\"args\":{\"run\":");
+    json.append(std::to_string(e.run));
+    if (e.index >= 0) {
+      json.append(",\"index\":");
+      json.append(std::to_string(e.index));
+      AppendStringArg("kernel", e.kernel, &json);
+      AppendStringArg("remark", e.remark, &json);
+      AppendStringArg("input_shape", e.input_shape, &json);
+      AppendStringArg("output_shape", e.output_shape, &json);
+      AppendStringArg("filter_shape", e.filter_shape, &json);
+      json.append(",\"flops\":");
+      AppendNumber(e.flops, &json);
+      json.append(",\"bytes\":");
+      AppendNumber(e.bytes, &json);
+    }
+    json.append("}}");
+  }
+  json.append("\n],\"displayTimeUnit\":\"ms\"}\n");
+  return json;
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
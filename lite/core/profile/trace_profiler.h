@@ -0,0 +1,100 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+// One op or one whole run of a program on the timeline.
+struct TraceEvent {
+  std::string name;
+  std::string category;
+  std::string kernel;
+  std::string remark;
+  std::string input_shape;
+  std::string output_shape;
+  std::string filter_shape;
+  int run{0};
+  int index{-1};
+  // Microseconds since the profiler was created.
+  double start_us{0};
+  double end_us{0};
+  int thread{0};
+  // The thread an op ran on if it isn't the one adding the run.
+  std::thread::id thread_id;
+  // Estimated from OpLite::GetOpRuntimeInfo() and the tensor sizes.
+  double flops{0};
+  double bytes{0};
+};
+
+// The op-level profiler of a runtime program, which is compiled into every
+// build and switched on and off at runtime. When it is off, a run pays one
+// relaxed atomic load. When it is on, every run records its ops and the
+// records can be exported as Chrome trace-event JSON, to be opened by
+// chrome://tracing or Perfetto.
+class TraceProfiler {
+ public:
+  TraceProfiler() : epoch_(std::chrono::steady_clock::now()) {}
+
+  void set_enabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  double NowMicros() const {
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - epoch_)
+        .count();
+  }
+
+  // Adds a run of [start_us, end_us) and the events of its ops, whose run
+  // and thread are filled here.
+  void AddRun(double start_us, double end_us, std::vector<TraceEvent>* ops);
+
+  std::vector<TraceEvent> events() const;
+  size_t dropped_events() const;
+  void Clear();
+
+  // {"traceEvents": [...]}, one complete ("X") event per record.
+  std::string ToChromeTrace() const;
+
+  // The records beyond it are dropped, so a profiler left on can't eat up
+  // the memory.
+  static const size_t kMaxEvents = 1 << 20;
+
+ private:
+  int ThreadIndex(std::thread::id id);
+
+  std::atomic<bool> enabled_{false};
+  const std::chrono::steady_clock::time_point epoch_;
+  mutable std::mutex mutex_;
+  std::vector<TraceEvent> events_;
+  std::map<std::thread::id, int> threads_;
+  int runs_{0};
+  size_t dropped_{0};
+};
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,98 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/trace_profiler.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+TEST(trace_profiler, add_run) {
+  TraceProfiler profiler;
+  EXPECT_FALSE(profiler.enabled());
+  profiler.set_enabled(true);
+  EXPECT_TRUE(profiler.enabled());
+
+  std::vector<TraceEvent> ops(2);
+  ops[0].name = "conv2d";
+  ops[0].category = "op";
+  ops[0].kernel = "conv2d,kX86,kFloat,kNCHW,def";
+  ops[0].input_shape = "1x3x224x224";
+  ops[0].index = 1;
+  ops[0].start_us = 10;
+  ops[0].end_us = 30;
+  ops[0].flops = 1e6;
+  ops[0].bytes = 4096;
+  ops[1].name = "relu";
+  ops[1].category = "op";
+  ops[1].remark = "\"quoted\"";
+  ops[1].index = 2;
+  ops[1].start_us = 30;
+  ops[1].end_us = 35;
+  profiler.AddRun(5, 40, &ops);
+  EXPECT_TRUE(ops.empty());
+
+  // Another thread gets its own track.
+  std::thread other([&profiler]() {
+    std::vector<TraceEvent> no_ops;
+    profiler.AddRun(50, 60, &no_ops);
+  });
+  other.join();
+
+  auto events = profiler.events();
+  ASSERT_EQ(events.size(), 4u);
+  EXPECT_EQ(events[0].name, "run");
+  EXPECT_EQ(events[0].run, 0);
+  EXPECT_EQ(events[1].name, "conv2d");
+  EXPECT_EQ(events[1].run, 0);
+  EXPECT_EQ(events[1].thread, events[0].thread);
+  EXPECT_EQ(events[3].run, 1);
+  EXPECT_NE(events[3].thread, events[0].thread);
+
+  std::string json = profiler.ToChromeTrace();
+  EXPECT_EQ(json.find("{\"traceEvents\":["), 0u);
+  EXPECT_NE(json.find("\"name\":\"conv2d\",\"cat\":\"op\",\"ph\":\"X\","
+                      "\"ts\":10.000,\"dur\":20.000"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"input_shape\":\"1x3x224x224\""), std::string::npos);
+  EXPECT_NE(json.find("\"flops\":1000000.000,\"bytes\":4096.000"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"remark\":\"\\\"quoted\\\"\""), std::string::npos);
+  // The unset strings are left out.
+  EXPECT_EQ(json.find("\"filter_shape\""), std::string::npos);
+
+  profiler.Clear();
+  EXPECT_TRUE(profiler.events().empty());
+  EXPECT_EQ(profiler.ToChromeTrace(),
+            "{\"traceEvents\":[\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+TEST(trace_profiler, max_events) {
+  TraceProfiler profiler;
+  std::vector<TraceEvent> ops(TraceProfiler::kMaxEvents / 2);
+  profiler.AddRun(0, 1, &ops);
+  EXPECT_EQ(profiler.events().size(), TraceProfiler::kMaxEvents / 2 + 1);
+  ops.resize(TraceProfiler::kMaxEvents / 2);
+  profiler.AddRun(1, 2, &ops);
+  EXPECT_EQ(profiler.events().size(), TraceProfiler::kMaxEvents / 2 + 1);
+  EXPECT_EQ(profiler.dropped_events(), TraceProfiler::kMaxEvents / 2 + 1);
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
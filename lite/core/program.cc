@@ -16,7 +16,9 @@
 
 #include <algorithm>
 #include <map>
+#include <mutex>  // NOLINT
 #include <set>
+#include <thread>  // NOLINT
 
 #ifdef ENABLE_ARM_FP16
 #include "lite/backends/arm/math/fp16/funcs_fp16.h"
@@ -28,6 +30,8 @@
 #ifdef LITE_WITH_PRECISION_PROFILE
 #include "lite/core/profile/precision_profiler.h"
 #endif
+#include "lite/core/thread_pool.h"
+#include "lite/core/tuning_cache.h"
 
 namespace paddle {
 namespace lite {
@@ -586,6 +590,41 @@ void RuntimeProgram::SaveOutput() {
 }
 #endif
 
+// The event of an instruction which just ran, the shapes and FLOPs come from
+// OpLite::GetOpRuntimeInfo() and the bytes are the sizes of its inputs and
+// outputs.
+static profile::TraceEvent TraceInstruction(const Instruction& inst,
+                                            int idx,
+                                            double start_us,
+                                            double end_us) {
+  auto* op = const_cast<OpLite*>(inst.op());
+  profile::OpCharacter ch;
+  ch.op_type = op->Type();
+  op->GetOpRuntimeInfo(&ch);
+  profile::TraceEvent event;
+  event.name = op->Type();
+  event.category = "op";
+  event.kernel = inst.kernel()->name();
+  event.remark = ch.remark;
+  event.input_shape = ch.input_shape;
+  event.output_shape = ch.output_shape;
+  event.filter_shape = ch.filter_shape;
+  event.index = idx;
+  event.start_us = start_us;
+  event.end_us = end_us;
+  event.flops = ch.macs;
+  auto var_names = op->op_info()->input_names();
+  auto out_names = op->op_info()->output_names();
+  var_names.insert(var_names.end(), out_names.begin(), out_names.end());
+  for (auto& var_name : var_names) {
+    auto* var = op->scope() ? op->scope()->FindVar(var_name) : nullptr;
+    if (var && var->IsType<Tensor>()) {
+      event.bytes += var->Get<Tensor>().memory_size();
+    }
+  }
+  return event;
+}
+
 void RuntimeProgram::Run() {
 #ifdef LITE_WITH_PRECISION_PROFILE
   auto inst_precision_profiler = paddle::lite::profile::PrecisionProfiler();
@@ -593,39 +632,57 @@ void RuntimeProgram::Run() {
       inst_precision_profiler.GetSummaryHeader();
 #endif
 
-  int idx = -1;
+  const bool tracing = trace_profiler_.enabled();
+  const double run_start_us = tracing ? trace_profiler_.NowMicros() : 0;
+  std::vector<profile::TraceEvent> trace_events;
 
-  auto& insts = instructions_[kRootBlockIdx];
-  for (auto& inst : insts) {
-    ++idx;
+  if (inter_op_threads_ > 1 && !inter_op_initialized_) {
+    InitInterOp();
+  }
+  if (inter_op_executor_) {
+    RunInterOp(tracing, &trace_events);
+  } else {
+    int idx = -1;
+
+    auto& insts = instructions_[kRootBlockIdx];
+    for (auto& inst : insts) {
+      ++idx;
 #if !defined(LITE_WITH_METAL)
-    if (inst.is_feed_fetch_op()) continue;
+      if (inst.is_feed_fetch_op()) continue;
 #endif
 
 #ifdef LITE_WITH_OPENCL
-    // delegate flush judgement to specify target , it is too heavy for Inst
-    inst.Flush(idx);
+      // delegate flush judgement to specify target , it is too heavy for Inst
+      inst.Flush(idx);
 #if defined(LITE_WITH_PROFILE) || defined(LITE_WITH_PRECISION_PROFILE)
-    VLOG(4) << "kernel name " << idx << " " << inst.kernel()->name();
-    const auto* op_info = inst.op()->op_info();
-    auto var_in_names = op_info->input_names();
-    for (int i = 0; i < var_in_names.size(); i++) {
-      VLOG(4) << "input var_in_names: " << var_in_names[i];
-    }
-    auto var_out_names = op_info->output_names();
-    for (int i = 0; i < var_out_names.size(); i++) {
-      VLOG(4) << "output var_out_names: " << var_out_names[i];
-    }
+      VLOG(4) << "kernel name " << idx << " " << inst.kernel()->name();
+      const auto* op_info = inst.op()->op_info();
+      auto var_in_names = op_info->input_names();
+      for (int i = 0; i < var_in_names.size(); i++) {
+        VLOG(4) << "input var_in_names: " << var_in_names[i];
+      }
+      auto var_out_names = op_info->output_names();
+      for (int i = 0; i < var_out_names.size(); i++) {
+        VLOG(4) << "output var_out_names: " << var_out_names[i];
+      }
 #endif
 #endif
 
-    inst.Run();
+      if (tracing) {
+        const double start_us = trace_profiler_.NowMicros();
+        inst.Run();
+        const double end_us = trace_profiler_.NowMicros();
+        trace_events.push_back(TraceInstruction(inst, idx, start_us, end_us));
+      } else {
+        inst.Run();
+      }
 #ifdef LITE_WITH_PRECISION_PROFILE
-    if (inst.op()->Type() != "while") {
-      precision_profiler_summary +=
-          inst_precision_profiler.GetInstPrecision(&inst);
-    }
+      if (inst.op()->Type() != "while") {
+        precision_profiler_summary +=
+            inst_precision_profiler.GetInstPrecision(&inst);
+      }
 #endif  // LITE_WITH_PRECISION_PROFILE
+    }
   }
 
 #ifdef LITE_WITH_METAL
@@ -635,6 +692,27 @@ void RuntimeProgram::Run() {
   }
 #endif
 
+  if (tracing) {
+    trace_profiler_.AddRun(
+        run_start_us, trace_profiler_.NowMicros(), &trace_events);
+  }
+
+#ifdef LITE_WITH_X86
+  if (x86_workspace_) {
+    x86_workspace_->ReleaseRetired();
+  }
+  for (size_t i = 1; i < x86_lane_workspaces_.size(); i++) {
+    x86_lane_workspaces_[i]->ReleaseRetired();
+  }
+#endif
+
+  if (use_memory_arena_) {
+    if (!memory_arena_) {
+      InitMemoryArena();
+    }
+    memory_arena_->Update();
+  }
+
 #ifdef LITE_WITH_PROFILE
   LOG(INFO) << "\n" << profiler_.Summary(profile::Type::kDispatch, false, 1);
 #endif
@@ -645,6 +723,233 @@ void RuntimeProgram::Run() {
 #endif
 }
 
+void RuntimeProgram::InitMemoryArena() {
+  memory_arena_.reset(new MemoryArena());
+  // Sub-blocks access the variables of the root block by name
+  if (instructions_.size() > 1) {
+    LOG(WARNING) << "Memory arena is disabled for the programs with "
+                    "sub-blocks.";
+    return;
+  }
+  // The inputs and outputs of these ops are owned by the users, or keep their
+  // data across runs.
+  const std::set<std::string> invalid_op_types = {
+      "feed", "fetch", "subgraph", "while", "conditional_block", "share_data"};
+  std::map<std::string, std::pair<int, int>> lifecycles;
+  std::set<std::string> invalid_var_names;
+  int idx = 0;
+  for (auto& inst : instructions_[kRootBlockIdx]) {
+    const auto* op_info = inst.op()->op_info();
+    auto var_names = op_info->input_names();
+    auto out_names = op_info->output_names();
+    var_names.insert(var_names.end(), out_names.begin(), out_names.end());
+    if (invalid_op_types.count(op_info->Type()) || inst.op()->run_once()) {
+      invalid_var_names.insert(var_names.begin(), var_names.end());
+    }
+    for (auto& var_name : var_names) {
+      if (!lifecycles.count(var_name)) {
+        lifecycles[var_name] = std::make_pair(idx, idx);
+      } else {
+        lifecycles[var_name].second = idx;
+      }
+    }
+    ++idx;
+  }
+  // The tensors sharing their buffer with others, such as the inputs and
+  // outputs of the inplace reshape ops, must keep their own memory.
+  std::map<const void*, int> data_refs;
+  for (auto& var_name : exec_scope_->LocalVarNames()) {
+    auto* var = exec_scope_->FindLocalVar(var_name);
+    if (var && var->IsType<Tensor>() && var->Get<Tensor>().IsInitialized()) {
+      data_refs[var->Get<Tensor>().raw_data()]++;
+    }
+  }
+  for (auto& item : lifecycles) {
+    if (invalid_var_names.count(item.first)) continue;
+    // Weights live in the root scope, only the local variables are activations
+    auto* var = exec_scope_->FindLocalVar(item.first);
+    if (!var || !var->IsType<Tensor>()) continue;
+    auto* tensor = var->GetMutable<Tensor>();
+    auto target = tensor->target();
+    if (tensor->persistable() || !tensor->IsInitialized() ||
+        tensor->offset() != 0 || data_refs[tensor->raw_data()] > 1 ||
+        !(target == TARGET(kHost) || target == TARGET(kX86) ||
+          target == TARGET(kARM))) {
+      continue;
+    }
+    memory_arena_->AddTensor(
+        item.first, tensor, item.second.first, item.second.second);
+  }
+  VLOG(4) << memory_arena_->tensor_num()
+          << " tensors are placed in the memory arena.";
+}
+
+void RuntimeProgram::InitInterOp() {
+  inter_op_initialized_ = true;
+#if defined(LITE_WITH_PROFILE) || defined(LITE_WITH_PRECISION_PROFILE) || \
+    defined(LITE_WITH_OPENCL) || defined(LITE_WITH_METAL)
+  LOG(WARNING) << "Inter-op parallelism is disabled in the builds with the "
+                  "profilers, OpenCL or Metal.";
+#else
+  // The memory arena places the tensors by the lifetimes in program order.
+  if (use_memory_arena_) {
+    LOG(WARNING) << "Inter-op parallelism is disabled with the memory arena.";
+    return;
+  }
+  // These ops access the variables of the root block through their sub-blocks
+  // or devices, they run after all of the instructions before them, and
+  // before all of those after them.
+  const std::set<std::string> barrier_op_types = {"while",
+                                                  "conditional_block",
+                                                  "conditional_block_infer",
+                                                  "subgraph"};
+  // The outputs of these ops share the buffer of the input if inplace
+  const std::set<std::string> inplace_op_types = {"reshape",
+                                                  "reshape2",
+                                                  "flatten",
+                                                  "flatten2",
+                                                  "squeeze",
+                                                  "squeeze2",
+                                                  "unsqueeze",
+                                                  "unsqueeze2"};
+  // The variable whose buffer a variable shares
+  std::map<std::string, std::string> aliases;
+  auto buffer_of = [&](const std::string& name) {
+    auto it = aliases.find(name);
+    return it == aliases.end() ? name : it->second;
+  };
+  // The dependencies by the buffers accessed: read-after-write,
+  // write-after-read and write-after-write. The variables reused by
+  // MemoryOptimizePass are renamed to share a name, so the conflicts between
+  // them are covered as well.
+  std::map<std::string, int> last_writer;
+  std::map<std::string, std::vector<int>> readers;
+  std::vector<std::vector<int>> deps;
+  std::vector<int> since_barrier;
+  int last_barrier = -1;
+  auto& insts = instructions_[kRootBlockIdx];
+  for (size_t idx = 0; idx < insts.size(); idx++) {
+    auto& inst = insts[idx];
+    if (inst.is_feed_fetch_op()) continue;
+    const auto* op_info = inst.op()->op_info();
+    const int node = static_cast<int>(deps.size());
+    auto target = inst.kernel()->target();
+    // The kernels of the other targets use the device-wide workspaces or
+    // queues
+    bool barrier = barrier_op_types.count(op_info->Type()) ||
+                   !(target == TARGET(kHost) || target == TARGET(kX86) ||
+                     target == TARGET(kAny));
+    std::set<int> node_deps;
+    if (barrier) {
+      node_deps.insert(since_barrier.begin(), since_barrier.end());
+    }
+    if (last_barrier >= 0) node_deps.insert(last_barrier);
+    auto in_names = op_info->input_names();
+    auto out_names = op_info->output_names();
+    for (auto& name : in_names) {
+      auto it = last_writer.find(buffer_of(name));
+      if (it != last_writer.end()) node_deps.insert(it->second);
+    }
+    for (auto& name : out_names) {
+      auto buffer = buffer_of(name);
+      auto it = last_writer.find(buffer);
+      if (it != last_writer.end()) node_deps.insert(it->second);
+      auto& buffer_readers = readers[buffer];
+      node_deps.insert(buffer_readers.begin(), buffer_readers.end());
+    }
+    node_deps.erase(node);
+    for (auto& name : in_names) {
+      readers[buffer_of(name)].push_back(node);
+    }
+    for (auto& name : out_names) {
+      auto buffer = buffer_of(name);
+      last_writer[buffer] = node;
+      readers[buffer].clear();
+    }
+    if (inplace_op_types.count(op_info->Type()) &&
+        op_info->HasAttr("inplace") && op_info->GetAttr<bool>("inplace") &&
+        op_info->HasInput("X") && op_info->HasOutput("Out") &&
+        !op_info->Input("X").empty()) {
+      auto buffer = buffer_of(op_info->Input("X").front());
+      for (auto& name : op_info->Output("Out")) {
+        aliases[name] = buffer;
+      }
+    }
+    if (barrier) {
+      last_barrier = node;
+      since_barrier.clear();
+    } else {
+      since_barrier.push_back(node);
+    }
+    deps.emplace_back(node_deps.begin(), node_deps.end());
+    inter_op_insts_.push_back(static_cast<int>(idx));
+  }
+  // Nothing to overlap if every instruction depends on the previous one
+  bool chain = true;
+  for (size_t node = 1; node < deps.size() && chain; node++) {
+    chain = std::find(deps[node].begin(),
+                      deps[node].end(),
+                      static_cast<int>(node) - 1) != deps[node].end();
+  }
+  if (chain) {
+    VLOG(4) << "No independent instructions for the inter-op parallelism.";
+    inter_op_insts_.clear();
+    return;
+  }
+  inter_op_executor_.reset(new DataflowExecutor(deps, inter_op_threads_));
+#ifdef LITE_WITH_X86
+  x86_lane_workspaces_.push_back(x86_workspace_);
+  for (int lane = 1; lane < inter_op_threads_; lane++) {
+    x86_lane_workspaces_.push_back(std::make_shared<ScratchArena>());
+  }
+#endif
+  VLOG(4) << "Run " << deps.size() << " instructions on " << inter_op_threads_
+          << " inter-op threads.";
+#endif
+}
+
+void RuntimeProgram::RunInterOp(bool tracing,
+                                std::vector<profile::TraceEvent>* events) {
+  auto& insts = instructions_[kRootBlockIdx];
+#ifdef LITE_USE_THREAD_POOL
+  // The workers dispatch the parallel loops of their kernels onto the pool
+  // of the caller, so the lanes share the intra-op threads
+  ThreadPool* pool = ThreadPool::Current();
+#endif
+  // The kernels prepared on the workers are tuned with the cache of the caller
+  TuningCache* tuning_cache = TuningCache::Current();
+  std::mutex events_mutex;
+  inter_op_executor_->Run([&](int node, int lane) {
+#ifdef LITE_USE_THREAD_POOL
+    std::unique_ptr<ThreadPool::ScopedBind> bind_thread_pool;
+    if (lane != 0) bind_thread_pool.reset(new ThreadPool::ScopedBind(pool));
+#endif
+    std::unique_ptr<TuningCache::ScopedBind> bind_tuning_cache;
+    if (lane != 0) {
+      bind_tuning_cache.reset(new TuningCache::ScopedBind(tuning_cache));
+    }
+    const int idx = inter_op_insts_[node];
+    auto& inst = insts[idx];
+#ifdef LITE_WITH_X86
+    if (inst.kernel()->target() == TARGET(kX86) && x86_workspace_) {
+      inst.mutable_kernel()->mutable_context()->As<X86Context>().SetWorkspace(
+          x86_lane_workspaces_[lane]);
+    }
+#endif
+    if (tracing) {
+      const double start_us = trace_profiler_.NowMicros();
+      inst.Run();
+      const double end_us = trace_profiler_.NowMicros();
+      auto event = TraceInstruction(inst, idx, start_us, end_us);
+      event.thread_id = std::this_thread::get_id();
+      std::lock_guard<std::mutex> lock(events_mutex);
+      events->push_back(std::move(event));
+    } else {
+      inst.Run();
+    }
+  });
+}
+
 void Program::Build(const std::shared_ptr<cpp::ProgramDesc>& program_desc) {
   CHECK(ops_.empty()) << "Executor duplicate Build found";
 
@@ -19,9 +19,12 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/core/dataflow_executor.h"
 #include "lite/core/kernel.h"
+#include "lite/core/memory_arena.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/profile/trace_profiler.h"
 #include "lite/model_parser/cpp_desc.h"
 #ifdef LITE_WITH_PROFILE
 #include "lite/core/profile/profiler.h"
@@ -259,6 +262,15 @@ class LITE_API RuntimeProgram {
         if (kernel != nullptr) {
           kernel->SetContext(
               ContextScheduler::Global().NewContext(kernel->target()));
+#ifdef LITE_WITH_X86
+          if (kernel->target() == TARGET(kX86)) {
+            if (!x86_workspace_) {
+              x86_workspace_ = std::make_shared<ScratchArena>();
+            }
+            kernel->mutable_context()->As<X86Context>().SetWorkspace(
+                x86_workspace_);
+          }
+#endif
         }
       }
     }
@@ -286,8 +298,22 @@ class LITE_API RuntimeProgram {
 
   void set_version(const int64_t version) { version_ = version; }
 
+  // Place the activations of the root block at offsets of one contiguous
+  // arena, which is planned after the first run.
+  void set_use_memory_arena(bool use_memory_arena) {
+    use_memory_arena_ = use_memory_arena;
+  }
+
+  // Run the independent instructions of the root block concurrently on
+  // `threads` threads including the calling one, which share the intra-op
+  // thread pool. 1 runs the instructions in order.
+  void set_inter_op_threads(int threads) { inter_op_threads_ = threads; }
+
   const int64_t get_version() const { return version_; }
 
+  // The op-level profiler which can be switched on between runs.
+  profile::TraceProfiler* trace_profiler() { return &trace_profiler_; }
+
 #ifndef LITE_ON_TINY_PUBLISH
   // Update the ops and vars of all of blocks to the given program_desc
   // according to the instructions
@@ -305,14 +331,36 @@ class LITE_API RuntimeProgram {
 
  private:
   RuntimeProgram(const RuntimeProgram&) = delete;
+  // Collect the activations which can be placed in the memory arena
+  void InitMemoryArena();
+  // Build the dependencies of the instructions of the root block for the
+  // inter-op parallel execution
+  void InitInterOp();
+  void RunInterOp(bool tracing, std::vector<profile::TraceEvent>* events);
+
   std::vector<std::vector<Instruction>> instructions_;
   Scope* exec_scope_{};
   int64_t version_{0};
+  bool use_memory_arena_{false};
+  std::unique_ptr<MemoryArena> memory_arena_;
+  int inter_op_threads_{1};
+  bool inter_op_initialized_{false};
+  // The instruction of every node of the executor
+  std::vector<int> inter_op_insts_;
+  std::unique_ptr<DataflowExecutor> inter_op_executor_;
+  profile::TraceProfiler trace_profiler_;
 
 #ifdef LITE_WITH_METAL
   std::unique_ptr<KernelContext> metal_ctx_{nullptr};
 #endif
 
+#ifdef LITE_WITH_X86
+  // The workspace shared by the x86 kernels of this program.
+  std::shared_ptr<ScratchArena> x86_workspace_;
+  // The workspaces of the inter-op lanes, the first one is x86_workspace_.
+  std::vector<std::shared_ptr<ScratchArena>> x86_lane_workspaces_;
+#endif
+
 #ifdef LITE_WITH_PROFILE
   profile::Profiler profiler_;
   void set_profiler() {
@@ -14,11 +14,124 @@
 
 #include "lite/core/thread_pool.h"
 #include <string.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#include <algorithm>
 #include "lite/utils/log/logging.h"
+#include "lite/utils/macros.h"
 
 namespace paddle {
 namespace lite {
 
+namespace {
+// Number of relax iterations an idle thread busy-waits before parking.
+const int kSpinCount = 1 << 14;
+// An owner pops 1/kGuidedDivisor of its remaining range per chunk.
+const int kGuidedDivisor = 4;
+
+// Non-zero while the current thread executes a job, nested parallel loops are
+// run serially to avoid oversubscription and deadlocks.
+LITE_THREAD_LOCAL int gJobDepth = 0;
+// The pool bound by ThreadPool::ScopedBind on the current thread.
+LITE_THREAD_LOCAL ThreadPool* gCurrentPool = nullptr;
+
+inline void CpuRelax() {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+  __asm__ __volatile__("pause");
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+  __asm__ __volatile__("yield");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+// A range [begin, end) is packed into one 64-bit word, so that the owner
+// (advancing begin) and thieves (retreating end) race on a single CAS.
+inline uint64_t PackRange(uint32_t begin, uint32_t end) {
+  return (static_cast<uint64_t>(begin) << 32) | end;
+}
+inline uint32_t RangeBegin(uint64_t range) {
+  return static_cast<uint32_t>(range >> 32);
+}
+inline uint32_t RangeEnd(uint64_t range) {
+  return static_cast<uint32_t>(range & 0xffffffffu);
+}
+}  // namespace
+
+struct ThreadPool::Job {
+  Job(const TASK* fn, int start, int step, int total, int slot_num)
+      : fn(fn),
+        start(start),
+        step(step),
+        total(total),
+        slot_num(slot_num),
+        ranges(new std::atomic<uint64_t>[slot_num]) {
+    for (int i = 0; i < slot_num; ++i) {
+      uint32_t begin = static_cast<int64_t>(total) * i / slot_num;
+      uint32_t end = static_cast<int64_t>(total) * (i + 1) / slot_num;
+      ranges[i].store(PackRange(begin, end));
+    }
+  }
+
+  // Pop a guided chunk from the front of the range owned by `slot`.
+  bool Pop(int slot, int* begin, int* end) {
+    auto& range = ranges[slot];
+    uint64_t cur = range.load(std::memory_order_acquire);
+    while (true) {
+      uint32_t b = RangeBegin(cur);
+      uint32_t e = RangeEnd(cur);
+      if (b >= e) return false;
+      uint32_t chunk = (e - b + kGuidedDivisor - 1) / kGuidedDivisor;
+      if (range.compare_exchange_weak(cur, PackRange(b + chunk, e))) {
+        *begin = b;
+        *end = b + chunk;
+        return true;
+      }
+    }
+  }
+
+  // Take the back half of the range owned by `victim`.
+  bool Steal(int victim, int* begin, int* end) {
+    auto& range = ranges[victim];
+    uint64_t cur = range.load(std::memory_order_acquire);
+    while (true) {
+      uint32_t b = RangeBegin(cur);
+      uint32_t e = RangeEnd(cur);
+      if (b >= e) return false;
+      uint32_t take = (e - b + 1) / 2;
+      if (range.compare_exchange_weak(cur, PackRange(b, e - take))) {
+        *begin = e - take;
+        *end = e;
+        return true;
+      }
+    }
+  }
+
+  void Execute(int begin, int end, int slot) {
+    for (int i = begin; i < end; ++i) {
+      (*fn)(start + i * step, slot);
+    }
+    if (done.fetch_add(end - begin) + (end - begin) == total) {
+      std::lock_guard<std::mutex> lock(mutex);
+      cv.notify_all();
+    }
+  }
+
+  bool Finished() const { return done.load() == total; }
+
+  const TASK* fn;
+  const int start;
+  const int step;
+  const int total;
+  const int slot_num;
+  std::unique_ptr<std::atomic<uint64_t>[]> ranges;
+  std::atomic<int> next_slot{1};
+  std::atomic<int> done{0};
+  std::mutex mutex;
+  std::condition_variable cv;
+};
+
 ThreadPool* ThreadPool::gInstance = nullptr;
 static std::mutex gInitMutex;  // confirm thread-safe when use singleton mode
 int ThreadPool::Init(int number) {
@@ -40,138 +153,208 @@ void ThreadPool::Destroy() {
   }
 }
 
-ThreadPool::ThreadPool(int number) {
-  thread_num_ = number;
-  for (int i = 0; i < thread_num_; ++i) {
-    tasks_.second.emplace_back(new std::atomic<bool>{false});
-  }
-  for (int thread_index = 1; thread_index < thread_num_; ++thread_index) {
-    workers_.emplace_back([this, thread_index]() {
-      while (!stop_) {
-        // if (*tasks_.second[thread_index]) {
-        while (!(*tasks_.second[thread_index])) {
-          std::this_thread::yield();
+ThreadPool::ThreadPool(int number, const std::vector<int>& cpu_ids)
+    : cpu_ids_(cpu_ids) {
+  thread_num_ = std::max(number, 1);
+  // The calling thread always participates, so spawn thread_num - 1 workers
+  for (int worker_index = 1; worker_index < thread_num_; ++worker_index) {
+    workers_.emplace_back([this, worker_index]() {
+      if (!cpu_ids_.empty()) {
+        int cpu_id = cpu_ids_[worker_index % cpu_ids_.size()];
+        if (!SetAffinity({cpu_id})) {
+          LOG(WARNING) << "Failed to bind thread pool worker " << worker_index
+                       << " to cpu " << cpu_id;
         }
-        tasks_.first(thread_index, thread_index);
-        *tasks_.second[thread_index] = false;
       }
+      WorkerLoop(worker_index);
     });
   }
 }
 
 ThreadPool::~ThreadPool() {
-  stop_ = true;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
   for (auto& worker : workers_) {
     worker.join();
   }
-  for (auto c : tasks_.second) {
-    delete c;
+}
+
+bool ThreadPool::SetAffinity(const std::vector<int>& cpu_ids) {
+#if defined(__linux__)
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (auto cpu_id : cpu_ids) {
+    if (cpu_id >= 0 && cpu_id < CPU_SETSIZE) CPU_SET(cpu_id, &mask);
   }
+  return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#else
+  return false;
+#endif
 }
 
-void ThreadPool::AcquireThreadPool() {
-  if (nullptr == gInstance) {
-    return;
+std::vector<int> ThreadPool::GetAffinity() {
+  std::vector<int> cpu_ids;
+#if defined(__linux__)
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+    for (int i = 0; i < CPU_SETSIZE; ++i) {
+      if (CPU_ISSET(i, &mask)) cpu_ids.push_back(i);
+    }
   }
-  LOG(INFO) << "ThreadPool::AcquireThreadPool()\n";
-  std::unique_lock<std::mutex> _l(gInstance->mutex_);
-  while (!gInstance->ready_) gInstance->cv_.wait(_l);
-  gInstance->ready_ = false;
-  return;
+#endif
+  return cpu_ids;
 }
 
-void ThreadPool::ReleaseThreadPool() {
-  if (nullptr == gInstance) {
+ThreadPool::ScopedBind::ScopedBind(ThreadPool* pool) {
+  prev_pool_ = gCurrentPool;
+  gCurrentPool = pool;
+  if (pool != nullptr && !pool->cpu_ids_.empty()) {
+    prev_cpu_ids_ = GetAffinity();
+    restore_affinity_ = !prev_cpu_ids_.empty() && SetAffinity(pool->cpu_ids_);
+  }
+}
+
+ThreadPool::ScopedBind::~ScopedBind() {
+  if (restore_affinity_) {
+    SetAffinity(prev_cpu_ids_);
+  }
+  gCurrentPool = prev_pool_;
+}
+
+ThreadPool* ThreadPool::Current() {
+  return gCurrentPool != nullptr ? gCurrentPool : gInstance;
+}
+
+void ThreadPool::AcquireThreadPool() {}
+
+void ThreadPool::ReleaseThreadPool() {}
+
+void ThreadPool::WorkerLoop(int worker_index) {
+  VLOG(4) << "ThreadPool worker " << worker_index << " started";
+  while (!stop_) {
+    uint64_t seen = epoch_.load(std::memory_order_acquire);
+    int slot = 0;
+    auto job = ClaimJob(&slot);
+    if (job) {
+      RunJob(job.get(), slot);
+      continue;
+    }
+    // Nothing to do: spin for a while, then park until a new job arrives
+    bool woken = false;
+    for (int i = 0; i < kSpinCount && !stop_; ++i) {
+      if (epoch_.load(std::memory_order_acquire) != seen) {
+        woken = true;
+        break;
+      }
+      CpuRelax();
+    }
+    if (!woken) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++sleepers_;
+      cv_.wait(lock, [&]() { return stop_ || epoch_.load() != seen; });
+      --sleepers_;
+    }
+  }
+}
+
+std::shared_ptr<ThreadPool::Job> ThreadPool::ClaimJob(int* slot) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& job : jobs_) {
+    if (job->Finished()) continue;
+    int s = job->next_slot.fetch_add(1);
+    if (s < job->slot_num) {
+      *slot = s;
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+bool ThreadPool::StealRange(Job* job, int slot, int* begin, int* end) {
+  for (int i = 1; i < job->slot_num; ++i) {
+    int victim = (slot + i) % job->slot_num;
+    if (job->Steal(victim, begin, end)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::RunJob(Job* job, int slot) {
+  ++gJobDepth;
+  int begin = 0;
+  int end = 0;
+  while (true) {
+    while (job->Pop(slot, &begin, &end)) {
+      job->Execute(begin, end, slot);
+    }
+    if (!StealRange(job, slot, &begin, &end)) break;
+    // Publish the stolen range as our own so that it can be stolen again
+    job->ranges[slot].store(PackRange(begin, end), std::memory_order_release);
+  }
+  --gJobDepth;
+}
+
+void ThreadPool::ParallelFor(const TASK& task, int end, int start, int step) {
+  if (step <= 0 || end <= start) return;
+  int total = (end - start + step - 1) / step;
+  if (total <= 1 || thread_num_ <= 1 || gJobDepth > 0) {
+    for (int v = start; v < end; v += step) {
+      task(v, 0);
+    }
     return;
   }
-  LOG(INFO) << "ThreadPool::ReleaseThreadPool()\n";
-  std::unique_lock<std::mutex> _l(gInstance->mutex_);
-  gInstance->ready_ = true;
-  gInstance->cv_.notify_all();
+  int slot_num = std::min(thread_num_, total);
+  std::shared_ptr<Job> job(new Job(&task, start, step, total, slot_num));
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(job);
+    epoch_.fetch_add(1, std::memory_order_release);
+    for (int i = 1; i < slot_num && i <= sleepers_; ++i) {
+      cv_.notify_one();
+    }
+  }
+  // The calling thread owns slot 0, then helps the others until all chunks
+  // have been handed out
+  RunJob(job.get(), 0);
+  for (int i = 0; i < kSpinCount && !job->Finished(); ++i) {
+    CpuRelax();
+  }
+  if (!job->Finished()) {
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->cv.wait(lock, [&]() { return job->Finished(); });
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  jobs_.erase(std::find(jobs_.begin(), jobs_.end(), job));
 }
 
 void ThreadPool::Enqueue(TASK_BASIC&& task) {
-  if (task.second <= 1 || (nullptr == gInstance)) {
+  ThreadPool* pool = Current();
+  if (task.second <= 1 || (nullptr == pool)) {
     for (int i = 0; i < task.second; ++i) {
       task.first(i, 0);
     }
     return;
   }
-  int work_size = task.second;
-  if (work_size > gInstance->thread_num_) {
-    gInstance->tasks_.first = [work_size, &task](int index, int tId) {
-      for (int v = tId; v < work_size; v += gInstance->thread_num_) {
-        task.first(v, tId);  // nested lambda func
-      }
-    };
-    work_size = gInstance->thread_num_;
-  } else {
-    gInstance->tasks_.first = std::move(task.first);
-  }
-  for (int i = 1; i < work_size; ++i) {
-    *(gInstance->tasks_.second[i]) = true;
-  }
-  // invoke tid 0 callback in main thread
-  // other tid task is invoked in child thread
-  gInstance->tasks_.first(0, 0);
-  bool complete = true;
-  // check tid 1 to thread_num - 1 all work completed in child thread
-  do {
-    std::this_thread::yield();
-    complete = true;
-    for (int i = 1; i < work_size; ++i) {
-      if (*gInstance->tasks_.second[i]) {
-        complete = false;
-        break;
-      }
-    }
-  } while (!complete);
+  pool->ParallelFor(task.first, task.second);
 }
 
 void ThreadPool::Enqueue(TASK_COMMON&& task) {
   int end = std::get<1>(task);
   int start = std::get<2>(task);
   int step = std::get<3>(task);
-  int work_size = (end - start + step - 1) / step;
-  if (work_size <= 1 || (nullptr == gInstance)) {
+  ThreadPool* pool = Current();
+  if (nullptr == pool) {
     for (int v = start; v < end; v += step) {
       std::get<0>(task)(v, 0);
     }
     return;
   }
-  if (work_size > gInstance->thread_num_) {
-    gInstance->tasks_.first = ([=, &task](int index, int tId) {
-      auto start_index = start + tId * step;
-      auto stride = gInstance->thread_num_ * step;
-      for (int v = start_index; v < end; v += stride) {
-        std::get<0>(task)(v, tId);  // nested lambda func
-      }
-    });
-    work_size = gInstance->thread_num_;
-  } else {
-    gInstance->tasks_.first = ([=, &task](int index, int tId) {
-      auto v = start + tId * step;
-      std::get<0>(task)(v, tId);  // nested lambda func
-    });
-  }
-  for (int i = 1; i < work_size; ++i) {
-    *(gInstance->tasks_.second[i]) = true;
-  }
-  // invoke tid 0 callback in main thread
-  // other tid task is invoked in new thread
-  gInstance->tasks_.first(0, 0);
-  bool complete = true;
-  // check tid 1 to thread_num - 1 all work completed in new thread
-  do {
-    std::this_thread::yield();
-    complete = true;
-    for (int i = 1; i < work_size; ++i) {
-      if (*gInstance->tasks_.second[i]) {
-        complete = false;
-        break;
-      }
-    }
-  } while (!complete);
+  pool->ParallelFor(std::get<0>(task), end, start, step);
 }
 
 }  // namespace lite
@@ -15,7 +15,9 @@
 #pragma once
 #include <atomic>
 #include <condition_variable>  //NOLINT
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>   //NOLINT
 #include <thread>  //NOLINT
 #include <tuple>
@@ -25,32 +27,91 @@
 namespace paddle {
 namespace lite {
 
+/*
+ * ThreadPool executes parallel for loops on a fixed set of worker threads.
+ *
+ * Every call of `ParallelFor` (or the static `Enqueue`) creates a job whose
+ * iteration space is split into one contiguous range per participant
+ * ("slot"). The calling thread always owns slot 0, idle workers claim the
+ * remaining slots. A participant pops guided chunks from the front of its own
+ * range and, once it runs dry, steals half of the remaining iterations from
+ * the back of another slot. The `tid` passed to the task is the slot index,
+ * which is unique among the threads executing one job and always smaller than
+ * `thread_num()`, so kernels may keep using it to index per-thread buffers.
+ *
+ * Idle workers spin for a bounded time and then park on a condition variable
+ * (futex-backed on Linux), so an idle pool does not burn cores. Any number of
+ * threads may submit jobs concurrently; a job submitted from inside a running
+ * task is executed serially on the submitting thread.
+ *
+ * Besides the process-wide instance created by `Init`, a predictor may own a
+ * private pool, optionally pinned to a set of cpus, and bind it to the calling
+ * thread with `ScopedBind` while it runs, so that the LITE_PARALLEL_* macros
+ * used by its kernels dispatch onto that pool.
+ */
 class ThreadPool {
  public:
   typedef std::function<void(int, int)> TASK;
   typedef std::pair<std::function<void(int, int)>, int> TASK_BASIC;
   typedef std::tuple<std::function<void(int, int)>, int, int, int> TASK_COMMON;
 
+  // Workers are pinned round-robin to `cpu_ids` if it is not empty.
+  explicit ThreadPool(int number,
+                      const std::vector<int>& cpu_ids = std::vector<int>());
+  ~ThreadPool();
+
+  // Make `pool` the current pool of the calling thread for the lifetime of
+  // this object, and restrict the calling thread to the cpus of the pool.
+  class ScopedBind {
+   public:
+    explicit ScopedBind(ThreadPool* pool);
+    ~ScopedBind();
+
+   private:
+    ThreadPool* prev_pool_{nullptr};
+    bool restore_affinity_{false};
+    std::vector<int> prev_cpu_ids_;
+  };
+
+  // Run `task(v, tid)` for v in [start, end) with stride `step`.
+  void ParallelFor(const TASK& task, int end, int start = 0, int step = 1);
+  int thread_num() const { return thread_num_; }
+  const std::vector<int>& cpu_ids() const { return cpu_ids_; }
+
+  // The pool bound to the calling thread, or the process-wide one.
+  static ThreadPool* Current();
+  // Used by the LITE_PARALLEL_* macros, dispatch onto `Current()`.
   static void Enqueue(TASK_BASIC&& task);
   static void Enqueue(TASK_COMMON&& task);
+  // Kept for API compatibility. Jobs from different callers no longer need to
+  // be serialized, so these are no-ops.
   static void AcquireThreadPool();
   static void ReleaseThreadPool();
   static int Init(int number);
   static void Destroy();
 
  private:
+  struct Job;
+
+  void WorkerLoop(int worker_index);
+  std::shared_ptr<Job> ClaimJob(int* slot);
+  static void RunJob(Job* job, int slot);
+  static bool StealRange(Job* job, int slot, int* begin, int* end);
+
   static ThreadPool* gInstance;
-  explicit ThreadPool(int number = 0);
-  ~ThreadPool();
+  static bool SetAffinity(const std::vector<int>& cpu_ids);
+  static std::vector<int> GetAffinity();
 
   std::vector<std::thread> workers_;
-  std::atomic<bool> stop_{false};
-  bool ready_{true};
-  std::pair<TASK, std::vector<std::atomic<bool>*>> tasks_;
+  std::vector<std::shared_ptr<Job>> jobs_;
   std::condition_variable cv_;
   std::mutex mutex_;
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<bool> stop_{false};
+  int sleepers_{0};
 
   int thread_num_ = 0;
+  std::vector<int> cpu_ids_;
 };
 }  // namespace lite
 }  // namespace paddle
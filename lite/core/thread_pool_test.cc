@@ -0,0 +1,117 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(thread_pool, parallel_for) {
+  ThreadPool pool(4);
+  const int n = 1000;
+  std::vector<int> hits(n, 0);
+  pool.ParallelFor(
+      [&](int i, int tid) {
+        ASSERT_GE(tid, 0);
+        ASSERT_LT(tid, pool.thread_num());
+        hits[i]++;
+      },
+      n);
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(hits[i], 1);
+  }
+}
+
+TEST(thread_pool, strided_and_imbalanced) {
+  ThreadPool pool(3);
+  std::vector<int> hits(103, 0);
+  pool.ParallelFor(
+      [&](int i, int tid) {
+        // make the head of the range much heavier than the tail
+        if (i < 10) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        hits[i]++;
+      },
+      103,
+      1,
+      3);
+  for (int i = 0; i < 103; ++i) {
+    EXPECT_EQ(hits[i], (i - 1) % 3 == 0 ? 1 : 0);
+  }
+}
+
+TEST(thread_pool, concurrent_callers) {
+  ThreadPool pool(4);
+  const int callers = 4;
+  const int n = 257;
+  std::vector<std::atomic<int>> sums(callers);
+  std::vector<std::thread> threads;
+  for (int c = 0; c < callers; ++c) {
+    threads.emplace_back([&, c]() {
+      for (int rep = 0; rep < 50; ++rep) {
+        pool.ParallelFor([&](int i, int tid) { sums[c] += i; }, n);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  for (int c = 0; c < callers; ++c) {
+    EXPECT_EQ(sums[c].load(), 50 * n * (n - 1) / 2);
+  }
+}
+
+TEST(thread_pool, nested) {
+  ThreadPool pool(4);
+  std::atomic<int> count{0};
+  pool.ParallelFor(
+      [&](int i, int tid) {
+        pool.ParallelFor([&](int j, int inner_tid) { count++; }, 8);
+      },
+      8);
+  EXPECT_EQ(count.load(), 64);
+}
+
+TEST(thread_pool, global_enqueue) {
+  ThreadPool::Init(4);
+  std::atomic<int> count{0};
+  ThreadPool::Enqueue(std::make_pair(
+      std::function<void(int, int)>([&](int i, int tid) { count += i; }), 10));
+  EXPECT_EQ(count.load(), 45);
+  ThreadPool::Destroy();
+}
+
+TEST(thread_pool, scoped_bind) {
+  ThreadPool pool(2, {0});
+  EXPECT_EQ(ThreadPool::Current(), nullptr);
+  {
+    ThreadPool::ScopedBind bind(&pool);
+    EXPECT_EQ(ThreadPool::Current(), &pool);
+    std::atomic<int> count{0};
+    ThreadPool::Enqueue(std::make_tuple(
+        std::function<void(int, int)>([&](int i, int tid) {
+          EXPECT_LT(tid, 2);
+          count++;
+        }),
+        16,
+        0,
+        2));
+    EXPECT_EQ(count.load(), 8);
+  }
+  EXPECT_EQ(ThreadPool::Current(), nullptr);
+}
+
+}  // namespace lite
+}  // namespace paddle
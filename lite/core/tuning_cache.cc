@@ -0,0 +1,156 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/tuning_cache.h"
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <thread>  // NOLINT
+#include "lite/utils/io.h"
+#include "lite/utils/log/cp_logging.h"
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+
+static const char kTuningCacheMagic[] = "# paddle-lite cpu tuning cache v1";
+
+// The cache bound by TuningCache::ScopedBind on the current thread.
+static LITE_THREAD_LOCAL TuningCache* gCurrentCache = nullptr;
+
+TuningCache::TuningCache(const std::string& file) : file_(file) {
+  if (file.empty() || !IsFileExists(file)) return;
+  if (Load(file)) {
+    LOG(INFO) << "Load " << choices_.size() << " tuned records from: " << file;
+  } else {
+    LOG(INFO) << "Ignore the tuning cache produced on another CPU model: "
+              << file;
+  }
+}
+
+TuningCache::~TuningCache() { Save(); }
+
+TuningCache::ScopedBind::ScopedBind(TuningCache* cache) {
+  prev_cache_ = gCurrentCache;
+  gCurrentCache = cache;
+}
+
+TuningCache::ScopedBind::~ScopedBind() { gCurrentCache = prev_cache_; }
+
+TuningCache* TuningCache::Current() { return gCurrentCache; }
+
+bool TuningCache::Lookup(const std::string& key, int* choice) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = choices_.find(key);
+  if (it == choices_.end()) return false;
+  *choice = it->second;
+  return true;
+}
+
+void TuningCache::Insert(const std::string& key, int choice) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = choices_.find(key);
+  if (it != choices_.end() && it->second == choice) return;
+  choices_[key] = choice;
+  dirty_ = true;
+}
+
+size_t TuningCache::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return choices_.size();
+}
+
+void TuningCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  choices_.clear();
+  dirty_ = false;
+}
+
+bool TuningCache::Load(const std::string& file) {
+  auto lines = ReadLines(file);
+  if (lines.size() < 2 || lines[0] != kTuningCacheMagic ||
+      lines[1] != "cpu " + CpuModel()) {
+    return false;
+  }
+  for (size_t i = 2; i < lines.size(); i++) {
+    auto pos = lines[i].rfind(' ');
+    if (pos == std::string::npos) continue;
+    choices_[lines[i].substr(0, pos)] = atoi(lines[i].c_str() + pos + 1);
+  }
+  return true;
+}
+
+void TuningCache::Save() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!dirty_ || file_.empty()) return;
+  std::vector<std::string> lines{kTuningCacheMagic, "cpu " + CpuModel()};
+  for (auto& choice : choices_) {
+    lines.push_back(choice.first + " " + std::to_string(choice.second));
+  }
+  WriteLines(lines, file_);
+  dirty_ = false;
+  LOG(INFO) << "Tuned records have been saved to: " << file_;
+}
+
+std::string TuningCache::CpuModel() {
+  std::string model;
+#if defined(__linux__) || defined(__ANDROID__)
+  FILE* fp = fopen("/proc/cpuinfo", "rb");
+  if (fp) {
+    char line[1024];
+    while (fgets(line, sizeof(line), fp)) {
+      if (strncmp(line, "model name", 10) && strncmp(line, "Hardware", 8) &&
+          strncmp(line, "CPU part", 8)) {
+        continue;
+      }
+      const char* value = strchr(line, ':');
+      if (!value) continue;
+      std::string item(value + 1);
+      item.erase(0, item.find_first_not_of(" \t"));
+      item.erase(item.find_last_not_of(" \t\r\n") + 1);
+      if (model.find(item) == std::string::npos) {
+        model += (model.empty() ? "" : "/") + item;
+      }
+    }
+    fclose(fp);
+  }
+#endif
+  if (model.empty()) model = "unknown";
+  return model + " x" + std::to_string(std::thread::hardware_concurrency());
+}
+
+int PickFastest(const std::vector<std::function<void()>>& candidates,
+                int repeats) {
+  using Clock = std::chrono::steady_clock;
+  int best = 0;
+  auto best_time = Clock::duration::max();
+  for (size_t i = 0; i < candidates.size(); i++) {
+    candidates[i]();
+    auto min_time = Clock::duration::max();
+    for (int r = 0; r < repeats; r++) {
+      auto start = Clock::now();
+      candidates[i]();
+      min_time = std::min(min_time, Clock::now() - start);
+    }
+    if (min_time < best_time) {
+      best_time = min_time;
+      best = static_cast<int>(i);
+    }
+  }
+  return best;
+}
+
+}  // namespace lite
+}  // namespace paddle
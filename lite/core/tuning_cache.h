@@ -0,0 +1,86 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <functional>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * TuningCache keeps the results of the measurement-based algorithm selection
+ * of the CPU kernels. A kernel with several viable implementations for its
+ * shapes (e.g. the x86 conv2d) times each of them once in `PrepareForRun`
+ * while a cache is bound to the calling thread, and records the fastest one
+ * under a key describing the op signature (shapes, attributes and threads).
+ *
+ * A predictor with tuning on owns a cache and binds it with `ScopedBind`
+ * while it runs, so that the tuning of a predictor doesn't affect the others.
+ * The records can be persisted to a text file, which is loaded when the
+ * cache is created and written back when it's destroyed, similar to the
+ * OpenCL tuned file. The file is tagged with the CPU model it was produced on
+ * and ignored on a different one.
+ */
+class TuningCache {
+ public:
+  // If `file` isn't empty and was produced on the same CPU model, the records
+  // in it are loaded.
+  explicit TuningCache(const std::string& file = "");
+  ~TuningCache();
+
+  // Make `cache` the current cache of the calling thread for the lifetime of
+  // this object.
+  class ScopedBind {
+   public:
+    explicit ScopedBind(TuningCache* cache);
+    ~ScopedBind();
+
+   private:
+    TuningCache* prev_cache_{nullptr};
+  };
+
+  // The cache bound to the calling thread, or nullptr if tuning is off.
+  static TuningCache* Current();
+
+  bool Lookup(const std::string& key, int* choice);
+  void Insert(const std::string& key, int choice);
+  size_t size();
+  void Clear();
+
+  // Write the records to the file if there are new ones.
+  void Save();
+
+  // Describe the CPU model of the current machine.
+  static std::string CpuModel();
+
+ private:
+  bool Load(const std::string& file);
+
+  std::mutex mutex_;
+  bool dirty_{false};
+  std::string file_;
+  std::map<std::string, int> choices_;
+};
+
+// Run every candidate `repeats` times after a warm-up run, and return the
+// index of the one with the least minimal time.
+int PickFastest(const std::vector<std::function<void()>>& candidates,
+                int repeats = 3);
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,91 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/tuning_cache.h"
+#include <gtest/gtest.h>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/utils/io.h"
+
+namespace paddle {
+namespace lite {
+
+TEST(TuningCache, persist) {
+  const std::string file = "tuning_cache_test.txt";
+  std::remove(file.c_str());
+  {
+    TuningCache cache(file);
+    int choice = -1;
+    EXPECT_FALSE(cache.Lookup("conv x=1,3,224,224", &choice));
+    cache.Insert("conv x=1,3,224,224", 2);
+    cache.Insert("conv x=1,8,56,56", 1);
+    ASSERT_TRUE(cache.Lookup("conv x=1,3,224,224", &choice));
+    EXPECT_EQ(choice, 2);
+  }
+
+  // The records are saved when the cache is destroyed
+  {
+    TuningCache cache(file);
+    EXPECT_EQ(cache.size(), 2u);
+    int choice = -1;
+    ASSERT_TRUE(cache.Lookup("conv x=1,8,56,56", &choice));
+    EXPECT_EQ(choice, 1);
+  }
+
+  // A file produced on another CPU model is ignored
+  auto lines = ReadLines(file);
+  ASSERT_EQ(lines.size(), 4u);
+  lines[1] = "cpu another cpu x1024";
+  WriteLines(lines, file);
+  {
+    TuningCache cache(file);
+    EXPECT_EQ(cache.size(), 0u);
+  }
+  std::remove(file.c_str());
+}
+
+TEST(TuningCache, scoped_bind) {
+  EXPECT_EQ(TuningCache::Current(), nullptr);
+  TuningCache outer, inner;
+  {
+    TuningCache::ScopedBind bind_outer(&outer);
+    EXPECT_EQ(TuningCache::Current(), &outer);
+    {
+      TuningCache::ScopedBind bind_inner(&inner);
+      EXPECT_EQ(TuningCache::Current(), &inner);
+    }
+    EXPECT_EQ(TuningCache::Current(), &outer);
+    // Other threads aren't affected
+    TuningCache* other = &inner;
+    std::thread([&]() { other = TuningCache::Current(); }).join();
+    EXPECT_EQ(other, nullptr);
+  }
+  EXPECT_EQ(TuningCache::Current(), nullptr);
+}
+
+TEST(TuningCache, pick_fastest) {
+  auto sleep = [](int ms) {
+    return [ms]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    };
+  };
+  EXPECT_EQ(PickFastest({sleep(8), sleep(1), sleep(4)}), 1);
+  EXPECT_EQ(PickFastest({sleep(1)}), 0);
+}
+
+}  // namespace lite
+}  // namespace paddle
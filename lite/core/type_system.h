@@ -185,22 +185,27 @@ static bool TargetCompatibleTo(const Type& a, const Type& b) {
   return true;
 }
 
+// Layouts whose memory is not the plain dims of the tensor, they never match
+// kAny and are always converted by a layout kernel.
+static bool DataLayoutIsOpaque(DataLayoutType layout) {
+  return layout == DATALAYOUT(kImageDefault) ||
+         layout == DATALAYOUT(kImageFolder) ||
+         layout == DATALAYOUT(kNCHW8c) || layout == DATALAYOUT(kNCHW16c);
+}
+
 static bool DataLayoutCompatibleTo(const Type& a, const Type& b) {
   return a.IsVoid() ||                 //
          (a.layout() == b.layout() ||  //
           ((b.layout() == DATALAYOUT(kAny)) &&
-           (a.layout() != DATALAYOUT(kImageDefault) &&
-            a.layout() != DATALAYOUT(kImageFolder))));
+           !DataLayoutIsOpaque(a.layout())));
 }
 static bool DataLayoutCompatible(const Type& a, const Type& b) {
   return a.IsVoid() || b.IsVoid() ||   //
          (a.layout() == b.layout() ||  //
           ((b.layout() == DATALAYOUT(kAny)) &&
-           (a.layout() != DATALAYOUT(kImageDefault) &&
-            a.layout() != DATALAYOUT(kImageFolder))) ||
+           !DataLayoutIsOpaque(a.layout())) ||
           ((a.layout() == DATALAYOUT(kAny)) &&
-           (b.layout() != DATALAYOUT(kImageDefault) &&
-            b.layout() != DATALAYOUT(kImageFolder))));
+           !DataLayoutIsOpaque(b.layout())));
 }
 
 static bool PrecisionCompatibleTo(const Type& a, const Type& b) {
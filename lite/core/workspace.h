@@ -14,6 +14,7 @@
 
 #pragma once
 #include <memory>
+#include <vector>
 #include "lite/core/memory.h"
 #include "lite/core/types.h"
 #include "lite/utils/macros.h"
@@ -81,5 +82,58 @@ class WorkSpace {
   DISALLOW_COPY_AND_ASSIGN(WorkSpace);
 };
 
+/*
+ * ScratchArena backs the workspace of the kernel contexts of one runtime
+ * program, whose kernels use it one after another to hold their temporaries.
+ *
+ * The memory is 64-byte aligned and sized by the largest request, so it stops
+ * growing after the first run. Growing never moves the memory handed out
+ * before: the outgrown block is retired and only freed by `ReleaseRetired`,
+ * which must be called when no kernel is running, e.g. at the end of a run.
+ */
+class ScratchArena {
+ public:
+  static const size_t kAlignment = 64;
+
+  explicit ScratchArena(TargetType target = TARGET(kHost)) : target_(target) {}
+  ~ScratchArena() {
+    ReleaseRetired();
+    TargetFree(target_, data_);
+  }
+
+  // Make sure the arena holds at least `size` bytes.
+  bool Extend(size_t size) {
+    if (size <= capacity_) return data_ != nullptr;
+    size = (size + kAlignment - 1) / kAlignment * kAlignment;
+    if (data_) retired_.push_back(data_);
+    data_ = TargetMalloc(target_, size);
+    capacity_ = size;
+    return data_ != nullptr;
+  }
+
+  template <typename T>
+  T* data() {
+    return static_cast<T*>(data_);
+  }
+
+  size_t capacity() const { return capacity_; }
+
+  // Free the blocks which were outgrown since the last call.
+  void ReleaseRetired() {
+    for (auto* data : retired_) {
+      TargetFree(target_, data);
+    }
+    retired_.clear();
+  }
+
+ private:
+  TargetType target_;
+  void* data_{nullptr};
+  size_t capacity_{0};
+  std::vector<void*> retired_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScratchArena);
+};
+
 }  // namespace lite
 }  // namespace paddle
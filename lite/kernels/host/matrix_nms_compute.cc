@@ -13,153 +13,16 @@
 // limitations under the License.
 
 #include "lite/kernels/host/matrix_nms_compute.h"
-#include <cmath>
-#include <map>
-#include <utility>
+#include <numeric>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
+#include "lite/core/parallel_defines.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-static T BBoxArea(const T* box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static T JaccardOverlap(const T* box1, const T* box2, const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = (std::max)(box1[0], box2[0]);
-    const T inter_ymin = (std::max)(box1[1], box2[1]);
-    const T inter_xmax = (std::min)(box1[2], box2[2]);
-    const T inter_ymax = (std::min)(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
-template <class T>
-T PolyIoU(const T* box1,
-          const T* box2,
-          const size_t box_size,
-          const bool normalized) {
-  LOG(FATAL) << "PolyIoU not implement.";
-  return *box1;
-}
-
-template <typename T, bool gaussian>
-struct decay_score;
-
-template <typename T>
-struct decay_score<T, true> {
-  T operator()(T iou, T max_iou, T sigma) {
-    return std::exp((max_iou * max_iou - iou * iou) * sigma);
-  }
-};
-
-template <typename T>
-struct decay_score<T, false> {
-  T operator()(T iou, T max_iou, T sigma) {
-    return (1. - iou) / (1. - max_iou);
-  }
-};
-
-template <typename T, bool gaussian>
-void NMSMatrix(const Tensor& bbox,
-               const Tensor& scores,
-               const T score_threshold,
-               const T post_threshold,
-               const float sigma,
-               const int64_t top_k,
-               const bool normalized,
-               std::vector<int>* selected_indices,
-               std::vector<T>* decayed_scores) {
-  int64_t num_boxes = bbox.dims()[0];
-  int64_t box_size = bbox.dims()[1];
-
-  auto score_ptr = scores.data<T>();
-  auto bbox_ptr = bbox.data<T>();
-
-  std::vector<int32_t> perm(num_boxes);
-  std::iota(perm.begin(), perm.end(), 0);
-  auto end = std::remove_if(
-      perm.begin(), perm.end(), [&score_ptr, score_threshold](int32_t idx) {
-        return score_ptr[idx] <= score_threshold;
-      });
-  auto sort_fn = [&score_ptr](int32_t lhs, int32_t rhs) {
-    return score_ptr[lhs] > score_ptr[rhs];
-  };
-
-  int64_t num_pre = std::distance(perm.begin(), end);
-  if (num_pre <= 0) {
-    return;
-  }
-  if (top_k > -1 && num_pre > top_k) {
-    num_pre = top_k;
-  }
-  std::partial_sort(perm.begin(), perm.begin() + num_pre, end, sort_fn);
-
-  std::vector<T> iou_matrix((num_pre * (num_pre - 1)) >> 1);
-  std::vector<T> iou_max(num_pre);
-
-  iou_max[0] = 0.;
-  for (int64_t i = 1; i < num_pre; i++) {
-    T max_iou = 0.;
-    auto idx_a = perm[i];
-    for (int64_t j = 0; j < i; j++) {
-      auto idx_b = perm[j];
-      auto iou = JaccardOverlap<T>(
-          bbox_ptr + idx_a * box_size, bbox_ptr + idx_b * box_size, normalized);
-      max_iou = (std::max)(max_iou, iou);
-      iou_matrix[i * (i - 1) / 2 + j] = iou;
-    }
-    iou_max[i] = max_iou;
-  }
-
-  if (score_ptr[perm[0]] > post_threshold) {
-    selected_indices->push_back(perm[0]);
-    decayed_scores->push_back(score_ptr[perm[0]]);
-  }
-
-  decay_score<T, gaussian> decay_fn;
-  for (int64_t i = 1; i < num_pre; i++) {
-    T min_decay = 1.;
-    for (int64_t j = 0; j < i; j++) {
-      auto max_iou = iou_max[j];
-      auto iou = iou_matrix[i * (i - 1) / 2 + j];
-      auto decay = decay_fn(iou, max_iou, sigma);
-      min_decay = (std::min)(min_decay, decay);
-    }
-    auto ds = min_decay * score_ptr[perm[i]];
-    if (ds <= post_threshold) continue;
-    selected_indices->push_back(perm[i]);
-    decayed_scores->push_back(ds);
-  }
-}
-
 template <typename T>
 size_t MultiClassMatrixNMS(const Tensor& scores,
                            const Tensor& bboxes,
@@ -183,36 +46,41 @@ size_t MultiClassMatrixNMS(const Tensor& scores,
 
   size_t num_det = 0;
   auto class_num = scores.dims()[0];
-  Tensor score_slice;
-  for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    score_slice = scores.Slice<float>(c, c + 1);
-    if (use_gaussian) {
-      NMSMatrix<T, true>(bboxes,
-                         score_slice,
-                         score_threshold,
-                         post_threshold,
-                         gaussian_sigma,
-                         nms_top_k,
-                         normalized,
-                         &all_indices,
-                         &all_scores);
-    } else {
-      NMSMatrix<T, false>(bboxes,
-                          score_slice,
-                          score_threshold,
-                          post_threshold,
-                          gaussian_sigma,
-                          nms_top_k,
-                          normalized,
-                          &all_indices,
-                          &all_scores);
+  auto num_boxes = scores.dims()[1];
+  auto box_size = bboxes.dims()[1];
+  const T* boxes_data = bboxes.data<T>();
+  const T* scores_data = scores.data<T>();
+  // The classes are independent, run them across the thread pool and merge
+  // the results in class order.
+  std::vector<std::vector<int>> class_indices(class_num);
+  std::vector<std::vector<T>> class_scores(class_num);
+  LITE_PARALLEL_BEGIN(c, tid, class_num) {
+    if (c != background_label) {
+      lite::host::math::MatrixNMS<T>(boxes_data,
+                                     box_size,
+                                     scores_data + c * num_boxes,
+                                     1,
+                                     num_boxes,
+                                     score_threshold,
+                                     post_threshold,
+                                     gaussian_sigma,
+                                     use_gaussian,
+                                     nms_top_k,
+                                     normalized,
+                                     &class_indices[c],
+                                     &class_scores[c]);
     }
-    for (size_t i = 0; i < all_indices.size() - num_det; i++) {
-      all_classes.push_back(static_cast<T>(c));
-    }
-    num_det = all_indices.size();
   }
+  LITE_PARALLEL_END();
+  for (int64_t c = 0; c < class_num; ++c) {
+    all_indices.insert(
+        all_indices.end(), class_indices[c].begin(), class_indices[c].end());
+    all_scores.insert(
+        all_scores.end(), class_scores[c].begin(), class_scores[c].end());
+    all_classes.insert(
+        all_classes.end(), class_indices[c].size(), static_cast<T>(c));
+  }
+  num_det = all_indices.size();
 
   if (num_det <= 0) {
     return num_det;
@@ -17,9 +17,11 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 #include "lite/backends/host/math/nms_util.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/parallel_defines.h"
 namespace paddle {
 namespace lite {
 namespace kernels {
@@ -58,70 +60,6 @@ void SliceOneClass(const Tensor& items,
   }
 }
 
-template <typename T>
-void NMSFast(const Tensor& bbox,
-             const Tensor& scores,
-             const T score_threshold,
-             const T nms_threshold,
-             const T eta,
-             const int64_t top_k,
-             std::vector<int>* selected_indices,
-             const bool normalized) {
-  // The total boxes for each instance.
-  int64_t num_boxes = bbox.dims()[0];
-  // 4: [xmin ymin xmax ymax]
-  // 8: [x1 y1 x2 y2 x3 y3 x4 y4]
-  // 16, 24, or 32: [x1 y1 x2 y2 ...  xn yn], n = 8, 12 or 16
-  int64_t box_size = bbox.dims()[1];
-
-  std::vector<T> scores_data(num_boxes);
-  std::copy_n(scores.data<T>(), num_boxes, scores_data.begin());
-  std::vector<std::pair<T, int>> sorted_indices;
-  lite::host::math::GetMaxScoreIndex(
-      scores_data, score_threshold, top_k, &sorted_indices);
-
-  selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-  const T* bbox_data = bbox.data<T>();
-
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
-    bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-        // 4: [xmin ymin xmax ymax]
-        if (box_size == 4) {
-          overlap = lite::host::math::JaccardOverlap<T>(
-              bbox_data + idx * box_size,
-              bbox_data + kept_idx * box_size,
-              normalized);
-        }
-        // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
-        if (box_size == 8 || box_size == 16 || box_size == 24 ||
-            box_size == 32) {
-          overlap =
-              lite::host::math::PolyIoU<T>(bbox_data + idx * box_size,
-                                           bbox_data + kept_idx * box_size,
-                                           box_size,
-                                           normalized);
-        }
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
-    }
-    if (keep) {
-      selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
-  }
-}
-
 template <typename T>
 void MultiClassNMS(const operators::MulticlassNmsParam& param,
                    const Tensor& scores,
@@ -140,35 +78,59 @@ void MultiClassNMS(const operators::MulticlassNmsParam& param,
   int num_det = 0;
 
   int64_t class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
-  Tensor bbox_slice, score_slice;
+  const T* boxes_data = bboxes.data<T>();
+  const T* scores_data = scores.data<T>();
+  // The classes are independent, run them across the thread pool and merge
+  // the results in class order.
+  std::vector<std::vector<int>> class_indices(class_num);
+  LITE_PARALLEL_BEGIN(c, tid, class_num) {
+    if (c != background_label) {
+      if (scores_size == 3) {
+        // scores: [C, M], bboxes: [M, box_size]
+        int64_t num_boxes = scores.dims()[1];
+        int box_size = bboxes.dims()[1];
+        lite::host::math::GreedyNMS<T>(boxes_data,
+                                       box_size,
+                                       box_size,
+                                       scores_data + c * num_boxes,
+                                       1,
+                                       num_boxes,
+                                       score_threshold,
+                                       nms_threshold,
+                                       nms_eta,
+                                       nms_top_k,
+                                       normalized,
+                                       &class_indices[c]);
+      } else {
+        // scores: [M, C], bboxes: [M, C, 4]
+        int64_t num_boxes = scores.dims()[0];
+        int64_t box_dim = bboxes.dims()[2];
+        lite::host::math::GreedyNMS<T>(boxes_data + c * box_dim,
+                                       class_num * box_dim,
+                                       4,
+                                       scores_data + c,
+                                       class_num,
+                                       num_boxes,
+                                       score_threshold,
+                                       nms_threshold,
+                                       nms_eta,
+                                       nms_top_k,
+                                       normalized,
+                                       &class_indices[c]);
+        std::stable_sort(class_indices[c].begin(), class_indices[c].end());
+      }
+    }
+  }
+  LITE_PARALLEL_END();
   for (int64_t c = 0; c < class_num; ++c) {
     if (c == background_label) continue;
-    if (scores_size == 3) {
-      score_slice = scores.Slice<T>(c, c + 1);
-      bbox_slice = bboxes;
-    } else {
-      score_slice.Resize({scores.dims()[0], 1});
-      bbox_slice.Resize({scores.dims()[0], 4});
-      SliceOneClass<T>(scores, c, &score_slice);
-      SliceOneClass<T>(bboxes, c, &bbox_slice);
-    }
-    NMSFast(bbox_slice,
-            score_slice,
-            score_threshold,
-            nms_threshold,
-            nms_eta,
-            nms_top_k,
-            &((*indices)[c]),
-            normalized);
-    if (scores_size == 2) {
-      std::stable_sort((*indices)[c].begin(), (*indices)[c].end());
-    }
-    num_det += (*indices)[c].size();
+    num_det += class_indices[c].size();
+    (*indices)[c].swap(class_indices[c]);
   }
 
   *num_nmsed_out = num_det;
-  const T* scores_data = scores.data<T>();
   if (keep_top_k > -1 && num_det > keep_top_k) {
+    Tensor score_slice;
     const T* sdata;
     std::vector<std::pair<T, std::pair<int, int>>> score_index_pairs;
     for (const auto& it : *indices) {
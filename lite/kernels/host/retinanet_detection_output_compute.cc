@@ -13,10 +13,14 @@
 // limitations under the License.
 
 #include "lite/kernels/host/retinanet_detection_output_compute.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
+#include "lite/core/parallel_defines.h"
 #include "lite/operators/retinanet_detection_output_op.h"
 
 namespace paddle {
@@ -57,84 +61,29 @@ static inline void GetMaxScoreIndex(
   }
 }
 
-template <class T>
-static inline T BBoxArea(const std::vector<T>& box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static inline T JaccardOverlap(const std::vector<T>& box1,
-                               const std::vector<T>& box2,
-                               const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = (std::max)(box1[0], box2[0]);
-    const T inter_ymin = (std::max)(box1[1], box2[1]);
-    const T inter_xmax = (std::min)(box1[2], box2[2]);
-    const T inter_ymax = (std::min)(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
 template <class T>
 void NMSFast(const std::vector<std::vector<T>>& cls_dets,
              const T nms_threshold,
              const T eta,
              std::vector<int>* selected_indices) {
-  int64_t num_boxes = cls_dets.size();
-  std::vector<std::pair<T, int>> sorted_indices;
+  // Each det is [xmin, ymin, xmax, ymax, score], pack them row by row.
+  const int64_t num_boxes = cls_dets.size();
+  std::vector<T> dets(num_boxes * 5);
   for (int64_t i = 0; i < num_boxes; ++i) {
-    sorted_indices.push_back(std::make_pair(cls_dets[i][4], i));
-  }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(
-      sorted_indices.begin(), sorted_indices.end(), SortScorePairDescend<int>);
-  selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
-    bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-
-        overlap = JaccardOverlap<T>(cls_dets[idx], cls_dets[kept_idx], false);
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
-    }
-    if (keep) {
-      selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
+    std::copy_n(cls_dets[i].begin(), 5, dets.begin() + i * 5);
   }
+  lite::host::math::GreedyNMS<T>(dets.data(),
+                                 5,
+                                 4,
+                                 dets.data() + 4,
+                                 5,
+                                 num_boxes,
+                                 -std::numeric_limits<T>::infinity(),
+                                 nms_threshold,
+                                 eta,
+                                 -1,
+                                 false,
+                                 selected_indices);
 }
 
 template <class T>
@@ -209,11 +158,18 @@ void MultiClassNMS(const std::map<int, std::vector<std::vector<T>>>& preds,
                    int* num_nmsed_out) {
   std::map<int, std::vector<int>> indices;
   int num_det = 0;
+  std::vector<std::vector<int>> class_indices(class_num);
+  LITE_PARALLEL_BEGIN(c, tid, class_num) {
+    auto it = preds.find(c);
+    if (it != preds.end()) {
+      NMSFast(it->second, nms_threshold, nms_eta, &class_indices[c]);
+    }
+  }
+  LITE_PARALLEL_END();
   for (int c = 0; c < class_num; ++c) {
     if (static_cast<bool>(preds.count(c))) {
-      const std::vector<std::vector<T>> cls_dets = preds.at(c);
-      NMSFast(cls_dets, nms_threshold, nms_eta, &(indices[c]));
-      num_det += indices[c].size();
+      num_det += class_indices[c].size();
+      indices[c].swap(class_indices[c]);
     }
   }
 
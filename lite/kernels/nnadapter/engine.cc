@@ -15,12 +15,17 @@
 #include "lite/kernels/nnadapter/engine.h"
 #include <sys/time.h>
 #include <time.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <functional>
+#include <iterator>
 #include <utility>
 #include "lite/core/op_registry.h"
 #include "lite/kernels/nnadapter/converter/converter.h"
 #include "lite/utils/env.h"
 #include "lite/utils/md5.h"
+#include "lite/utils/string.h"
 
 namespace paddle {
 namespace lite {
@@ -54,6 +59,46 @@ std::string GenerateModelCacheToken(
   return MD5(os.str());
 }
 
+size_t ShapeSignatureHash::operator()(const ShapeSignature& signature) const {
+  size_t seed = signature.size();
+  for (auto value : signature) {
+    seed ^=
+        std::hash<int64_t>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+// Copy the host tensor src to the zero padded dst, whose dimensions have been
+// set and are not less than the ones of src
+void PadTensor(const Tensor& src, Tensor* dst) {
+  auto src_dims = src.dims();
+  auto dst_dims = dst->dims();
+  auto rank = src_dims.size();
+  CHECK_EQ(rank, dst_dims.size());
+  size_t element_size = PrecisionTypeLength(src.precision());
+  auto dst_data = static_cast<char*>(dst->mutable_data(
+      TARGET(kHost), dst_dims.production() * element_size));
+  memset(dst_data, 0, dst_dims.production() * element_size);
+  if (rank == 0 || src_dims.production() == 0) return;
+  // Copy the innermost rows one by one
+  auto src_data = static_cast<const char*>(src.raw_data());
+  int64_t row_size = src_dims[rank - 1] * element_size;
+  int64_t row_count = src_dims.production() / src_dims[rank - 1];
+  std::vector<int64_t> row_index(rank, 0);
+  for (int64_t i = 0; i < row_count; i++) {
+    int64_t offset = 0;
+    for (size_t j = 0; j + 1 < rank; j++) {
+      offset = offset * dst_dims[j] + row_index[j];
+    }
+    offset *= dst_dims[rank - 1] * element_size;
+    memcpy(dst_data + offset, src_data + i * row_size, row_size);
+    for (int j = static_cast<int>(rank) - 2; j >= 0; j--) {
+      if (++row_index[j] < src_dims[j]) break;
+      row_index[j] = 0;
+    }
+  }
+}
+
 void* AccessModelInput(void* memory,
                        NNAdapterOperandType* type,
                        void* device_buffer) {
@@ -287,6 +332,33 @@ Engine::Engine(KernelContext* ctx,
   };
   std::stable_sort(input_vars_.begin(), input_vars_.end(), sort_comp_func);
   std::stable_sort(output_vars_.begin(), output_vars_.end(), sort_comp_func);
+  // Get the shape buckets of the inputs from the environment, the programs are
+  // fed with the padded copies of the bucketed inputs
+  auto shape_bucket_configs = GetConfigsFromEnv(
+      SUBGRAPH_INPUT_SHAPE_BUCKETS_FILE, SUBGRAPH_INPUT_SHAPE_BUCKETS_BUFFER);
+  for (auto line : Split(shape_bucket_configs, "\n")) {
+    line.erase(std::remove_if(line.begin(), line.end(), ::isspace),
+               line.end());
+    if (line.empty()) continue;
+    auto items = Split(line, ":");
+    CHECK_EQ(items.size(), 3u) << "Invalid shape bucket config: " << line;
+    for (size_t i = 0; i < input_count; i++) {
+      if (input_vars_[i].name != items[0]) continue;
+      auto sizes = Split<int64_t>(items[2], ",");
+      std::sort(sizes.begin(), sizes.end());
+      bucketed_inputs_[i].buckets.emplace_back(std::stoi(items[1]), sizes);
+    }
+  }
+  for (auto& bucketed_input : bucketed_inputs_) {
+    auto& input_var = input_vars_[bucketed_input.first];
+    VLOG(3) << "NNAdapter input " << input_var.name
+            << " is padded to the shape buckets.";
+    bucketed_input.second.origin = input_var.value;
+    input_var.value = &bucketed_input.second.padded;
+  }
+  program_cache_capacity_ =
+      std::max(GetIntFromEnv(SUBGRAPH_PROGRAM_CACHE_CAPACITY, 0), 0);
+  VLOG(3) << "NNAdapter program_cache_capacity: " << program_cache_capacity_;
   // Get the specified devices and create a context for each device to build or
   // load the device-specific program from the model or the cache file/buffer.
   const auto& device_names =
@@ -329,6 +401,7 @@ Engine::Engine(KernelContext* ctx,
 }
 
 Engine::~Engine() {
+  program_index_.clear();
   programs_.clear();
   NNAdapterContext_destroy_invoke(context_);
   for (auto* device : devices_) {
@@ -336,10 +409,72 @@ Engine::~Engine() {
   }
 }
 
+ShapeSignature Engine::PrepareInputs() {
+  for (auto& bucketed_input : bucketed_inputs_) {
+    auto origin = bucketed_input.second.origin;
+    auto padded = &bucketed_input.second.padded;
+    auto target = origin->target();
+    CHECK(target == TARGET(kHost) || target == TARGET(kARM) ||
+          target == TARGET(kX86))
+        << "Only the host inputs can be padded to the shape buckets.";
+    auto dims = origin->dims().Vectorize();
+    for (const auto& bucket : bucketed_input.second.buckets) {
+      int rank = dims.size();
+      int axis = bucket.first < 0 ? bucket.first + rank : bucket.first;
+      CHECK(axis >= 0 && axis < rank) << "Invalid axis " << bucket.first
+                                      << " of the shape bucket.";
+      auto it = std::lower_bound(
+          bucket.second.begin(), bucket.second.end(), dims[axis]);
+      if (it != bucket.second.end()) dims[axis] = *it;
+    }
+    padded->set_precision(origin->precision());
+    padded->Resize(dims);
+    PadTensor(*origin, padded);
+  }
+  ShapeSignature signature;
+  for (const auto& input_var : input_vars_) {
+    auto dims = input_var.value->dims();
+    signature.push_back(dims.size());
+    for (size_t i = 0; i < dims.size(); i++) {
+      signature.push_back(dims[i]);
+    }
+  }
+  return signature;
+}
+
+void Engine::TouchProgram(std::list<std::shared_ptr<Program>>::iterator it) {
+  programs_.splice(programs_.begin(), programs_, it);
+  if (program_cache_capacity_ == 0) return;
+  while (programs_.size() > program_cache_capacity_) {
+    auto last = std::prev(programs_.end());
+    for (auto index = program_index_.begin(); index != program_index_.end();) {
+      if (index->second == last) {
+        index = program_index_.erase(index);
+      } else {
+        ++index;
+      }
+    }
+    programs_.erase(last);
+    VLOG(3) << "Release the least recently used program.";
+  }
+}
+
 bool Engine::Run() {
-  // Try to execute all cached programs.
-  for (auto program : programs_) {
-    int ret = program->Execute();
+  auto signature = PrepareInputs();
+  // Execute the program which has run with the same input shapes
+  auto index = program_index_.find(signature);
+  if (index != program_index_.end()) {
+    auto it = index->second;
+    TouchProgram(it);
+    int ret = (*it)->Execute();
+    CHECK_EQ(ret, static_cast<int>(NNADAPTER_NO_ERROR))
+        << "Program execute failed.";
+    return true;
+  }
+  // Try to execute all cached programs for the new input shapes, the ones
+  // compiled with the dynamic shape info may support them.
+  for (auto it = programs_.begin(); it != programs_.end(); ++it) {
+    int ret = (*it)->Execute();
     if (ret == NNADAPTER_INVALID_DIMENSIONS) {
       VLOG(1) << "Warning: Input shapes are not supported by the program, try "
                  "the next "
@@ -348,6 +483,8 @@ bool Engine::Run() {
     }
     CHECK_EQ(ret, static_cast<int>(NNADAPTER_NO_ERROR))
         << "Program execute failed.";
+    program_index_[signature] = it;
+    TouchProgram(it);
     return true;
   }
   // Rebuild the device program corresponding to the input dimensions if not
@@ -383,7 +520,9 @@ bool Engine::Run() {
   }
   CHECK(program->IsValid());
   CHECK(program->SetInputsAndOutputs(&input_vars_, &output_vars_));
-  programs_.push_back(program);
+  programs_.push_front(program);
+  program_index_[signature] = programs_.begin();
+  TouchProgram(programs_.begin());
   int ret = program->Execute();
   CHECK_EQ(ret, static_cast<int>(NNADAPTER_NO_ERROR))
       << "Program execute failed.";
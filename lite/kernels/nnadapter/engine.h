@@ -15,9 +15,12 @@
 #pragma once
 
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "lite/backends/nnadapter/nnadapter_wrapper.h"
 #include "lite/core/program.h"
@@ -35,6 +38,23 @@ typedef struct {
   int32_t quant_zero_point{0};
 } Variable;
 
+// The dimensions of all of the inputs, which identify the program compiled for
+// them
+typedef std::vector<int64_t> ShapeSignature;
+
+struct ShapeSignatureHash {
+  size_t operator()(const ShapeSignature& signature) const;
+};
+
+// An input whose dimensions are rounded up to the shape buckets, the padded
+// copy of the original tensor is fed to the programs
+typedef struct {
+  Tensor* origin{nullptr};
+  Tensor padded;
+  // The axis and the sorted bucket sizes
+  std::vector<std::pair<int, std::vector<int64_t>>> buckets{};
+} BucketedInput;
+
 class Program {
  public:
   explicit Program(::NNAdapterContext* context) : context_(context) {}
@@ -79,6 +99,12 @@ class Engine {
   bool Run();
 
  private:
+  // Pad the bucketed inputs and generate the shape signature of the inputs
+  ShapeSignature PrepareInputs();
+  // Mark the program as the most recently used one, and release the least
+  // recently used ones if the capacity is exceeded
+  void TouchProgram(std::list<std::shared_ptr<Program>>::iterator it);
+
   KernelContext* ctx_{nullptr};
   const cpp::BlockDesc* block_desc_{nullptr};
   Scope* exec_scope_{nullptr};
@@ -86,7 +112,16 @@ class Engine {
   std::vector<Variable> output_vars_;
   std::vector<NNAdapterDevice*> devices_;
   ::NNAdapterContext* context_{nullptr};
-  std::vector<std::shared_ptr<Program>> programs_;
+  // The compiled programs from the most to the least recently used one, and
+  // the index of them by the shape signatures of the inputs
+  std::list<std::shared_ptr<Program>> programs_;
+  std::unordered_map<ShapeSignature,
+                     std::list<std::shared_ptr<Program>>::iterator,
+                     ShapeSignatureHash>
+      program_index_;
+  size_t program_cache_capacity_{0};
+  // The bucketed inputs by their indexes of input_vars_
+  std::map<size_t, BucketedInput> bucketed_inputs_;
   std::string model_cache_dir_{""};
 };
 
@@ -0,0 +1,69 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/backends/x86/math/blas.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/types.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// x: [B, M, K], y: [B, K, N], out: [B, M, N]
+template <typename T>
+class BmmCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::BmmParam;
+
+  void Run() override {
+    auto& ctx = this->ctx_->template As<X86Context>();
+    auto& param = *param_.get_mutable<operators::BmmParam>();
+    auto x_dims = param.X->dims();
+    auto y_dims = param.Y->dims();
+    int batch = x_dims[0];
+    int m = x_dims[1];
+    int k = x_dims[2];
+    int n = y_dims[2];
+
+    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(ctx);
+    blas.BatchedGEMM(false,
+                     false,
+                     m,
+                     n,
+                     k,
+                     static_cast<T>(1),
+                     param.X->template data<T>(),
+                     k,
+                     static_cast<int64_t>(m) * k,
+                     param.Y->template data<T>(),
+                     n,
+                     static_cast<int64_t>(k) * n,
+                     static_cast<T>(0),
+                     param.Out->template mutable_data<T>(),
+                     n,
+                     static_cast<int64_t>(m) * n,
+                     batch);
+  }
+
+  virtual ~BmmCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
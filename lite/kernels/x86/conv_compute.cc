@@ -13,10 +13,17 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/conv_compute.h"
+#include <algorithm>
+#include <functional>
 #include <utility>
 #include "lite/backends/x86/math/fill_bias_activate.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/packed_weight_cache.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/core/tuning_cache.h"
 #include "lite/kernels/x86/conv_depthwise.h"
 #include "lite/kernels/x86/conv_direct.h"
+#include "lite/kernels/x86/conv_winograd.h"
 
 namespace paddle {
 namespace lite {
@@ -79,6 +86,117 @@ namespace x86 {
   bool pads_equal =                                                 \
       ((paddings[0] == paddings[1]) && (paddings[2] == paddings[3]));
 
+template <>
+KernelLite<TARGET(kX86), PRECISION(kFloat)>*
+Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::CreateImpl(
+    ConvAlgo algo) {
+  switch (algo) {
+    case ConvAlgo::kDepthwise:
+      VLOG(3) << "invoking conv_depthwise_3x3p0p1 or conv_depthwise_5x5";
+      return new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
+    case ConvAlgo::kWinograd:
+      VLOG(3) << "invoking conv_winograd3x3";
+      return new WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>;
+    case ConvAlgo::kDirect:
+#if defined(_WIN64) || defined(__MINGW64__) || \
+    (defined(__CYGWIN__) && defined(__x86_64__)) || defined(__x86_64__)
+      VLOG(3) << "invoking directConv";
+      return new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>();
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+template <>
+void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareGemm() {
+  if (!lite::x86::math::use_packed_sgemm()) return;
+  // Pack the filter of every group once for the gemm path
+  auto& param = this->Param<param_t>();
+  const int groups = param.groups;
+  int m = param.filter->dims()[0] / groups;
+  int k = param.filter->dims()[1] * param.filter->dims()[2] *
+          param.filter->dims()[3];
+  int64_t group_packed_size = lite::x86::math::sgemm_packed_a_size(m, k);
+  packed_weights_ = PackedWeightCache::Global().Get(
+      *param.filter,
+      string_format("x86.sgemm_pack_a g=%d m=%d k=%d", groups, m, k),
+      [=](const Tensor& filter, Tensor* packed) {
+        packed->Resize({group_packed_size * groups});
+        auto weights = filter.data<float>();
+        auto packed_weights = packed->mutable_data<float>();
+        for (int g = 0; g < groups; g++) {
+          lite::x86::math::sgemm_pack_a(false,
+                                        m,
+                                        k,
+                                        weights + g * m * k,
+                                        k,
+                                        packed_weights + g * group_packed_size);
+        }
+      });
+}
+
+template <>
+std::string Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::TuningKey(
+    const operators::ConvParam& param) {
+  auto dims = [](const std::vector<int64_t>& v) {
+    std::string str;
+    for (auto d : v) str += (str.empty() ? "" : ",") + std::to_string(d);
+    return str;
+  };
+  int threads = static_cast<int>(lite::x86::GetMaxThreads());
+#ifdef LITE_USE_THREAD_POOL
+  if (ThreadPool::Current()) {
+    threads = std::max(threads, ThreadPool::Current()->thread_num());
+  }
+#endif
+  return string_format(
+      "x86.conv2d.fp32 x=%s w=%s s=%d,%d p=%s d=%s g=%d act=%d t=%d",
+      dims(param.x->dims().Vectorize()).c_str(),
+      dims(param.filter->dims().Vectorize()).c_str(),
+      param.strides[0],
+      param.strides[1],
+      Join(*param.paddings, ",").c_str(),
+      Join(*param.dilations, ",").c_str(),
+      param.groups,
+      static_cast<int>(param.activation_param.active_type),
+      threads);
+}
+
+template <>
+void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run();
+
+template <>
+int Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::TuneAlgo(
+    const std::vector<ConvAlgo>& algos) {
+  auto& param = this->Param<param_t>();
+  std::vector<std::unique_ptr<KernelLite<TARGET(kX86), PRECISION(kFloat)>>>
+      impls;
+  std::vector<std::function<void()>> candidates;
+  for (auto algo : algos) {
+    std::unique_ptr<KernelLite<TARGET(kX86), PRECISION(kFloat)>> impl(
+        CreateImpl(algo));
+    if (impl) {
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      impl->SetContext(std::move(ctx));
+      impl->SetParam(param);
+      impl->PrepareForRun();
+      auto raw = impl.get();
+      candidates.push_back([raw]() { raw->Run(); });
+      impls.push_back(std::move(impl));
+    } else {
+      PrepareGemm();
+      candidates.push_back([this]() { this->Run(); });
+    }
+  }
+  int best = PickFastest(candidates);
+  if (algos[best] != ConvAlgo::kGemm) {
+    packed_weights_.reset();
+  }
+  return best;
+}
+
 template <>
 void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
   PREPARE_PARAM
@@ -100,31 +218,56 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
                        (paddings[2] == paddings[3]);
   bool flag_p = paddings[0] <= stride_h;
 
-  //! select conv impl
-  if (dw_kernel && kps_equal && flag_dw && pads_equal &&
-      ((flag_dw_5x5 && no_dilation) || (flag_dw_3x3 && (groups & 3) == 0))) {
-    impl_ = new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    VLOG(3) << "invoking conv_depthwise_3x3p0p1 or conv_depthwise_5x5";
-  }
-
+  //! select conv impl, the heuristic choice goes first
+  auto o_dims = param.output->dims();
+  // 3x3s1 with enough channels and outputs to amortize the transforms
+  bool flag_winograd = groups == 1 && kernel_h == 3 && kernel_w == 3 &&
+                       stride_h == 1 && nodilations && kps_equal &&
+                       pads_equal && input_channel >= 16 &&
+                       output_channel >= 16 && o_dims[2] >= 6 &&
+                       o_dims[3] >= 6;
   // support 3x3s1p01,5x5s1p01,7x7s1p01
   //  3x3s2p012,5x5s1p012,7x7s1p012
-  if (output_channel % 8 == 0 && groups == 1 &&
-      (kernel_h == 3 || kernel_h == 5 || kernel_h == 7) &&
-      (stride_h == 2 || stride_h == 1) && nodilations && kps_equal &&
-      pad_all_equal && flag_p) {
+  bool flag_direct = false;
 #if defined(_WIN64) || defined(__MINGW64__) || \
     (defined(__CYGWIN__) && defined(__x86_64__)) || defined(__x86_64__)
-    impl_ = new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>();
-    VLOG(3) << "invoking directConv";
+  flag_direct = output_channel % 8 == 0 && groups == 1 &&
+                (kernel_h == 3 || kernel_h == 5 || kernel_h == 7) &&
+                (stride_h == 2 || stride_h == 1) && nodilations && kps_equal &&
+                pad_all_equal && flag_p;
 #endif
+  bool flag_depthwise =
+      dw_kernel && kps_equal && flag_dw && pads_equal &&
+      ((flag_dw_5x5 && no_dilation) || (flag_dw_3x3 && (groups & 3) == 0));
+  std::vector<ConvAlgo> algos;
+  if (flag_winograd) algos.push_back(ConvAlgo::kWinograd);
+  if (flag_direct) algos.push_back(ConvAlgo::kDirect);
+  if (flag_depthwise) algos.push_back(ConvAlgo::kDepthwise);
+  algos.push_back(ConvAlgo::kGemm);
+
+  ConvAlgo algo = algos[0];
+  auto* tuning_cache = TuningCache::Current();
+  if (algos.size() > 1 && tuning_cache) {
+    auto key = TuningKey(param);
+    int cached = -1;
+    if (tuning_cache->Lookup(key, &cached) &&
+        std::count(algos.begin(), algos.end(), ConvAlgo(cached))) {
+      algo = ConvAlgo(cached);
+    } else {
+      algo = algos[TuneAlgo(algos)];
+      tuning_cache->Insert(key, static_cast<int>(algo));
+    }
+    VLOG(3) << "conv2d tuned: " << key << " -> " << static_cast<int>(algo);
   }
 
+  impl_ = CreateImpl(algo);
   if (impl_) {
     impl_->SetContext(std::move(this->ctx_));
     impl_->SetParam(param);
     impl_->PrepareForRun();
     is_first_epoch_ = false;
+  } else {
+    PrepareGemm();
   }
 }
 
@@ -155,7 +298,8 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   if (!flag_1x1gemm_) {
     size_t col_size = group_size_coldata * group;
     size_t col_data_size = static_cast<size_t>(col_size * sizeof(float));
-    col_data = static_cast<float*>(TargetMalloc(TARGET(kX86), col_data_size));
+    ctx.ExtendWorkspace(col_data_size);
+    col_data = ctx.workspace_data<float>();
   }
   auto act_param = param.activation_param;
   paddle::lite::x86::math::Blas<lite::TargetType::kX86> matmul(ctx);
@@ -189,6 +333,24 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
       if (n == 1) {
         matmul.GEMV<float>(
             false, m, k, 1.f, weights_group, col_data_group, 0.f, dout_group);
+      } else if (packed_weights_) {
+        int64_t group_packed_size = packed_weights_->numel() / group;
+        lite::x86::math::sgemm(
+            false,
+            false,
+            m,
+            n,
+            k,
+            1.f,
+            weights_group,
+            k,
+            col_data_group,
+            n,
+            0.f,
+            dout_group,
+            n,
+            packed_weights_->data<float>() + g * group_packed_size,
+            nullptr);
       } else {
         matmul.GEMM<float>(false,
                            false,
@@ -209,7 +371,6 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
     lite::x86::math::fill_bias_act(
         dout_batch, bias_ptr, chout, wout * hout, flag_bias, &act_param);
   }
-  if (!flag_1x1gemm_) TargetFree(TARGET(kX86), col_data);
 }
 
 template <>
@@ -291,6 +452,7 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun() {
 template <>
 void Conv2dCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
   INIT_PARAM
+  auto& ctx = ctx_->As<X86Context>();
   int group_size_coldata = n * k;
   int channel_size_in = hin * win;
   int channel_size_out = hout * wout;
@@ -305,8 +467,8 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
 
   if (!flag_1x1gemm_) {
     int col_size = group * group_size_coldata;
-    col_data = static_cast<int8_t*>(
-        TargetMalloc(TARGET(kX86), col_size * sizeof(int8_t)));
+    ctx.ExtendWorkspace(col_size * sizeof(int8_t));
+    col_data = ctx.workspace_data<int8_t>();
   }
   for (int b = 0; b < num; ++b) {
     for (int g = 0; g < group; ++g) {
@@ -337,7 +499,6 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
       }
     }
   }
-  if (!flag_1x1gemm_) TargetFree(TARGET(kX86), col_data);
 }
 
 template <>
@@ -422,6 +583,7 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun() {
 template <>
 void Conv2dCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
   INIT_PARAM
+  auto& ctx = ctx_->As<X86Context>();
   int group_size_coldata = n * k;
   int channel_size_in = hin * win;
   int channel_size_out = hout * wout;
@@ -436,8 +598,8 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
 
   if (!flag_1x1gemm_) {
     int col_size = group * group_size_coldata;
-    col_data = static_cast<int8_t*>(
-        TargetMalloc(TARGET(kX86), col_size * sizeof(int8_t)));
+    ctx.ExtendWorkspace(col_size * sizeof(int8_t));
+    col_data = ctx.workspace_data<int8_t>();
   }
   for (int b = 0; b < num; ++b) {
     for (int g = 0; g < group; ++g) {
@@ -468,7 +630,6 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
       }
     }
   }
-  if (!flag_1x1gemm_) TargetFree(TARGET(kX86), col_data);
 }
 
 #undef PREPARE_PARAM
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <memory>
 #include <string>
 #include <vector>
 #include "lite/backends/x86/math/avx/conv_utils.h"
@@ -21,6 +22,7 @@
 #include "lite/backends/x86/math/conv_bias.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
 #include "lite/backends/x86/math/im2col.h"
+#include "lite/backends/x86/math/packed_sgemm.h"
 #include "lite/backends/x86/math/vol2col.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
@@ -46,6 +48,9 @@ inline bool IsExpand(const std::vector<int64_t>& filter_dim,
   return !(filter_1 && strides_1 && padding_0 && dilation_1);
 }
 
+// The fp32 conv algorithms, the values are persisted in the tuning cache.
+enum class ConvAlgo { kGemm = 0, kDepthwise = 1, kWinograd = 2, kDirect = 3 };
+
 template <PrecisionType Ptype, PrecisionType OutType>
 class Conv2dCompute : public KernelLite<TARGET(kX86), Ptype> {
  public:
@@ -79,6 +84,16 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), Ptype> {
 
  private:
   using param_t = operators::ConvParam;
+
+  // Create the kernel of `algo`, or nullptr for the im2col + gemm path
+  // implemented by `Run` itself.
+  KernelLite<TARGET(kX86), Ptype>* CreateImpl(ConvAlgo algo);
+  void PrepareGemm();
+  // Time every viable algorithm on the current shapes and return the index
+  // of the fastest one, used when the tuning cache is enabled.
+  int TuneAlgo(const std::vector<ConvAlgo>& algos);
+  std::string TuningKey(const param_t& param);
+
   KernelLite<TARGET(kX86), Ptype>* impl_{nullptr};
   Context<TargetType::kX86>* device_ctx;
   bool flag_1x1gemm_{false};
@@ -86,6 +101,9 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), Ptype> {
   std::vector<float> w_scale_;
   Tensor weights_;
   Tensor bias_;
+  // The filter of every group packed by sgemm_pack_a for the gemm path,
+  // shared with the clones through the PackedWeightCache.
+  std::shared_ptr<const Tensor> packed_weights_;
   std::vector<lite::x86::math::generate_gemm_s8u8_x86_kern<float>*>
       gemm_s8_ptr_float_{};
   std::vector<lite::x86::math::generate_gemm_s8u8_x86_kern<int8_t>*>
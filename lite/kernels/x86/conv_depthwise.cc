@@ -25,7 +25,7 @@ namespace kernels {
 namespace x86 {
 #define CONV_DW_PARAM                                                         \
   i_data, o_data, bs, oc, oh, ow, ic, ih, iw, w_data, b_data, pad, flag_bias, \
-      act_param
+      act_param, &ctx
 
 template <>
 void DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {}
@@ -34,6 +34,7 @@ template <>
 void DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   auto& param = this->Param<param_t>();
   CHECK(this->ctx_);
+  auto& ctx = this->ctx_->template As<X86Context>();
 
   auto input_dims = param.x->dims();
   CHECK_EQ(input_dims.size(), 4UL);
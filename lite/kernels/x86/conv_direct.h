@@ -15,12 +15,14 @@
 #pragma once
 
 #include <cmath>
+#include <memory>
 #include <string>
 #include <vector>
 #include "lite/backends/x86/math/avx/conv_utils.h"
 #include "lite/backends/x86/math/conv_direct_fp32.h"
 #include "lite/core/context.h"
 #include "lite/core/kernel.h"
+#include "lite/core/packed_weight_cache.h"
 #include "lite/core/target_wrapper.h"
 
 namespace paddle {
@@ -54,11 +56,20 @@ class DirectConv : public KernelLite<TARGET(kX86), Ptype> {
     int cround = ROUNDUP(oc, block);
     oc_expand_ = cround;
     // [chout, chin, wh, ww] -> [chout / block, chin, wh, ww, block]
-    weights_.Resize({cround / block, ic, wh, ww, block});
-    auto filter_data = param.filter->template data<float>();
-    auto weights_w_data = weights_.mutable_data<float>();
-    lite::x86::math::conv_trans_weights_numc(
-        filter_data, weights_w_data, oc, ic, wh, ww, block);
+    weights_ = PackedWeightCache::Global().Get(
+        *param.filter,
+        string_format("x86.conv_trans_weights_numc block=%d", block),
+        [=](const Tensor& filter, Tensor* weights) {
+          weights->Resize({cround / block, ic, wh, ww, block});
+          lite::x86::math::conv_trans_weights_numc(
+              filter.template data<float>(),
+              weights->template mutable_data<float>(),
+              oc,
+              ic,
+              wh,
+              ww,
+              block);
+        });
 
     auto x_dims = param.x->dims();
     auto w_dims = param.filter->dims();
@@ -88,7 +99,8 @@ class DirectConv : public KernelLite<TARGET(kX86), Ptype> {
 
  private:
   using param_t = operators::ConvParam;
-  Tensor weights_;
+  // The filter blocked by the output channels, shared by the clones
+  std::shared_ptr<const Tensor> weights_;
   Tensor bias_;
   Tensor trans_in_;
   bool flag_trans_weights_{false};
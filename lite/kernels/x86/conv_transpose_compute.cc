@@ -115,10 +115,10 @@ void Conv2DTransposeCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
                 : nullptr;
   float* col_data = nullptr;
 
-  if (!flag_1x1s1p1) {
+  if (!flag_1x1s1p1 && !depthwise_s1 && !depthwise_s2) {
     int col_size = param.groups * group_size_coldata;
-    col_data = static_cast<float*>(
-        TargetMalloc(TARGET(kX86), col_size * sizeof(float)));
+    ctx.ExtendWorkspace(col_size * sizeof(float));
+    col_data = ctx.workspace_data<float>();
   }
 
   for (int i = 0; i < num; i++) {
@@ -174,7 +174,6 @@ void Conv2DTransposeCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
     lite::x86::math::fill_bias_act(
         dout_batch, bias_ptr, chout, wout * hout, flag_bias, &act_param);
   }
-  if (!flag_1x1s1p1) TargetFree(TARGET(kX86), col_data);
 }
 
 }  // namespace x86
@@ -0,0 +1,104 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/conv_winograd.h"
+#include <algorithm>
+#include "lite/backends/x86/math/conv_winograd.h"
+#include "lite/backends/x86/math/fill_bias_activate.h"
+#include "lite/core/packed_weight_cache.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <>
+void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  auto o_dims = param.output->dims();
+  int chout = param.filter->dims()[0];
+  int chin = param.filter->dims()[1];
+  // F(6x6, 3x3) needs less work per output, but wastes more of the last
+  // tiles on small feature maps and is a bit less accurate
+  unit_ = std::min(o_dims[2], o_dims[3]) >= 12 ? 6 : 4;
+  int unit = unit_;
+  weights_ = PackedWeightCache::Global().Get(
+      *param.filter,
+      string_format("x86.conv_winograd3x3 unit=%d", unit),
+      [=](const Tensor& filter, Tensor* weights) {
+        weights->Resize({lite::x86::math::conv_winograd3x3_weights_size(
+            unit, chout, chin)});
+        lite::x86::math::conv_winograd3x3_trans_weights(
+            unit,
+            filter.data<float>(),
+            weights->mutable_data<float>(),
+            chout,
+            chin);
+      });
+}
+
+template <>
+void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
+  auto& param = this->Param<param_t>();
+  CHECK(this->ctx_);
+  auto& ctx = this->ctx_->template As<X86Context>();
+
+  auto x_dims = param.x->dims();
+  auto o_dims = param.output->dims();
+  int bs = x_dims[0];
+  int ic = x_dims[1];
+  int ih = x_dims[2];
+  int iw = x_dims[3];
+  int oc = o_dims[1];
+  int oh = o_dims[2];
+  int ow = o_dims[3];
+  auto paddings = *param.paddings;
+
+  const auto* i_data = param.x->data<float>();
+  const auto* b_data = param.bias ? param.bias->data<float>() : nullptr;
+  auto* o_data = param.output->mutable_data<float>();
+  bool flag_bias = param.bias != nullptr;
+  auto act_param = param.activation_param;
+
+  lite::x86::math::conv_winograd3x3(unit_,
+                                    i_data,
+                                    o_data,
+                                    bs,
+                                    oc,
+                                    oh,
+                                    ow,
+                                    ic,
+                                    ih,
+                                    iw,
+                                    paddings[0],
+                                    paddings[2],
+                                    weights_->data<float>(),
+                                    &ctx);
+  for (int i = 0; i < bs; i++) {
+    lite::x86::math::fill_bias_act(o_data + i * oc * oh * ow,
+                                   b_data,
+                                   oc,
+                                   oh * ow,
+                                   flag_bias,
+                                   &act_param);
+  }
+#ifdef LITE_WITH_PROFILE
+  kernel_func_name_ = "conv_winograd3x3";
+#endif
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
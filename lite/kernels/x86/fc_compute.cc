@@ -14,7 +14,9 @@
 
 #include "lite/kernels/x86/fc_compute.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/backends/x86/math/gemm_weight_only.h"
 #include "lite/backends/x86/math/saturate.h"
+#include "lite/core/packed_weight_cache.h"
 
 namespace paddle {
 namespace lite {
@@ -63,7 +65,8 @@ class FCFunctor {
                   T* Y,
                   const T* B = nullptr,
                   bool relu = false,
-                  bool padding_weights = false) {
+                  bool padding_weights = false,
+                  const float* W_packed = nullptr) {
     auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
     T* Y1_data = nullptr;
 
@@ -130,7 +133,25 @@ class FCFunctor {
       }
       parallel_compute(0, M);
     } else {
-      blas.MatMul(M, N, K, X, W, Y);
+      if (W_packed) {
+        lite::x86::math::sgemm(false,
+                               false,
+                               M,
+                               N,
+                               K,
+                               1.f,
+                               X,
+                               K,
+                               W,
+                               N,
+                               0.f,
+                               Y,
+                               N,
+                               nullptr,
+                               W_packed);
+      } else {
+        blas.MatMul(M, N, K, X, W, Y);
+      }
       if (!B) {
         return;
       }
@@ -139,6 +160,55 @@ class FCFunctor {
   }
 };
 
+template <>
+void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+  auto& param = *param_.get_mutable<param_t>();
+  auto* w = param.w;
+  // The weights quantized by post_quant_dynamic_pass stay int8 or int4
+  if (w->precision() == PRECISION(kInt8)) {
+    int bits = param.bit_length;
+    CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+    int ldw = w->dims()[1];
+    int K = param.padding_weights ? w->dims()[0] - 4 : w->dims()[0];
+    int N = param.padding_weights ? ldw - 4 : ldw;
+    CHECK_GE(param.weight_scale.size(), static_cast<size_t>(N));
+    weight_only_bits_ = bits;
+    packed_w_ = PackedWeightCache::Global().Get(
+        *w,
+        string_format("x86.weight_only_pack bits=%d k=%d n=%d", bits, K, N),
+        [=](const Tensor& weight, Tensor* packed) {
+          int64_t size = lite::x86::math::weight_only_packed_size(bits, K, N);
+          packed->Resize({size});
+          lite::x86::math::pack_weight_only(bits,
+                                            K,
+                                            N,
+                                            weight.data<int8_t>(),
+                                            ldw,
+                                            packed->mutable_data<uint8_t>());
+        });
+    return;
+  }
+  // Pack the constant weights once, the padded weights keep using Blas
+  if (!lite::x86::math::use_packed_sgemm() || param.padding_weights ||
+      !w->persistable()) {
+    return;
+  }
+  int K = w->dims()[0];
+  int N = w->dims()[1];
+  packed_w_ = PackedWeightCache::Global().Get(
+      *w,
+      string_format("x86.sgemm_pack_b k=%d n=%d", K, N),
+      [=](const Tensor& weight, Tensor* packed) {
+        packed->Resize({lite::x86::math::sgemm_packed_b_size(K, N)});
+        lite::x86::math::sgemm_pack_b(false,
+                                      K,
+                                      N,
+                                      weight.data<float>(),
+                                      N,
+                                      packed->mutable_data<float>());
+      });
+}
+
 template <>
 void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   auto& param = *param_.get_mutable<param_t>();
@@ -156,8 +226,23 @@ void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   int M = output->dims().production() / w_dims1;
 
   const float* input_data = input->template data<float>();
-  const float* w_data = w->template data<float>();
   float* output_data = output->template mutable_data<float>();
+  if (weight_only_bits_) {
+    lite::x86::math::gemm_weight_only(weight_only_bits_,
+                                      M,
+                                      w_dims1,
+                                      w_dims0,
+                                      input_data,
+                                      w_dims0,
+                                      packed_w_->data<uint8_t>(),
+                                      param.weight_scale.data(),
+                                      bias ? bias->data<float>() : nullptr,
+                                      with_relu,
+                                      output_data,
+                                      w_dims1);
+    return;
+  }
+  const float* w_data = w->template data<float>();
 
   auto& context = ctx_->As<X86Context>();
   FCFunctor<lite::TargetType::kX86, float> fc;
@@ -170,7 +255,8 @@ void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
      output_data,
      bias ? bias->template data<float>() : NULL,
      with_relu,
-     padding_weights);
+     padding_weights,
+     packed_w_ ? packed_w_->data<float>() : nullptr);
 }
 
 template <>
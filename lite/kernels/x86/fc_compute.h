@@ -14,11 +14,13 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include "lite/backends/x86/jit/helper.h"
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/packed_sgemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
@@ -35,11 +37,23 @@ class FcCompute : public KernelLite<TARGET(kX86), PType> {
  public:
   using param_t = operators::FcParam;
 
+  virtual void PrepareForRun() {}
+
   virtual void Run();
 
   virtual ~FcCompute() = default;
+
+ private:
+  // The constant weights packed by sgemm_pack_b, null if not packed.
+  std::shared_ptr<const lite::Tensor> packed_w_;
+  // The bits of the int8 or int4 weights of post_quant_dynamic_pass, which
+  // are packed by pack_weight_only, 0 for the fp32 weights.
+  int weight_only_bits_{0};
 };
 
+template <>
+void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun();
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,320 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_multi_head_attention_compute.h"
+#ifdef __AVX__
+#include <immintrin.h>
+#include "lite/backends/x86/math/avx/avx_mathfuns.h"
+#endif
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/packed_sgemm.h"
+#include "lite/core/parallel_defines.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace {
+
+// row = softmax(row + mask), the mask is read with a stride of `mask_step`
+// which is 0 if it's broadcast along the row.
+void MaskedSoftmax(float* row, const float* mask, int mask_step, int len) {
+  if (mask != nullptr) {
+    if (mask_step == 1) {
+      for (int j = 0; j < len; ++j) row[j] += mask[j];
+    } else {
+      for (int j = 0; j < len; ++j) row[j] += mask[j * mask_step];
+    }
+  }
+  int j = 0;
+  float max_val = -FLT_MAX;
+#ifdef __AVX__
+  __m256 vmax = _mm256_set1_ps(-FLT_MAX);
+  for (; j + 8 <= len; j += 8) {
+    vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(row + j));
+  }
+  float lanes[8];
+  _mm256_storeu_ps(lanes, vmax);
+  for (int k = 0; k < 8; ++k) max_val = std::max(max_val, lanes[k]);
+#endif
+  for (; j < len; ++j) max_val = std::max(max_val, row[j]);
+
+  j = 0;
+  float sum = 0.f;
+#ifdef __AVX__
+  vmax = _mm256_set1_ps(max_val);
+  __m256 vsum = _mm256_setzero_ps();
+  for (; j + 8 <= len; j += 8) {
+    __m256 v = lite::x86::math::exp256_ps(
+        _mm256_sub_ps(_mm256_loadu_ps(row + j), vmax));
+    _mm256_storeu_ps(row + j, v);
+    vsum = _mm256_add_ps(vsum, v);
+  }
+  _mm256_storeu_ps(lanes, vsum);
+  for (int k = 0; k < 8; ++k) sum += lanes[k];
+#endif
+  for (; j < len; ++j) {
+    row[j] = std::exp(row[j] - max_val);
+    sum += row[j];
+  }
+
+  float scale = 1.f / sum;
+  j = 0;
+#ifdef __AVX__
+  __m256 vscale = _mm256_set1_ps(scale);
+  for (; j + 8 <= len; j += 8) {
+    _mm256_storeu_ps(row + j, _mm256_mul_ps(_mm256_loadu_ps(row + j), vscale));
+  }
+#endif
+  for (; j < len; ++j) row[j] *= scale;
+}
+
+}  // namespace
+
+void FusedMultiHeadAttentionCompute::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  const int hidden = param.q_weight->dims()[0];
+  const int dim = param.q_weight->dims()[1];
+  const float* weights[3] = {param.q_weight->data<float>(),
+                             param.k_weight->data<float>(),
+                             param.v_weight->data<float>()};
+  const float* biases[3] = {param.q_bias->data<float>(),
+                            param.k_bias->data<float>(),
+                            param.v_bias->data<float>()};
+  qkv_weight_.Resize({hidden, 3 * dim});
+  qkv_bias_.Resize({3 * dim});
+  float* qkv_weight = qkv_weight_.mutable_data<float>();
+  float* qkv_bias = qkv_bias_.mutable_data<float>();
+  for (int i = 0; i < 3; ++i) {
+    for (int r = 0; r < hidden; ++r) {
+      memcpy(qkv_weight + r * 3 * dim + i * dim,
+             weights[i] + r * dim,
+             sizeof(float) * dim);
+    }
+    memcpy(qkv_bias + i * dim, biases[i], sizeof(float) * dim);
+  }
+
+  if (lite::x86::math::use_packed_sgemm()) {
+    const int out_dim = param.out_weight->dims()[1];
+    packed_qkv_weight_.Resize(
+        {lite::x86::math::sgemm_packed_b_size(hidden, 3 * dim)});
+    lite::x86::math::sgemm_pack_b(false,
+                                  hidden,
+                                  3 * dim,
+                                  qkv_weight,
+                                  3 * dim,
+                                  packed_qkv_weight_.mutable_data<float>());
+    packed_out_weight_.Resize(
+        {lite::x86::math::sgemm_packed_b_size(dim, out_dim)});
+    lite::x86::math::sgemm_pack_b(false,
+                                  dim,
+                                  out_dim,
+                                  param.out_weight->data<float>(),
+                                  out_dim,
+                                  packed_out_weight_.mutable_data<float>());
+  }
+}
+
+void FusedMultiHeadAttentionCompute::Run() {
+  auto& ctx = this->ctx_->template As<X86Context>();
+  auto& param = this->Param<param_t>();
+  auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, float>(ctx);
+  const auto input_dims = param.input->dims();
+  const int batch = input_dims[0];
+  const int seq_len = input_dims[1];
+  const int hidden = input_dims[2];
+  const int heads = param.head_num;
+  const int dim = param.q_weight->dims()[1];
+  const int head_dim = dim / heads;
+  const int out_dim = param.out_weight->dims()[1];
+  const int rows = batch * seq_len;
+  const int qkv_dim = 3 * dim;
+
+  // C[m, n] = A[m, k] * W[k, n] + bias
+  auto linear = [&](int m,
+                    int n,
+                    int k,
+                    const float* a,
+                    const float* w,
+                    const Tensor& packed_w,
+                    const float* bias,
+                    float* c) {
+    if (packed_w.numel() > 0) {
+      lite::x86::math::sgemm(false,
+                             false,
+                             m,
+                             n,
+                             k,
+                             1.f,
+                             a,
+                             k,
+                             w,
+                             n,
+                             0.f,
+                             c,
+                             n,
+                             nullptr,
+                             packed_w.data<float>());
+    } else {
+      blas.GEMM(false, false, m, n, k, 1.f, a, k, w, n, 0.f, c, n);
+    }
+    LITE_PARALLEL_BEGIN(i, tid, m) {
+      float* c_row = c + static_cast<int64_t>(i) * n;
+      for (int j = 0; j < n; ++j) c_row[j] += bias[j];
+    }
+    LITE_PARALLEL_END();
+  };
+
+  // q, k, v of all the heads: [batch, seq_len, 3, heads, head_dim]
+  qkv_.Resize({rows, qkv_dim});
+  float* qkv = qkv_.mutable_data<float>();
+  linear(rows,
+         qkv_dim,
+         hidden,
+         param.input->data<float>(),
+         qkv_weight_.data<float>(),
+         packed_qkv_weight_,
+         qkv_bias_.data<float>(),
+         qkv);
+
+  // scores = alpha * q * k^T of every [batch, head]
+  const int batch_heads = batch * heads;
+  scores_.Resize({batch_heads, seq_len, seq_len});
+  context_.Resize({rows, dim});
+  float* scores = scores_.mutable_data<float>();
+  float* context = context_.mutable_data<float>();
+  std::vector<const float*> a_array(batch_heads), b_array(batch_heads);
+  std::vector<float*> c_array(batch_heads);
+  for (int b = 0; b < batch; ++b) {
+    for (int h = 0; h < heads; ++h) {
+      int i = b * heads + h;
+      const float* q = qkv + static_cast<int64_t>(b) * seq_len * qkv_dim +
+                       h * head_dim;
+      a_array[i] = q;
+      b_array[i] = q + dim;
+      c_array[i] = scores + static_cast<int64_t>(i) * seq_len * seq_len;
+    }
+  }
+  blas.BatchedGEMM(false,
+                   true,
+                   seq_len,
+                   seq_len,
+                   head_dim,
+                   param.alpha,
+                   a_array.data(),
+                   qkv_dim,
+                   b_array.data(),
+                   qkv_dim,
+                   0.f,
+                   c_array.data(),
+                   seq_len,
+                   batch_heads);
+
+  // The mask is broadcast to [batch, heads, seq_len, seq_len]
+  const float* mask = nullptr;
+  int64_t mask_strides[4] = {0, 0, 0, 0};
+  if (param.mask != nullptr) {
+    mask = param.mask->data<float>();
+    const auto mask_dims = param.mask->dims();
+    const int64_t full_dims[4] = {batch, heads, seq_len, seq_len};
+    int64_t stride = 1;
+    for (int i = 3, j = mask_dims.size() - 1; j >= 0; --i, --j) {
+      CHECK(mask_dims[j] == full_dims[i] || mask_dims[j] == 1)
+          << "The mask(" << mask_dims << ") can not be broadcast to [" << batch
+          << ", " << heads << ", " << seq_len << ", " << seq_len << "]";
+      mask_strides[i] = mask_dims[j] == 1 ? 0 : stride;
+      stride *= mask_dims[j];
+    }
+  }
+  LITE_PARALLEL_BEGIN(r, tid, batch_heads * seq_len) {
+    int i = r % seq_len;
+    int h = (r / seq_len) % heads;
+    int b = r / seq_len / heads;
+    const float* mask_row =
+        mask == nullptr ? nullptr
+                        : mask + b * mask_strides[0] + h * mask_strides[1] +
+                              i * mask_strides[2];
+    MaskedSoftmax(scores + static_cast<int64_t>(r) * seq_len,
+                  mask_row,
+                  mask_strides[3],
+                  seq_len);
+  }
+  LITE_PARALLEL_END();
+
+  // context of every head = scores * v, written in place of the concatenated
+  // heads: [batch, seq_len, heads, head_dim]
+  for (int b = 0; b < batch; ++b) {
+    for (int h = 0; h < heads; ++h) {
+      int i = b * heads + h;
+      a_array[i] = c_array[i];
+      b_array[i] = qkv + static_cast<int64_t>(b) * seq_len * qkv_dim +
+                   2 * dim + h * head_dim;
+      c_array[i] =
+          context + static_cast<int64_t>(b) * seq_len * dim + h * head_dim;
+    }
+  }
+  blas.BatchedGEMM(false,
+                   false,
+                   seq_len,
+                   head_dim,
+                   seq_len,
+                   1.f,
+                   a_array.data(),
+                   seq_len,
+                   b_array.data(),
+                   qkv_dim,
+                   0.f,
+                   c_array.data(),
+                   dim,
+                   batch_heads);
+
+  linear(rows,
+         out_dim,
+         dim,
+         context,
+         param.out_weight->data<float>(),
+         packed_out_weight_,
+         param.out_bias->data<float>(),
+         param.output->mutable_data<float>());
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fused_multi_head_attention,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::FusedMultiHeadAttentionCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("QWeight", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("KWeight", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("VWeight", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("QBias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("KBias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("VBias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("OutWeight", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("OutBias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Mask", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,62 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/*
+ * The q, k and v projections run as one GEMM on the weights concatenated in
+ * PrepareForRun, the scores and the weighted sums of all the heads as two
+ * batched GEMMs that read the heads in place, so no transpose is
+ * materialized. The mask and the softmax are applied row by row in between.
+ */
+class FusedMultiHeadAttentionCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FusedMultiHeadAttentionParam;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~FusedMultiHeadAttentionCompute() = default;
+
+ private:
+  // [hidden, 3 * head_num * head_dim] and [3 * head_num * head_dim]
+  Tensor qkv_weight_;
+  Tensor qkv_bias_;
+  // qkv_weight_ and the out weight packed by sgemm_pack_b, empty if the
+  // packed sgemm is not used
+  Tensor packed_qkv_weight_;
+  Tensor packed_out_weight_;
+  // [batch * seq_len, 3 * head_num * head_dim]
+  Tensor qkv_;
+  // [batch * head_num, seq_len, seq_len]
+  Tensor scores_;
+  // [batch * seq_len, head_num * head_dim]
+  Tensor context_;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
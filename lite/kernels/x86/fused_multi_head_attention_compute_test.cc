@@ -0,0 +1,176 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/fused_multi_head_attention_compute.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// y[rows, n] = x[rows, k] * w[k, n] + b[n]
+static std::vector<float> Linear(const float* x,
+                                 const Tensor& w,
+                                 const Tensor& b,
+                                 int rows) {
+  int k = w.dims()[0], n = w.dims()[1];
+  std::vector<float> y(rows * n);
+  for (int r = 0; r < rows; ++r) {
+    for (int j = 0; j < n; ++j) {
+      float sum = b.data<float>()[j];
+      for (int l = 0; l < k; ++l) {
+        sum += x[r * k + l] * w.data<float>()[l * n + j];
+      }
+      y[r * n + j] = sum;
+    }
+  }
+  return y;
+}
+
+static void TestAttention(int batch,
+                          int seq_len,
+                          int hidden,
+                          int heads,
+                          int head_dim,
+                          const std::vector<int64_t>& mask_shape) {
+  const int dim = heads * head_dim, out_dim = hidden;
+  const int rows = batch * seq_len;
+  const float alpha = 1.f / std::sqrt(static_cast<float>(head_dim));
+  Tensor input, weights[4], biases[4], mask, output;
+  input.Resize({batch, seq_len, hidden});
+  for (int i = 0; i < 3; ++i) {
+    weights[i].Resize({hidden, dim});
+    biases[i].Resize({dim});
+  }
+  weights[3].Resize({dim, out_dim});
+  biases[3].Resize({out_dim});
+  std::vector<Tensor*> tensors{&input};
+  for (int i = 0; i < 4; ++i) {
+    tensors.push_back(&weights[i]);
+    tensors.push_back(&biases[i]);
+  }
+  if (!mask_shape.empty()) {
+    mask.Resize(mask_shape);
+    tensors.push_back(&mask);
+  }
+  for (auto* tensor : tensors) {
+    fill_data_rand(
+        tensor->mutable_data<float>(), -0.5f, 0.5f, tensor->numel());
+  }
+  output.Resize({batch, seq_len, out_dim});
+
+  operators::FusedMultiHeadAttentionParam param;
+  param.input = &input;
+  param.q_weight = &weights[0];
+  param.k_weight = &weights[1];
+  param.v_weight = &weights[2];
+  param.out_weight = &weights[3];
+  param.q_bias = &biases[0];
+  param.k_bias = &biases[1];
+  param.v_bias = &biases[2];
+  param.out_bias = &biases[3];
+  param.mask = mask_shape.empty() ? nullptr : &mask;
+  param.output = &output;
+  param.head_num = heads;
+  param.alpha = alpha;
+  FusedMultiHeadAttentionCompute attention;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  attention.SetContext(std::move(ctx));
+  attention.SetParam(param);
+  attention.PrepareForRun();
+  attention.Run();
+
+  const float* x = input.data<float>();
+  auto q = Linear(x, weights[0], biases[0], rows);
+  auto k = Linear(x, weights[1], biases[1], rows);
+  auto v = Linear(x, weights[2], biases[2], rows);
+  // the mask aligned to [batch, heads, seq_len, seq_len]
+  std::vector<int64_t> mask_dims(4 - mask_shape.size(), 1);
+  mask_dims.insert(mask_dims.end(), mask_shape.begin(), mask_shape.end());
+  std::vector<float> context(rows * dim);
+  std::vector<float> scores(seq_len);
+  for (int b = 0; b < batch; ++b) {
+    for (int h = 0; h < heads; ++h) {
+      for (int i = 0; i < seq_len; ++i) {
+        float max_val = -1e30f;
+        for (int j = 0; j < seq_len; ++j) {
+          float sum = 0.f;
+          for (int l = 0; l < head_dim; ++l) {
+            sum += q[(b * seq_len + i) * dim + h * head_dim + l] *
+                   k[(b * seq_len + j) * dim + h * head_dim + l];
+          }
+          scores[j] = sum * alpha;
+          if (!mask_shape.empty()) {
+            int64_t idx[4] = {b, h, i, j};
+            int64_t offset = 0;
+            for (int d = 0; d < 4; ++d) {
+              offset = offset * mask_dims[d] + (mask_dims[d] == 1 ? 0 : idx[d]);
+            }
+            scores[j] += mask.data<float>()[offset];
+          }
+          max_val = std::max(max_val, scores[j]);
+        }
+        float sum = 0.f;
+        for (int j = 0; j < seq_len; ++j) {
+          scores[j] = std::exp(scores[j] - max_val);
+          sum += scores[j];
+        }
+        for (int l = 0; l < head_dim; ++l) {
+          float acc = 0.f;
+          for (int j = 0; j < seq_len; ++j) {
+            acc += scores[j] / sum *
+                   v[(b * seq_len + j) * dim + h * head_dim + l];
+          }
+          context[(b * seq_len + i) * dim + h * head_dim + l] = acc;
+        }
+      }
+    }
+  }
+  auto ref = Linear(context.data(), weights[3], biases[3], rows);
+  for (int i = 0; i < rows * out_dim; ++i) {
+    EXPECT_NEAR(output.data<float>()[i], ref[i], 1e-4);
+  }
+}
+
+TEST(fused_multi_head_attention_x86, retrive_op) {
+  auto attention =
+      KernelRegistry::Global().Create("fused_multi_head_attention");
+  ASSERT_FALSE(attention.empty());
+  ASSERT_TRUE(attention.front());
+}
+
+TEST(fused_multi_head_attention_x86, run_test) {
+  TestAttention(2, 7, 32, 4, 8, {});
+  TestAttention(2, 13, 48, 3, 16, {2, 1, 1, 13});
+  TestAttention(1, 20, 24, 2, 12, {1, 2, 20, 20});
+  TestAttention(3, 1, 16, 2, 8, {3, 1, 1, 1});
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_multi_head_attention, kX86, kFloat, kNCHW, def);
@@ -13,6 +13,7 @@
 // limitations under the License.
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <vector>
 #include "lite/backends/x86/fluid/eigen.h"
@@ -36,16 +37,19 @@ namespace x86 {
 
 using Tensor = lite::Tensor;
 
+// dst[i] = src[index_lod[i]], dst has as many rows as src.
 template <typename T>
-inline void ReorderInitState(const lite::Context<TARGET(kX86)>& context,
-                             const Tensor& src,
+inline void ReorderInitState(const Tensor& src,
                              const std::vector<uint64_t>& index_lod,
-                             Tensor* dst,
-                             bool indexed_src) {
-  lite::x86::math::CopyMatrixRowsFunctor<TARGET(kX86), T> row_shuffle;
-  dst->Resize(src.dims());
-  dst->template mutable_data<T>();
-  row_shuffle(context, src, index_lod, dst, indexed_src);
+                             T* dst) {
+  const T* src_data = src.template data<T>();
+  const int64_t height = src.dims()[0];
+  const int64_t width = src.dims()[1];
+  for (int64_t i = 0; i < height; ++i) {
+    std::memcpy(dst + i * width,
+                src_data + index_lod[i] * width,
+                width * sizeof(T));
+  }
 }
 
 static inline int64_t CalculateSeqWidth(const DDim& dims) {
@@ -94,15 +98,16 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     gru_value.gate_weight = const_cast<T*>(weight_data);
     gru_value.state_weight =
         const_cast<T*>(weight_data + 2 * frame_size * frame_size);
-    Tensor ordered_h0;
 
     if (h0) {
       // Since the batch computing for GRU reorders the input sequences
       // according to their length. The initialized cell state also needs
       // to reorder.
       const std::vector<uint64_t>& order(batch_gate->lod()[2]);
-      ReorderInitState<T>(context, *h0, order, &ordered_h0, true);
-      gru_value.prev_out_value = ordered_h0.mutable_data<T>();
+      context.ExtendWorkspace(h0->numel() * sizeof(T));
+      T* ordered_h0 = context.workspace_data<T>();
+      ReorderInitState<T>(*h0, order, ordered_h0);
+      gru_value.prev_out_value = ordered_h0;
     } else {
       gru_value.prev_out_value = nullptr;
     }
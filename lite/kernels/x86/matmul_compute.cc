@@ -13,6 +13,64 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/matmul_compute.h"
+#include <algorithm>
+#include <vector>
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void MatMulInt8Compute::Run() {
+  auto &param = *param_.get_mutable<operators::MatMulParam>();
+  auto *x = param.X;
+  auto *y = param.Y;
+  auto mat_dim_a = lite::x86::math::CreateMatrixDescriptor(
+      RowMatrixFromVector(x->dims()), 0, param.transpose_X);
+  auto mat_dim_b = lite::x86::math::CreateMatrixDescriptor(
+      ColumnMatrixFromVector(y->dims()), 0, param.transpose_Y);
+  CHECK_EQ(mat_dim_a.width_, mat_dim_b.height_);
+  CHECK(mat_dim_a.batch_size_ == mat_dim_b.batch_size_ ||
+        mat_dim_a.batch_size_ == 0 || mat_dim_b.batch_size_ == 0);
+
+  std::vector<float> y_scale;
+  const int8_t *y_data = lite::x86::math::gemm_s8u8_dynamic_b(
+      *y, param.transpose_Y, param.weight_scale, &y_s8_, &y_scale);
+  const float *x_data = x->data<float>();
+  float *o_data = param.Out->mutable_data<float>();
+
+  int m = mat_dim_a.height_;
+  int n = mat_dim_b.width_;
+  int k = mat_dim_a.width_;
+  int lda = mat_dim_a.trans_ ? m : k;
+  int batch = std::max(mat_dim_a.batch_size_, mat_dim_b.batch_size_);
+  if (mat_dim_b.batch_size_ == 0 && !mat_dim_a.trans_) {
+    // x: [B, M, K] is a single [B * M, K] matrix
+    m *= std::max(batch, 1);
+    batch = 0;
+  }
+  int64_t out_stride = static_cast<int64_t>(m) * n;
+  for (int i = 0; i < std::max(batch, 1); ++i) {
+    lite::x86::math::gemm_s8u8_dynamic(mat_dim_a.trans_,
+                                       mat_dim_b.trans_,
+                                       m,
+                                       n,
+                                       k,
+                                       param.alpha,
+                                       x_data + i * mat_dim_a.stride_,
+                                       lda,
+                                       y_data + i * mat_dim_b.stride_,
+                                       y_scale.data(),
+                                       y_scale.size(),
+                                       o_data + i * out_stride);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
 
 REGISTER_LITE_KERNEL(matmul,
                      kX86,
@@ -24,3 +82,14 @@ REGISTER_LITE_KERNEL(matmul,
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(matmul,
+                     kX86,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::x86::MatMulInt8Compute,
+                     fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
@@ -70,6 +70,21 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   virtual ~MatMulCompute() = default;
 };
 
+// The rows of X are quantized to int8 at runtime, Y is either the int8
+// weight with its channel wise scales or a float tensor quantized per tensor.
+class MatMulInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MatMulParam;
+
+  void Run() override;
+
+  virtual ~MatMulInt8Compute() = default;
+
+ private:
+  // The quantized Y if Y is float.
+  lite::Tensor y_s8_;
+};
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -14,13 +14,18 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "lite/core/op_registry.h"
+#include "lite/kernels/x86/bmm_compute.h"
 #include "lite/kernels/x86/matmul_compute.h"
+#include "lite/kernels/x86/matmul_v2_compute.h"
+#include "lite/tests/utils/fill_data.h"
 
 namespace paddle {
 namespace lite {
@@ -80,9 +85,208 @@ TEST(matmul_x86, run_test) {
   }
 }
 
+// out[b] = x[bx] * y[by], x: [xb, m, k], y: [yb, k, n], xb or yb may be 1
+static void batched_matmul_ref(const float* x,
+                               const float* y,
+                               float* out,
+                               int xb,
+                               int yb,
+                               int m,
+                               int n,
+                               int k) {
+  for (int b = 0; b < std::max(xb, yb); ++b) {
+    const float* xm = x + (xb == 1 ? 0 : b) * m * k;
+    const float* ym = y + (yb == 1 ? 0 : b) * k * n;
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < n; ++j) {
+        float sum = 0.f;
+        for (int l = 0; l < k; ++l) sum += xm[i * k + l] * ym[l * n + j];
+        out[(b * m + i) * n + j] = sum;
+      }
+    }
+  }
+}
+
+TEST(matmul_v2_x86, broadcast_batch) {
+  // x: [2, 3, m, k], y: [1, 3, k, n] and the reverse
+  const int m = 5, n = 9, k = 7;
+  for (bool broadcast_y : {true, false}) {
+    lite::Tensor x, y, out, out_ref;
+    x.Resize({broadcast_y ? 2 : 1, 3, m, k});
+    y.Resize({broadcast_y ? 1 : 2, 3, k, n});
+    out.Resize({2, 3, m, n});
+    out_ref.Resize({2, 3, m, n});
+    fill_data_rand(x.mutable_data<float>(), -0.5f, 0.5f, x.numel());
+    fill_data_rand(y.mutable_data<float>(), -0.5f, 0.5f, y.numel());
+
+    MatMulV2Compute<float> matmul;
+    operators::MatMulParam param;
+    param.X = &x;
+    param.Y = &y;
+    param.Out = &out;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    matmul.SetContext(std::move(ctx));
+    matmul.SetParam(param);
+    matmul.Run();
+
+    float* ref = out_ref.mutable_data<float>();
+    for (int b = 0; b < 2; ++b) {
+      for (int h = 0; h < 3; ++h) {
+        int xi = broadcast_y ? b * 3 + h : h;
+        int yi = broadcast_y ? h : b * 3 + h;
+        batched_matmul_ref(x.data<float>() + xi * m * k,
+                           y.data<float>() + yi * k * n,
+                           ref + (b * 3 + h) * m * n,
+                           1,
+                           1,
+                           m,
+                           n,
+                           k);
+      }
+    }
+    for (int64_t i = 0; i < out.numel(); i++) {
+      EXPECT_NEAR(out.data<float>()[i], ref[i], 1e-4);
+    }
+  }
+}
+
+TEST(bmm_x86, run_test) {
+  const int batch = 6, m = 4, n = 33, k = 17;
+  lite::Tensor x, y, out, out_ref;
+  x.Resize({batch, m, k});
+  y.Resize({batch, k, n});
+  out.Resize({batch, m, n});
+  out_ref.Resize({batch, m, n});
+  fill_data_rand(x.mutable_data<float>(), -0.5f, 0.5f, x.numel());
+  fill_data_rand(y.mutable_data<float>(), -0.5f, 0.5f, y.numel());
+
+  BmmCompute<float> bmm;
+  operators::BmmParam param;
+  param.X = &x;
+  param.Y = &y;
+  param.Out = &out;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  bmm.SetContext(std::move(ctx));
+  bmm.SetParam(param);
+  bmm.Run();
+
+  batched_matmul_ref(x.data<float>(),
+                     y.data<float>(),
+                     out_ref.mutable_data<float>(),
+                     batch,
+                     batch,
+                     m,
+                     n,
+                     k);
+  for (int64_t i = 0; i < out.numel(); i++) {
+    EXPECT_NEAR(out.data<float>()[i], out_ref.data<float>()[i], 1e-4);
+  }
+}
+
+// The int8 kernels quantize x per row at runtime, so they are compared to the
+// fp32 result with a tolerance relative to the largest output.
+static void check_int8_result(const lite::Tensor& out, const float* ref) {
+  float max_ref = 0.f;
+  for (int64_t i = 0; i < out.numel(); i++) {
+    max_ref = std::max(max_ref, std::fabs(ref[i]));
+  }
+  for (int64_t i = 0; i < out.numel(); i++) {
+    EXPECT_NEAR(out.data<float>()[i], ref[i], 2e-2f * max_ref);
+  }
+}
+
+TEST(matmul_v2_x86, int8_weight) {
+  // x: [2, m, k], y: int8 [k, n] with per column scales
+  const int m = 7, n = 19, k = 40;
+  lite::Tensor x, y, out, y_ref, out_ref;
+  x.Resize({2, m, k});
+  y.Resize({k, n});
+  y_ref.Resize({k, n});
+  out.Resize({2, m, n});
+  out_ref.Resize({2, m, n});
+  fill_data_rand(x.mutable_data<float>(), -0.5f, 0.5f, x.numel());
+  std::vector<float> weight_scale(n);
+  for (int j = 0; j < n; j++) weight_scale[j] = 0.01f * (j % 4 + 1);
+  auto* y_data = y.mutable_data<int8_t>();
+  auto* y_ref_data = y_ref.mutable_data<float>();
+  for (int i = 0; i < k * n; i++) {
+    y_data[i] = static_cast<int8_t>((i * 13) % 255 - 127);
+    y_ref_data[i] = y_data[i] * weight_scale[i % n];
+  }
+
+  MatMulV2Int8Compute matmul;
+  operators::MatMulParam param;
+  param.X = &x;
+  param.Y = &y;
+  param.Out = &out;
+  param.enable_int8 = true;
+  param.weight_scale = weight_scale;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  matmul.SetContext(std::move(ctx));
+  matmul.SetParam(param);
+  matmul.Run();
+
+  batched_matmul_ref(x.data<float>(),
+                     y_ref_data,
+                     out_ref.mutable_data<float>(),
+                     2,
+                     1,
+                     m,
+                     n,
+                     k);
+  check_int8_result(out, out_ref.data<float>());
+}
+
+TEST(matmul_x86, int8_activation) {
+  // q: [2, m, k] * k: [2, n, k]^T, both are activations
+  const int batch = 2, m = 9, n = 12, k = 33;
+  lite::Tensor x, y, out, y_t, out_ref;
+  x.Resize({batch, m, k});
+  y.Resize({batch, n, k});
+  y_t.Resize({batch, k, n});
+  out.Resize({batch, m, n});
+  out_ref.Resize({batch, m, n});
+  fill_data_rand(x.mutable_data<float>(), -0.5f, 0.5f, x.numel());
+  fill_data_rand(y.mutable_data<float>(), -0.5f, 0.5f, y.numel());
+  auto* y_t_data = y_t.mutable_data<float>();
+  for (int b = 0; b < batch; b++) {
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < k; j++) {
+        y_t_data[(b * k + j) * n + i] = y.data<float>()[(b * n + i) * k + j];
+      }
+    }
+  }
+
+  MatMulInt8Compute matmul;
+  operators::MatMulParam param;
+  param.X = &x;
+  param.Y = &y;
+  param.Out = &out;
+  param.transpose_Y = true;
+  param.alpha = 0.5f;
+  param.enable_int8 = true;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  matmul.SetContext(std::move(ctx));
+  matmul.SetParam(param);
+  matmul.Run();
+
+  float* ref = out_ref.mutable_data<float>();
+  batched_matmul_ref(x.data<float>(), y_t_data, ref, batch, batch, m, n, k);
+  for (int64_t i = 0; i < out_ref.numel(); i++) ref[i] *= 0.5f;
+  check_int8_result(out, ref);
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(matmul, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(matmul_v2, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(bmm, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(matmul, kX86, kInt8, kNCHW, fp32_out);
+USE_LITE_KERNEL(matmul_v2, kX86, kInt8, kNCHW, fp32_out);
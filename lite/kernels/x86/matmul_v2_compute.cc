@@ -13,6 +13,82 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/matmul_v2_compute.h"
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void MatMulV2Int8Compute::Run() {
+  auto& param = *param_.get_mutable<operators::MatMulParam>();
+  auto x_dims = param.X->dims();
+  auto y_dims = param.Y->dims();
+  bool x_transpose = param.transpose_X;
+  bool y_transpose = param.transpose_Y;
+  // A vector x is a row matrix and a vector y is a column matrix
+  if (x_dims.size() == 1) {
+    x_dims = DDim({1, x_dims[0]});
+    x_transpose = false;
+  }
+  if (y_dims.size() == 1) {
+    y_dims = DDim({y_dims[0], 1});
+    y_transpose = false;
+  }
+  int x_rank = x_dims.size();
+  int y_rank = y_dims.size();
+  int m = x_transpose ? x_dims[x_rank - 1] : x_dims[x_rank - 2];
+  int k = x_transpose ? x_dims[x_rank - 2] : x_dims[x_rank - 1];
+  int n = y_transpose ? y_dims[y_rank - 2] : y_dims[y_rank - 1];
+  CHECK_EQ(k, y_transpose ? y_dims[y_rank - 1] : y_dims[y_rank - 2])
+      << "The k of x(" << x_dims << ") and y(" << y_dims << ") mismatch";
+  int lda = x_transpose ? m : k;
+
+  std::vector<float> y_scale;
+  const int8_t* y_data = lite::x86::math::gemm_s8u8_dynamic_b(
+      *param.Y, y_transpose, param.weight_scale, &y_s8_, &y_scale);
+  const float* x_data = param.X->data<float>();
+  float* o_data = param.Out->mutable_data<float>();
+
+  if (y_rank == 2 && !x_transpose) {
+    // x: [B, M, K] is a single [B * M, K] matrix
+    lite::x86::math::gemm_s8u8_dynamic(false,
+                                       y_transpose,
+                                       m * x_dims.count(0, x_rank - 2),
+                                       n,
+                                       k,
+                                       param.alpha,
+                                       x_data,
+                                       lda,
+                                       y_data,
+                                       y_scale.data(),
+                                       y_scale.size(),
+                                       o_data);
+    return;
+  }
+  std::vector<int64_t> x_offsets, y_offsets;
+  BroadcastBatchOffsets(x_dims, y_dims, &x_offsets, &y_offsets);
+  int64_t out_stride = static_cast<int64_t>(m) * n;
+  for (size_t i = 0; i < x_offsets.size(); ++i) {
+    lite::x86::math::gemm_s8u8_dynamic(x_transpose,
+                                       y_transpose,
+                                       m,
+                                       n,
+                                       k,
+                                       param.alpha,
+                                       x_data + x_offsets[i],
+                                       lda,
+                                       y_data + y_offsets[i],
+                                       y_scale.data(),
+                                       y_scale.size(),
+                                       o_data + i * out_stride);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
 
 REGISTER_LITE_KERNEL(matmul_v2,
                      kX86,
@@ -24,3 +100,14 @@ REGISTER_LITE_KERNEL(matmul_v2,
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(matmul_v2,
+                     kX86,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::x86::MatMulV2Int8Compute,
+                     fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
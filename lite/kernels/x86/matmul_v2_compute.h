@@ -13,9 +13,16 @@
 // limitations under the License.
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_weight_only.h"
+#include "lite/backends/x86/math/packed_sgemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/packed_weight_cache.h"
 #include "lite/core/types.h"
 namespace paddle {
 namespace lite {
@@ -54,13 +61,6 @@ namespace x86 {
           << "k must be equal y_dims[y_dims.size() - 1]";                    \
     }                                                                        \
     ldc = n;                                                                 \
-    if (x_dims.size() > 2 && y_dims.size() > 2) {                            \
-      auto sum_x = x_dims.count(0, x_dims.size() - 2);                       \
-      auto sum_y = y_dims.count(0, y_dims.size() - 2);                       \
-      CHECK_EQ(sum_x, sum_y)                                                 \
-          << "sum_x(x_dims[0]+..x_dims[size()-2]) must be equal with "       \
-             "sum_y(y_dims[0]+..y_dims[size()-2])";                          \
-    }                                                                        \
   } else if ((x_dims.size() == 2 && y_dims.size() == 2) ||                   \
              (x_dims.size() == 2 && y_dims.size() == 1)) {                   \
     if (!x_transpose) {                                                      \
@@ -143,12 +143,135 @@ namespace x86 {
                << " doesn't support!";                                       \
   }
 
+// The offsets of the matrices of x and y for every batch of the output,
+// the batch dims of x and y are broadcast against each other like numpy.
+static void BroadcastBatchOffsets(const DDim& x_dims,
+                                  const DDim& y_dims,
+                                  std::vector<int64_t>* x_offsets,
+                                  std::vector<int64_t>* y_offsets) {
+  int x_rank = x_dims.size() - 2;
+  int y_rank = y_dims.size() - 2;
+  int rank = std::max(x_rank, y_rank);
+  std::vector<int64_t> out_batch(rank);
+  std::vector<int64_t> x_strides(rank, 0);
+  std::vector<int64_t> y_strides(rank, 0);
+  int64_t x_stride = x_dims[x_rank] * x_dims[x_rank + 1];
+  int64_t y_stride = y_dims[y_rank] * y_dims[y_rank + 1];
+  for (int i = rank - 1; i >= 0; --i) {
+    int xi = i - (rank - x_rank);
+    int yi = i - (rank - y_rank);
+    int64_t x_dim = xi >= 0 ? x_dims[xi] : 1;
+    int64_t y_dim = yi >= 0 ? y_dims[yi] : 1;
+    CHECK(x_dim == y_dim || x_dim == 1 || y_dim == 1)
+        << "The batch dims of x(" << x_dims << ") and y(" << y_dims
+        << ") can not be broadcast";
+    out_batch[i] = std::max(x_dim, y_dim);
+    x_strides[i] = x_dim == 1 ? 0 : x_stride;
+    y_strides[i] = y_dim == 1 ? 0 : y_stride;
+    x_stride *= x_dim;
+    y_stride *= y_dim;
+  }
+  int64_t batch = 1;
+  for (auto dim : out_batch) batch *= dim;
+  x_offsets->assign(batch, 0);
+  y_offsets->assign(batch, 0);
+  for (int64_t b = 0; b < batch; ++b) {
+    int64_t index = b;
+    for (int i = rank - 1; i >= 0; --i) {
+      int64_t pos = index % out_batch[i];
+      index /= out_batch[i];
+      (*x_offsets)[b] += pos * x_strides[i];
+      (*y_offsets)[b] += pos * y_strides[i];
+    }
+  }
+}
+
 template <typename T>
 class MatMulV2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MatMulParam;
 
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<operators::MatMulParam>();
+    auto y_dims = param.Y->dims();
+    // The 2-D weights quantized by post_quant_dynamic_pass stay int8 or int4,
+    // their channel wise scales are the output columns unless transposed
+    if (std::is_same<T, float>::value &&
+        param.Y->precision() == PRECISION(kInt8)) {
+      CHECK(y_dims.size() == 2 && !param.transpose_X && !param.transpose_Y)
+          << "The int8 weight of matmul_v2 must be 2-D and not transposed";
+      int bits = param.bit_length;
+      CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+      int k = y_dims[0];
+      int n = y_dims[1];
+      CHECK_GE(param.weight_scale.size(), static_cast<size_t>(n));
+      weight_only_bits_ = bits;
+      weight_only_scale_.resize(n);
+      for (int i = 0; i < n; ++i) {
+        weight_only_scale_[i] = param.weight_scale[i] * param.alpha;
+      }
+      packed_y_ = PackedWeightCache::Global().Get(
+          *param.Y,
+          string_format("x86.weight_only_pack bits=%d k=%d n=%d", bits, k, n),
+          [=](const Tensor& y, Tensor* packed) {
+            packed->Resize(
+                {lite::x86::math::weight_only_packed_size(bits, k, n)});
+            lite::x86::math::pack_weight_only(
+                bits,
+                k,
+                n,
+                y.template data<int8_t>(),
+                n,
+                packed->template mutable_data<uint8_t>());
+          });
+      return;
+    }
+    // Pack the constant 2-D weights once
+    if (!std::is_same<T, float>::value ||
+        !lite::x86::math::use_packed_sgemm() || !param.Y->persistable() ||
+        y_dims.size() != 2) {
+      return;
+    }
+    bool y_transpose = param.transpose_Y;
+    int k = y_transpose ? y_dims[1] : y_dims[0];
+    int n = y_transpose ? y_dims[0] : y_dims[1];
+    int ldb = y_dims[1];
+    packed_y_ = PackedWeightCache::Global().Get(
+        *param.Y,
+        string_format("x86.sgemm_pack_b trans=%d k=%d n=%d", y_transpose, k, n),
+        [=](const Tensor& y, Tensor* packed) {
+          packed->Resize({lite::x86::math::sgemm_packed_b_size(k, n)});
+          lite::x86::math::sgemm_pack_b(y_transpose,
+                                        k,
+                                        n,
+                                        y.template data<float>(),
+                                        ldb,
+                                        packed->template mutable_data<float>());
+        });
+  }
+
   void Run() override {
+    if (weight_only_bits_) {
+      // x: [..., K], y: [K, N], out: [..., N] as a single gemm
+      auto& param = *param_.get_mutable<operators::MatMulParam>();
+      int k = param.Y->dims()[0];
+      int n = param.Y->dims()[1];
+      int m = param.X->numel() / k;
+      lite::x86::math::gemm_weight_only(
+          weight_only_bits_,
+          m,
+          n,
+          k,
+          param.X->template data<float>(),
+          k,
+          packed_y_->template data<uint8_t>(),
+          weight_only_scale_.data(),
+          nullptr,
+          false,
+          param.Out->template mutable_data<float>(),
+          n);
+      return;
+    }
     INIT_PARAM;
     const auto* x_data = param.X->template data<T>();
     const auto* y_data = param.Y->template data<T>();
@@ -165,74 +288,109 @@ class MatMulV2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       // or
       // x: [M, K], y: [B, ..., K, N], out: [B, ..., M, N]
       // x: [M, K], y: [B, K, N], out: [B, M, N]
+      // the batch dims of x and y may be broadcast, e.g.
+      // x: [B, H, M, K], y: [1, H, K, N], out: [B, H, M, N]
       int x_inner = x_dims[x_dims.size() - 2] * x_dims[x_dims.size() - 1];
-      int y_inner = y_dims[y_dims.size() - 2] * y_dims[y_dims.size() - 1];
       int out_inner = o_dims[o_dims.size() - 2] * o_dims[o_dims.size() - 1];
 
-      if (x_dims.size() > 2 && y_dims.size() > 2) {
-        for (size_t i = 0; i < x_dims.count(0, x_dims.size() - 2); ++i) {
-          blas.GEMM(x_transpose,
-                    y_transpose,
-                    m,
-                    n,
-                    k,
-                    alpha,
-                    x_data + i * x_inner,
-                    lda,
-                    y_data + i * y_inner,
-                    ldb,
-                    0.f,
-                    o_data + i * out_inner,
-                    ldc);
+      if (x_dims.size() > 2 && y_dims.size() == 2 && packed_y_) {
+        // All the batches share the packed y, and are a single gemm unless x
+        // is transposed
+        int batch = x_dims.count(0, x_dims.size() - 2);
+        int rows = x_transpose ? m : m * batch;
+        batch = x_transpose ? batch : 1;
+        for (int i = 0; i < batch; ++i) {
+          lite::x86::math::sgemm(x_transpose,
+                                 y_transpose,
+                                 rows,
+                                 n,
+                                 k,
+                                 alpha,
+                                 x_data + i * x_inner,
+                                 lda,
+                                 y_data,
+                                 ldb,
+                                 0.f,
+                                 o_data + i * out_inner,
+                                 ldc,
+                                 nullptr,
+                                 packed_y_->template data<float>());
         }
-      } else if (x_dims.size() > 2 && y_dims.size() == 2) {
-        for (size_t i = 0; i < x_dims.count(0, x_dims.size() - 2); ++i) {
-          blas.GEMM(x_transpose,
-                    y_transpose,
-                    m,
-                    n,
-                    k,
-                    alpha,
-                    x_data + i * x_inner,
-                    lda,
-                    y_data,
-                    ldb,
-                    0.f,
-                    o_data + i * out_inner,
-                    ldc);
-        }
-      } else if (x_dims.size() == 2 && y_dims.size() > 2) {
-        for (size_t i = 0; i < y_dims.count(0, y_dims.size() - 2); ++i) {
-          blas.GEMM(x_transpose,
-                    y_transpose,
-                    m,
-                    n,
-                    k,
-                    alpha,
-                    x_data,
-                    lda,
-                    y_data + i * y_inner,
-                    ldb,
-                    0.f,
-                    o_data + i * out_inner,
-                    ldc);
+      } else if (x_dims.size() > 2 && y_dims.size() == 2 && !x_transpose) {
+        // x: [B, M, K] is a single [B * M, K] matrix
+        blas.GEMM(false,
+                  y_transpose,
+                  m * x_dims.count(0, x_dims.size() - 2),
+                  n,
+                  k,
+                  alpha,
+                  x_data,
+                  lda,
+                  y_data,
+                  ldb,
+                  0.f,
+                  o_data,
+                  ldc);
+      } else {
+        // One batched gemm over the broadcast batch dims
+        std::vector<int64_t> x_offsets, y_offsets;
+        BroadcastBatchOffsets(x_dims, y_dims, &x_offsets, &y_offsets);
+        int batch = x_offsets.size();
+        std::vector<const T*> x_array(batch), y_array(batch);
+        std::vector<T*> o_array(batch);
+        for (int i = 0; i < batch; ++i) {
+          x_array[i] = x_data + x_offsets[i];
+          y_array[i] = y_data + y_offsets[i];
+          o_array[i] = o_data + i * out_inner;
         }
+        blas.BatchedGEMM(x_transpose,
+                         y_transpose,
+                         m,
+                         n,
+                         k,
+                         static_cast<T>(alpha),
+                         x_array.data(),
+                         lda,
+                         y_array.data(),
+                         ldb,
+                         static_cast<T>(0),
+                         o_array.data(),
+                         ldc,
+                         batch);
       }
     } else if (x_dims.size() == 2 && y_dims.size() == 2) {
       // x: [M, K], y: [K, N], out: [M, N]
-      blas.GEMM(x_transpose,
-                y_transpose,
-                m,
-                n,
-                k,
-                alpha,
-                x_data,
-                lda,
-                y_data,
-                ldb,
-                0.f,
-                o_data,
-                ldc);
+      if (packed_y_) {
+        lite::x86::math::sgemm(x_transpose,
+                               y_transpose,
+                               m,
+                               n,
+                               k,
+                               alpha,
+                               x_data,
+                               lda,
+                               y_data,
+                               ldb,
+                               0.f,
+                               o_data,
+                               ldc,
+                               nullptr,
+                               packed_y_->template data<float>());
+      } else {
+        blas.GEMM(x_transpose,
+                  y_transpose,
+                  m,
+                  n,
+                  k,
+                  alpha,
+                  x_data,
+                  lda,
+                  y_data,
+                  ldb,
+                  0.f,
+                  o_data,
+                  ldc);
+      }
     } else if (x_dims.size() >= 2 && y_dims.size() == 1) {
       // x: [B, M, K], y: [K], out: [B, M]
       blas.GEMM(x_transpose,
@@ -297,6 +455,31 @@ class MatMulV2Compute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   }
 
   virtual ~MatMulV2Compute() = default;
+
+ private:
+  // The constant 2-D y packed by sgemm_pack_b, null if not packed.
+  std::shared_ptr<const lite::Tensor> packed_y_;
+  // The bits of the int8 or int4 y of post_quant_dynamic_pass, which is
+  // packed by pack_weight_only, 0 for the fp32 y.
+  int weight_only_bits_{0};
+  // The channel wise scales of the int8 or int4 y multiplied by alpha
+  std::vector<float> weight_only_scale_;
+};
+
+// The rows of X are quantized to int8 at runtime, Y is either the int8
+// weight with its channel wise scales or a float tensor quantized per tensor.
+class MatMulV2Int8Compute
+    : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MatMulParam;
+
+  void Run() override;
+
+  virtual ~MatMulV2Int8Compute() = default;
+
+ private:
+  // The quantized Y if Y is float.
+  lite::Tensor y_s8_;
 };
 
 }  // namespace x86
@@ -13,6 +13,45 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/mul_compute.h"
+#include <vector>
+#include "lite/backends/x86/math/gemm_s8u8_dynamic.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void MulInt8Compute::Run() {
+  auto& param = *param_.get_mutable<operators::MulParam>();
+  auto x_dims = param.x->dims().Flatten2D(param.x_num_col_dims);
+  auto y_dims = param.y->dims().Flatten2D(param.y_num_col_dims);
+  int m = x_dims[0];
+  int k = x_dims[1];
+  int n = y_dims[1];
+  CHECK_EQ(k, y_dims[0]) << "The k of x(" << param.x->dims() << ") and y("
+                         << param.y->dims() << ") mismatch";
+
+  std::vector<float> y_scale;
+  const int8_t* y_data = lite::x86::math::gemm_s8u8_dynamic_b(
+      *param.y, false, param.weight_scale, &y_s8_, &y_scale);
+  lite::x86::math::gemm_s8u8_dynamic(false,
+                                     false,
+                                     m,
+                                     n,
+                                     k,
+                                     1.f,
+                                     param.x->data<float>(),
+                                     k,
+                                     y_data,
+                                     y_scale.data(),
+                                     y_scale.size(),
+                                     param.output->mutable_data<float>());
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
 
 REGISTER_LITE_KERNEL(mul,
                      kX86,
@@ -24,3 +63,14 @@ REGISTER_LITE_KERNEL(mul,
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(mul,
+                     kX86,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::x86::MulInt8Compute,
+                     fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
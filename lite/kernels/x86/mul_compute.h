@@ -13,9 +13,14 @@
 // limitations under the License.
 #pragma once
 
+#include <memory>
+#include <type_traits>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_weight_only.h"
+#include "lite/backends/x86/math/packed_sgemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/packed_weight_cache.h"
 #include "lite/core/types.h"
 namespace paddle {
 namespace lite {
@@ -39,6 +44,56 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MulParam;
 
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<operators::MulParam>();
+    auto* y = param.y;
+    auto y_dims = y->dims();
+    if (y_dims.size() > 2) {
+      y_dims = y_dims.Flatten2D(param.y_num_col_dims);
+    }
+    int K = y_dims[0];
+    int N = y_dims[1];
+    // The weights quantized by post_quant_dynamic_pass stay int8 or int4
+    if (std::is_same<T, float>::value && y->precision() == PRECISION(kInt8)) {
+      int bits = param.bit_length;
+      CHECK(bits == 8 || bits == 4) << "Unsupported weight bits " << bits;
+      CHECK_GE(param.weight_scale.size(), static_cast<size_t>(N));
+      weight_only_bits_ = bits;
+      packed_y_ = PackedWeightCache::Global().Get(
+          *y,
+          string_format("x86.weight_only_pack bits=%d k=%d n=%d", bits, K, N),
+          [=](const Tensor& weight, Tensor* packed) {
+            packed->Resize(
+                {lite::x86::math::weight_only_packed_size(bits, K, N)});
+            lite::x86::math::pack_weight_only(
+                bits,
+                K,
+                N,
+                weight.template data<int8_t>(),
+                N,
+                packed->template mutable_data<uint8_t>());
+          });
+      return;
+    }
+    // Pack the constant weights once
+    if (!std::is_same<T, float>::value ||
+        !lite::x86::math::use_packed_sgemm() || !y->persistable()) {
+      return;
+    }
+    packed_y_ = PackedWeightCache::Global().Get(
+        *y,
+        string_format("x86.sgemm_pack_b k=%d n=%d", K, N),
+        [=](const Tensor& weight, Tensor* packed) {
+          packed->Resize({lite::x86::math::sgemm_packed_b_size(K, N)});
+          lite::x86::math::sgemm_pack_b(false,
+                                        K,
+                                        N,
+                                        weight.template data<float>(),
+                                        N,
+                                        packed->template mutable_data<float>());
+        });
+  }
+
   void Run() override {
     auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<operators::MulParam>();
@@ -70,15 +125,74 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       z->Resize({x_matrix.dims()[0], y_matrix.dims()[1]});
     }
 
-    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
-
-    blas.MatMul(x_matrix, y_matrix, z);
+    if (weight_only_bits_) {
+      int M = x_matrix.dims()[0];
+      int K = x_matrix.dims()[1];
+      int N = y_matrix.dims()[1];
+      lite::x86::math::gemm_weight_only(weight_only_bits_,
+                                        M,
+                                        N,
+                                        K,
+                                        x_matrix.template data<float>(),
+                                        K,
+                                        packed_y_->template data<uint8_t>(),
+                                        param.weight_scale.data(),
+                                        nullptr,
+                                        false,
+                                        z->template mutable_data<float>(),
+                                        N);
+    } else if (packed_y_) {
+      int M = x_matrix.dims()[0];
+      int K = x_matrix.dims()[1];
+      int N = y_matrix.dims()[1];
+      lite::x86::math::sgemm(false,
+                             false,
+                             M,
+                             N,
+                             K,
+                             1.f,
+                             x_matrix.template data<float>(),
+                             K,
+                             y_matrix.template data<float>(),
+                             N,
+                             0.f,
+                             z->template mutable_data<float>(),
+                             N,
+                             nullptr,
+                             packed_y_->template data<float>());
+    } else {
+      auto blas =
+          lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
+      blas.MatMul(x_matrix, y_matrix, z);
+    }
     if (z_dim.size() != 2) {
       z->Resize(z_dim);
     }
   }
 
   virtual ~MulCompute() = default;
+
+ private:
+  // The constant y packed by sgemm_pack_b, null if not packed.
+  std::shared_ptr<const lite::Tensor> packed_y_;
+  // The bits of the int8 or int4 y of post_quant_dynamic_pass, which is
+  // packed by pack_weight_only, 0 for the fp32 y.
+  int weight_only_bits_{0};
+};
+
+// The rows of x are quantized to int8 at runtime, y is either the int8
+// weight with its channel wise scales or a float tensor quantized per tensor.
+class MulInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MulParam;
+
+  void Run() override;
+
+  virtual ~MulInt8Compute() = default;
+
+ private:
+  // The quantized y if y is float.
+  lite::Tensor y_s8_;
 };
 
 }  // namespace x86
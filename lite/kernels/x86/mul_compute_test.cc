@@ -80,6 +80,55 @@ TEST(mul_x86, run_test) {
   }
 }
 
+TEST(mul_x86, weight_only) {
+  // The int8 and int4 y of post_quant_dynamic_pass against the dequantized y
+  constexpr int M = 5, K = 37, N = 29;
+  for (int bits : {8, 4}) {
+    int range = (1 << (bits - 1)) - 1;
+    lite::Tensor x, y, out;
+    x.Resize({M, K});
+    y.Resize({K, N});
+    out.Resize({M, N});
+    auto* x_data = x.mutable_data<float>();
+    auto* y_data = y.mutable_data<int8_t>();
+    std::vector<float> scale(N);
+    for (int i = 0; i < M * K; i++) {
+      x_data[i] = static_cast<float>(i % 13) / 13.f - 0.5f;
+    }
+    for (int i = 0; i < K * N; i++) {
+      y_data[i] = static_cast<int8_t>(i % (2 * range + 2) - range - 1);
+    }
+    for (int j = 0; j < N; j++) {
+      scale[j] = 0.01f * (j + 1);
+    }
+
+    MulCompute<float> mul;
+    operators::MulParam param;
+    param.x = &x;
+    param.y = &y;
+    param.output = &out;
+    param.weight_scale = scale;
+    param.bit_length = bits;
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    mul.SetContext(std::move(ctx));
+    mul.SetParam(param);
+    mul.PrepareForRun();
+    mul.Run();
+
+    auto* out_data = out.data<float>();
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < N; j++) {
+        float ref = 0.f;
+        for (int k = 0; k < K; k++) {
+          ref += x_data[i * K + k] * y_data[k * N + j] * scale[j];
+        }
+        EXPECT_NEAR(out_data[i * N + j], ref, 1e-4);
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -0,0 +1,1021 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/nchwc_compute.h"
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/backends/x86/math/conv_nchwc.h"
+#include "lite/backends/x86/math/nchwc.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace math = lite::x86::math;
+
+namespace {
+
+// Floats in memory of a tensor, only 4-D tensors are blocked.
+template <int Block>
+int64_t PhysicalSize(const DDim& dims) {
+  if (dims.size() != 4) return dims.production();
+  return math::nchwc_size(dims[0], dims[1], dims[2] * dims[3], Block);
+}
+
+template <int Block>
+float* MutableNCHWc(Tensor* tensor) {
+  return tensor->mutable_data<float>(
+      TARGET(kX86), PhysicalSize<Block>(tensor->dims()) * sizeof(float));
+}
+
+math::ConvNCHWcParam ConvShape(const operators::ConvParam& param) {
+  auto x_dims = param.x->dims();
+  auto w_dims = param.filter->dims();
+  auto o_dims = param.output->dims();
+  auto paddings = *param.paddings;
+  auto dilations = *param.dilations;
+  math::ConvNCHWcParam shape;
+  shape.chin = x_dims[1];
+  shape.hin = x_dims[2];
+  shape.win = x_dims[3];
+  shape.chout = o_dims[1];
+  shape.hout = o_dims[2];
+  shape.wout = o_dims[3];
+  shape.kernel_h = w_dims[2];
+  shape.kernel_w = w_dims[3];
+  shape.stride_h = param.strides[0];
+  shape.stride_w = param.strides[1];
+  shape.pad_h = paddings[0];
+  shape.pad_w = paddings[2];
+  shape.dilation_h = dilations[0];
+  shape.dilation_w = dilations[1];
+  shape.groups = param.groups;
+  return shape;
+}
+
+void ElementwiseAct(const operators::ElementwiseParam& param,
+                    float* out,
+                    int64_t len) {}
+
+void ElementwiseAct(const operators::FusionElementwiseActivationParam& param,
+                    float* out,
+                    int64_t len) {
+  operators::ActivationParam act_param;
+  act_param.has_active = true;
+  if (param.act_type == "relu") {
+    act_param.active_type = lite_api::ActivationType::kRelu;
+  } else if (param.act_type == "tanh") {
+    act_param.active_type = lite_api::ActivationType::kTanh;
+  } else if (param.act_type == "sigmoid") {
+    act_param.active_type = lite_api::ActivationType::kSigmoid;
+  } else {
+    LOG(FATAL) << "unsupported active type:" << param.act_type;
+  }
+  math::nchwc_act(out, out, len, act_param);
+}
+
+}  // namespace
+
+template <int Block>
+void ConvNCHWcCompute<Block>::PrepareForRun() {
+  auto& param = this->template Param<param_t>();
+  auto shape = ConvShape(param);
+  depthwise_ = shape.groups > 1 && shape.groups == shape.chin &&
+               shape.groups == shape.chout;
+  const float* filter = param.filter->template data<float>();
+  if (depthwise_) {
+    weights_.Resize({math::conv_depthwise_nchwc_weights_size(shape, Block)});
+    math::conv_depthwise_nchwc_trans_weights(
+        filter, weights_.mutable_data<float>(), shape, Block);
+  } else {
+    weights_.Resize({math::conv_nchwc_weights_size(shape, Block)});
+    math::conv_nchwc_trans_weights(
+        filter, weights_.mutable_data<float>(), shape, Block);
+  }
+  if (param.bias) {
+    bias_.Resize({math::nchwc_blocks(shape.chout, Block) * Block});
+    math::nchwc_pack_channel(param.bias->template data<float>(),
+                             bias_.mutable_data<float>(),
+                             shape.chout,
+                             Block);
+  }
+}
+
+template <int Block>
+void ConvNCHWcCompute<Block>::Run() {
+  auto& param = this->template Param<param_t>();
+  auto shape = ConvShape(param);
+  auto act_param = param.activation_param;
+  // the fused swish of conv keeps its beta in swish_scale
+  if (act_param.active_type == lite_api::ActivationType::kSwish) {
+    act_param.Swish_beta = act_param.swish_scale;
+  }
+  const float* din = param.x->template data<float>();
+  const float* bias = param.bias ? bias_.data<float>() : nullptr;
+  float* dout = MutableNCHWc<Block>(param.output);
+  int num = param.x->dims()[0];
+  if (depthwise_) {
+    math::conv_depthwise_nchwc(din,
+                               dout,
+                               num,
+                               weights_.data<float>(),
+                               bias,
+                               shape,
+                               act_param,
+                               Block);
+  } else {
+    math::conv_nchwc(
+        din, dout, num, weights_.data<float>(), bias, shape, act_param, Block);
+  }
+}
+
+template <int Block>
+void PoolNCHWcCompute<Block>::Run() {
+  auto& param = this->template Param<param_t>();
+  auto x_dims = param.x->dims();
+  auto o_dims = param.output->dims();
+  std::vector<int> ksize = param.ksize;
+  std::vector<int> paddings = *param.paddings;
+  if (param.global_pooling) {
+    ksize = {static_cast<int>(x_dims[2]), static_cast<int>(x_dims[3])};
+    paddings = {0, 0, 0, 0};
+  }
+  math::pooling_nchwc(param.x->template data<float>(),
+                      MutableNCHWc<Block>(param.output),
+                      x_dims[0],
+                      x_dims[1],
+                      x_dims[2],
+                      x_dims[3],
+                      o_dims[2],
+                      o_dims[3],
+                      ksize,
+                      param.strides,
+                      paddings,
+                      param.pooling_type == "max",
+                      param.exclusive,
+                      param.adaptive,
+                      Block);
+}
+
+template <int Block, typename ParamType, bool IsMul>
+void ElementwiseNCHWcCompute<Block, ParamType, IsMul>::Run() {
+  auto& param = this->template Param<param_t>();
+  const Tensor* x = param.X;
+  const Tensor* y = param.Y;
+  // add and mul are commutative, x is the larger one
+  if (y->dims().production() > x->dims().production()) std::swap(x, y);
+  auto x_dims = x->dims();
+  auto y_dims = y->dims();
+  const float* x_data = x->template data<float>();
+  const float* y_data = y->template data<float>();
+  float* out = MutableNCHWc<Block>(param.Out);
+  int64_t len = PhysicalSize<Block>(x_dims);
+  int x_rank = x_dims.size();
+  int y_rank = y_dims.size();
+  int axis = param.axis < 0 ? x_rank - y_rank : param.axis;
+
+  if (x_dims == y_dims) {
+    math::nchwc_binary(x_data, y_data, out, len, IsMul);
+  } else if (x_rank == 4) {
+    int num = x_dims[0];
+    int channel = x_dims[1];
+    int size = x_dims[2] * x_dims[3];
+    if (y_rank == 4 && y_dims[1] == channel && y_dims[2] == 1 &&
+        y_dims[3] == 1 && (y_dims[0] == 1 || y_dims[0] == num)) {
+      // a blocked [N, C, 1, 1] tensor is packed per channel already
+      math::nchwc_binary_channel(x_data,
+                                 y_data,
+                                 out,
+                                 num,
+                                 channel,
+                                 size,
+                                 y_dims[0] == num,
+                                 IsMul,
+                                 Block);
+    } else if (y_dims.production() == 1 ||
+               (y_rank != 4 && axis == 1 && y_dims[0] == channel &&
+                y_dims.production() == channel)) {
+      // a scalar or a plain per channel tensor
+      y_packed_.Resize({math::nchwc_blocks(channel, Block) * Block});
+      float* y_packed = y_packed_.mutable_data<float>();
+      if (y_dims.production() == 1) {
+        memset(y_packed, 0, sizeof(float) * y_packed_.numel());
+        for (int c = 0; c < channel; ++c) y_packed[c] = y_data[0];
+      } else {
+        math::nchwc_pack_channel(y_data, y_packed, channel, Block);
+      }
+      math::nchwc_binary_channel(
+          x_data, y_packed, out, num, channel, size, false, IsMul, Block);
+    } else {
+      LOG(FATAL) << "unsupported broadcast of blocked tensors, x: " << x_dims
+                 << ", y: " << y_dims << ", axis: " << param.axis;
+    }
+  } else {
+    // plain tensors, y is broadcast on [axis, axis + y_rank) of x
+    CHECK_NE(y_rank, 4) << "unsupported broadcast of a blocked y: " << y_dims;
+    CHECK(axis >= 0 && axis + y_rank <= x_rank);
+    for (int i = 0; i < y_rank; ++i) {
+      CHECK_EQ(x_dims[axis + i], y_dims[i]);
+    }
+    int64_t pre = x_dims.count(0, axis);
+    int64_t n = y_dims.production();
+    int64_t post = x_dims.count(axis + y_rank, x_rank);
+    for (int64_t i = 0; i < pre; ++i) {
+      for (int64_t j = 0; j < n; ++j) {
+        const float* x_ptr = x_data + (i * n + j) * post;
+        float* out_ptr = out + (i * n + j) * post;
+        for (int64_t k = 0; k < post; ++k) {
+          out_ptr[k] = IsMul ? x_ptr[k] * y_data[j] : x_ptr[k] + y_data[j];
+        }
+      }
+    }
+  }
+  ElementwiseAct(param, out, len);
+}
+
+template <int Block>
+void ActivationNCHWcCompute<Block>::Run() {
+  auto& param = this->template Param<param_t>();
+  auto act_param = param;
+  // the relu6 op keeps its clip in threshold
+  if (act_param.active_type == lite_api::ActivationType::kRelu6) {
+    act_param.Relu_clipped_coef = param.threshold;
+  }
+  math::nchwc_act(param.X->template data<float>(),
+                  MutableNCHWc<Block>(param.Out),
+                  PhysicalSize<Block>(param.X->dims()),
+                  act_param);
+}
+
+template <int Block>
+void BatchNormNCHWcCompute<Block>::PrepareForRun() {
+  auto& param = this->template Param<param_t>();
+  int channel = param.scale->dims()[0];
+  std::vector<float> scale(channel);
+  std::vector<float> shift(channel);
+  const float* gamma = param.scale->template data<float>();
+  const float* beta = param.bias->template data<float>();
+  const float* mean = param.mean->template data<float>();
+  const float* variance = param.variance->template data<float>();
+  for (int c = 0; c < channel; ++c) {
+    scale[c] = gamma[c] / std::sqrt(variance[c] + param.epsilon);
+    shift[c] = beta[c] - mean[c] * scale[c];
+  }
+  int padded = math::nchwc_blocks(channel, Block) * Block;
+  scale_.Resize({padded});
+  shift_.Resize({padded});
+  math::nchwc_pack_channel(
+      scale.data(), scale_.mutable_data<float>(), channel, Block);
+  math::nchwc_pack_channel(
+      shift.data(), shift_.mutable_data<float>(), channel, Block);
+}
+
+template <int Block>
+void BatchNormNCHWcCompute<Block>::Run() {
+  auto& param = this->template Param<param_t>();
+  auto x_dims = param.x->dims();
+  const float* din = param.x->template data<float>();
+  float* dout = MutableNCHWc<Block>(param.y);
+  const float* scale = scale_.data<float>();
+  const float* shift = shift_.data<float>();
+  int num = x_dims[0];
+  int channel = x_dims[1];
+  if (x_dims.size() == 4) {
+    math::nchwc_channel_affine(din,
+                               dout,
+                               scale,
+                               shift,
+                               num,
+                               channel,
+                               x_dims[2] * x_dims[3],
+                               Block);
+    return;
+  }
+  int64_t size = x_dims.count(2, x_dims.size());
+  for (int n = 0; n < num; ++n) {
+    for (int c = 0; c < channel; ++c) {
+      int64_t offset = (static_cast<int64_t>(n) * channel + c) * size;
+      for (int64_t i = 0; i < size; ++i) {
+        dout[offset + i] = din[offset + i] * scale[c] + shift[c];
+      }
+    }
+  }
+}
+
+template <int Block>
+void ScaleNCHWcCompute<Block>::Run() {
+  auto& param = this->template Param<param_t>();
+  float scale = param.scale;
+  float bias = param.bias_after_scale ? param.bias : param.bias * scale;
+  const float* din = param.x->template data<float>();
+  float* dout = MutableNCHWc<Block>(param.output);
+  int64_t len = PhysicalSize<Block>(param.x->dims());
+  for (int64_t i = 0; i < len; ++i) {
+    dout[i] = din[i] * scale + bias;
+  }
+}
+
+template <int Block>
+void ConcatNCHWcCompute<Block>::Run() {
+  auto& param = this->template Param<param_t>();
+  // Copied rather than shared, so that the output stays valid when the memory
+  // optimize pass reuses the input
+  if (param.x.size() == 1) {
+    param.output->CopyDataFrom(*param.x[0]);
+    return;
+  }
+  int axis = param.axis;
+  if (param.axis_tensor != nullptr) {
+    axis = param.axis_tensor->template data<int>()[0];
+  }
+  auto out_dims = param.output->dims();
+  if (axis < 0) axis += static_cast<int>(out_dims.size());
+  float* dout = MutableNCHWc<Block>(param.output);
+
+  if (out_dims.size() == 4 && axis == 1) {
+    int num = out_dims[0];
+    int channel_out = out_dims[1];
+    int size = out_dims[2] * out_dims[3];
+    // the channels of the inputs may not fill the padded channels
+    if (channel_out % Block != 0) {
+      memset(dout, 0, sizeof(float) * PhysicalSize<Block>(out_dims));
+    }
+    int offset = 0;
+    for (auto* x : param.x) {
+      int channel = x->dims()[1];
+      math::nchwc_copy_channels(x->template data<float>(),
+                                dout,
+                                num,
+                                channel,
+                                channel_out,
+                                offset,
+                                size,
+                                Block);
+      offset += channel;
+    }
+    return;
+  }
+
+  // The other axes are concatenated on the dims in memory, which are
+  // [N, C / Block, H, W * Block] for a blocked tensor.
+  auto physical = [](const DDim& dims) {
+    if (dims.size() != 4) return dims;
+    return DDim(std::vector<int64_t>{dims[0],
+                                     math::nchwc_blocks(dims[1], Block),
+                                     dims[2],
+                                     dims[3] * Block});
+  };
+  auto out_physical = physical(out_dims);
+  int64_t num_concat = out_physical.count(0, axis);
+  int64_t out_chunk = out_physical.count(axis, out_physical.size());
+  int64_t offset = 0;
+  for (auto* x : param.x) {
+    int64_t chunk = physical(x->dims()).count(axis, out_physical.size());
+    const float* din = x->template data<float>();
+    for (int64_t n = 0; n < num_concat; ++n) {
+      memcpy(dout + n * out_chunk + offset,
+             din + n * chunk,
+             sizeof(float) * chunk);
+    }
+    offset += chunk;
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::ConvNCHWcCompute<8> ConvNCHW8c;
+typedef paddle::lite::kernels::x86::ConvNCHWcCompute<16> ConvNCHW16c;
+typedef paddle::lite::kernels::x86::PoolNCHWcCompute<8> PoolNCHW8c;
+typedef paddle::lite::kernels::x86::PoolNCHWcCompute<16> PoolNCHW16c;
+typedef paddle::lite::kernels::x86::ElementwiseNCHWcCompute<
+    8,
+    paddle::lite::operators::ElementwiseParam,
+    false>
+    AddNCHW8c;
+typedef paddle::lite::kernels::x86::ElementwiseNCHWcCompute<
+    16,
+    paddle::lite::operators::ElementwiseParam,
+    false>
+    AddNCHW16c;
+typedef paddle::lite::kernels::x86::ElementwiseNCHWcCompute<
+    8,
+    paddle::lite::operators::ElementwiseParam,
+    true>
+    MulNCHW8c;
+typedef paddle::lite::kernels::x86::ElementwiseNCHWcCompute<
+    16,
+    paddle::lite::operators::ElementwiseParam,
+    true>
+    MulNCHW16c;
+typedef paddle::lite::kernels::x86::ElementwiseNCHWcCompute<
+    8,
+    paddle::lite::operators::FusionElementwiseActivationParam,
+    false>
+    AddActNCHW8c;
+typedef paddle::lite::kernels::x86::ElementwiseNCHWcCompute<
+    16,
+    paddle::lite::operators::FusionElementwiseActivationParam,
+    false>
+    AddActNCHW16c;
+typedef paddle::lite::kernels::x86::ElementwiseNCHWcCompute<
+    8,
+    paddle::lite::operators::FusionElementwiseActivationParam,
+    true>
+    MulActNCHW8c;
+typedef paddle::lite::kernels::x86::ElementwiseNCHWcCompute<
+    16,
+    paddle::lite::operators::FusionElementwiseActivationParam,
+    true>
+    MulActNCHW16c;
+typedef paddle::lite::kernels::x86::ActivationNCHWcCompute<8> ActNCHW8c;
+typedef paddle::lite::kernels::x86::ActivationNCHWcCompute<16> ActNCHW16c;
+typedef paddle::lite::kernels::x86::BatchNormNCHWcCompute<8> BatchNormNCHW8c;
+typedef paddle::lite::kernels::x86::BatchNormNCHWcCompute<16> BatchNormNCHW16c;
+typedef paddle::lite::kernels::x86::ScaleNCHWcCompute<8> ScaleNCHW8c;
+typedef paddle::lite::kernels::x86::ScaleNCHWcCompute<16> ScaleNCHW16c;
+typedef paddle::lite::kernels::x86::ConcatNCHWcCompute<8> ConcatNCHW8c;
+typedef paddle::lite::kernels::x86::ConcatNCHWcCompute<16> ConcatNCHW16c;
+
+REGISTER_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW8c, ConvNCHW8c, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(depthwise_conv2d, kX86, kFloat, kNCHW8c, ConvNCHW8c, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(pool2d, kX86, kFloat, kNCHW8c, PoolNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW8c, AddNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_mul, kX86, kFloat, kNCHW8c, MulNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    fusion_elementwise_add_activation, kX86, kFloat, kNCHW8c, AddActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    fusion_elementwise_mul_activation, kX86, kFloat, kNCHW8c, MulActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu, kX86, kFloat, kNCHW8c, ActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu6, kX86, kFloat, kNCHW8c, ActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(leaky_relu, kX86, kFloat, kNCHW8c, ActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(sigmoid, kX86, kFloat, kNCHW8c, ActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(tanh, kX86, kFloat, kNCHW8c, ActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(hard_swish, kX86, kFloat, kNCHW8c, ActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(hard_sigmoid, kX86, kFloat, kNCHW8c, ActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(swish, kX86, kFloat, kNCHW8c, ActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(abs, kX86, kFloat, kNCHW8c, ActNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(batch_norm, kX86, kFloat, kNCHW8c, BatchNormNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Scale",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Mean",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Variance",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Y",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .BindOutput("MeanOut",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .BindOutput("VarianceOut",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .BindOutput("SavedMean",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .BindOutput("SavedVariance",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(scale, kX86, kFloat, kNCHW8c, ScaleNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(concat, kX86, kFloat, kNCHW8c, ConcatNCHW8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("AxisTensor",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kInt32),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW16c, ConvNCHW16c, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(depthwise_conv2d, kX86, kFloat, kNCHW16c, ConvNCHW16c, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(pool2d, kX86, kFloat, kNCHW16c, PoolNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW16c, AddNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_mul, kX86, kFloat, kNCHW16c, MulNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_add_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW16c,
+                     AddActNCHW16c,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_mul_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW16c,
+                     MulActNCHW16c,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu, kX86, kFloat, kNCHW16c, ActNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu6, kX86, kFloat, kNCHW16c, ActNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(leaky_relu, kX86, kFloat, kNCHW16c, ActNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(sigmoid, kX86, kFloat, kNCHW16c, ActNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(tanh, kX86, kFloat, kNCHW16c, ActNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(hard_swish, kX86, kFloat, kNCHW16c, ActNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(hard_sigmoid, kX86, kFloat, kNCHW16c, ActNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(swish, kX86, kFloat, kNCHW16c, ActNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(abs, kX86, kFloat, kNCHW16c, ActNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(batch_norm, kX86, kFloat, kNCHW16c, BatchNormNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindInput("Scale",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Mean",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Variance",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Y",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .BindOutput("MeanOut",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .BindOutput("VarianceOut",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .BindOutput("SavedMean",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .BindOutput("SavedVariance",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(scale, kX86, kFloat, kNCHW16c, ScaleNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(concat, kX86, kFloat, kNCHW16c, ConcatNCHW16c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW16c))})
+    .BindInput("AxisTensor",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kInt32),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW16c))})
+    .Finalize();
@@ -0,0 +1,117 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/*
+ * Kernels of the blocked NCHW8c / NCHW16c layouts, see
+ * lite/backends/x86/math/nchwc.h. They are only picked when one of the
+ * layouts is in the valid places, the layout kernels convert from and to
+ * NCHW around them.
+ */
+
+template <int Block>
+struct NCHWcLayout {
+  static constexpr DataLayoutType value =
+      Block == 8 ? DATALAYOUT(kNCHW8c) : DATALAYOUT(kNCHW16c);
+};
+
+template <int Block>
+using NCHWcKernel =
+    KernelLite<TARGET(kX86), PRECISION(kFloat), NCHWcLayout<Block>::value>;
+
+template <int Block>
+class ConvNCHWcCompute : public NCHWcKernel<Block> {
+ public:
+  using param_t = operators::ConvParam;
+  void PrepareForRun() override;
+  void Run() override;
+  virtual ~ConvNCHWcCompute() = default;
+
+ private:
+  bool depthwise_{false};
+  Tensor weights_;
+  Tensor bias_;
+};
+
+template <int Block>
+class PoolNCHWcCompute : public NCHWcKernel<Block> {
+ public:
+  using param_t = operators::PoolParam;
+  void Run() override;
+  virtual ~PoolNCHWcCompute() = default;
+};
+
+template <int Block, typename ParamType, bool IsMul>
+class ElementwiseNCHWcCompute : public NCHWcKernel<Block> {
+ public:
+  using param_t = ParamType;
+  void Run() override;
+  virtual ~ElementwiseNCHWcCompute() = default;
+
+ private:
+  Tensor y_packed_;
+};
+
+template <int Block>
+class ActivationNCHWcCompute : public NCHWcKernel<Block> {
+ public:
+  using param_t = operators::ActivationParam;
+  void Run() override;
+  virtual ~ActivationNCHWcCompute() = default;
+};
+
+template <int Block>
+class BatchNormNCHWcCompute : public NCHWcKernel<Block> {
+ public:
+  using param_t = operators::BatchNormParam;
+  void PrepareForRun() override;
+  void Run() override;
+  virtual ~BatchNormNCHWcCompute() = default;
+
+ private:
+  // y = x * scale_ + shift_, packed by nchwc_pack_channel
+  Tensor scale_;
+  Tensor shift_;
+};
+
+template <int Block>
+class ScaleNCHWcCompute : public NCHWcKernel<Block> {
+ public:
+  using param_t = operators::ScaleParam;
+  void Run() override;
+  virtual ~ScaleNCHWcCompute() = default;
+};
+
+template <int Block>
+class ConcatNCHWcCompute : public NCHWcKernel<Block> {
+ public:
+  using param_t = operators::ConcatParam;
+  void Run() override;
+  virtual ~ConcatNCHWcCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,518 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/host/activation_compute.h"
+#include "lite/kernels/x86/activation_compute.h"
+#include "lite/kernels/x86/batch_norm_compute.h"
+#include "lite/kernels/x86/elementwise_compute.h"
+#include "lite/kernels/x86/layout_compute.h"
+#include "lite/kernels/x86/nchwc_compute.h"
+#include "lite/kernels/x86/pool_compute.h"
+#include "lite/kernels/x86/scale_compute.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename KernelType>
+static void RunLayout(const Tensor& x, Tensor* y) {
+  KernelType kernel;
+  operators::LayoutParam param;
+  param.x = const_cast<Tensor*>(&x);
+  param.y = y;
+  kernel.SetParam(param);
+  kernel.Run();
+}
+
+// Run the NCHW kernel which the blocked one is checked against
+template <typename KernelType, typename ParamType>
+static void RunReference(const ParamType& param) {
+  KernelType kernel;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernel.SetContext(std::move(ctx));
+  kernel.SetParam(param);
+  kernel.PrepareForRun();
+  kernel.Run();
+}
+
+static void ExpectNear(const Tensor& out, const Tensor& ref, float abs_error) {
+  ASSERT_EQ(out.dims(), ref.dims());
+  const float* out_data = out.data<float>();
+  const float* ref_data = ref.data<float>();
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    EXPECT_NEAR(out_data[i], ref_data[i], abs_error) << "at " << i;
+  }
+}
+
+template <int Block>
+static void TestConv(int chin, int chout, int groups, int stride, bool relu) {
+  const int num = 2, hin = 9, win = 11, kernel = 3, pad = 1;
+  const int hout = (hin + 2 * pad - kernel) / stride + 1;
+  const int wout = (win + 2 * pad - kernel) / stride + 1;
+  Tensor x, filter, bias, x_blocked, out_blocked, out;
+  x.Resize({num, chin, hin, win});
+  filter.Resize({chout, chin / groups, kernel, kernel});
+  bias.Resize({chout});
+  for (Tensor* tensor : {&x, &filter, &bias}) {
+    fill_data_rand(tensor->mutable_data<float>(), -0.5f, 0.5f, tensor->numel());
+  }
+  RunLayout<NCHWToNCHWcCompute<Block>>(x, &x_blocked);
+  out_blocked.Resize({num, chout, hout, wout});
+
+  operators::ConvParam param;
+  param.x = &x_blocked;
+  param.filter = &filter;
+  param.bias = &bias;
+  param.output = &out_blocked;
+  param.strides = {stride, stride};
+  param.paddings =
+      std::make_shared<std::vector<int>>(std::vector<int>{pad, pad, pad, pad});
+  param.dilations = std::make_shared<std::vector<int>>(std::vector<int>{1, 1});
+  param.groups = groups;
+  if (relu) {
+    param.activation_param.has_active = true;
+    param.activation_param.active_type = lite_api::ActivationType::kRelu;
+  }
+  ConvNCHWcCompute<Block> conv;
+  conv.SetParam(param);
+  conv.PrepareForRun();
+  conv.Run();
+  RunLayout<NCHWcToNCHWCompute<Block>>(out_blocked, &out);
+
+  const float* x_data = x.data<float>();
+  const float* w_data = filter.data<float>();
+  const float* out_data = out.data<float>();
+  const int chin_g = chin / groups, chout_g = chout / groups;
+  for (int n = 0; n < num; ++n) {
+    for (int oc = 0; oc < chout; ++oc) {
+      int g = oc / chout_g;
+      for (int oh = 0; oh < hout; ++oh) {
+        for (int ow = 0; ow < wout; ++ow) {
+          float ref = bias.data<float>()[oc];
+          for (int ic = 0; ic < chin_g; ++ic) {
+            for (int ky = 0; ky < kernel; ++ky) {
+              for (int kx = 0; kx < kernel; ++kx) {
+                int ih = oh * stride - pad + ky;
+                int iw = ow * stride - pad + kx;
+                if (ih < 0 || ih >= hin || iw < 0 || iw >= win) continue;
+                int x_c = n * chin + g * chin_g + ic;
+                int x_idx = (x_c * hin + ih) * win + iw;
+                int w_idx = ((oc * chin_g + ic) * kernel + ky) * kernel + kx;
+                ref += x_data[x_idx] * w_data[w_idx];
+              }
+            }
+          }
+          if (relu) ref = std::max(ref, 0.f);
+          EXPECT_NEAR(
+              out_data[((n * chout + oc) * hout + oh) * wout + ow], ref, 1e-4);
+        }
+      }
+    }
+  }
+}
+
+template <int Block>
+static void TestConcatAndMul() {
+  const int num = 2, ch0 = 5, ch1 = 3, h = 3, w = 4, size = h * w;
+  Tensor x0, x1, y, x0_blocked, x1_blocked, y_blocked;
+  x0.Resize({num, ch0, h, w});
+  x1.Resize({num, ch1, h, w});
+  y.Resize({num, ch0 + ch1, 1, 1});
+  for (Tensor* tensor : {&x0, &x1, &y}) {
+    fill_data_rand(tensor->mutable_data<float>(), -0.5f, 0.5f, tensor->numel());
+  }
+  RunLayout<NCHWToNCHWcCompute<Block>>(x0, &x0_blocked);
+  RunLayout<NCHWToNCHWcCompute<Block>>(x1, &x1_blocked);
+  RunLayout<NCHWToNCHWcCompute<Block>>(y, &y_blocked);
+
+  // concat on channels, which are not a multiple of the block
+  Tensor concat_blocked, mul_blocked, out;
+  concat_blocked.Resize({num, ch0 + ch1, h, w});
+  operators::ConcatParam concat_param;
+  concat_param.x = {&x0_blocked, &x1_blocked};
+  concat_param.output = &concat_blocked;
+  concat_param.axis = 1;
+  ConcatNCHWcCompute<Block> concat;
+  concat.SetParam(concat_param);
+  concat.Run();
+
+  // multiplied by a [N, C, 1, 1] tensor, fused with relu
+  mul_blocked.Resize({num, ch0 + ch1, h, w});
+  operators::FusionElementwiseActivationParam mul_param;
+  mul_param.X = &concat_blocked;
+  mul_param.Y = &y_blocked;
+  mul_param.Out = &mul_blocked;
+  mul_param.act_type = "relu";
+  ElementwiseNCHWcCompute<Block,
+                          operators::FusionElementwiseActivationParam,
+                          true>
+      mul;
+  mul.SetParam(mul_param);
+  mul.Run();
+  RunLayout<NCHWcToNCHWCompute<Block>>(mul_blocked, &out);
+
+  const float* out_data = out.data<float>();
+  for (int n = 0; n < num; ++n) {
+    for (int c = 0; c < ch0 + ch1; ++c) {
+      const float* src = c < ch0 ? x0.data<float>() + (n * ch0 + c) * size
+                                 : x1.data<float>() +
+                                       (n * ch1 + c - ch0) * size;
+      float scale = y.data<float>()[n * (ch0 + ch1) + c];
+      for (int i = 0; i < size; ++i) {
+        EXPECT_NEAR(out_data[(n * (ch0 + ch1) + c) * size + i],
+                    std::max(src[i] * scale, 0.f),
+                    1e-5);
+      }
+    }
+  }
+}
+
+template <int Block>
+static void TestPool(const std::string& pooling_type,
+                     bool global_pooling,
+                     int kernel,
+                     int stride,
+                     int pad,
+                     bool exclusive) {
+  const int num = 2, channel = 13, hin = 9, win = 11;
+  const int hout =
+      global_pooling ? 1 : (hin + 2 * pad - kernel) / stride + 1;
+  const int wout =
+      global_pooling ? 1 : (win + 2 * pad - kernel) / stride + 1;
+  Tensor x, x_blocked, out_blocked, out, ref;
+  x.Resize({num, channel, hin, win});
+  fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+  RunLayout<NCHWToNCHWcCompute<Block>>(x, &x_blocked);
+
+  operators::PoolParam param;
+  param.pooling_type = pooling_type;
+  param.global_pooling = global_pooling;
+  param.ksize = {kernel, kernel};
+  param.strides = {stride, stride};
+  param.paddings =
+      std::make_shared<std::vector<int>>(std::vector<int>{pad, pad, pad, pad});
+  param.exclusive = exclusive;
+  param.x = &x_blocked;
+  param.output = &out_blocked;
+  out_blocked.Resize({num, channel, hout, wout});
+  PoolNCHWcCompute<Block> pool;
+  pool.SetParam(param);
+  pool.Run();
+  RunLayout<NCHWcToNCHWCompute<Block>>(out_blocked, &out);
+
+  param.x = &x;
+  param.output = &ref;
+  ref.Resize({num, channel, hout, wout});
+  RunReference<PoolCompute<float>>(param);
+  ExpectNear(out, ref, 1e-5f);
+}
+
+// The mean, variance, scale and bias are folded once by PrepareForRun, then
+// reused by the runs on new inputs.
+template <int Block>
+static void TestBatchNorm(const DDim& x_dims) {
+  const int channel = x_dims[1];
+  Tensor x, scale, bias, mean, variance, x_blocked, y_blocked, y, ref;
+  x.Resize(x_dims);
+  for (Tensor* tensor : {&scale, &bias, &mean, &variance}) {
+    tensor->Resize({channel});
+    fill_data_rand(tensor->mutable_data<float>(), -1.f, 1.f, channel);
+  }
+  fill_data_rand(variance.mutable_data<float>(), 0.1f, 1.f, channel);
+
+  operators::BatchNormParam param;
+  param.x = &x_blocked;
+  param.y = &y_blocked;
+  param.scale = &scale;
+  param.bias = &bias;
+  param.mean = &mean;
+  param.variance = &variance;
+  param.epsilon = 1e-5f;
+  param.is_test = true;
+  BatchNormNCHWcCompute<Block> batch_norm;
+  batch_norm.SetParam(param);
+  batch_norm.PrepareForRun();
+
+  for (int i = 0; i < 2; ++i) {
+    fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+    RunLayout<NCHWToNCHWcCompute<Block>>(x, &x_blocked);
+    y_blocked.Resize(x_dims);
+    batch_norm.Run();
+    RunLayout<NCHWcToNCHWCompute<Block>>(y_blocked, &y);
+
+    operators::BatchNormParam ref_param = param;
+    ref_param.x = &x;
+    ref_param.y = &ref;
+    ref.Resize(x_dims);
+    RunReference<BatchNormCompute<float>>(ref_param);
+    ExpectNear(y, ref, 1e-5f);
+  }
+}
+
+template <int Block, typename RefKernelType>
+static void TestActivation(operators::ActivationParam param) {
+  Tensor x, x_blocked, out_blocked, out, ref;
+  x.Resize({2, 13, 5, 7});
+  fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+  RunLayout<NCHWToNCHWcCompute<Block>>(x, &x_blocked);
+
+  param.has_active = true;
+  param.X = &x_blocked;
+  param.Out = &out_blocked;
+  out_blocked.Resize(x.dims());
+  ActivationNCHWcCompute<Block> act;
+  act.SetParam(param);
+  act.Run();
+  RunLayout<NCHWcToNCHWCompute<Block>>(out_blocked, &out);
+
+  param.X = &x;
+  param.Out = &ref;
+  ref.Resize(x.dims());
+  RunReference<RefKernelType>(param);
+  ExpectNear(out, ref, 1e-5f);
+}
+
+template <int Block>
+static void TestActivations() {
+  using lite_api::ActivationType;
+  operators::ActivationParam param;
+  param.active_type = ActivationType::kRelu;
+  TestActivation<Block, ReluCompute<float>>(param);
+  // the clips are within the inputs, so that both sides are checked
+  param.active_type = ActivationType::kRelu6;
+  param.threshold = 0.5f;
+  TestActivation<Block, Relu6Compute<float>>(param);
+  param.active_type = ActivationType::kLeakyRelu;
+  param.Leaky_relu_alpha = 0.1f;
+  TestActivation<Block, LeakyReluCompute<float>>(param);
+  param.active_type = ActivationType::kSigmoid;
+  TestActivation<Block, SigmoidCompute<float>>(param);
+  param.active_type = ActivationType::kTanh;
+  TestActivation<Block, TanhCompute<float>>(param);
+  param.active_type = ActivationType::kHardSwish;
+  param.hard_swish_threshold = 1.f;
+  param.hard_swish_scale = 6.f;
+  param.hard_swish_offset = 0.5f;
+  TestActivation<Block, HardSwishComputeCompute<float>>(param);
+  // swish, hard_sigmoid and abs have no x86 kernels of NCHW
+  param.active_type = ActivationType::kSwish;
+  param.Swish_beta = 1.5f;
+  TestActivation<Block, host::SwishCompute>(param);
+  param.active_type = ActivationType::kHardSigmoid;
+  param.hard_sigmoid_slope = 2.f;
+  param.hard_sigmoid_offset = 0.5f;
+  TestActivation<Block, host::HardSigmoidCompute>(param);
+  param.active_type = ActivationType::kAbs;
+  TestActivation<Block, host::AbsCompute>(param);
+}
+
+template <int Block, bool IsMul, typename RefKernelType, typename ParamType>
+static void TestElementwise(ParamType param, const DDim& y_dims) {
+  const DDim x_dims({2, 13, 5, 7});
+  Tensor x, y, x_blocked, y_blocked, out_blocked, out, ref;
+  x.Resize(x_dims);
+  y.Resize(y_dims);
+  for (Tensor* tensor : {&x, &y}) {
+    fill_data_rand(tensor->mutable_data<float>(), -1.f, 1.f, tensor->numel());
+  }
+  RunLayout<NCHWToNCHWcCompute<Block>>(x, &x_blocked);
+  RunLayout<NCHWToNCHWcCompute<Block>>(y, &y_blocked);
+
+  param.X = &x_blocked;
+  param.Y = &y_blocked;
+  param.Out = &out_blocked;
+  out_blocked.Resize(x_dims);
+  ElementwiseNCHWcCompute<Block, ParamType, IsMul> elementwise;
+  elementwise.SetParam(param);
+  elementwise.Run();
+  RunLayout<NCHWcToNCHWCompute<Block>>(out_blocked, &out);
+
+  param.X = &x;
+  param.Y = &y;
+  param.Out = &ref;
+  ref.Resize(x_dims);
+  RunReference<RefKernelType>(param);
+  ExpectNear(out, ref, 1e-5f);
+}
+
+template <int Block>
+static void TestElementwises() {
+  operators::ElementwiseParam param;
+  // the same dims, a blocked y of [N, C, 1, 1] or [1, C, 1, 1] and a scalar
+  for (auto y_dims : {DDim({2, 13, 5, 7}),
+                      DDim({2, 13, 1, 1}),
+                      DDim({1, 13, 1, 1}),
+                      DDim({1})}) {
+    TestElementwise<Block, false, ElementwiseAddCompute<float>>(param, y_dims);
+    TestElementwise<Block, true, ElementwiseMulCompute<float>>(param, y_dims);
+  }
+  // a plain y of the channels
+  param.axis = 1;
+  TestElementwise<Block, false, ElementwiseAddCompute<float>>(param,
+                                                              DDim({13}));
+  TestElementwise<Block, true, ElementwiseMulCompute<float>>(param,
+                                                             DDim({13}));
+
+  operators::FusionElementwiseActivationParam act_param;
+  for (auto act_type : {"relu", "tanh", "sigmoid"}) {
+    act_param.act_type = act_type;
+    act_param.axis = -1;
+    TestElementwise<Block, false, ElementwiseAddActivationCompute<float>>(
+        act_param, DDim({2, 13, 5, 7}));
+    TestElementwise<Block, true, ElementwiseMulActivationCompute<float>>(
+        act_param, DDim({2, 13, 1, 1}));
+    act_param.axis = 1;
+    TestElementwise<Block, true, ElementwiseMulActivationCompute<float>>(
+        act_param, DDim({13}));
+  }
+}
+
+template <int Block>
+static void TestScale(bool bias_after_scale) {
+  Tensor x, x_blocked, out_blocked, out, ref;
+  x.Resize({2, 13, 5, 7});
+  fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+  RunLayout<NCHWToNCHWcCompute<Block>>(x, &x_blocked);
+
+  operators::ScaleParam param;
+  param.scale = 1.5f;
+  param.bias = 0.25f;
+  param.bias_after_scale = bias_after_scale;
+  param.x = &x_blocked;
+  param.output = &out_blocked;
+  out_blocked.Resize(x.dims());
+  ScaleNCHWcCompute<Block> scale;
+  scale.SetParam(param);
+  scale.Run();
+  RunLayout<NCHWcToNCHWCompute<Block>>(out_blocked, &out);
+
+  param.x = &x;
+  param.output = &ref;
+  ref.Resize(x.dims());
+  RunReference<ScaleCompute<float>>(param);
+  ExpectNear(out, ref, 1e-5f);
+}
+
+// The outputs passed through unchanged must not alias the inputs, which the
+// memory optimize pass may reuse
+template <int Block>
+static void TestPassThrough() {
+  Tensor x_2d, y, y_back;
+  x_2d.Resize({3, 5});
+  fill_data_rand(x_2d.mutable_data<float>(), -0.5f, 0.5f, x_2d.numel());
+  RunLayout<NCHWToNCHWcCompute<Block>>(x_2d, &y);
+  RunLayout<NCHWcToNCHWCompute<Block>>(y, &y_back);
+  Tensor x, x_blocked, concat_out;
+  x.Resize({2, 3, 4, 5});
+  fill_data_rand(x.mutable_data<float>(), -0.5f, 0.5f, x.numel());
+  RunLayout<NCHWToNCHWcCompute<Block>>(x, &x_blocked);
+  concat_out.Resize({2, 3, 4, 5});
+  operators::ConcatParam param;
+  param.x = {&x_blocked};
+  param.output = &concat_out;
+  param.axis = 1;
+  ConcatNCHWcCompute<Block> concat;
+  concat.SetParam(param);
+  concat.Run();
+
+  std::vector<std::pair<const Tensor*, const Tensor*>> pairs{
+      {&x_2d, &y}, {&y, &y_back}, {&x_blocked, &concat_out}};
+  for (auto& pair : pairs) {
+    const float* in = pair.first->data<float>();
+    const float* out = pair.second->data<float>();
+    EXPECT_NE(in, out);
+    EXPECT_EQ(pair.first->memory_size(), pair.second->memory_size());
+    for (size_t i = 0; i < pair.first->memory_size() / sizeof(float); ++i) {
+      EXPECT_EQ(in[i], out[i]);
+    }
+  }
+}
+
+TEST(nchwc_x86, retrive_op) {
+  auto conv2d = KernelRegistry::Global().Create("conv2d");
+  ASSERT_FALSE(conv2d.empty());
+}
+
+TEST(nchwc_x86, conv) {
+  TestConv<8>(16, 24, 1, 1, true);
+  TestConv<8>(6, 9, 3, 1, false);
+  TestConv<8>(24, 24, 24, 2, true);
+  TestConv<16>(3, 20, 1, 2, false);
+  TestConv<16>(32, 32, 2, 1, true);
+}
+
+TEST(nchwc_x86, concat_mul) {
+  TestConcatAndMul<8>();
+  TestConcatAndMul<16>();
+}
+
+TEST(nchwc_x86, pool) {
+  for (bool exclusive : {true, false}) {
+    TestPool<8>("avg", false, 3, 1, 1, exclusive);
+    TestPool<16>("avg", false, 3, 2, 1, exclusive);
+  }
+  TestPool<8>("max", false, 3, 2, 1, true);
+  TestPool<16>("max", false, 2, 2, 0, true);
+  TestPool<8>("avg", true, 1, 1, 0, true);
+  TestPool<16>("max", true, 1, 1, 0, true);
+}
+
+TEST(nchwc_x86, batch_norm) {
+  TestBatchNorm<8>(DDim({2, 13, 5, 7}));
+  TestBatchNorm<16>(DDim({2, 13, 5, 7}));
+  // not blocked
+  TestBatchNorm<8>(DDim({4, 13}));
+}
+
+TEST(nchwc_x86, activation) {
+  TestActivations<8>();
+  TestActivations<16>();
+}
+
+TEST(nchwc_x86, elementwise) {
+  TestElementwises<8>();
+  TestElementwises<16>();
+}
+
+TEST(nchwc_x86, scale) {
+  for (bool bias_after_scale : {true, false}) {
+    TestScale<8>(bias_after_scale);
+    TestScale<16>(bias_after_scale);
+  }
+}
+
+TEST(nchwc_x86, pass_through) {
+  TestPassThrough<8>();
+  TestPassThrough<16>();
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW8c, def);
+USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW16c, def);
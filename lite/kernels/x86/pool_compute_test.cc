@@ -14,8 +14,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cfloat>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -79,6 +82,115 @@ TEST(pool2d_x86, run_test) {
   }
 }
 
+static void pool_compute_ref(const lite::Tensor& x,
+                             const operators::PoolParam& param,
+                             lite::Tensor* out) {
+  const auto& x_dims = x.dims();
+  const auto& out_dims = out->dims();
+  const int hin = x_dims[2], win = x_dims[3];
+  const int hout = out_dims[2], wout = out_dims[3];
+  const int kh = param.ksize[0], kw = param.ksize[1];
+  const int sh = param.strides[0], sw = param.strides[1];
+  const int ph = (*param.paddings)[0], pw = (*param.paddings)[2];
+  const bool is_max = param.pooling_type == "max";
+  const float* x_data = x.data<float>();
+  float* out_data = out->mutable_data<float>();
+  for (int i = 0; i < x_dims[0] * x_dims[1]; ++i) {
+    const float* in_plane = x_data + i * hin * win;
+    for (int oh = 0; oh < hout; ++oh) {
+      for (int ow = 0; ow < wout; ++ow) {
+        int hstart = oh * sh - ph, wstart = ow * sw - pw;
+        int hend = std::min(hstart + kh, hin + ph);
+        int wend = std::min(wstart + kw, win + pw);
+        int pool_size = (hend - hstart) * (wend - wstart);
+        hstart = std::max(hstart, 0);
+        wstart = std::max(wstart, 0);
+        hend = std::min(hend, hin);
+        wend = std::min(wend, win);
+        if (is_max || param.exclusive) {
+          pool_size = (hend - hstart) * (wend - wstart);
+        }
+        float res = is_max ? -FLT_MAX : 0.f;
+        for (int h = hstart; h < hend; ++h) {
+          for (int w = wstart; w < wend; ++w) {
+            float v = in_plane[h * win + w];
+            res = is_max ? std::max(res, v) : res + v;
+          }
+        }
+        out_data[(i * hout + oh) * wout + ow] = is_max ? res : res / pool_size;
+      }
+    }
+  }
+}
+
+static void test_pool(const std::string& pooling_type,
+                      int hin,
+                      int win,
+                      int kernel,
+                      int stride,
+                      int pad,
+                      bool exclusive,
+                      bool global_pooling) {
+  lite::Tensor x, out, out_ref;
+  const int num = 2, channel = 5;
+  if (global_pooling) {
+    kernel = std::max(hin, win);
+    stride = 1;
+    pad = 0;
+  }
+  const int kh = global_pooling ? hin : kernel;
+  const int kw = global_pooling ? win : kernel;
+  const int hout = (hin + 2 * pad - kh) / stride + 1;
+  const int wout = (win + 2 * pad - kw) / stride + 1;
+  x.Resize({num, channel, hin, win});
+  out.Resize({num, channel, hout, wout});
+  out_ref.Resize({num, channel, hout, wout});
+  auto* x_data = x.mutable_data<float>();
+  for (int64_t i = 0; i < x.dims().production(); i++) {
+    x_data[i] = static_cast<float>((i * 13) % 31) - 15.f;
+  }
+
+  PoolCompute<float> pool2d;
+  operators::PoolParam param;
+  param.x = &x;
+  param.output = &out;
+  param.strides = {stride, stride};
+  param.paddings =
+      std::make_shared<std::vector<int>>(std::vector<int>{pad, pad, pad, pad});
+  param.ksize = {kernel, kernel};
+  param.pooling_type = pooling_type;
+  param.exclusive = exclusive;
+  param.global_pooling = global_pooling;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  pool2d.SetContext(std::move(ctx));
+  pool2d.SetParam(param);
+  pool2d.Run();
+
+  pool_compute_ref(x, param, &out_ref);
+  const float* out_data = out.data<float>();
+  const float* ref_data = out_ref.data<float>();
+  for (int64_t i = 0; i < out.dims().production(); i++) {
+    EXPECT_NEAR(out_data[i], ref_data[i], 1e-4);
+  }
+}
+
+TEST(pool2d_x86, fast_path) {
+  for (auto pooling_type : {"max", "avg"}) {
+    for (bool exclusive : {true, false}) {
+      // 2x2s2, 3x3s2 with padding, 3x3s1 and an odd stride
+      test_pool(pooling_type, 16, 33, 2, 2, 0, exclusive, false);
+      test_pool(pooling_type, 17, 40, 3, 2, 1, exclusive, false);
+      test_pool(pooling_type, 9, 27, 3, 1, 1, exclusive, false);
+      test_pool(pooling_type, 11, 37, 5, 3, 2, exclusive, false);
+      test_pool(pooling_type, 1, 3, 2, 2, 1, exclusive, false);
+      // global pooling
+      test_pool(pooling_type, 7, 7, 0, 0, 0, exclusive, true);
+      test_pool(pooling_type, 13, 9, 0, 0, 0, exclusive, true);
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
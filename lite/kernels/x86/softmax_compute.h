@@ -13,10 +13,13 @@
 // limitations under the License.
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include "lite/backends/x86/math/softmax.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/parallel_defines.h"
 namespace paddle {
 namespace lite {
 namespace kernels {
@@ -45,6 +48,39 @@ static inline int SizeFromAxis(const int axis, const DDim& dims) {
   return size;
 }
 
+// Softmax of x[axis_dim, inner] along axis_dim, `buffer` holds 2 * inner
+// values.
+template <typename T>
+void SoftmaxAlongAxis(const T* x, T* y, int axis_dim, int inner, T* buffer) {
+  T* max_val = buffer;
+  T* sum = buffer + inner;
+  std::copy(x, x + inner, max_val);
+  for (int j = 1; j < axis_dim; ++j) {
+    const T* x_row = x + static_cast<int64_t>(j) * inner;
+    for (int i = 0; i < inner; ++i) {
+      max_val[i] = (std::max)(max_val[i], x_row[i]);
+    }
+  }
+  std::fill(sum, sum + inner, static_cast<T>(0));
+  for (int j = 0; j < axis_dim; ++j) {
+    const T* x_row = x + static_cast<int64_t>(j) * inner;
+    T* y_row = y + static_cast<int64_t>(j) * inner;
+    for (int i = 0; i < inner; ++i) {
+      y_row[i] = std::exp(x_row[i] - max_val[i]);
+      sum[i] += y_row[i];
+    }
+  }
+  for (int i = 0; i < inner; ++i) {
+    sum[i] = static_cast<T>(1) / sum[i];
+  }
+  for (int j = 0; j < axis_dim; ++j) {
+    T* y_row = y + static_cast<int64_t>(j) * inner;
+    for (int i = 0; i < inner; ++i) {
+      y_row[i] *= sum[i];
+    }
+  }
+}
+
 template <typename T>
 class SoftmaxCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
@@ -67,20 +103,23 @@ class SoftmaxCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       lite::x86::math::SoftmaxFunctor<lite::TargetType::kX86, T, true>()(
           context, axis_dim, x, output);
     } else {
+      // Compute on [n, axis_dim, inner] in place of reshaping the tensors,
+      // the running max and sum of every slice live in the workspace.
       const int n = SizeToAxis(axis, x->dims());
-      const int d = SizeFromAxis(axis, x->dims());
-
-      DDim x_dims = x->dims();
-      DDim out_dims = output->dims();
-
-      DDim shape_2d(std::vector<DDim::value_type>{n, d});
-      x->Resize(shape_2d);
-      output->Resize(shape_2d);
-
-      lite::x86::math::SoftmaxFunctor<lite::TargetType::kX86, T, true>()(
-          context, axis_dim, x, output);
-      x->Resize(x_dims);
-      output->Resize(out_dims);
+      const int inner = SizeFromAxis(axis + 1, x->dims());
+      const int64_t slice_size = static_cast<int64_t>(axis_dim) * inner;
+      context.ExtendWorkspace(sizeof(T) * 2 * inner * n);
+      T* buffer = context.workspace_data<T>();
+      const T* x_data = x->template data<T>();
+      T* out_data = output->template mutable_data<T>();
+      LITE_PARALLEL_BEGIN(i, tid, n) {
+        SoftmaxAlongAxis<T>(x_data + i * slice_size,
+                            out_data + i * slice_size,
+                            axis_dim,
+                            inner,
+                            buffer + 2 * static_cast<int64_t>(i) * inner);
+      }
+      LITE_PARALLEL_END();
     }
   }
 
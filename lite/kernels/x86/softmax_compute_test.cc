@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -76,6 +77,45 @@ TEST(softmax_x86, run_test) {
   }
 }
 
+TEST(softmax_x86, middle_axis) {
+  lite::Tensor x, out;
+  std::vector<int64_t> shape{2, 5, 3, 4};
+  x.Resize(lite::DDim(shape));
+  out.Resize(lite::DDim(shape));
+  auto x_data = x.mutable_data<float>();
+  auto out_data = out.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = static_cast<float>((i * 7) % 11) * 0.3f - 1.f;
+  }
+
+  SoftmaxCompute<float> softmax;
+  operators::SoftmaxParam param;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  softmax.SetContext(std::move(ctx));
+  param.x = &x;
+  param.output = &out;
+  param.axis = 1;
+  softmax.SetParam(param);
+  softmax.Run();
+
+  const int axis_dim = 5;
+  const int inner = 12;
+  for (int n = 0; n < 2; n++) {
+    for (int i = 0; i < inner; i++) {
+      const float* x_ptr = x_data + n * axis_dim * inner + i;
+      const float* out_ptr = out_data + n * axis_dim * inner + i;
+      float sum = 0.f;
+      for (int j = 0; j < axis_dim; j++) {
+        sum += std::exp(x_ptr[j * inner]);
+      }
+      for (int j = 0; j < axis_dim; j++) {
+        EXPECT_NEAR(out_ptr[j * inner], std::exp(x_ptr[j * inner]) / sum, 1e-5);
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
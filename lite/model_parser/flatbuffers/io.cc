@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "lite/model_parser/flatbuffers/io.h"
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <limits>
 #include <memory>
@@ -24,6 +26,41 @@
 namespace paddle {
 namespace lite {
 namespace fbs {
+
+namespace {
+// A non-owning view of a param in a mapped model file. It turns into an owned
+// copy when a writable buffer is requested, so the mapping shared by all the
+// predictors which load the same model is never modified.
+class MappedParamBuffer : public lite::Buffer {
+ public:
+  MappedParamBuffer(const std::shared_ptr<model_parser::MappedFile>& file,
+                    const void* data,
+                    size_t size)
+      : Buffer(const_cast<void*>(data), TARGET(kHost), size), file_(file) {}
+
+  void ResetLazy(TargetType target, size_t size) override {
+    if (file_) {
+      const void* mapped_data = data_;
+      const size_t mapped_size = space_;
+      const TargetType mapped_target = target_;
+      data_ = nullptr;
+      space_ = 0;
+      own_data_ = true;
+      Buffer::ResetLazy(target, (std::max)(size, mapped_size));
+      if (target == mapped_target) {
+        TargetCopy(TARGET(kHost), data_, mapped_data, mapped_size);
+      }
+      file_.reset();
+      return;
+    }
+    Buffer::ResetLazy(target, size);
+  }
+
+ private:
+  std::shared_ptr<model_parser::MappedFile> file_;
+};
+}  // namespace
+
 namespace deprecated {
 void SetCombinedParamsWithScope(const lite::Scope& scope,
                                 const std::set<std::string>& param_names,
@@ -68,6 +105,30 @@ void FillTensor(lite::Tensor* tensor, const ParamDescReadAPI& param) {
   std::memcpy(dst, param.GetData(), param.byte_size());
   tensor->set_persistable(true);
 }
+void FillTensor(lite::Tensor* tensor,
+                const ParamDescReadAPI& param,
+                const std::shared_ptr<model_parser::MappedFile>& file) {
+  CHECK(tensor);
+  CHECK(file);
+  const char* data = static_cast<const char*>(param.GetData());
+  const size_t byte_size = param.byte_size();
+  // Kernels may read a little beyond the end of a tensor (see the tail padding
+  // of TargetMalloc), which must stay inside the mapping.
+  const bool referable =
+      data != nullptr && byte_size > 0 &&
+      reinterpret_cast<uintptr_t>(data) % kParamDataAlignment == 0 &&
+      data + byte_size + kParamDataAlignment <= file->data() + file->length();
+  if (!referable) {
+    FillTensor(tensor, param);
+    return;
+  }
+  tensor->Resize(param.Dim());
+  tensor->set_precision(lite::ConvertPrecisionType(param.GetDataType()));
+  tensor->ResetBuffer(std::make_shared<MappedParamBuffer>(file, data, byte_size),
+                      byte_size);
+  tensor->set_persistable(true);
+}
+
 #ifdef LITE_WITH_FLATBUFFERS_DESC
 void ParamSerializer::ForwardWrite(const lite::Scope& scope,
                                    const std::set<std::string>& param_names) {
@@ -99,10 +160,27 @@ void ParamSerializer::ForwardWrite(const lite::Scope& scope,
 
     const size_t param_bytes = buf_->size();
     CHECK(param_bytes) << "The bytes size of param can not be zero";
-    constexpr uint32_t offset = sizeof(uint32_t);
+    // Pad between the offset field and the param, so that the tensor data
+    // inside the param lands on a multiple of kParamDataAlignment in the file.
+    // The readers skip the padding by the offset.
+    size_t padding_bytes = 0;
+    if (tensor.memory_size() > 0) {
+      fbs::ParamDescView param_view(buf_.get());
+      const size_t data_offset =
+          static_cast<const char*>(param_view.GetData()) -
+          static_cast<const char*>(buf_->data());
+      const size_t data_pos =
+          writer_->current() + 2 * sizeof(uint32_t) + data_offset;
+      padding_bytes = (kParamDataAlignment - data_pos % kParamDataAlignment) %
+                      kParamDataAlignment;
+    }
+    const uint32_t offset = sizeof(uint32_t) + padding_bytes;
     const uint32_t total_size = param_bytes + offset;
     writer_->Write<uint32_t>(total_size);
     writer_->Write<uint32_t>(offset);
+    for (size_t k = 0; k < padding_bytes; ++k) {
+      writer_->Write<uint8_t>(0U);
+    }
     writer_->Write(buf_->data(), param_bytes);
   }
 }
@@ -124,11 +202,25 @@ void ParamDeserializer::ForwardRead(lite::Scope* scope) {
   uint32_t max_tensor_size =
       *reinterpret_cast<uint32_t const*>(data + sizeof(uint16_t));
 
-  buf_->ResetLazy(max_tensor_size);
+  // Reference the params in place if the model file is mapped
+  auto mapped_file = reader_->mapped_file();
+  if (!mapped_file) {
+    buf_->ResetLazy(max_tensor_size);
+  }
   for (size_t i = 0; i < params_size; ++i) {
     uint32_t total_size = reader_->Read<uint32_t>();
     uint32_t offset = reader_->Read<uint32_t>();
     uint32_t param_bytes = total_size - offset;
+    if (mapped_file) {
+      reader_->Skip(offset - sizeof(offset));
+      const char* param_data = mapped_file->data() + reader_->current();
+      reader_->Skip(param_bytes);
+      fbs::ParamDescView param(param_data, param_bytes);
+      FillTensor(scope->Var(param.Name())->GetMutable<lite::Tensor>(),
+                 param,
+                 mapped_file);
+      continue;
+    }
     ReadBytesToBuffer(offset - sizeof(offset));
     ReadBytesToBuffer(param_bytes);
     fbs::ParamDescView param(buf_.get());
@@ -33,6 +33,17 @@ void FillParam(const std::string& name,
 
 void FillTensor(lite::Tensor* tensor, const ParamDescReadAPI& param);
 
+// Make the tensor a view of the param data in the mapped model file instead
+// of a copy, if the data is suitably aligned. The tensor is copied into its own
+// memory once it's requested to be writable, see `Tensor::mutable_data`.
+void FillTensor(lite::Tensor* tensor,
+                const ParamDescReadAPI& param,
+                const std::shared_ptr<model_parser::MappedFile>& file);
+
+// The data of each param is aligned to this in the saved model file, so that
+// it can be referenced directly once the file is mapped into memory.
+const size_t kParamDataAlignment = 64;
+
 #ifdef LITE_WITH_FLATBUFFERS_DESC
 class ParamSerializer {
  public:
@@ -128,6 +128,34 @@ TEST(CombinedParamsDesc, Scope) {
     deserializer.ForwardRead(&scope_3);
     check_params(scope_3);
   }
+
+  {
+    Scope scope_4;
+    LOG(INFO) << "Load params from mapped file...";
+    auto mapped_file = model_parser::MappedFile::Open(path);
+    ASSERT_TRUE(mapped_file);
+    // The mapping is shared by all the users of the same file
+    EXPECT_EQ(mapped_file, model_parser::MappedFile::Open(path));
+    model_parser::MappedFileReader reader(mapped_file);
+    fbs::ParamDeserializer deserializer(&reader);
+    deserializer.ForwardRead(&scope_4);
+    check_params(scope_4);
+
+    // The first param is followed by the others, so it must be referenced
+    // in place.
+    auto* tensor = scope_4.FindVar(param_names[0])->GetMutable<Tensor>();
+    const char* data = static_cast<const char*>(tensor->raw_data());
+    EXPECT_GE(data, mapped_file->data());
+    EXPECT_LT(data, mapped_file->data() + mapped_file->length());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % kParamDataAlignment, 0u);
+    // Asking for a writable tensor gives a private copy
+    float* mutable_data = tensor->mutable_data<float>();
+    EXPECT_NE(static_cast<const void*>(mutable_data),
+              static_cast<const void*>(data));
+    check_params(scope_4);
+    mutable_data[0] = -1.f;
+    EXPECT_EQ(*reinterpret_cast<const float*>(data), tensor_0->data<float>()[0]);
+  }
 }
 #endif  // LITE_WITH_FLATBUFFERS_DESC
 
@@ -34,15 +34,19 @@ class ParamDescView : public ParamDescReadAPI {
  public:
   explicit ParamDescView(model_parser::Buffer* buf) {
     CHECK(buf) << "The pointer in buf can not be nullptr";
-    flatbuffers::Verifier verifier(static_cast<const uint8_t*>(buf->data()),
-                                   buf->size());
+    Init(buf->data(), buf->size());
+  }
+  // View a param in memory which is not owned by a buffer, e.g. a mapped file.
+  ParamDescView(const void* data, size_t size) { Init(data, size); }
+  explicit ParamDescView(proto::ParamDesc const* desc) : desc_(desc) { Init(); }
+  void Init(const void* data, size_t size) {
+    CHECK(data) << "The pointer of param data can not be nullptr";
+    flatbuffers::Verifier verifier(static_cast<const uint8_t*>(data), size);
     CHECK(verifier.VerifyBuffer<paddle::lite::fbs::proto::ParamDesc>(nullptr))
         << "Param verification failed.";
-    desc_ =
-        flatbuffers::GetRoot<paddle::lite::fbs::proto::ParamDesc>(buf->data());
+    desc_ = flatbuffers::GetRoot<paddle::lite::fbs::proto::ParamDesc>(data);
     Init();
   }
-  explicit ParamDescView(proto::ParamDesc const* desc) : desc_(desc) { Init(); }
   void Init() {
     CHECK(desc_);
     CHECK(desc_->variable_type() ==
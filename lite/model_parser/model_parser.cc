@@ -741,13 +741,28 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
 
 void LoadModelNaiveFromFile(const std::string &filename,
                             Scope *scope,
-                            cpp::ProgramDesc *cpp_prog) {
+                            cpp::ProgramDesc *cpp_prog,
+                            bool use_mmap) {
   CHECK(cpp_prog);
   CHECK(scope);
   // ModelFile
   const std::string prog_path = filename;
-  // Offset
-  model_parser::BinaryFileReader reader(filename, 0);
+  std::unique_ptr<model_parser::ByteReader> reader_ptr;
+  std::shared_ptr<model_parser::MappedFile> mapped_file;
+  if (use_mmap) {
+    mapped_file = model_parser::MappedFile::Open(filename);
+    if (!mapped_file) {
+      LOG(WARNING) << "Failed to map '" << filename
+                   << "' into memory, read it instead.";
+    }
+  }
+  if (mapped_file) {
+    reader_ptr.reset(new model_parser::MappedFileReader(mapped_file));
+  } else {
+    // Offset
+    reader_ptr.reset(new model_parser::BinaryFileReader(filename, 0));
+  }
+  auto &reader = *reader_ptr;
 
   // (1)get meta version
   uint16_t meta_version;
@@ -833,7 +848,7 @@ void LoadModelNaiveV0FromFile(const std::string &filename,
   VLOG(4) << "Load naive buffer model in '" << filename << "' successfully";
 }
 #endif  // LITE_ON_TINY_PUBLISH
-void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
+void LoadModelFbsFromFile(model_parser::ByteReader *reader,
                           Scope *scope,
                           cpp::ProgramDesc *cpp_prog,
                           uint16_t meta_version) {
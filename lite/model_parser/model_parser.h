@@ -139,14 +139,18 @@ void LoadNonCombinedParamsPb(const std::string& model_dir,
                              const lite_api::CxxModelBuffer& model_buffer,
                              Scope* scope);
 #endif  // LITE_ON_TINY_PUBLISH
-void LoadModelFbsFromFile(model_parser::BinaryFileReader* reader,
+void LoadModelFbsFromFile(model_parser::ByteReader* reader,
                           Scope* scope,
                           cpp::ProgramDesc* cpp_prog,
                           uint16_t meta_version);
 
+// If `use_mmap` is true, the model file is mapped into memory and the params
+// reference the mapping instead of being copied. The mapping is shared by all
+// the scopes loaded from the same file.
 void LoadModelNaiveFromFile(const std::string& filename,
                             lite::Scope* scope,
-                            cpp::ProgramDesc* prog);
+                            cpp::ProgramDesc* prog,
+                            bool use_mmap = false);
 
 void LoadModelNaiveFromMemory(const std::string& model_buffer,
                               lite::Scope* scope,
@@ -15,9 +15,7 @@
 #pragma once
 #include <string>
 #include "lite/core/op_lite.h"
-#ifdef LITE_WITH_PROFILE
 #include "lite/api/paddle_place.h"
-#endif
 
 namespace paddle {
 namespace lite {
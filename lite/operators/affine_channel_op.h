@@ -39,7 +39,6 @@ class AffineChannelOpLite : public OpLite {
 
   std::string DebugString() const override { return "affine_channel"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.X->dims();
     auto output_dims = param_.Out->dims();
@@ -48,7 +47,6 @@ class AffineChannelOpLite : public OpLite {
     ch->remark = param_.data_layout;
     ch->macs = param_.X->numel() * 2.0;
   }
-#endif
 
  private:
   mutable AffineChannelParam param_;
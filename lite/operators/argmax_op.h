@@ -39,7 +39,6 @@ class ArgmaxOpLite : public OpLite {
 
   std::string DebugString() const override { return "argmax"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.X->dims();
     auto output_dims = param_.Out->dims();
@@ -58,7 +57,6 @@ class ArgmaxOpLite : public OpLite {
     for (int i = 1; i <= max_num; i++) gops *= i;
     ch->macs = gops * output_dims.production();
   }
-#endif
 
  private:
   mutable ArgmaxParam param_;
@@ -38,7 +38,6 @@ class ArgsortOpLite : public OpLite {
   void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
   std::string DebugString() const override { return "argsort"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.X->dims();
     auto output_dims = param_.Out->dims();
@@ -46,7 +45,6 @@ class ArgsortOpLite : public OpLite {
     ch->output_shape = ch->DimToStr(output_dims);
     ch->macs = param_.X->numel() * 1.0;
   }
-#endif
 
  private:
   mutable ArgsortParam param_;
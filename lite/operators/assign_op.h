@@ -44,7 +44,6 @@ class AssignOpLite : public OpLite {
     return true;
   }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.X->dims();
     auto output_dims = param_.Out->dims();
@@ -53,7 +52,6 @@ class AssignOpLite : public OpLite {
     // ch->remark = "";
     ch->macs = param_.X->numel() * 1.0;
   }
-#endif
 
  private:
   mutable AssignParam param_;
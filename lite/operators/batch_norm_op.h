@@ -39,7 +39,6 @@ class BatchNormOp : public OpLite {
   void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
   std::string DebugString() const override { return "batch_norm"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.x->dims();
     auto output_dims = param_.y->dims();
@@ -48,7 +47,6 @@ class BatchNormOp : public OpLite {
     // ch->remark = "";
     ch->macs = param_.y->numel() * 2.0;
   }
-#endif
 
  private:
   mutable BatchNormParam param_;
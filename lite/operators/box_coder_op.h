@@ -39,7 +39,6 @@ class BoxCoderOpLite : public OpLite {
 
   std::string DebugString() const override { return "box_coder"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     // auto input_dims = param_.Input->dims();
     // auto output_dims = param_.Output->dims();
@@ -49,7 +48,6 @@ class BoxCoderOpLite : public OpLite {
                  "x" + std::to_string(param_.proposals->dims()[1]);
     ch->macs = param_.proposals->dims()[0] * param_.proposals->dims()[1] * 30.f;
   }
-#endif
 
  private:
   mutable BoxCoderParam param_;
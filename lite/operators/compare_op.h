@@ -38,7 +38,6 @@ class CompareOp : public OpLite {
 
   std::string DebugString() const override { return "binary logical"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto output_dims = param_.Out->dims();
     ch->input_shape = "X:" + ch->DimToStr(param_.X->dims()) + "Y:" +
@@ -48,7 +47,6 @@ class CompareOp : public OpLite {
                  std::to_string(param_.force_cpu);
     ch->macs = param_.Out->numel() * 1.0f;
   }
-#endif
 
  private:
   mutable CompareParam param_;
@@ -22,9 +22,7 @@
 #include "lite/core/tensor.h"
 #include "lite/operators/op_params.h"
 #include "lite/utils/all.h"
-#ifdef LITE_WITH_PROFILE
 #include "lite/api/paddle_place.h"
-#endif
 
 namespace paddle {
 namespace lite {
@@ -40,7 +38,6 @@ class ConvOpLite : public OpLite {
   bool InferShapeImpl() const override;
   bool InferShapeWithCache() const override { return true; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter* ch) {
     auto filter_dims = param_.filter->dims();
     auto input_dims = param_.x->dims();
@@ -66,7 +63,6 @@ class ConvOpLite : public OpLite {
       ch->macs += 1.0f * output_dims.production();
     }
   }
-#endif
 
   bool AttachInput(const cpp::OpDescWrite& op_desc,
                    lite::Scope* scope) override {
@@ -22,9 +22,7 @@
 #include "lite/core/tensor.h"
 #include "lite/operators/op_params.h"
 #include "lite/utils/all.h"
-#ifdef LITE_WITH_PROFILE
 #include "lite/api/paddle_place.h"
-#endif
 
 namespace paddle {
 namespace lite {
@@ -40,7 +38,6 @@ class DeformableConvOpLite : public OpLite {
   bool InferShapeImpl() const override;
   bool InferShapeWithCache() const override { return true; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter* ch) {
     auto filter_dims = param_.conv_param.filter->dims();
     auto input_dims = param_.x->dims();
@@ -63,7 +60,6 @@ class DeformableConvOpLite : public OpLite {
                output_dims.production() * input_dims[1] /
                param_.conv_param.groups;
   }
-#endif
 
   // TODO(Superjomn) replace framework::OpDesc with a lite one.
   bool AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) override {
@@ -144,6 +144,15 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
     if (op_info->HasOutputScale(out_scale_name, true))
       param_.output_scale = op_info->GetOutputScale(out_scale_name, true)[0];
   }
+  // The weights quantized by post_quant_dynamic_pass which are kept in int8
+  // for the kernels computing with them directly
+  auto weight_quant_scale = W + "_quant_scale";
+  if (op_desc.HasAttr("quantize_weight_bits") &&
+      op_desc.HasAttr(weight_quant_scale)) {
+    param_.weight_scale =
+        op_desc.GetAttr<std::vector<float>>(weight_quant_scale);
+    param_.bit_length = op_desc.GetAttr<int>("quantize_weight_bits");
+  }
   if (op_desc.HasAttr("op_type")) {
     param_.op_type = op_desc.GetAttr<std::string>("op_type");
   }
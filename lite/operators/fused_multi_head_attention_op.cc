@@ -0,0 +1,98 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_multi_head_attention_op.h"
+#include <algorithm>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedMultiHeadAttentionOpLite::CheckShape() const {
+  CHECK_OR_FALSE(param_.input);
+  CHECK_OR_FALSE(param_.q_weight);
+  CHECK_OR_FALSE(param_.k_weight);
+  CHECK_OR_FALSE(param_.v_weight);
+  CHECK_OR_FALSE(param_.q_bias);
+  CHECK_OR_FALSE(param_.k_bias);
+  CHECK_OR_FALSE(param_.v_bias);
+  CHECK_OR_FALSE(param_.out_weight);
+  CHECK_OR_FALSE(param_.out_bias);
+  CHECK_OR_FALSE(param_.output);
+
+  const auto input_dims = param_.input->dims();
+  const auto q_dims = param_.q_weight->dims();
+  const auto out_dims = param_.out_weight->dims();
+  CHECK_EQ_OR_FALSE(input_dims.size(), 3UL);
+  CHECK_EQ_OR_FALSE(q_dims.size(), 2UL);
+  CHECK_EQ_OR_FALSE(q_dims[0], input_dims[2]);
+  CHECK_OR_FALSE(param_.k_weight->dims() == q_dims);
+  CHECK_OR_FALSE(param_.v_weight->dims() == q_dims);
+  CHECK_EQ_OR_FALSE(param_.q_bias->numel(), q_dims[1]);
+  CHECK_EQ_OR_FALSE(param_.k_bias->numel(), q_dims[1]);
+  CHECK_EQ_OR_FALSE(param_.v_bias->numel(), q_dims[1]);
+  CHECK_EQ_OR_FALSE(out_dims.size(), 2UL);
+  CHECK_EQ_OR_FALSE(out_dims[0], q_dims[1]);
+  CHECK_EQ_OR_FALSE(param_.out_bias->numel(), out_dims[1]);
+  CHECK_GT_OR_FALSE(param_.head_num, 0);
+  CHECK_EQ_OR_FALSE(q_dims[1] % param_.head_num, 0);
+  if (param_.mask) {
+    CHECK_OR_FALSE(param_.mask->dims().size() <= 4UL);
+  }
+  return true;
+}
+
+bool FusedMultiHeadAttentionOpLite::InferShapeImpl() const {
+  const auto input_dims = param_.input->dims();
+  param_.output->Resize(
+      {input_dims[0], input_dims[1], param_.out_weight->dims()[1]});
+  param_.output->set_lod(param_.input->lod());
+  return true;
+}
+
+bool FusedMultiHeadAttentionOpLite::AttachImpl(const cpp::OpDesc &op_desc,
+                                               lite::Scope *scope) {
+  auto get_input = [&](const std::string &name) {
+    return scope->FindTensor(op_desc.Input(name).front());
+  };
+  param_.input = get_input("Input");
+  param_.q_weight = get_input("QWeight");
+  param_.k_weight = get_input("KWeight");
+  param_.v_weight = get_input("VWeight");
+  param_.q_bias = get_input("QBias");
+  param_.k_bias = get_input("KBias");
+  param_.v_bias = get_input("VBias");
+  param_.out_weight = get_input("OutWeight");
+  param_.out_bias = get_input("OutBias");
+  param_.mask = nullptr;
+  std::vector<std::string> input_arg_names = op_desc.InputArgumentNames();
+  if (std::find(input_arg_names.begin(), input_arg_names.end(), "Mask") !=
+          input_arg_names.end() &&
+      !op_desc.Input("Mask").empty()) {
+    param_.mask = get_input("Mask");
+  }
+  param_.output = scope->FindMutableTensor(op_desc.Output("Output").front());
+  param_.head_num = op_desc.GetAttr<int>("head_num");
+  param_.alpha = op_desc.GetAttr<float>("alpha");
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_multi_head_attention,
+                 paddle::lite::operators::FusedMultiHeadAttentionOpLite);
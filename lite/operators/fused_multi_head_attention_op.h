@@ -0,0 +1,61 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include "lite/core/kernel.h"
+#include "lite/core/op_lite.h"
+#include "lite/core/scope.h"
+#include "lite/operators/op_params.h"
+#include "lite/utils/all.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+/*
+ * The multi-head attention of a transformer encoder in one op, fused by
+ * lite_multi_head_attention_fuse_pass:
+ *   q, k, v = input * QWeight + QBias, input * KWeight + KBias, ...
+ *   each head: attn = softmax(alpha * q * k^T + Mask) * v
+ *   Output = concat(attn of heads) * OutWeight + OutBias
+ * The batch and the sequence length are only known at runtime.
+ */
+class FusedMultiHeadAttentionOpLite : public OpLite {
+ public:
+  FusedMultiHeadAttentionOpLite() {}
+
+  explicit FusedMultiHeadAttentionOpLite(const std::string &type)
+      : OpLite(type) {}
+
+  bool CheckShape() const override;
+
+  bool InferShapeImpl() const override;
+
+  bool AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) override;
+
+  void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
+
+  std::string DebugString() const override {
+    return "fused_multi_head_attention";
+  }
+
+ private:
+  mutable FusedMultiHeadAttentionParam param_;
+};
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
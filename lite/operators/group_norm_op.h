@@ -39,7 +39,6 @@ class GroupNormOp : public OpLite {
 
   std::string DebugString() const override { return "group_norm"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.x->dims());
     ch->output_shape = ch->DimToStr(param_.out->dims());
@@ -50,7 +49,6 @@ class GroupNormOp : public OpLite {
     auto nchw = x_dims.production();
     ch->macs = 5.f * nchw + 3.f * (nc + hw);
   }
-#endif
 
  private:
   mutable GroupNormParam param_;
@@ -43,14 +43,12 @@ class IncrementOp : public OpLite {
     return true;
   }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.X->dims());
     ch->output_shape = ch->DimToStr(param_.Out->dims());
     ch->remark = "step" + std::to_string(param_.step);
     ch->macs = param_.X->numel() * 1.0f;
   }
-#endif
 
  private:
   mutable IncrementParam param_;
@@ -39,14 +39,12 @@ class Index_selectOpLite : public OpLite {
 
   std::string DebugString() const override { return "index_select"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.X->dims();
     auto output_dims = param_.Out->dims();
     ch->input_shape = ch->DimToStr(input_dims);
     ch->output_shape = ch->DimToStr(output_dims);
   }
-#endif
 
  private:
   mutable Index_selectParam param_;
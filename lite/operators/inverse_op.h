@@ -39,14 +39,12 @@ class InverseOpLite : public OpLite {
 
   std::string DebugString() const override { return "inverse"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.Input->dims();
     auto output_dims = param_.Output->dims();
     ch->input_shape = ch->DimToStr(input_dims);
     ch->output_shape = ch->DimToStr(output_dims);
   }
-#endif
 
  private:
   mutable InverseParam param_;
@@ -30,7 +30,6 @@ class IoCopyOp : public OpLite {
 
   void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.x->dims();
     auto output_dims = param_.y->dims();
@@ -38,7 +37,6 @@ class IoCopyOp : public OpLite {
     ch->output_shape = ch->DimToStr(output_dims);
     ch->remark = "type" + std::to_string(param_.process_type);
   }
-#endif
 
  protected:
   bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
@@ -31,12 +31,10 @@ class LoDArrayLengthOp : public OpLite {
 
   void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto output_dims = param_.out->dims();
     ch->output_shape = ch->DimToStr(output_dims);
   }
-#endif
 
  protected:
   bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
@@ -36,14 +36,12 @@ class LrnOpLite : public OpLite {
 
   std::string DebugString() const override { return "lrn"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.X->dims());
     ch->output_shape = ch->DimToStr(param_.Out->dims());
     ch->remark = "n" + std::to_string(param_.n) + param_.norm_region;
     ch->macs = param_.Out->numel() * param_.k * 2.f;
   }
-#endif
 
  private:
   mutable LrnParam param_;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/operators/matmul_v2_op.h"
+#include <algorithm>
 #include "lite/core/op_registry.h"
 
 namespace paddle {
@@ -97,11 +98,15 @@ bool MatMulV2OpLite::InferShapeImpl() const {
   } else {
     N = dims_y[ndims_y - 1];
   }
-  std::vector<int64_t> new_dims;
-  if (ndims_x >= ndims_y) {
-    dim_out_vec.assign(dims_x.begin(), dims_x.end() - 2);
-  } else {
-    dim_out_vec.assign(dims_y.begin(), dims_y.end() - 2);
+  // the batch dims are broadcast against each other
+  int batch_rank = std::max(ndims_x, ndims_y) - 2;
+  dim_out_vec.resize(batch_rank);
+  for (int i = 0; i < batch_rank; ++i) {
+    int xi = i - (batch_rank - (ndims_x - 2));
+    int yi = i - (batch_rank - (ndims_y - 2));
+    int64_t x_dim = xi >= 0 ? dims_x[xi] : 1;
+    int64_t y_dim = yi >= 0 ? dims_y[yi] : 1;
+    dim_out_vec[i] = x_dim == 1 ? y_dim : x_dim;
   }
   if (!x_broadcasted) {
     dim_out_vec.push_back(M);
@@ -152,6 +157,15 @@ bool MatMulV2OpLite::AttachImpl(const cpp::OpDesc &op_desc,
     if (op_info->HasOutputScale(out_scale_name, true))
       param_.output_scale = op_info->GetOutputScale(out_scale_name, true)[0];
   }
+  // The weights quantized by post_quant_dynamic_pass which are kept in int8
+  // for the kernels computing with them directly
+  auto weight_quant_scale = op_desc.Input("Y").front() + "_quant_scale";
+  if (op_desc.HasAttr("quantize_weight_bits") &&
+      op_desc.HasAttr(weight_quant_scale)) {
+    param_.weight_scale =
+        op_desc.GetAttr<std::vector<float>>(weight_quant_scale);
+    param_.bit_length = op_desc.GetAttr<int>("quantize_weight_bits");
+  }
   return true;
 }
 
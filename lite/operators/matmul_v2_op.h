@@ -43,7 +43,6 @@ class MatMulV2OpLite : public OpLite {
 
   std::string DebugString() const override { return "matmul_v2"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.X->dims());
     ch->filter_shape = ch->DimToStr(param_.Y->dims());
@@ -66,7 +65,6 @@ class MatMulV2OpLite : public OpLite {
     }
     ch->macs = 3.f * m * n * k;
   }
-#endif
 
  private:
   mutable MatMulParam param_;
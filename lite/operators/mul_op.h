@@ -72,6 +72,15 @@ class MulOpLite : public OpLite {
       if (op_info->HasOutputScale(out_scale_name, true))
         param_.output_scale = op_info->GetOutputScale(out_scale_name, true)[0];
     }
+    // The weights quantized by post_quant_dynamic_pass which are kept in int8
+    // for the kernels computing with them directly
+    auto weight_quant_scale = op_desc.Input("Y").front() + "_quant_scale";
+    if (op_desc.HasAttr("quantize_weight_bits") &&
+        op_desc.HasAttr(weight_quant_scale)) {
+      param_.weight_scale =
+          op_desc.GetAttr<std::vector<float>>(weight_quant_scale);
+      param_.bit_length = op_desc.GetAttr<int>("quantize_weight_bits");
+    }
     input_tensor_ptrs_cache_.push_back(param_.x);
     input_tensor_ptrs_cache_.push_back(param_.y);
     output_tensor_ptrs_cache_.push_back(param_.output);
@@ -81,7 +90,6 @@ class MulOpLite : public OpLite {
 
   std::string DebugString() const override { return "mul"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.x->dims());
     ch->filter_shape = ch->DimToStr(param_.y->dims());
@@ -93,7 +101,6 @@ class MulOpLite : public OpLite {
     auto y_mat_dims = y_dims.Flatten2D(param_.y_num_col_dims);
     ch->macs = 1.f * x_mat_dims[0] * x_mat_dims[1] * y_mat_dims[1];
   }
-#endif
 
  private:
   mutable MulParam param_;
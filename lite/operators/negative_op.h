@@ -38,14 +38,12 @@ class NegativeOpLite : public OpLite {
 
   std::string DebugString() const override { return "negative"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.X->dims());
     ch->output_shape = ch->DimToStr(param_.Out->dims());
     // ch->remark = "";
     ch->macs = 1.f * param_.Out->numel();
   }
-#endif
 
  private:
   mutable NegativeParam param_;
@@ -54,13 +54,11 @@ class OneHotOp : public OpLite {
 
   std::string DebugString() const override { return "one_hot"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.X->dims());
     ch->output_shape = ch->DimToStr(param_.Out->dims());
     ch->macs = param_.X->numel() * 1.f;
   }
-#endif
 
  private:
   mutable OneHotParam param_;
@@ -1396,6 +1396,31 @@ struct BmmParam : ParamBase {
   lite::Tensor* Out{};
 };
 
+// Multi-head attention fused from the projections, scaled dot-product,
+// softmax and output projection of a transformer encoder.
+struct FusedMultiHeadAttentionParam : ParamBase {
+  // [batch, seq_len, hidden]
+  const lite::Tensor* input{nullptr};
+  // [hidden, head_num * head_dim] and [head_num * head_dim]
+  const lite::Tensor* q_weight{nullptr};
+  const lite::Tensor* k_weight{nullptr};
+  const lite::Tensor* v_weight{nullptr};
+  const lite::Tensor* q_bias{nullptr};
+  const lite::Tensor* k_bias{nullptr};
+  const lite::Tensor* v_bias{nullptr};
+  // [head_num * head_dim, out_dim] and [out_dim]
+  const lite::Tensor* out_weight{nullptr};
+  const lite::Tensor* out_bias{nullptr};
+  // Optional, added to the scores, broadcast to
+  // [batch, head_num, seq_len, seq_len]
+  const lite::Tensor* mask{nullptr};
+  // [batch, seq_len, out_dim]
+  lite::Tensor* output{nullptr};
+  int head_num{1};
+  // the scale of q * k^T
+  float alpha{1.f};
+};
+
 struct GatherNdParam : ParamBase {
   const lite::Tensor* x{nullptr};
   const lite::Tensor* index{nullptr};
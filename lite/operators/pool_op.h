@@ -106,7 +106,6 @@ class PoolOpLite : public OpLite {
 
   std::string DebugString() const override { return "pool"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.x->dims();
     auto output_dims = param_.output->dims();
@@ -123,7 +122,6 @@ class PoolOpLite : public OpLite {
     ch->remark += param_.padding_algorithm;
     ch->macs = output_dims.production() * param_.ksize[0] * param_.ksize[1];
   }
-#endif
 
  private:
   mutable PoolParam param_;
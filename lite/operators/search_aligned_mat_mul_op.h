@@ -39,7 +39,6 @@ class SearchAlignedMatMulOpLite : public OpLite {
 
   std::string DebugString() const override { return "search_aligned_mat_mul"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter* ch) {
     ch->input_shape = ch->DimToStr(param_.X->dims());
     ch->filter_shape = ch->DimToStr(param_.Y->dims());
@@ -67,7 +66,6 @@ class SearchAlignedMatMulOpLite : public OpLite {
     int K = X_K;
     ch->macs = 2.0 * M * N * K;
   }
-#endif
 
  private:
   mutable MatMulParam param_;
@@ -39,7 +39,6 @@ class SearchSeqFcOpLite : public OpLite {
 
   std::string DebugString() const override { return "search_seq_fc"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.x->dims());
     ch->filter_shape = ch->DimToStr(param_.w->dims());
@@ -49,7 +48,6 @@ class SearchSeqFcOpLite : public OpLite {
     auto w_dims = param_.w->dims();
     ch->macs = 2.f * x_dims[0] * x_dims[1] * w_dims[0];
   }
-#endif
 
  private:
   mutable SearchSeqFcParam param_;
@@ -39,13 +39,11 @@ class SignOp : public OpLite {
 
   std::string DebugString() const override { return "sign"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.X->dims());
     ch->output_shape = ch->DimToStr(param_.Out->dims());
     ch->macs = param_.Out->numel();
   }
-#endif
 
  private:
   mutable SignParam param_;
@@ -37,7 +37,6 @@ class SoftmaxOp : public OpLite {
   void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
   std::string DebugString() const override { return "softmax"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     auto input_dims = param_.x->dims();
     auto output_dims = param_.output->dims();
@@ -46,7 +45,6 @@ class SoftmaxOp : public OpLite {
     ch->remark = "axis" + std::to_string(param_.axis);
     ch->macs = 2.f * input_dims.production() * 3;
   }
-#endif
 
  private:
   mutable SoftmaxParam param_;
@@ -38,7 +38,6 @@ class SparseConvOp : public OpLite {
 
   bool InferShapeImpl() const override;
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter* ch) {
     auto filter_dims = param_.oc_nonzeros->dims();
     auto input_dims = param_.x->dims();
@@ -60,7 +59,6 @@ class SparseConvOp : public OpLite {
     // GMACPS = 1e-6f * MACs / predict_ms
     ch->macs = 2.f * output_dims.production() * input_dims[1] / param_.groups;
   }
-#endif
 
   bool AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) override {
     auto X = op_desc.Input("Input").front();
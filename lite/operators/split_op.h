@@ -39,7 +39,6 @@ class SplitOp : public OpLite {
   void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
   std::string DebugString() const override { return "split"; }
 
-#ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter *ch) {
     ch->input_shape = ch->DimToStr(param_.x->dims());
 
@@ -58,7 +57,6 @@ class SplitOp : public OpLite {
     ch->remark = "axis" + std::to_string(param_.axis) + "num" +
                  std::to_string(param_.num) + "sections" + sections;
   }
-#endif
 
  private:
   mutable SplitParam param_;
@@ -0,0 +1,153 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "lite/tests/benchmark/src/x86_configs.h"
+#include "lite/tests/benchmark/src/x86_utils.h"
+
+#include "lite/backends/x86/math/avx/conv_utils.h"
+#include "lite/backends/x86/math/conv_depthwise_impl.h"
+#include "lite/core/context.h"
+
+// The im2col used by the x86 fp32 conv kernel on one image, which unfolds
+// C x H x W into (C * kernel * kernel) x (out_h * out_w).
+static void x86_im2col(benchmark::State& state, int dilation) {  // NOLINT
+  const int c = state.range(0);
+  const int h = state.range(1);
+  const int w = state.range(2);
+  const int kernel = state.range(3);
+  const int stride = state.range(4);
+  const int pad = state.range(5);
+  const int threads = state.range(6);
+  const int kernel_extent = dilation * (kernel - 1) + 1;
+  const int out_h = (h + 2 * pad - kernel_extent) / stride + 1;
+  const int out_w = (w + 2 * pad - kernel_extent) / stride + 1;
+
+  std::vector<float> im(static_cast<size_t>(c) * h * w);
+  std::vector<float> col(static_cast<size_t>(c) * kernel * kernel * out_h *
+                         out_w);
+  X86FillRandom(im.data(), im.size(), -1.f, 1.f);
+
+  X86ScopedThreads scoped_threads(threads);
+  auto run = [&]() {
+    paddle::lite::x86::math::im2col<float>(im.data(),
+                                           c,
+                                           h,
+                                           w,
+                                           kernel,
+                                           kernel,
+                                           pad,
+                                           pad,
+                                           pad,
+                                           pad,
+                                           stride,
+                                           stride,
+                                           dilation,
+                                           dilation,
+                                           col.data());
+  };
+  run();  // warm up
+
+  for (auto _ : state) {
+    run();
+  }
+
+  X86ReportThroughput(state,
+                      0,
+                      static_cast<int64_t>(im.size() + col.size()) *
+                          static_cast<int64_t>(sizeof(float)));
+}
+
+// The direct x86 fp32 depthwise convolutions with bias, one image. The 3x3
+// kernels are run with pad 1 and the 5x5 kernels with pad 2.
+static void x86_depthwise(benchmark::State& state, bool relu) {  // NOLINT
+  const int c = state.range(0);
+  const int h = state.range(1);
+  const int w = state.range(2);
+  const int kernel = state.range(3);
+  const int stride = state.range(4);
+  const int pad = kernel / 2;
+  const int out_h = (h + 2 * pad - kernel) / stride + 1;
+  const int out_w = (w + 2 * pad - kernel) / stride + 1;
+
+  std::vector<float> input(static_cast<size_t>(c) * h * w);
+  std::vector<float> output(static_cast<size_t>(c) * out_h * out_w);
+  std::vector<float> weights(static_cast<size_t>(c) * kernel * kernel);
+  std::vector<float> bias(c);
+  X86FillRandom(input.data(), input.size(), -1.f, 1.f);
+  X86FillRandom(weights.data(), weights.size(), -1.f, 1.f);
+  X86FillRandom(bias.data(), bias.size(), -1.f, 1.f);
+
+  paddle::lite::operators::ActivationParam act_param;
+  if (relu) {
+    act_param.has_active = true;
+    act_param.active_type = paddle::lite_api::ActivationType::kRelu;
+  }
+  paddle::lite::X86Context ctx;
+  namespace math = paddle::lite::x86::math;
+  auto* conv = math::conv_depthwise_3x3s1_p01_direct;
+  if (kernel == 3 && stride == 2) {
+    conv = math::conv_depthwise_3x3s2_p01_direct;
+  } else if (kernel == 5) {
+    conv = stride == 1 ? math::conv_depthwise_5x5s1
+                       : math::conv_depthwise_5x5s2;
+  }
+  auto run = [&]() {
+    conv(input.data(),
+         output.data(),
+         1,
+         c,
+         out_h,
+         out_w,
+         c,
+         h,
+         w,
+         weights.data(),
+         bias.data(),
+         pad,
+         true,
+         act_param,
+         &ctx);
+  };
+  run();  // warm up
+
+  for (auto _ : state) {
+    run();
+  }
+
+  X86ReportThroughput(
+      state,
+      int64_t(2) * c * out_h * out_w * kernel * kernel,
+      static_cast<int64_t>(input.size() + output.size() + weights.size() +
+                           bias.size()) *
+          static_cast<int64_t>(sizeof(float)));
+}
+
+BENCHMARK_CAPTURE(x86_im2col, dilation1, 1)
+    ->Apply(X86Im2colArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_im2col, dilation2, 2)
+    ->Apply(X86Im2colArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_depthwise, bias, false)
+    ->Apply(X86DepthwiseArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_depthwise, bias_relu, true)
+    ->Apply(X86DepthwiseArguments)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
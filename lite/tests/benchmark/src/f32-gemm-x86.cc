@@ -0,0 +1,121 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include "lite/tests/benchmark/src/x86_configs.h"
+#include "lite/tests/benchmark/src/x86_utils.h"
+
+#include "lite/backends/x86/math/blas.h"
+#include "lite/core/context.h"
+#include "lite/core/tensor.h"
+
+// C(M x N) = A(M x K) * B, B is K x N or N x K if `trans_b`.
+static void x86_f32_gemm(benchmark::State& state, bool trans_b) {  // NOLINT
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int k = state.range(2);
+  const int threads = state.range(3);
+
+  paddle::lite::Tensor a, b, c;
+  a.Resize({m, k});
+  b.Resize({k, n});
+  c.Resize({m, n});
+  X86FillRandom(a.mutable_data<float>(), a.numel(), -1.f, 1.f);
+  X86FillRandom(b.mutable_data<float>(), b.numel(), -1.f, 1.f);
+  const float* a_data = a.data<float>();
+  const float* b_data = b.data<float>();
+  float* c_data = c.mutable_data<float>();
+
+  X86ScopedThreads scoped_threads(threads);
+  paddle::lite::X86Context ctx;
+  auto blas =
+      paddle::lite::x86::math::GetBlas<paddle::lite::TargetType::kX86, float>(
+          ctx);
+  auto run = [&]() {
+    blas.GEMM(CblasNoTrans,
+              trans_b ? CblasTrans : CblasNoTrans,
+              m,
+              n,
+              k,
+              1.f,
+              a_data,
+              b_data,
+              0.f,
+              c_data);
+  };
+  run();  // warm up
+
+  for (auto _ : state) {
+    run();
+  }
+
+  X86ReportThroughput(state,
+                      int64_t(2) * m * n * k,
+                      (int64_t(m) * k + int64_t(k) * n + int64_t(m) * n) *
+                          static_cast<int64_t>(sizeof(float)));
+}
+
+// y = A * x or y = A^T * x if `trans`, A is M x N.
+static void x86_f32_gemv(benchmark::State& state, bool trans) {  // NOLINT
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int threads = state.range(2);
+  const int x_size = trans ? m : n;
+  const int y_size = trans ? n : m;
+
+  paddle::lite::Tensor a, x, y;
+  a.Resize({m, n});
+  x.Resize({x_size});
+  y.Resize({y_size});
+  X86FillRandom(a.mutable_data<float>(), a.numel(), -1.f, 1.f);
+  X86FillRandom(x.mutable_data<float>(), x.numel(), -1.f, 1.f);
+  const float* a_data = a.data<float>();
+  const float* x_data = x.data<float>();
+  float* y_data = y.mutable_data<float>();
+
+  X86ScopedThreads scoped_threads(threads);
+  paddle::lite::X86Context ctx;
+  auto blas =
+      paddle::lite::x86::math::GetBlas<paddle::lite::TargetType::kX86, float>(
+          ctx);
+  auto run = [&]() {
+    blas.GEMV(trans, m, n, 1.f, a_data, x_data, 0.f, y_data);
+  };
+  run();  // warm up
+
+  for (auto _ : state) {
+    run();
+  }
+
+  X86ReportThroughput(
+      state,
+      int64_t(2) * m * n,
+      (int64_t(m) * n + x_size + y_size) * static_cast<int64_t>(sizeof(float)));
+}
+
+BENCHMARK_CAPTURE(x86_f32_gemm, nn, false)
+    ->Apply(X86GemmArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_f32_gemm, nt, true)
+    ->Apply(X86GemmArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_f32_gemv, n, false)
+    ->Apply(X86GemvArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_f32_gemv, t, true)
+    ->Apply(X86GemvArguments)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
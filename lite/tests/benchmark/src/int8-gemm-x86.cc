@@ -0,0 +1,82 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "lite/tests/benchmark/src/x86_configs.h"
+#include "lite/tests/benchmark/src/x86_utils.h"
+
+#include "lite/backends/x86/math/gemm_s8u8_compute.h"
+
+// C(M x N) = A(M x K) * B(K x N) with int8 A and B, as run by the x86 int8
+// conv and fc kernels: A is packed once when the gemm is created, B is packed
+// on every call. `relu_type` is 0 for none, 1 for relu.
+template <typename TYPE_C>
+static void x86_s8u8_gemm(benchmark::State& state, int relu_type) {  // NOLINT
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int k = state.range(2);
+
+  std::vector<int8_t> a(static_cast<size_t>(m) * k);
+  std::vector<int8_t> b(static_cast<size_t>(k) * n);
+  std::vector<TYPE_C> c(static_cast<size_t>(m) * n);
+  std::vector<float> a_scale(m, 0.01f);
+  std::vector<float> bias(m);
+  X86FillRandom(a.data(), a.size(), -127.f, 127.f);
+  X86FillRandom(b.data(), b.size(), -127.f, 127.f);
+  X86FillRandom(bias.data(), bias.size(), -1.f, 1.f);
+
+  paddle::lite::x86::math::generate_gemm_s8u8_x86_kern<TYPE_C> gemm(
+      false,
+      false,
+      m,
+      n,
+      k,
+      a.data(),
+      n,
+      a_scale.data(),
+      0.02f,
+      1.f,
+      bias.data(),
+      relu_type,
+      1.f);
+  gemm.compute(a.data(), b.data(), c.data());  // warm up
+
+  for (auto _ : state) {
+    gemm.compute(a.data(), b.data(), c.data());
+  }
+
+  X86ReportThroughput(
+      state,
+      int64_t(2) * m * n * k,
+      int64_t(m) * k + int64_t(k) * n +
+          int64_t(m) * n * static_cast<int64_t>(sizeof(TYPE_C)));
+}
+
+constexpr static auto x86_s8u8_gemm_out_f32 = x86_s8u8_gemm<float>;
+constexpr static auto x86_s8u8_gemm_out_int8 = x86_s8u8_gemm<int8_t>;
+
+BENCHMARK_CAPTURE(x86_s8u8_gemm_out_f32, none, 0)
+    ->Apply(X86Int8GemmArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_s8u8_gemm_out_f32, relu, 1)
+    ->Apply(X86Int8GemmArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_s8u8_gemm_out_int8, none, 0)
+    ->Apply(X86Int8GemmArguments)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
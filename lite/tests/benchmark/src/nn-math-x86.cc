@@ -0,0 +1,280 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "lite/tests/benchmark/src/x86_configs.h"
+#include "lite/tests/benchmark/src/x86_utils.h"
+
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/math/elementwise.h"
+#include "lite/backends/x86/math/math_function.h"
+#include "lite/backends/x86/math/pooling.h"
+#include "lite/backends/x86/math/softmax.h"
+#include "lite/core/context.h"
+#include "lite/core/tensor.h"
+
+using paddle::lite::Tensor;
+
+template <typename PoolProcess>
+static void x86_pool2d(benchmark::State& state, bool exclusive) {  // NOLINT
+  const int n = state.range(0);
+  const int c = state.range(1);
+  const int h = state.range(2);
+  const int w = state.range(3);
+  const int kernel = state.range(4);
+  const int stride = state.range(5);
+  const int pad = state.range(6);
+  const int threads = state.range(7);
+  const int out_h = (h + 2 * pad - kernel) / stride + 1;
+  const int out_w = (w + 2 * pad - kernel) / stride + 1;
+
+  Tensor x, out;
+  x.Resize({n, c, h, w});
+  out.Resize({n, c, out_h, out_w});
+  X86FillRandom(x.mutable_data<float>(), x.numel(), -1.f, 1.f);
+  out.mutable_data<float>();
+
+  X86ScopedThreads scoped_threads(threads);
+  paddle::lite::X86Context ctx;
+  paddle::lite::x86::math::
+      Pool2dFunctor<paddle::lite::TargetType::kX86, PoolProcess, float>
+          pool2d;
+  PoolProcess pool_process;
+  const std::vector<int> ksize{kernel, kernel};
+  const std::vector<int> strides{stride, stride};
+  const std::vector<int> paddings{pad, pad, pad, pad};
+  auto run = [&]() {
+    pool2d(ctx,
+           &x,
+           ksize,
+           strides,
+           paddings,
+           pool_process,
+           exclusive,
+           false,
+           &out);
+  };
+  run();  // warm up
+
+  for (auto _ : state) {
+    run();
+  }
+
+  X86ReportThroughput(
+      state,
+      out.numel() * kernel * kernel,
+      (x.numel() + out.numel()) * static_cast<int64_t>(sizeof(float)));
+}
+
+constexpr static auto x86_max_pool2d =
+    x86_pool2d<paddle::lite::x86::math::MaxPool<float>>;
+constexpr static auto x86_avg_pool2d =
+    x86_pool2d<paddle::lite::x86::math::AvgPool<float>>;
+
+// Softmax over the last axis of a rows x cols matrix.
+static void x86_softmax(benchmark::State& state) {  // NOLINT
+  const int rows = state.range(0);
+  const int cols = state.range(1);
+
+  Tensor x, out;
+  x.Resize({rows, cols});
+  out.Resize({rows, cols});
+  X86FillRandom(x.mutable_data<float>(), x.numel(), -8.f, 8.f);
+  out.mutable_data<float>();
+
+  paddle::lite::X86Context ctx;
+  paddle::lite::x86::math::
+      SoftmaxFunctor<paddle::lite::TargetType::kX86, float, true>
+          softmax;
+  softmax(ctx, cols, &x, &out);  // warm up
+
+  for (auto _ : state) {
+    softmax(ctx, cols, &x, &out);
+  }
+
+  // max, exp, sum and scale of every element, counting exp as one flop
+  X86ReportThroughput(
+      state,
+      int64_t(4) * x.numel(),
+      (x.numel() + out.numel()) * static_cast<int64_t>(sizeof(float)));
+}
+
+// The jit layer_norm kernel used by the x86 layer_norm kernel, normalizing
+// every row of a rows x cols matrix.
+static void x86_layer_norm(benchmark::State& state) {  // NOLINT
+  const int rows = state.range(0);
+  const int cols = state.range(1);
+
+  std::vector<float> x(static_cast<size_t>(rows) * cols);
+  std::vector<float> out(x.size());
+  std::vector<float> mean(rows);
+  std::vector<float> var(rows);
+  std::vector<float> scale(cols);
+  std::vector<float> bias(cols);
+  X86FillRandom(x.data(), x.size(), -1.f, 1.f);
+  X86FillRandom(scale.data(), scale.size(), 0.5f, 1.5f);
+  X86FillRandom(bias.data(), bias.size(), -1.f, 1.f);
+
+  auto layer_norm =
+      paddle::lite::jit::KernelFuncs<paddle::lite::jit::LayerNormTuple<float>,
+                                     paddle::lite::fluid::CPUPlace>::Cache()
+          .At(cols);
+  auto run = [&]() {
+    layer_norm(x.data(),
+               out.data(),
+               mean.data(),
+               var.data(),
+               scale.data(),
+               bias.data(),
+               rows,
+               1e-5f,
+               cols);
+  };
+  run();  // warm up
+
+  for (auto _ : state) {
+    run();
+  }
+
+  // mean, variance and the affine normalization
+  X86ReportThroughput(
+      state,
+      int64_t(8) * rows * cols,
+      (int64_t(2) * rows * cols + 2 * rows + 2 * cols) *
+          static_cast<int64_t>(sizeof(float)));
+}
+
+static void x86_transpose(benchmark::State& state,  // NOLINT
+                          std::vector<int> axis) {
+  std::vector<int64_t> in_shape{
+      state.range(0), state.range(1), state.range(2), state.range(3)};
+  std::vector<int64_t> out_shape(4);
+  for (int i = 0; i < 4; ++i) {
+    out_shape[i] = in_shape[axis[i]];
+  }
+
+  Tensor x, out;
+  x.Resize(in_shape);
+  out.Resize(out_shape);
+  X86FillRandom(x.mutable_data<float>(), x.numel(), -1.f, 1.f);
+  out.mutable_data<float>();
+
+  paddle::lite::X86Context ctx;
+  paddle::lite::x86::math::Transpose<paddle::lite::TargetType::kX86, float, 4>
+      transpose;
+  transpose(ctx, x, &out, axis);  // warm up
+
+  for (auto _ : state) {
+    transpose(ctx, x, &out, axis);
+  }
+
+  X86ReportThroughput(
+      state,
+      0,
+      (x.numel() + out.numel()) * static_cast<int64_t>(sizeof(float)));
+}
+
+typedef void (*X86BroadcastFunc)(const float*,
+                                 const float*,
+                                 float*,
+                                 int,
+                                 int,
+                                 int,
+                                 bool,
+                                 std::string,
+                                 bool);
+
+// out[b][c][i] = x[b][c][i] op y[c], the fast broadcast path of the x86
+// elementwise kernels.
+static void x86_elementwise_broadcast(benchmark::State& state,  // NOLINT
+                                      X86BroadcastFunc broadcast,
+                                      const std::string& act_type) {
+  const int batch = state.range(0);
+  const int channels = state.range(1);
+  const int num = state.range(2);
+
+  std::vector<float> x(static_cast<size_t>(batch) * channels * num);
+  std::vector<float> y(channels);
+  std::vector<float> out(x.size());
+  X86FillRandom(x.data(), x.size(), -1.f, 1.f);
+  X86FillRandom(y.data(), y.size(), 0.5f, 1.5f);
+
+  const bool has_active = !act_type.empty();
+  auto run = [&]() {
+    broadcast(x.data(),
+              y.data(),
+              out.data(),
+              batch,
+              channels,
+              num,
+              has_active,
+              act_type,
+              false);
+  };
+  run();  // warm up
+
+  for (auto _ : state) {
+    run();
+  }
+
+  X86ReportThroughput(
+      state,
+      static_cast<int64_t>(x.size()) * (has_active ? 2 : 1),
+      static_cast<int64_t>(x.size() + y.size() + out.size()) *
+          static_cast<int64_t>(sizeof(float)));
+}
+
+BENCHMARK_CAPTURE(x86_max_pool2d, max, true)
+    ->Apply(X86PoolingArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_avg_pool2d, avg_exclusive, true)
+    ->Apply(X86PoolingArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_avg_pool2d, avg_inclusive, false)
+    ->Apply(X86PoolingArguments)
+    ->UseRealTime();
+BENCHMARK(x86_softmax)->Apply(X86SoftmaxArguments)->UseRealTime();
+BENCHMARK(x86_layer_norm)->Apply(X86LayerNormArguments)->UseRealTime();
+BENCHMARK_CAPTURE(x86_transpose, axis_0213, std::vector<int>{0, 2, 1, 3})
+    ->Apply(X86TransposeArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_transpose, axis_0312, std::vector<int>{0, 3, 1, 2})
+    ->Apply(X86TransposeArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_elementwise_broadcast,
+                  add,
+                  paddle::lite::x86::math::Elementwise_Broadcast_Add<float>,
+                  "")
+    ->Apply(X86ElementwiseBroadcastArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_elementwise_broadcast,
+                  add_relu,
+                  paddle::lite::x86::math::Elementwise_Broadcast_Add<float>,
+                  "relu")
+    ->Apply(X86ElementwiseBroadcastArguments)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(x86_elementwise_broadcast,
+                  mul,
+                  paddle::lite::x86::math::Elementwise_Broadcast_Mul<float>,
+                  "")
+    ->Apply(X86ElementwiseBroadcastArguments)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,149 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "lite/tests/benchmark/src/x86_utils.h"
+
+// Shapes of the x86 micro benchmarks, taken from ResNet-50, MobileNet v1 and
+// BERT base (sequence length 128). Routines which run multi-threaded get a
+// trailing "threads" argument swept by X86ApplyThreadGrid.
+
+static void X86GemmArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K", "threads"});
+  X86ApplyThreadGrid(b,
+                     {
+                         /*  M     N      K  */
+                         {3136, 64, 576},    // resnet50 conv2_x 3x3
+                         {3136, 256, 64},    // resnet50 conv2_x 1x1
+                         {784, 128, 1152},   // resnet50 conv3_x 3x3
+                         {196, 256, 2304},   // resnet50 conv4_x 3x3
+                         {49, 512, 4608},    // resnet50 conv5_x 3x3
+                         {12544, 64, 32},    // mobilenet_v1 pw 1
+                         {196, 512, 512},    // mobilenet_v1 pw 7-11
+                         {128, 768, 768},    // bert qkv / out proj
+                         {128, 3072, 768},   // bert ffn up
+                         {128, 768, 3072},   // bert ffn down
+                         {128, 128, 64},     // bert attention score
+                     });
+}
+
+static void X86GemvArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "threads"});
+  X86ApplyThreadGrid(b,
+                     {
+                         /*  M     N  */
+                         {1000, 2048},  // resnet50 fc
+                         {768, 768},    // bert proj, batch 1
+                         {3072, 768},   // bert ffn up, batch 1
+                         {768, 3072},   // bert ffn down, batch 1
+                         {4096, 4096},
+                     });
+}
+
+static void X86Int8GemmArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K"});
+  /*          M     N      K  */
+  b->Args({64, 3136, 576});    // resnet50 conv2_x 3x3, weights as A
+  b->Args({256, 3136, 64});    // resnet50 conv2_x 1x1
+  b->Args({128, 784, 1152});   // resnet50 conv3_x 3x3
+  b->Args({512, 49, 4608});    // resnet50 conv5_x 3x3
+  b->Args({128, 768, 768});    // bert proj
+  b->Args({128, 3072, 768});   // bert ffn up
+  b->Args({1, 1000, 2048});    // resnet50 fc, batch 1
+}
+
+static void X86Im2colArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"C", "H", "W", "kernel", "stride", "pad", "threads"});
+  X86ApplyThreadGrid(b,
+                     {
+                         /* C    H    W  k  s  p */
+                         {3, 224, 224, 7, 2, 3},  // resnet50 conv1
+                         {64, 56, 56, 3, 1, 1},   // resnet50 conv2_x
+                         {128, 28, 28, 3, 1, 1},  // resnet50 conv3_x
+                         {256, 14, 14, 3, 1, 1},  // resnet50 conv4_x
+                         {128, 56, 56, 3, 2, 1},  // resnet50 conv3_1
+                     });
+}
+
+static void X86DepthwiseArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"C", "H", "W", "kernel", "stride"});
+  /*          C    H    W  k  s */
+  b->Args({32, 112, 112, 3, 1});  // mobilenet_v1 dw 1
+  b->Args({64, 112, 112, 3, 2});  // mobilenet_v1 dw 2
+  b->Args({128, 56, 56, 3, 1});
+  b->Args({256, 28, 28, 3, 2});
+  b->Args({512, 14, 14, 3, 1});
+  b->Args({1024, 7, 7, 3, 1});
+  b->Args({144, 56, 56, 5, 1});  // mobilenet_v3 style 5x5
+  b->Args({240, 28, 28, 5, 2});
+  b->Args({672, 14, 14, 5, 1});
+}
+
+static void X86PoolingArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "C", "H", "W", "kernel", "stride", "pad", "threads"});
+  X86ApplyThreadGrid(b,
+                     {
+                         /*N  C     H    W   k  s  p */
+                         {1, 64, 112, 112, 3, 2, 1},  // resnet50 max pool
+                         {1, 2048, 7, 7, 7, 1, 0},    // resnet50 global
+                         {8, 64, 112, 112, 3, 2, 1},
+                         {1, 256, 28, 28, 2, 2, 0},
+                     });
+}
+
+static void X86SoftmaxArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"rows", "cols"});
+  /*          rows   cols */
+  b->Args({1, 1000});          // classifier
+  b->Args({64, 1000});
+  b->Args({12 * 128, 128});    // bert attention, 12 heads
+  b->Args({12 * 512, 512});
+  b->Args({128, 30522});       // bert vocabulary
+}
+
+static void X86LayerNormArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"rows", "cols"});
+  /*         rows  cols */
+  b->Args({128, 768});    // bert base
+  b->Args({512, 768});
+  b->Args({128, 1024});   // bert large
+  b->Args({1, 768});
+  b->Args({4096, 256});
+}
+
+static void X86TransposeArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"D0", "D1", "D2", "D3"});
+  // Transposed with the axis {0, 2, 1, 3}, as the heads split of attention.
+  /*          D0   D1   D2  D3 */
+  b->Args({1, 128, 12, 64});  // bert base
+  b->Args({8, 128, 12, 64});
+  b->Args({1, 512, 16, 64});  // bert large
+  b->Args({1, 56, 56, 64});   // nhwc like
+}
+
+static void X86ElementwiseBroadcastArguments(
+    benchmark::internal::Benchmark* b) {
+  b->ArgNames({"batch", "channels", "num"});
+  // x has the shape {batch, channels, num}, y has the shape {channels}.
+  /*         batch channels num */
+  b->Args({1, 64, 112 * 112});  // per channel bias / scale
+  b->Args({1, 256, 56 * 56});
+  b->Args({1, 2048, 7 * 7});
+  b->Args({8, 64, 56 * 56});
+  b->Args({32, 512, 14 * 14});
+}
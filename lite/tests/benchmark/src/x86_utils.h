@@ -0,0 +1,112 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#if (defined PADDLE_WITH_MKLML) && !(defined __APPLE__)
+#include <omp.h>
+#endif
+#ifdef PADDLE_WITH_MKLML
+#include "lite/backends/x86/mklml.h"
+#endif
+#ifdef LITE_USE_THREAD_POOL
+#include "lite/core/thread_pool.h"
+#endif
+
+// Thread counts swept by the benchmarks of multi-threaded routines: powers of
+// two up to the number of cores, plus the number of cores itself.
+static std::vector<int> X86ThreadCounts() {
+  int cores =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  std::vector<int> counts;
+  for (int threads = 1; threads < cores; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(cores);
+  return counts;
+}
+
+// Registers every shape in `shapes` once per thread count, the thread count
+// is appended as the last argument.
+static void X86ApplyThreadGrid(
+    benchmark::internal::Benchmark* b,
+    const std::vector<std::vector<int64_t>>& shapes) {
+  for (auto& shape : shapes) {
+    for (int threads : X86ThreadCounts()) {
+      std::vector<int64_t> args(shape);
+      args.push_back(threads);
+      b->Args(args);
+    }
+  }
+}
+
+// Runs the x86 math routines called in its scope on `threads` threads: binds
+// a private ThreadPool to the calling thread when the thread pool is used and
+// sets the MKL and OpenMP thread numbers when MKL is used.
+class X86ScopedThreads {
+ public:
+  explicit X86ScopedThreads(int threads) {
+#ifdef LITE_USE_THREAD_POOL
+    pool_.reset(new paddle::lite::ThreadPool(threads));
+    bind_.reset(new paddle::lite::ThreadPool::ScopedBind(pool_.get()));
+#endif
+#ifdef PADDLE_WITH_MKLML
+#ifdef LITE_WITH_STATIC_MKL
+    MKL_Set_Num_Threads(threads);
+#else
+    paddle::lite::x86::MKL_Set_Num_Threads(threads);
+#endif
+#if !defined(__APPLE__)
+    omp_set_num_threads(threads);
+#endif
+#endif
+  }
+
+ private:
+#ifdef LITE_USE_THREAD_POOL
+  std::unique_ptr<paddle::lite::ThreadPool> pool_;
+  std::unique_ptr<paddle::lite::ThreadPool::ScopedBind> bind_;
+#endif
+};
+
+template <typename T>
+static void X86FillRandom(T* data, int64_t size, float low, float high) {
+  std::mt19937 rng(2021);
+  std::uniform_real_distribution<float> dist(low, high);
+  for (int64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<T>(dist(rng));
+  }
+}
+
+// Reports the arithmetic throughput as "FLOPS" and the minimal memory traffic
+// of one call (every input read once, every output written once) as
+// bytes_per_second. "FLOPS" is omitted for pure data movement routines.
+static void X86ReportThroughput(benchmark::State& state,  // NOLINT
+                                int64_t flops_per_iter,
+                                int64_t bytes_per_iter) {
+  if (flops_per_iter > 0) {
+    state.counters["FLOPS"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * flops_per_iter,
+        benchmark::Counter::kIsRate);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          bytes_per_iter);
+}
@@ -507,6 +507,34 @@ void TestConvDepthwise(Place place, float abs_error = 2e-5) {
   arena.TestPrecision();
 }
 
+// Winograd transforms lose a few bits, the error grows with the channels
+void TestConvWinograd(Place place, float abs_error = 1e-3) {
+  for (auto dims : std::vector<std::vector<int64_t>>{
+           {1, 16, 20, 20}, {2, 32, 13, 27}, {1, 64, 30, 30}}) {
+    for (auto paddings :
+         std::vector<std::vector<int>>{{0, 0}, {1, 1}, {2, 2}}) {
+      for (auto with_bias : {false, true}) {
+        std::unique_ptr<arena::TestCase> tester(
+            new ConvComputeTester(place,
+                                  "def",
+                                  DDim(dims),
+                                  dims[1] + 8,
+                                  3,
+                                  {1, 1},
+                                  paddings,
+                                  1,
+                                  {1, 1},
+                                  "",
+                                  with_bias,
+                                  with_bias,
+                                  "relu"));
+        arena::Arena arena(std::move(tester), place, abs_error);
+        arena.TestPrecision();
+      }
+    }
+  }
+}
+
 TEST(Conv2d, precision) {
   float abs_error = 2e-5;
   Place place;
@@ -543,6 +571,7 @@ TEST(Conv2d, precision) {
   place = TARGET(kX86);
   TestConvKsize(place, abs_error);
   TestConvDepthwise(place, abs_error);
+  TestConvWinograd(place);
   return;
 #else
   return;
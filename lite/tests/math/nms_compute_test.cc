@@ -0,0 +1,300 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+#include "lite/backends/host/math/nms.h"
+#include "lite/backends/host/math/nms_util.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/core/profile/timer.h"
+
+using paddle::lite::profile::Timer;
+namespace host_math = paddle::lite::host::math;
+
+// The NMSFast of multiclass_nms before the bitmask engine.
+void nms_basic(const float* boxes,
+               const float* scores,
+               int num,
+               float score_threshold,
+               float nms_threshold,
+               float eta,
+               int top_k,
+               bool normalized,
+               std::vector<int>* selected_indices) {
+  std::vector<float> scores_data(scores, scores + num);
+  std::vector<std::pair<float, int>> sorted_indices;
+  host_math::GetMaxScoreIndex(
+      scores_data, score_threshold, top_k, &sorted_indices);
+  selected_indices->clear();
+  float adaptive_threshold = nms_threshold;
+  while (sorted_indices.size() != 0) {
+    const int idx = sorted_indices.front().second;
+    bool keep = true;
+    for (size_t k = 0; k < selected_indices->size(); ++k) {
+      if (!keep) break;
+      const int kept_idx = (*selected_indices)[k];
+      float overlap = host_math::JaccardOverlap<float>(
+          boxes + idx * 4, boxes + kept_idx * 4, normalized);
+      keep = overlap <= adaptive_threshold;
+    }
+    if (keep) {
+      selected_indices->push_back(idx);
+    }
+    sorted_indices.erase(sorted_indices.begin());
+    if (keep && eta < 1 && adaptive_threshold > 0.5) {
+      adaptive_threshold *= eta;
+    }
+  }
+}
+
+// Boxes gathered around a few centers, so that many of them overlap.
+void fill_boxes(int num, float scale, std::vector<float>* boxes) {
+  std::mt19937 gen(num);
+  std::uniform_real_distribution<float> center(0.f, scale);
+  std::uniform_real_distribution<float> jitter(-0.05f * scale, 0.05f * scale);
+  std::uniform_real_distribution<float> size(0.02f * scale, 0.3f * scale);
+  std::vector<float> centers(16);
+  for (auto& c : centers) c = center(gen);
+  boxes->resize(num * 4);
+  for (int i = 0; i < num; ++i) {
+    const float cx = centers[(i % 8) * 2] + jitter(gen);
+    const float cy = centers[(i % 8) * 2 + 1] + jitter(gen);
+    const float w = size(gen);
+    const float h = size(gen);
+    float* box = boxes->data() + i * 4;
+    box[0] = cx - w / 2;
+    box[1] = cy - h / 2;
+    box[2] = cx + w / 2;
+    box[3] = cy + h / 2;
+  }
+  if (num > 2) {
+    // A degenerate box and a duplicate.
+    (*boxes)[2] = (*boxes)[0] - 1.f;
+    std::copy_n(boxes->data() + 4, 4, boxes->data() + 8);
+  }
+}
+
+void fill_scores(int num, std::vector<float>* scores) {
+  std::mt19937 gen(num + 1);
+  std::uniform_real_distribution<float> dis(0.f, 1.f);
+  scores->resize(num);
+  for (auto& s : *scores) s = dis(gen);
+  if (num > 3) (*scores)[3] = (*scores)[1];  // a tie
+}
+
+TEST(TestHostNMS, greedy_nms) {
+  for (int num : {1, 3, 7, 64, 100, 1000}) {
+    std::vector<float> scores;
+    fill_scores(num, &scores);
+    for (bool normalized : {true, false}) {
+      std::vector<float> boxes;
+      fill_boxes(num, normalized ? 1.f : 512.f, &boxes);
+      for (float nms_threshold : {0.3f, 0.5f, 0.7f}) {
+        for (float eta : {1.f, 0.9f}) {
+          for (int top_k : {-1, 50}) {
+            std::vector<int> basic;
+            std::vector<int> out;
+            nms_basic(boxes.data(),
+                      scores.data(),
+                      num,
+                      0.05f,
+                      nms_threshold,
+                      eta,
+                      top_k,
+                      normalized,
+                      &basic);
+            host_math::GreedyNMS<float>(boxes.data(),
+                                        4,
+                                        4,
+                                        scores.data(),
+                                        1,
+                                        num,
+                                        0.05f,
+                                        nms_threshold,
+                                        eta,
+                                        top_k,
+                                        normalized,
+                                        &out);
+            EXPECT_EQ(basic, out) << "num: " << num
+                                  << ", normalized: " << normalized
+                                  << ", nms_threshold: " << nms_threshold
+                                  << ", eta: " << eta << ", top_k: " << top_k;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestHostNMS, greedy_nms_strided) {
+  // scores: [M, C] and bboxes: [M, C, 4] as in multiclass_nms3 with rois.
+  const int num = 200;
+  const int class_num = 3;
+  std::vector<float> boxes;
+  std::vector<float> scores;
+  fill_boxes(num * class_num, 1.f, &boxes);
+  fill_scores(num * class_num, &scores);
+  for (int c = 0; c < class_num; ++c) {
+    std::vector<float> class_boxes(num * 4);
+    std::vector<float> class_scores(num);
+    for (int i = 0; i < num; ++i) {
+      std::copy_n(boxes.data() + (i * class_num + c) * 4,
+                  4,
+                  class_boxes.data() + i * 4);
+      class_scores[i] = scores[i * class_num + c];
+    }
+    std::vector<int> basic;
+    std::vector<int> out;
+    nms_basic(class_boxes.data(),
+              class_scores.data(),
+              num,
+              0.1f,
+              0.45f,
+              1.f,
+              -1,
+              true,
+              &basic);
+    host_math::GreedyNMS<float>(boxes.data() + c * 4,
+                                class_num * 4,
+                                4,
+                                scores.data() + c,
+                                class_num,
+                                num,
+                                0.1f,
+                                0.45f,
+                                1.f,
+                                -1,
+                                true,
+                                &out);
+    EXPECT_EQ(basic, out) << "class: " << c;
+  }
+}
+
+TEST(TestHostNMS, matrix_nms) {
+  const int num = 300;
+  std::vector<float> boxes;
+  std::vector<float> scores;
+  fill_boxes(num, 1.f, &boxes);
+  fill_scores(num, &scores);
+  for (bool gaussian : {true, false}) {
+    const float sigma = 2.f;
+    std::vector<int> out;
+    std::vector<float> decayed;
+    host_math::MatrixNMS<float>(boxes.data(),
+                                4,
+                                scores.data(),
+                                1,
+                                num,
+                                0.1f,
+                                0.05f,
+                                sigma,
+                                gaussian,
+                                100,
+                                true,
+                                &out,
+                                &decayed);
+    // Brute force over the top 100 candidates.
+    std::vector<int> order;
+    host_math::SortScoreIndex<float>(
+        scores.data(), 1, num, 0.1f, 100, &order);
+    std::vector<int> basic;
+    std::vector<float> basic_decayed;
+    for (size_t i = 0; i < order.size(); ++i) {
+      float min_decay = 1.f;
+      for (size_t j = 0; j < i; ++j) {
+        float max_iou = 0.f;
+        for (size_t k = 0; k < j; ++k) {
+          max_iou = std::max(max_iou,
+                             host_math::JaccardOverlap<float>(
+                                 boxes.data() + order[j] * 4,
+                                 boxes.data() + order[k] * 4,
+                                 true));
+        }
+        float iou = host_math::JaccardOverlap<float>(
+            boxes.data() + order[i] * 4, boxes.data() + order[j] * 4, true);
+        float decay = gaussian
+                          ? std::exp((max_iou * max_iou - iou * iou) * sigma)
+                          : (1. - iou) / (1. - max_iou);
+        min_decay = std::min(min_decay, decay);
+      }
+      float ds = min_decay * scores[order[i]];
+      if (ds > 0.05f) {
+        basic.push_back(order[i]);
+        basic_decayed.push_back(ds);
+      }
+    }
+    EXPECT_EQ(basic, out) << "gaussian: " << gaussian;
+    ASSERT_EQ(basic_decayed.size(), decayed.size());
+    for (size_t i = 0; i < decayed.size(); ++i) {
+      EXPECT_NEAR(basic_decayed[i], decayed[i], 1e-6f);
+    }
+  }
+}
+
+TEST(TestHostNMS, multiclass_nms_performance) {
+  // A YOLO like head: 80 classes, thousands of candidates per class.
+  const int class_num = 80;
+  const int num = 4000;
+  std::vector<float> boxes;
+  std::vector<float> scores;
+  fill_boxes(num, 608.f, &boxes);
+  fill_scores(num * class_num, &scores);
+  std::vector<std::vector<int>> basic(class_num);
+  std::vector<std::vector<int>> out(class_num);
+
+  Timer t_basic;
+  Timer t_out;
+  for (int r = 0; r < 5; ++r) {
+    t_basic.Start();
+    for (int c = 0; c < class_num; ++c) {
+      nms_basic(boxes.data(),
+                scores.data() + c * num,
+                num,
+                0.01f,
+                0.45f,
+                1.f,
+                1000,
+                false,
+                &basic[c]);
+    }
+    t_basic.Stop();
+    t_out.Start();
+    LITE_PARALLEL_BEGIN(c, tid, class_num) {
+      host_math::GreedyNMS<float>(boxes.data(),
+                                  4,
+                                  4,
+                                  scores.data() + c * num,
+                                  1,
+                                  num,
+                                  0.01f,
+                                  0.45f,
+                                  1.f,
+                                  1000,
+                                  false,
+                                  &out[c]);
+    }
+    LITE_PARALLEL_END();
+    t_out.Stop();
+  }
+  EXPECT_EQ(basic, out);
+  LOG(INFO) << "multiclass nms, classes: " << class_num << ", boxes: " << num
+            << ", basic min time(ms): " << t_basic.LapTimes().Min()
+            << ", engine min time(ms): " << t_out.LapTimes().Min()
+            << ", speedup: "
+            << t_basic.LapTimes().Min() / t_out.LapTimes().Min();
+}
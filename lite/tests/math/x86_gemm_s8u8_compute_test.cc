@@ -24,10 +24,16 @@
 #include <gtest/gtest.h>
 #include <string.h>
 #include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "lite/backends/x86/cpu_info.h"
 #include "lite/backends/x86/math/blas.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+#include "lite/backends/x86/math/gemm_s8u8_pack.h"
 #include "lite/core/context.h"
 #include "lite/core/profile/timer.h"
+#include "lite/core/thread_pool.h"
 #include "lite/core/tensor.h"
 #include "lite/operators/op_params.h"
 #include "lite/tests/utils/fill_data.h"
@@ -353,6 +359,175 @@ bool test_gemm_s8u8f32(
   return true;
 }
 
+namespace x86_math = paddle::lite::x86::math;
+
+float act_ref(float x, int relu_type, float alpha) {
+  switch (relu_type) {
+    case 1:
+      return std::max(x, 0.f);
+    case 2:
+      return std::min(std::max(x, 0.f), alpha);
+    case 3:
+      return x <= 0.f ? x * alpha : x;
+    default:
+      return x;
+  }
+}
+
+float diff_ref(float test, float ref) {
+  return std::fabs(test - ref) / std::max(1.f, std::fabs(ref));
+}
+
+float diff_ref(int8_t test, float ref) {
+  ref = ref >= 0.f ? ref + 0.5f : ref - 0.5f;
+  int iref = std::min(std::max(static_cast<int>(ref), -127), 127);
+  return std::abs(test - iref);
+}
+
+// Runs one micro kernel on packed A and B against a scalar reference.
+template <typename TYPE_C>
+bool test_gemm_s8u8_kernel(
+    x86_math::GemmS8U8Isa isa, int m, int n, int k, int relu_type) {
+  const int k_align4 = (k + 3) / 4 * 4;
+  const float alpha = relu_type == 2 ? 20.f : 0.1f;
+  std::vector<int8_t> a(m * k);
+  std::vector<int8_t> b(k * n);
+  std::vector<float> scale(m);
+  std::vector<float> bias(m);
+  fill_data_rand(a.data(),
+                 static_cast<int8_t>(-63),
+                 static_cast<int8_t>(63),
+                 a.size());
+  fill_data_rand(b.data(),
+                 static_cast<int8_t>(-127),
+                 static_cast<int8_t>(127),
+                 b.size());
+  fill_data_rand(scale.data(), 0.001f, 0.01f, scale.size());
+  fill_data_rand(bias.data(), -10.f, 10.f, bias.size());
+  std::vector<int8_t> pack_a(m * k_align4, 0);
+  std::vector<uint8_t> pack_b(n * k_align4);
+  x86_math::gemm_s8u8s8_prepackA(m, k, a.data(), pack_a.data(), false);
+  x86_math::gemm_s8u8s8_runpackB(n, k, n, b.data(), pack_b.data(), false);
+  std::vector<TYPE_C> c(m * n);
+  x86_math::gemm_kernel_loop_int8(isa,
+                                  m,
+                                  n,
+                                  k,
+                                  pack_a.data(),
+                                  pack_b.data(),
+                                  c.data(),
+                                  n,
+                                  scale.data(),
+                                  bias.data(),
+                                  relu_type,
+                                  alpha);
+  // the kernel adds 128 to B, repack_bias folds it into the bias
+  float max_diff = 0.f;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      int acc = 0;
+      for (int l = 0; l < k; l++) {
+        acc += a[i * k + l] * (b[l * n + j] + TRANS_INT8_UINT8_OFFT);
+      }
+      float ref = act_ref(acc * scale[i] + bias[i], relu_type, alpha);
+      max_diff = std::max(max_diff, diff_ref(c[i * n + j], ref));
+    }
+  }
+  float limit = std::is_same<TYPE_C, int8_t>::value ? 1.f : 1e-4f;
+  return max_diff <= limit;
+}
+
+// The threaded gemm must match the single thread one, only the column tails
+// may differ in rounding as the tiles move.
+template <typename TYPE_C>
+bool test_gemm_s8u8_threads(bool tra, bool trb, int m, int n, int k) {
+  std::vector<int8_t> a(m * k);
+  std::vector<int8_t> b(k * n);
+  std::vector<float> sa(m, 1 / 63.f);
+  std::vector<float> bias(m);
+  fill_data_rand(a.data(),
+                 static_cast<int8_t>(-63),
+                 static_cast<int8_t>(63),
+                 a.size());
+  fill_data_rand(b.data(),
+                 static_cast<int8_t>(-127),
+                 static_cast<int8_t>(127),
+                 b.size());
+  fill_data_rand(bias.data(), -1.f, 1.f, bias.size());
+  x86_math::generate_gemm_s8u8_x86_kern<TYPE_C> gemm(tra,
+                                                     trb,
+                                                     m,
+                                                     n,
+                                                     k,
+                                                     a.data(),
+                                                     n,
+                                                     sa.data(),
+                                                     1 / 127.f,
+                                                     1 / 127.f,
+                                                     bias.data(),
+                                                     1,
+                                                     0.f);
+  float limit = std::is_same<TYPE_C, int8_t>::value ? 1.f : 1e-4f;
+  std::vector<TYPE_C> c_serial(m * n);
+  std::vector<TYPE_C> c_threads(m * n);
+  {
+    paddle::lite::ThreadPool pool(1);
+    paddle::lite::ThreadPool::ScopedBind bind(&pool);
+    gemm.compute(a.data(), b.data(), c_serial.data());
+  }
+  paddle::lite::ThreadPool pool(4);
+  paddle::lite::ThreadPool::ScopedBind bind(&pool);
+  for (int i = 0; i < 2; i++) {
+    gemm.compute(a.data(), b.data(), c_threads.data());
+    for (int j = 0; j < m * n; j++) {
+      if (diff_ref(c_threads[j], static_cast<float>(c_serial[j])) > limit) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST(TestX86LiteGemmInt8, gemm_s8u8_kernels) {
+  std::vector<x86_math::GemmS8U8Isa> isas{x86_math::GemmS8U8Isa::kAVX2};
+  if (paddle::lite::x86::MayIUse(paddle::lite::x86::avx512_core)) {
+    isas.push_back(x86_math::GemmS8U8Isa::kAVX512BW);
+  }
+  if (paddle::lite::x86::MayIUse(paddle::lite::x86::avx512_core_vnni)) {
+    isas.push_back(x86_math::GemmS8U8Isa::kAVX512VNNI);
+  }
+  for (auto isa : isas) {
+    for (int m : {1, 2, 7, 8, 13, 24}) {
+      for (int n : {1, 3, 17, 32, 57, 100}) {
+        for (int k : {1, 6, 37}) {
+          for (int relu_type = 0; relu_type < 4; relu_type++) {
+            EXPECT_TRUE(test_gemm_s8u8_kernel<int8_t>(isa, m, n, k, relu_type))
+                << "isa " << static_cast<int>(isa) << ", " << m << "x" << n
+                << "x" << k << ", relu " << relu_type;
+            EXPECT_TRUE(test_gemm_s8u8_kernel<float>(isa, m, n, k, relu_type))
+                << "isa " << static_cast<int>(isa) << ", " << m << "x" << n
+                << "x" << k << ", relu " << relu_type;
+          }
+        }
+      }
+    }
+  }
+}
+
+#ifdef LITE_USE_THREAD_POOL
+TEST(TestX86LiteGemmInt8, gemm_s8u8_multi_threads) {
+  for (auto shape : std::vector<std::vector<int>>{
+           {1, 1000, 300}, {64, 40, 67}, {19, 300, 33}, {301, 2000, 129}}) {
+    for (auto trans : {false, true}) {
+      EXPECT_TRUE(test_gemm_s8u8_threads<int8_t>(
+          trans, trans, shape[0], shape[1], shape[2]));
+      EXPECT_TRUE(test_gemm_s8u8_threads<float>(
+          trans, !trans, shape[0], shape[1], shape[2]));
+    }
+  }
+}
+#endif
+
 TEST(TestX86LiteGemmInt8, gemm_s8u8_compute) {
 #ifdef GEMM_PROFILE
   pthread_t tid = {0};
@@ -0,0 +1,228 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/x86/math/packed_sgemm.h"
+#include "lite/core/profile/timer.h"
+#include "lite/core/thread_pool.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/tests/utils/naive_math_impl.h"
+
+using paddle::lite::profile::Timer;
+namespace x86_math = paddle::lite::x86::math;
+
+float max_relative_diff(const std::vector<float>& basic,
+                        const std::vector<float>& out) {
+  float max_diff = 0.f;
+  for (size_t i = 0; i < basic.size(); ++i) {
+    float diff = std::fabs(basic[i] - out[i]) / (std::fabs(basic[i]) + 1.f);
+    max_diff = std::max(max_diff, diff);
+  }
+  return max_diff;
+}
+
+bool test_sgemm(bool trans_a,
+                bool trans_b,
+                int m,
+                int n,
+                int k,
+                float alpha,
+                float beta,
+                bool prepack) {
+  int lda = trans_a ? m + 1 : k + 3;
+  int ldb = trans_b ? k + 2 : n + 1;
+  int ldc = n + 5;
+  std::vector<float> a((trans_a ? k : m) * lda);
+  std::vector<float> b((trans_b ? n : k) * ldb);
+  std::vector<float> c(m * ldc);
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(b.data(), -1.f, 1.f, b.size());
+  fill_data_rand(c.data(), -1.f, 1.f, c.size());
+  std::vector<float> c_basic(c);
+
+  std::vector<float> packed_a;
+  std::vector<float> packed_b;
+  if (prepack) {
+    packed_a.resize(x86_math::sgemm_packed_a_size(m, k));
+    packed_b.resize(x86_math::sgemm_packed_b_size(k, n));
+    x86_math::sgemm_pack_a(trans_a, m, k, a.data(), lda, packed_a.data());
+    x86_math::sgemm_pack_b(trans_b, k, n, b.data(), ldb, packed_b.data());
+  }
+  x86_math::sgemm(trans_a,
+                  trans_b,
+                  m,
+                  n,
+                  k,
+                  alpha,
+                  a.data(),
+                  lda,
+                  b.data(),
+                  ldb,
+                  beta,
+                  c.data(),
+                  ldc,
+                  prepack ? packed_a.data() : nullptr,
+                  prepack ? packed_b.data() : nullptr);
+  basic_gemm<float, float>(trans_a,
+                           trans_b,
+                           m,
+                           n,
+                           k,
+                           alpha,
+                           a.data(),
+                           lda,
+                           b.data(),
+                           ldb,
+                           beta,
+                           c_basic.data(),
+                           ldc,
+                           nullptr);
+  float diff = max_relative_diff(c_basic, c);
+  if (diff > 1e-4f) {
+    LOG(INFO) << "sgemm failed, trans_a: " << trans_a
+              << ", trans_b: " << trans_b << ", M: " << m << ", N: " << n
+              << ", K: " << k << ", alpha: " << alpha << ", beta: " << beta
+              << ", prepack: " << prepack << ", diff: " << diff;
+    return false;
+  }
+  return true;
+}
+
+bool test_sgemv(bool trans_a, int m, int n, float beta) {
+  int lda = n + 3;
+  int x_size = trans_a ? m : n;
+  int y_size = trans_a ? n : m;
+  std::vector<float> a(m * lda);
+  std::vector<float> x(x_size);
+  std::vector<float> y(y_size);
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(x.data(), -1.f, 1.f, x.size());
+  fill_data_rand(y.data(), -1.f, 1.f, y.size());
+  std::vector<float> y_basic(y);
+
+  x86_math::sgemv(trans_a, m, n, 1.f, a.data(), lda, x.data(), beta, y.data());
+  // op(A) * x is a gemm of [y_size, x_size] x [x_size, 1]
+  basic_gemm<float, float>(trans_a,
+                           false,
+                           y_size,
+                           1,
+                           x_size,
+                           1.f,
+                           a.data(),
+                           lda,
+                           x.data(),
+                           1,
+                           beta,
+                           y_basic.data(),
+                           1,
+                           nullptr);
+  float diff = max_relative_diff(y_basic, y);
+  if (diff > 1e-4f) {
+    LOG(INFO) << "sgemv failed, trans_a: " << trans_a << ", M: " << m
+              << ", N: " << n << ", beta: " << beta << ", diff: " << diff;
+    return false;
+  }
+  return true;
+}
+
+TEST(TestX86Sgemm, sgemm_compute) {
+  for (auto m : {1, 2, 5, 13, 37, 150}) {
+    for (auto n : {1, 7, 16, 33, 100, 300}) {
+      for (auto k : {1, 3, 64, 257, 520}) {
+        for (auto trans_a : {false, true}) {
+          for (auto trans_b : {false, true}) {
+            for (auto prepack : {false, true}) {
+              EXPECT_TRUE(
+                  test_sgemm(trans_a, trans_b, m, n, k, 1.f, 0.f, prepack));
+              EXPECT_TRUE(
+                  test_sgemm(trans_a, trans_b, m, n, k, 0.5f, 1.5f, prepack));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestX86Sgemm, sgemv_compute) {
+  for (auto m : {1, 3, 17, 255, 1000}) {
+    for (auto n : {1, 8, 31, 600, 1500}) {
+      for (auto trans_a : {false, true}) {
+        EXPECT_TRUE(test_sgemv(trans_a, m, n, 0.f));
+        EXPECT_TRUE(test_sgemv(trans_a, m, n, 2.f));
+      }
+    }
+  }
+}
+
+#ifdef LITE_USE_THREAD_POOL
+TEST(TestX86Sgemm, sgemm_multi_threads) {
+  paddle::lite::ThreadPool pool(4);
+  paddle::lite::ThreadPool::ScopedBind bind(&pool);
+  for (auto shape : std::vector<std::vector<int>>{
+           {1, 1000, 512}, {8, 64, 300}, {150, 1100, 600}, {513, 31, 77}}) {
+    for (auto prepack : {false, true}) {
+      EXPECT_TRUE(test_sgemm(
+          false, false, shape[0], shape[1], shape[2], 1.f, 0.f, prepack));
+      EXPECT_TRUE(test_sgemm(
+          true, true, shape[0], shape[1], shape[2], 1.f, 1.f, prepack));
+    }
+  }
+}
+#endif
+
+TEST(TestX86Sgemm, sgemm_performance) {
+  const int m = 256;
+  const int n = 512;
+  const int k = 1024;
+  std::vector<float> a(m * k);
+  std::vector<float> b(k * n);
+  std::vector<float> c(m * n);
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(b.data(), -1.f, 1.f, b.size());
+  std::vector<float> packed_b(x86_math::sgemm_packed_b_size(k, n));
+  x86_math::sgemm_pack_b(false, k, n, b.data(), n, packed_b.data());
+  Timer t0;
+  for (int i = 0; i < 10; ++i) {
+    t0.Start();
+    x86_math::sgemm(false,
+                    false,
+                    m,
+                    n,
+                    k,
+                    1.f,
+                    a.data(),
+                    k,
+                    b.data(),
+                    n,
+                    0.f,
+                    c.data(),
+                    n,
+                    nullptr,
+                    packed_b.data());
+    t0.Stop();
+  }
+  double gops = 2.0 * m * n * k / 1e9;
+  LOG(INFO) << "sgemm M: " << m << ", N: " << n << ", K: " << k
+            << ", avg time(ms): " << t0.LapTimes().Avg()
+            << ", min time(ms): " << t0.LapTimes().Min()
+            << ", GOPS: " << gops / t0.LapTimes().Min() * 1e3;
+}
+
+#endif  // LITE_WITH_X86
@@ -39,6 +39,22 @@
 // target device model online during the execution phase.
 #define SUBGRAPH_ONLINE_MODE "SUBGRAPH_ONLINE_MODE"
 
+// The max number of the device programs compiled for the different input
+// shapes of a subgraph, the least recently used one is released once it's
+// exceeded. "0"(default) means unlimited.
+#define SUBGRAPH_PROGRAM_CACHE_CAPACITY "SUBGRAPH_PROGRAM_CACHE_CAPACITY"
+
+// Specify the configuration file path or buffer for the shape buckets of the
+// subgraph inputs, the dimension of an input is rounded up to the smallest
+// bucket not less than it and the input is padded with zeros, so that fewer
+// device programs are compiled. The outputs are computed from the padded
+// inputs and keep their shapes, so it only suits the models whose results are
+// not changed by the padding. An example is shown as below:
+// in_var_name:axis:bucket_0,bucket_1,bucket_2
+#define SUBGRAPH_INPUT_SHAPE_BUCKETS_FILE "SUBGRAPH_INPUT_SHAPE_BUCKETS_FILE"
+#define SUBGRAPH_INPUT_SHAPE_BUCKETS_BUFFER \
+  "SUBGRAPH_INPUT_SHAPE_BUCKETS_BUFFER"
+
 // The environment variables for the opencl memory config settings
 // Specify the path of configuration file for the opencl buffer memory config,
 // an